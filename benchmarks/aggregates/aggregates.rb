@@ -0,0 +1,22 @@
+
+# the number of nodes, by default 1000
+N= (ARGV[0].to_i != 0) ? ARGV[0].to_i : 1000
+
+# the facts of a size are the same for all runs
+srand(N)
+
+# create directory
+Dir.mkdir("aggregates#{N}") unless Dir.exist?("aggregates#{N}")
+
+# the nodes are grouped into components, in which edges lead to one of the next nodes
+M = 64
+
+File.open("aggregates#{N}/edge.facts",'w') do |f|
+    (0...N).each do |i|
+        last = [i - i % M + M - 1, N - 1].min
+        next if i == last
+        (0...3).each do |j|
+            f.write("#{i}\t#{[i + 1 + rand(8), last].min}\t#{rand(1000)}\n")
+        end
+    end
+end
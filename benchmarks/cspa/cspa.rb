@@ -0,0 +1,34 @@
+
+# the number of variables, by default 1000
+N= (ARGV[0].to_i != 0) ? ARGV[0].to_i : 1000
+
+# the facts of a size are the same for all runs
+srand(N)
+
+# variables are grouped into methods, within which they mostly flow into nearby ones
+M = 50
+
+def near(i)
+    [i - 1 - rand(8), i - i % M].max
+end
+
+# create directory
+Dir.mkdir("cspa#{N}") unless Dir.exist?("cspa#{N}")
+
+# the assignments within methods, and those of arguments of a few calls between methods
+File.open("cspa#{N}/assign.facts",'w') do |f|
+    (0...N).each do |i|
+        f.write("#{i}\t#{near(i)}\n") unless i % M == 0
+    end
+    (0...N / M / 4).each do |i|
+        f.write("#{rand(N) / M * M}\t#{rand(N)}\n")
+    end
+end
+
+# the dereferences of variables, yielding the locations they point to
+File.open("cspa#{N}/dereference.facts",'w') do |f|
+    (0...N / 10).each do |i|
+        v = rand(N)
+        f.write("#{v}\t#{near(v)}\n")
+    end
+end
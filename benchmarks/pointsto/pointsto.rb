@@ -0,0 +1,47 @@
+
+# the number of variables, by default 1000
+N= (ARGV[0].to_i != 0) ? ARGV[0].to_i : 1000
+
+# the facts of a size are the same for all runs
+srand(N)
+
+# variables are grouped into methods, within which they mostly flow into nearby ones
+M = 50
+
+def near(i)
+    [i - 1 - rand(8), i - i % M].max
+end
+
+# create directory
+Dir.mkdir("pointsto#{N}") unless Dir.exist?("pointsto#{N}")
+
+# objects are numbered after the variables, one is allocated for every tenth variable
+File.open("pointsto#{N}/new.facts",'w') do |f|
+    (0...N / 10).each do |i|
+        f.write("#{rand(N)}\t#{N + i}\n")
+    end
+end
+
+# the assignments within methods, and those of arguments between methods
+File.open("pointsto#{N}/assign.facts",'w') do |f|
+    (0...N).each do |i|
+        f.write("#{i}\t#{near(i)}\n") unless i % M == 0
+    end
+    (0...N / M).each do |i|
+        f.write("#{rand(N) / M * M}\t#{rand(N)}\n")
+    end
+end
+
+File.open("pointsto#{N}/load.facts",'w') do |f|
+    (0...N / 20).each do |i|
+        v = rand(N)
+        f.write("#{v}\t#{near(v)}\n")
+    end
+end
+
+File.open("pointsto#{N}/store.facts",'w') do |f|
+    (0...N / 20).each do |i|
+        v = rand(N)
+        f.write("#{v}\t#{near(v)}\n")
+    end
+end
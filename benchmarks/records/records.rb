@@ -0,0 +1,18 @@
+
+# the number of nodes, by default 1000
+N= (ARGV[0].to_i != 0) ? ARGV[0].to_i : 1000
+
+# the facts of a size are the same for all runs
+srand(N)
+
+# create directory
+Dir.mkdir("records#{N}") unless Dir.exist?("records#{N}")
+
+# each node has three successors
+File.open("records#{N}/edge.facts",'w') do |f|
+    (0...N).each do |i|
+        (0...3).each do |j|
+            f.write("#{i}\t#{rand(N)}\n")
+        end
+    end
+end
@@ -0,0 +1,286 @@
+#!/usr/bin/env ruby
+#
+# Souffle - A Datalog Compiler
+# Copyright (c) 2017, The Souffle Developers. All rights reserved
+# Licensed under the Universal Permissive License v 1.0 as shown at:
+# - https://opensource.org/licenses/UPL
+# - <souffle root>/licenses/SOUFFLE-UPL.txt
+#
+# Runs the benchmarks with the interpreter and the compiled programs for a number of threads,
+# and reports the median time of the runs, the time of loading the inputs, of the evaluation
+# and of writing the outputs, and the peak memory resident of each configuration in JSON.
+# The phases are taken from the profile log of an additional run of each configuration, read
+# by souffle-profile.
+#
+# usage: ruby run.rb [options] [benchmark ...]
+#
+# e.g.   ruby run.rb -s medium -j 1,4 -o results.json tc_left cspa
+#        ruby run.rb -c results.json tc_left cspa
+#
+
+require 'etc'
+require 'fileutils'
+require 'json'
+require 'optparse'
+require 'socket'
+require 'time'
+require 'tmpdir'
+
+DIR = File.expand_path(File.dirname(__FILE__))
+
+# a benchmark: its program and the generator of its facts, relative to this directory, the
+# directory of the facts of a size, created by the generator, and the sizes of the scales
+Benchmark = Struct.new(:program, :generator, :facts, :sizes)
+
+SCALES = ["small", "medium", "large"]
+
+BENCHMARKS = {
+    "tc_left"     => Benchmark.new("tc/tc_left.dl", "tc/tc.rb", "tc%d", [1000, 4000, 16000]),
+    "tc_right"    => Benchmark.new("tc/tc_right.dl", "tc/tc.rb", "tc%d", [1000, 4000, 16000]),
+    "tc_quad"     => Benchmark.new("tc/tc_quad.dl", "tc/tc.rb", "tc%d", [1000, 4000, 16000]),
+    "sg"          => Benchmark.new("sg/sg.dl", "sg/sg.rb", "sg%d", [25, 50, 100]),
+    "andersen"    => Benchmark.new("pointsto/andersen.dl", "pointsto/pointsto.rb", "pointsto%d",
+                                   [1000, 4000, 16000]),
+    "steensgaard" => Benchmark.new("pointsto/steensgaard.dl", "pointsto/pointsto.rb", "pointsto%d",
+                                   [250, 500, 1000]),
+    "cspa"        => Benchmark.new("cspa/cspa.dl", "cspa/cspa.rb", "cspa%d", [1000, 4000, 16000]),
+    "aggregates"  => Benchmark.new("aggregates/aggregates.dl", "aggregates/aggregates.rb", "aggregates%d",
+                                   [1000, 4000, 16000]),
+    "records"     => Benchmark.new("records/records.dl", "records/records.rb", "records%d",
+                                   [1000, 4000, 16000]),
+    "strings"     => Benchmark.new("strings/strings.dl", "strings/strings.rb", "strings%d",
+                                   [4000, 16000, 64000]),
+}
+
+MODES = ["interpreter", "compiled"]
+
+options = {
+    :souffle => File.join(DIR, "..", "src", "souffle"),
+    :profiler => File.join(DIR, "..", "src", "souffle-profile"),
+    :modes => MODES,
+    :jobs => [1, Etc.nprocessors].uniq,
+    :scale => "small",
+    :repeat => 3,
+    :output => nil,
+    :compare => nil,
+    :threshold => 10.0,
+    :workdir => nil,
+}
+
+parser = OptionParser.new do |opts|
+    opts.banner = "usage: ruby run.rb [options] [benchmark ...]"
+    opts.on("--souffle PATH", "the souffle executable (default: ../src/souffle)") do |path|
+        options[:souffle] = File.expand_path(path)
+    end
+    opts.on("--profiler PATH", "the souffle-profile executable (default: ../src/souffle-profile)") do |path|
+        options[:profiler] = File.expand_path(path)
+    end
+    opts.on("-m", "--modes LIST", Array, "interpreter and/or compiled (default: both)") do |modes|
+        options[:modes] = modes
+    end
+    opts.on("-j", "--jobs LIST", Array, "the numbers of threads (default: 1 and all cores)") do |jobs|
+        options[:jobs] = jobs.map { |j| Integer(j) }
+    end
+    opts.on("-s", "--scale SCALE", SCALES, "small, medium or large (default: small)") do |scale|
+        options[:scale] = scale
+    end
+    opts.on("-r", "--repeat N", Integer, "the timed runs of each configuration (default: 3)") do |n|
+        options[:repeat] = n
+    end
+    opts.on("-o", "--output FILE", "write the results to the given file instead of stdout") do |file|
+        options[:output] = file
+    end
+    opts.on("-c", "--compare FILE", "compare the times with the results of an earlier run") do |file|
+        options[:compare] = file
+    end
+    opts.on("-t", "--threshold PERCENT", Float, "the slowdown reported as regression (default: 10)") do |t|
+        options[:threshold] = t
+    end
+    opts.on("-w", "--workdir DIR", "keep the binaries and outputs in the given directory") do |dir|
+        options[:workdir] = File.expand_path(dir)
+    end
+    opts.on("-l", "--list", "list the benchmarks and their sizes") do
+        BENCHMARKS.each do |name, bench|
+            puts "%-12s %-26s %s" % [name, bench.program, bench.sizes.join(" ")]
+        end
+        exit
+    end
+end
+names = parser.parse(ARGV)
+names = BENCHMARKS.keys if names.empty?
+
+(names - BENCHMARKS.keys).each do |name|
+    abort "unknown benchmark #{name}, see --list"
+end
+(options[:modes] - MODES).each do |mode|
+    abort "unknown mode #{mode}"
+end
+abort "souffle executable #{options[:souffle]} not found" unless File.executable?(options[:souffle])
+abort "souffle-profile executable #{options[:profiler]} not found" unless File.executable?(options[:profiler])
+
+def log(message)
+    $stderr.puts message
+end
+
+# runs a command, failing the benchmarks if it fails
+def run(*cmd)
+    system(*cmd, :out => File::NULL, :err => File::NULL) or abort "failed: #{cmd.join(' ')}"
+end
+
+# the peak memory resident of a running process in bytes, or zero if it is unknown
+def peak_rss(pid)
+    status = File.read("/proc/#{pid}/status")
+    status =~ /^VmHWM:\s+(\d+) kB/ ? $1.to_i * 1024 : 0
+rescue SystemCallError
+    0
+end
+
+# runs a command and obtains its wall time in seconds and the peak memory resident, sampled
+# while the command is running
+def measure(cmd)
+    start = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+    pid = Process.spawn(*cmd, :out => File::NULL, :err => File::NULL)
+    finish = nil
+    waiter = Thread.new do
+        Process.wait(pid)
+        finish = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+        $?
+    end
+    peak = 0
+    while waiter.alive?
+        peak = [peak, peak_rss(pid)].max
+        sleep 0.01
+    end
+    abort "failed: #{cmd.join(' ')}" unless waiter.value.success?
+    [finish - start, peak]
+end
+
+# the phases and the peak memory of a profile log, as reported by souffle-profile
+def read_profile(profiler, file)
+    summary = IO.popen([profiler, file, "-c", "phases"], :err => File::NULL, &:read)
+    abort "failed: #{profiler} #{file} -c phases" unless $?.success?
+    profile = {"runtime" => 0.0, "loadtime" => 0.0, "savetime" => 0.0, "peak" => 0}
+    summary.each_line do |line|
+        name, value = line.split
+        case name
+        when "runtime", "loadtime", "savetime"
+            profile[name] = value.to_f
+        when "peak"
+            profile[name] = value.to_i
+        end
+    end
+    profile
+end
+
+def median(values)
+    sorted = values.sort
+    (sorted[(sorted.size - 1) / 2] + sorted[sorted.size / 2]) / 2.0
+end
+
+workdir = options[:workdir] || Dir.mktmpdir("souffle-benchmarks")
+FileUtils.mkdir_p(workdir)
+souffle = options[:souffle]
+scale = SCALES.index(options[:scale])
+results = []
+
+begin
+    names.each do |name|
+        bench = BENCHMARKS[name]
+        program = File.join(DIR, bench.program)
+        size = bench.sizes[scale]
+
+        # the facts are generated once, next to the generator
+        facts = File.join(DIR, File.dirname(bench.generator), bench.facts % size)
+        unless Dir.exist?(facts)
+            log "generating #{facts}"
+            Dir.chdir(File.dirname(facts)) do
+                run("ruby", File.basename(bench.generator), size.to_s)
+            end
+        end
+
+        # the programs are compiled with OpenMP, such that the threads can be set by each run
+        if options[:modes].include?("compiled")
+            log "compiling #{name}"
+            binary = File.join(workdir, name)
+            run(souffle, "-j", "auto", "-o", binary, program)
+            run(souffle, "-j", "auto", "-p", binary + ".log", "-o", binary + "_prof", program)
+            [binary, binary + "_prof"].each do |file|
+                abort "failed to compile #{program}" unless File.executable?(file)
+            end
+        end
+
+        output = File.join(workdir, "output")
+        FileUtils.mkdir_p(output)
+        options[:modes].each do |mode|
+            options[:jobs].each do |jobs|
+                args = ["-j", jobs.to_s, "-F", facts, "-D", output]
+                if mode == "interpreter"
+                    cmd = [souffle] + args + [program]
+                    profiled = [souffle, "-p", File.join(workdir, "profile.log")] + args + [program]
+                else
+                    cmd = [binary] + args
+                    profiled = [binary + "_prof", "-p", File.join(workdir, "profile.log")] + args
+                end
+
+                runs = (0...options[:repeat]).map { measure(cmd) }
+                run(*profiled)
+                profile = read_profile(options[:profiler], File.join(workdir, "profile.log"))
+
+                # the interpreter writes the outputs while evaluating the program
+                evaluation = profile["runtime"]
+                evaluation -= profile["savetime"] if mode == "interpreter"
+                result = {
+                    "benchmark" => name,
+                    "size" => size,
+                    "mode" => mode,
+                    "jobs" => jobs,
+                    "time" => median(runs.map(&:first)),
+                    "times" => runs.map(&:first),
+                    "load" => profile["loadtime"],
+                    "eval" => [evaluation, 0.0].max,
+                    "output" => profile["savetime"],
+                    "peak_rss" => [runs.map(&:last).max, profile["peak"]].max,
+                }
+                results << result
+                log "%-12s %6d %-11s -j%-3d %8.3fs  load %.3fs  eval %.3fs  output %.3fs  %6.1f MB" %
+                    [name, size, mode, jobs, result["time"], result["load"], result["eval"],
+                     result["output"], result["peak_rss"] / 1048576.0]
+            end
+        end
+    end
+ensure
+    FileUtils.rm_rf(workdir) unless options[:workdir]
+end
+
+report = {
+    "host" => Socket.gethostname,
+    "cores" => Etc.nprocessors,
+    "date" => Time.now.utc.iso8601,
+    "souffle" => `#{souffle} -h 2>&1`[/Version: (.*)/, 1],
+    "scale" => options[:scale],
+    "repeat" => options[:repeat],
+    "results" => results,
+}
+json = JSON.pretty_generate(report)
+if options[:output]
+    File.write(options[:output], json + "\n")
+else
+    puts json
+end
+
+# the configurations slower than in the baseline by more than the threshold are regressions
+if options[:compare]
+    key = lambda { |r| r.values_at("benchmark", "size", "mode", "jobs") }
+    baseline = JSON.parse(File.read(options[:compare]))["results"].map { |r| [key.call(r), r] }.to_h
+    regressions = 0
+    results.each do |result|
+        before = baseline[key.call(result)]
+        next unless before
+        change = (result["time"] / before["time"] - 1) * 100
+        regressed = change > options[:threshold]
+        regressions += 1 if regressed
+        log "%-12s %6d %-11s -j%-3d %8.3fs -> %8.3fs %+7.1f%%%s" %
+            [*key.call(result), before["time"], result["time"], change, regressed ? "  REGRESSION" : ""]
+    end
+    exit 1 if regressions > 0
+end
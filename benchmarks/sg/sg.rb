@@ -1,10 +1,13 @@
 
-# TODO: make this a parameter
+# the size of the layers of the generated graph, by default 75
 N= (ARGV[0].to_i != 0) ? ARGV[0].to_i : 75
 
-# fix a and f
+# the facts of a size are the same for all runs
+srand(N)
+
+# fix a and z
 a=1
-f=2
+z=2
 
 # initialize vector b, c, d and e
 b = Array.new(N)
@@ -25,11 +28,11 @@ Dir.mkdir("sg#{N}") unless Dir.exist?("sg#{N}")
 
 # create up file
 File.open("sg#{N}/up.facts",'w') do |f|
-    (1..N).each do |i| 
+    (0...N).each do |i| 
         f.write("#{a}\t#{b[i]}\n")
     end
-    (1..N).each do |i| 
-        (1..N).each do |j|
+    (0...N).each do |i| 
+        (0...N).each do |j|
             f.write("#{b[i]}\t#{c[j]}\n")
         end
     end
@@ -37,8 +40,8 @@ end
 
 # create flat file
 File.open("sg#{N}/flat.facts",'w') do |f|
-    (1..N).each do |i| 
-        (1..N).each do |j|
+    (0...N).each do |i| 
+        (0...N).each do |j|
             f.write("#{c[i]}\t#{d[j]}\n")
         end
     end
@@ -46,11 +49,11 @@ end
 
 # create down file
 File.open("sg#{N}/down.facts",'w') do |f|
-    (1..N).each do |i| 
-        f.write("#{e[i]}\t#{f}\n")
+    (0...N).each do |i| 
+        f.write("#{e[i]}\t#{z}\n")
     end
-    (1..N).each do |i| 
-        (1..N).each do |j|
+    (0...N).each do |i| 
+        (0...N).each do |j|
             f.write("#{d[i]}\t#{e[j]}\n")
         end
     end
@@ -0,0 +1,16 @@
+
+# the number of words, by default 1000
+N= (ARGV[0].to_i != 0) ? ARGV[0].to_i : 1000
+
+# the facts of a size are the same for all runs
+srand(N)
+
+# create directory
+Dir.mkdir("strings#{N}") unless Dir.exist?("strings#{N}")
+
+# words of six to twelve letters from a small alphabet, such that some of their suffixes are shared
+File.open("strings#{N}/word.facts",'w') do |f|
+    (0...N).each do |i|
+        f.write((0...6 + rand(7)).map { "abcdefgh"[rand(8)] }.join + "\n")
+    end
+end
@@ -1,7 +1,10 @@
 
-# TODO: make this a parameter
+# the number of nodes and edges, by default 75
 N= (ARGV[0].to_i != 0) ? ARGV[0].to_i : 75
 
+# the facts of a size are the same for all runs
+srand(N)
+
 # create directory
 Dir.mkdir("tc#{N}") unless Dir.exist?("tc#{N}")
 
@@ -11,4 +14,3 @@ File.open("tc#{N}/edge.facts",'w') do |f|
         f.write("#{rand(N)}\t#{rand(N)}\n")
     end
 end
-
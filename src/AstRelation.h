@@ -57,6 +57,9 @@
 /* Relation uses a union relation */
 #define EQREL_RELATION (0x80)
 
+/* Relation uses a hash set data structure */
+#define HASH_RELATION (0x100)
+
 namespace souffle {
 
 /*!
@@ -164,6 +167,11 @@ public:
         return (qualifier & EQREL_RELATION) != 0;
     }
 
+    /** Check whether relation is a hash relation */
+    bool isHash() const {
+        return (qualifier & HASH_RELATION) != 0;
+    }
+
     /** Check whether relation is an input relation */
     bool isPrintSize() const {
         return (qualifier & PRINTSIZE_RELATION) != 0;
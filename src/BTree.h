@@ -277,7 +277,7 @@ private:
         node* volatile parent;
 
         // a lock for synchronizing parallel operations on this node
-        lock_type lock;
+        lock_type lock{LockSite::btreeNode};
 
         // the number of keys in this node
         volatile size_type numElements;
@@ -1132,7 +1132,7 @@ private:
     node* volatile root;
 
     // a lock to synchronize update operations on the root pointer
-    lock_type root_lock;
+    lock_type root_lock{LockSite::btreeRoot};
 #else
     // the total number of elements in this tree
     size_type numElements;
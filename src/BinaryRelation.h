@@ -39,10 +39,19 @@
 
 #pragma once
 
-#include "Trie.h"
+#include "CompiledRamTuple.h"
 #include "UnionFind.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <memory>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace souffle {
 template <typename TupleType>
@@ -56,18 +65,41 @@ class BinaryRelation {
     // implicitly (causing writes)
     mutable SparseDisjointSet<DomainInt> sds;
 
-    // read/write lock on orderedStates
+    /**
+     * A snapshot of the equivalence classes of the relation. All members are stored in a single
+     * array, grouped by class; each class is sorted and classes are ordered by their smallest member.
+     * This requires space linear in the number of members, independent of the number of pairs.
+     */
+    struct Classes {
+        // the members of all classes
+        std::vector<DomainInt> members;
+        // class i occupies members[offsets[i], offsets[i+1])
+        std::vector<size_t> offsets;
+        // maps the representatives in the disjoint set to the index of their class
+        std::unordered_map<DomainInt, size_t> classIndex;
+
+        size_t numClasses() const {
+            return offsets.size() - 1;
+        }
+    };
+
+    // read/write lock on classes
     mutable souffle::shared_mutex statesLock;
 
-    // the ordering of states per disjoint set (mapping from representative to trie)
-    mutable std::unordered_map<DomainInt, std::shared_ptr<souffle::Trie<1>>> orderedStates;
+    // whether the classes need to be re-computed before being used
+    mutable std::atomic<bool> stale;
+
+    // the current snapshot of the classes (iterators keep their snapshot alive)
+    mutable std::shared_ptr<const Classes> classes;
 
 public:
+    BinaryRelation() : stale(true) {}
+
     BinaryRelation& operator=(const BinaryRelation& old) {
         if (this == &old) return *this;
 
         sds = old.sds;
-        orderedStates.clear();
+        stale.store(true);
 
         return *this;
     }
@@ -101,20 +133,13 @@ public:
      * @return true if the pair is new to the data structure
      */
     bool insert(DomainInt x, DomainInt y, operation_hints z) {
-        // uncomment if race conditions ever present themselves
-        // this should only be the case if the tries are generated during insertion
-        // and this is not normal souffle behaviour
-        // statesLock.lock_shared();
-
-        orderedStates.erase(x);
-        orderedStates.erase(y);
         sds.unionNodes(x, y);
 
-        bool retval = contains(x, y);
+        // only mark the classes as outdated, they are re-computed lazily when iterated; this is done
+        // after the union, such that a snapshot taken in between is not considered up-to-date
+        stale.store(true, std::memory_order_release);
 
-        // statesLock.unlock_shared();
-
-        return retval;
+        return contains(x, y);
     }
 
     /**
@@ -122,11 +147,11 @@ public:
      * @param other the binary relation from which to add nodes from
      */
     void insertAll(const BinaryRelation<TupleType>& other) {
-        // for each representative
-        for (auto rep = other.sds.beginReps(); rep != other.sds.endReps(); ++rep) {
-            // insert the pairing between the representative and its
-            for (auto subrep = other.sds.begin(*rep); subrep != other.sds.end(*rep); ++subrep) {
-                this->insert(*rep, *subrep);
+        // pair each member of every class with the smallest member of its class
+        for (auto cls : other.getClasses()) {
+            const DomainInt rep = *cls.begin();
+            for (auto member : cls) {
+                this->insert(rep, member);
             }
         }
     }
@@ -145,11 +170,19 @@ public:
 
         // we should be able to clear this prior, as it requires a lock on its own
         sds.clear();
-        orderedStates.clear();
+        classes.reset();
+        stale.store(true);
 
         statesLock.unlock();
     }
 
+    /**
+     * Whether the relation contains no pairs
+     */
+    bool empty() const {
+        return sds.size() == 0;
+    }
+
     /**
      * Size of relation
      * @return the sum of the number of pairs per disjoint set
@@ -169,162 +202,170 @@ public:
         return retval;
     }
 
-private:
     /**
-     * Create a trie which contains the disjoint set which contains this value
-     * @param val the value whose disjoint set will be constructed into a trie
-     * @return a reference to the newly created trie
+     * Determines the amount of memory used by this relation, including the snapshot of its classes
+     * @return the number of bytes allocated by this relation
      */
-    std::shared_ptr<souffle::Trie<1>> generateTrieIfNone(DomainInt val) const {
-        if (!sds.nodeExists(val)) throw "cannot generate trie for non-existent node";
+    size_t getMemoryUsage() const {
+        size_t res = sizeof(*this) - sizeof(sds) + sds.getMemoryUsage();
 
         statesLock.lock_shared();
-        DomainInt rep = sds.readOnlyFindNode(val);
+        if (classes) {
+            res += sizeof(Classes) + classes->members.capacity() * sizeof(DomainInt) +
+                   classes->offsets.capacity() * sizeof(size_t) +
+                   classes->classIndex.bucket_count() * sizeof(void*) +
+                   classes->classIndex.size() * (sizeof(void*) + sizeof(DomainInt) + sizeof(size_t));
+        }
+        statesLock.unlock_shared();
+
+        return res;
+    }
 
-        // return if already created
-        if (this->orderedStates.find(rep) != this->orderedStates.end()) {
-            auto retptr = this->orderedStates.at(rep);
+private:
+    /**
+     * Obtain an up-to-date snapshot of the equivalence classes, re-computing it if the
+     * relation has been modified since the last call
+     * @return the current classes
+     */
+    std::shared_ptr<const Classes> getClassSnapshot() const {
+        statesLock.lock_shared();
+        if (!stale.load(std::memory_order_acquire)) {
+            auto res = classes;
             statesLock.unlock_shared();
-            return retptr;
+            return res;
         }
-
         statesLock.unlock_shared();
+
         statesLock.lock();
 
-        // return if already created (other write thread may have been called simultaneously)
-        if (this->orderedStates.find(rep) != this->orderedStates.end()) {
-            auto retptr = this->orderedStates.at(rep);
-            statesLock.unlock();
-            return retptr;
+        // other write thread may have been called simultaneously
+        if (stale.load(std::memory_order_acquire)) {
+            stale.store(false);
+            classes = computeClasses();
         }
+        auto res = classes;
 
-        this->orderedStates[rep] = std::shared_ptr<souffle::Trie<1>>(new souffle::Trie<1>);
+        statesLock.unlock();
 
-        // populate the trie
-        for (auto it = sds.begin(rep); it != sds.end(rep); ++it) {
-            // add the current value of the iterator to the trie
-            this->orderedStates.at(rep)->insert(*it);
+        return res;
+    }
+
+    /**
+     * Group all members of the disjoint set by their classes
+     * @return the newly created snapshot
+     */
+    std::shared_ptr<const Classes> computeClasses() const {
+        // collect the sorted members of each class
+        std::vector<std::pair<DomainInt, std::vector<DomainInt>>> groups;
+        for (auto rep = sds.beginReps(); rep != sds.endReps(); ++rep) {
+            std::vector<DomainInt> cur;
+            for (auto it = sds.begin(*rep); it != sds.end(*rep); ++it) {
+                cur.push_back(*it);
+            }
+            std::sort(cur.begin(), cur.end());
+            groups.push_back(std::make_pair(*rep, std::move(cur)));
         }
 
-        auto retptr = this->orderedStates.at(rep);
+        // order classes by their smallest member
+        std::sort(groups.begin(), groups.end(),
+                [](const std::pair<DomainInt, std::vector<DomainInt>>& a,
+                        const std::pair<DomainInt, std::vector<DomainInt>>& b) {
+                    return a.second.front() < b.second.front();
+                });
+
+        auto res = std::make_shared<Classes>();
+        res->members.reserve(sds.size());
+        res->offsets.reserve(groups.size() + 1);
+        for (auto& cur : groups) {
+            res->classIndex[cur.first] = res->offsets.size();
+            res->offsets.push_back(res->members.size());
+            res->members.insert(res->members.end(), cur.second.begin(), cur.second.end());
+        }
+        res->offsets.push_back(res->members.size());
 
-        statesLock.unlock();
+        return res;
+    }
+
+    /**
+     * Locate the class of the given value within a snapshot
+     * @param cs the snapshot to search in
+     * @param val the value to be located
+     * @return the index of the class containing val, or numClasses() if not present
+     */
+    size_t findClass(const Classes& cs, DomainInt val) const {
+        if (!sds.nodeExists(val)) return cs.numClasses();
+        auto pos = cs.classIndex.find(sds.readOnlyFindNode(val));
+        return (pos == cs.classIndex.end()) ? cs.numClasses() : pos->second;
+    }
 
-        return retptr;
+    /**
+     * Locate the position of the given value within the member array of a snapshot
+     * @param cs the snapshot to search in
+     * @param cls the class of val (as obtained by findClass)
+     * @param val the value to be located
+     * @return the position of val in cs.members
+     */
+    static size_t findMember(const Classes& cs, size_t cls, DomainInt val) {
+        auto a = cs.members.begin() + cs.offsets[cls];
+        auto b = cs.members.begin() + cs.offsets[cls + 1];
+        return std::lower_bound(a, b, val) - cs.members.begin();
     }
 
 public:
+    /**
+     * An iterator streaming pairs out of a snapshot of the equivalence classes.
+     * It enumerates the pairs (x,y) for all x within a range of positions of the member array, and all y
+     * of the class of x. Its state is constant in size, independent of the size of the classes.
+     */
     class iterator : public std::iterator<std::forward_iterator_tag, TupleType> {
-        // special tombstone value to notify that this iter represents the end
-        bool isEndVal = false;
+        // the snapshot this iterator is walking through (nullptr for end iterators)
+        std::shared_ptr<const Classes> cs;
 
-        TupleType value;
-        const BinaryRelation* br = nullptr;
-        // iterate over all pairs, iterate over all starting at, iterate over all starting at & ending at,
-        // iterate over all in dj set, iterate over all (x,_) s.t. x in djset
-        enum IterType { BASIC, STARTAT, BETWEEN, CLOSURE, FRONTPROD };
-        IterType ityp;
-
-        // the tries for each iterator to belong to
-        // these are used for iterating through in order
-        std::list<std::pair<std::shared_ptr<souffle::Trie<1>>, souffle::Trie<1>::iterator>> iterList;
-
-        souffle::Trie<1>::iterator frontIter;
-        souffle::Trie<1>::iterator backIter;
-        std::shared_ptr<souffle::Trie<1>> cTrie;
-        // cache the values for cTrie->end(), as it is called... a lot.
-        std::unordered_map<std::shared_ptr<souffle::Trie<1>>, souffle::Trie<1>::iterator> cTrieEnds;
-
-        // for iterating between two points
-        TupleType endPoint;
-
-        // for the closure
-        DomainInt rep;
-        // for the front product iter
-        std::list<DomainInt> fronts;
+        // the class of the current front element
+        size_t cls = 0;
 
-    public:
-        // ctor for end()
-        iterator(bool truthy, const BinaryRelation* br) : isEndVal(true), br(br){};
+        // the current positions of x and y in the member array
+        size_t front = 0;
+        size_t back = 0;
 
-        // ctor for begin(...)
-        iterator(const BinaryRelation* br) : br(br) {
-            ityp = BASIC;
-            initIterators();
-            initCheckEnd();
-            setValue();
-        }
+        // the end of the range of x and of the current range of y
+        size_t frontEnd = 0;
+        size_t backEnd = 0;
 
-        // ctor for find(..)
-        iterator(const BinaryRelation* br, const TupleType& start) : br(br) {
-            ityp = STARTAT;
+        // the end of the range of y for the last x
+        size_t lastBackEnd = std::numeric_limits<size_t>::max();
 
-            if (!br->sds.nodeExists(start[0]) || !br->sds.nodeExists(start[1])) {
-                isEndVal = true;
-                return;
-            }
-
-            initIterators();
-            ffIterators(start);
-            initCheckEnd();
-            setValue();
-        };
+        TupleType value;
 
-        // ctor for findBetween(..)
-        iterator(const BinaryRelation* br, const TupleType& start, const TupleType& end)
-                : br(br), endPoint(end) {
-            ityp = BETWEEN;
+    public:
+        // ctor for end()
+        iterator() = default;
 
-            if (!br->sds.nodeExists(start[0]) || !br->sds.nodeExists(start[1])) {
-                isEndVal = true;
+        /**
+         * Create an iterator over a range of the member array
+         * @param cs the snapshot to iterate through
+         * @param cls the class of the first x
+         * @param front the position of the first x
+         * @param back the position of the first y
+         * @param frontEnd the end of the range of x
+         * @param lastBackEnd the end of the range of y for the last x
+         */
+        iterator(std::shared_ptr<const Classes> cs, size_t cls, size_t front, size_t back, size_t frontEnd,
+                size_t lastBackEnd = std::numeric_limits<size_t>::max())
+                : cs(std::move(cs)), cls(cls), front(front), back(back), frontEnd(frontEnd),
+                  lastBackEnd(lastBackEnd) {
+            if (front >= frontEnd) {
+                this->cs.reset();
                 return;
             }
-
-            initIterators();
-            ffIterators(start);
-            initCheckEnd();
-            setValue();
-        }
-
-        // ctor for closure
-        iterator(const BinaryRelation* br, DomainInt rep, std::shared_ptr<souffle::Trie<1>> trie)
-                : br(br), rep(rep) {
-            ityp = CLOSURE;
-            if (!br->sds.nodeExists(rep)) {
-                isEndVal = true;
+            updateBackEnd();
+            if (back >= backEnd) {
+                this->cs.reset();
                 return;
             }
-
-            initIterator(trie);
             setValue();
         }
 
-        // ctor for front product aka R(x, _) for all x in fronts
-        iterator(
-                const BinaryRelation* br, std::list<DomainInt> fronts, std::shared_ptr<souffle::Trie<1>> trie)
-                : br(br), fronts(fronts) {
-            if (std::any_of(
-                        fronts.begin(), fronts.end(), [&](DomainInt n) { return !br->sds.nodeExists(n); }))
-                throw "non-existent nodes provided";
-            ityp = FRONTPROD;
-            initIterator(trie);
-            // fast forward iter to the first requirement
-            auto f = this->fronts.front();
-            this->fronts.pop_front();
-            while ((*frontIter)[0] != f) ++frontIter;
-            setValue();
-        }
-
-        /** special fn to set endVal = true
-         * only set when the current iterator actually cannot iterate anymore
-         * should only be called in the constructor
-         */
-        void initCheckEnd() {
-            if (!cTrie || (frontIter == cTrie->end() && backIter == cTrie->end())) {
-                isEndVal = true;
-            }
-        }
-
         // copy ctor
         iterator(const iterator& other) = default;
         // move ctor
@@ -333,10 +374,10 @@ public:
         iterator& operator=(const iterator& other) = default;
 
         bool operator==(const iterator& other) const {
-            // return true if we're both end tombstones and of the same br
-            if (isEndVal && other.isEndVal) return br == other.br;
+            // all end iterators are equivalent
+            if (!cs || !other.cs) return cs == other.cs;
 
-            return isEndVal == other.isEndVal && value == other.value;
+            return cs == other.cs && front == other.front && back == other.back;
         }
 
         bool operator!=(const iterator& other) const {
@@ -352,248 +393,120 @@ public:
         }
 
         iterator& operator++() {
-            if (isEndVal) throw "error: incrementing an out of range iterator";
-
-            // if we're at the end of our iter, we must jump ahead
-            if (backIter == cTrie->end() || ++souffle::Trie<1>::iterator(backIter) == cTrie->end()) {
-                // if we cannot do anything more, we quit prematurely, and mark that we've reached the end
-                if (advanceFrontIter()) return *this;
+            if (!cs) throw "error: incrementing an out of range iterator";
 
-                // ^^ the above function also sets backIter to point to the correct point
-            } else {
-                // we can just step backIter along one
-                ++backIter;
+            // step y along within the class of x
+            if (++back < backEnd) {
+                setValue();
+                return *this;
             }
 
-            // if its a iterate_until iterator, we should check if the current "value" is > end point
-            // if so, mark it as end
-            if (ityp == BETWEEN && ((*frontIter)[0] > endPoint[0] || ((*frontIter)[0] == endPoint[0] &&
-                                                                             (*backIter)[0] > endPoint[1]))) {
-                isEndVal = true;
-            } else {
-                setValue();
+            // move on to the next x
+            if (++front >= frontEnd) {
+                cs.reset();
+                return *this;
             }
 
+            // x has entered the next class
+            if (front >= cs->offsets[cls + 1]) ++cls;
+
+            back = cs->offsets[cls];
+            updateBackEnd();
+            setValue();
+
             return *this;
         }
 
         // TODO: add debugging print statements to match the other souffle data structure abilities
 
     private:
-        /**
-         * Returns whether iter has reached the end of cTrie
-         */
-        bool isTrieEnd(souffle::Trie<1>::iterator iter) {
-            return iter == cTrieEnds[cTrie];
+        /** compute the end of the range of y for the current x */
+        void updateBackEnd() {
+            backEnd = cs->offsets[cls + 1];
+            if (front + 1 == frontEnd) backEnd = std::min(backEnd, lastBackEnd);
         }
 
-        /**
-         * Helper function to make the frontIter jump to the next valid Trie & update the current one
-         * @return whether we've reached end() or not
-         */
-        bool advanceFrontIter() {
-            // if we're at the end of this current Trie
-            if (frontIter == cTrie->end() || ++souffle::Trie<1>::iterator(frontIter) == cTrie->end()) {
-                // reaching the end of this trie means that the closure has completed
-                if (ityp == CLOSURE || ityp == FRONTPROD) {
-                    isEndVal = true;
-                    return true;
-                }
+        /** yield the current iterator value to update to what the iterator is currently pointing at */
+        void setValue() {
+            value[0] = cs->members[front];
+            value[1] = cs->members[back];
+        }
+    };
 
-                // remove this trie from iterList as it means we've exhausted it
-                iterList.remove_if(
-                        [&](std::pair<std::shared_ptr<souffle::Trie<1>>, souffle::Trie<1>::iterator> x) {
-                            return x.first == cTrie;
-                        });
+    /** an iterator over the (sorted) members of a single class */
+    typedef typename std::vector<DomainInt>::const_iterator member_iterator;
 
-                // have we exhausted all other tries?
-                if (iterList.empty()) {
-                    isEndVal = true;
-                    return true;
-                }
+    /**
+     * An iterator over the equivalence classes of this relation, yielding the range of members of
+     * each class. The first member of each class (its smallest) is the representative of the class.
+     */
+    class class_iterator : public std::iterator<std::forward_iterator_tag, range<member_iterator>> {
+        std::shared_ptr<const Classes> cs;
+        size_t cls = 0;
 
-                // find the next smallest Trie
-                bool isStart = true;
-                std::pair<std::shared_ptr<souffle::Trie<1>>, souffle::Trie<1>::iterator>* ref = nullptr;
-
-                for (auto& x : iterList) {
-                    if (isStart || (*x.second)[0] < (*frontIter)[0]) {
-                        ref = &x;
-                        cTrie = x.first;
-                        frontIter = souffle::Trie<1>::iterator(x.second);
-                        isStart = false;
-                    }
-                }
-                // as we've made frontIter point to this, we move our iter to the next one in the Trie
-                ++ref->second;
-                backIter = cTrie->begin();
-
-            } else {
-                if (ityp == FRONTPROD) {
-                    // no more front closure?
-                    if (fronts.empty()) {
-                        isEndVal = true;
-                        return true;
-                    }
-
-                    // step frontIter until we hit the next valid fronts
-                    auto newFront = fronts.front();
-                    fronts.pop_front();
-                    do {
-                        ++frontIter;
-                    } while ((*frontIter)[0] != newFront);
-
-                } else {
-                    // we can just step frontIter along one, because it will not step past the end of a trie
-                    ++frontIter;
-                    // step the front reference pointer one along
-                    for (auto& x : iterList) {
-                        if (x.first == cTrie) {
-                            ++x.second;
-                            break;
-                        }
-                    }
-                }
+    public:
+        class_iterator() = default;
 
-                backIter = cTrie->begin();
-            }
+        class_iterator(std::shared_ptr<const Classes> cs, size_t cls) : cs(std::move(cs)), cls(cls) {}
 
-            // we live to yield another time
-            return false;
+        bool operator==(const class_iterator& other) const {
+            return cs == other.cs && cls == other.cls;
         }
 
-        /** yield the current iterator value to update to what the iterator is currently pointing at */
-        void setValue() {
-            if (!isEndVal) {
-                TupleType tmp;
-                tmp[0] = (*frontIter)[0];
-                tmp[1] = (*backIter)[0];
-
-                value = tmp;
-            }
+        bool operator!=(const class_iterator& other) const {
+            return !((*this) == other);
         }
 
-        /**
-         * Adjust the iterators to point to the beginning of each trie
-         */
-        void initIterators() {
-            bool start = true;
-
-            for (auto& x : br->orderedStates) {
-                auto iterBeg = x.second->begin();
-
-                // find the smallest front element of the Tries to set the frontIter to
-                if (start) {
-                    frontIter = souffle::Trie<1>::iterator(x.second->begin());
-                    backIter = souffle::Trie<1>::iterator(frontIter);
-                    cTrie = x.second;
-                    start = false;
-                } else if ((*iterBeg)[0] <= (*frontIter)[0]) {
-                    // if the current one is smaller, that becomes the smallest iter
-                    frontIter = iterBeg;
-                    backIter = souffle::Trie<1>::iterator(frontIter);
-                    cTrie = x.second;
-                }
-                iterList.push_back(std::make_pair(x.second, iterBeg));
-                // add to hash map
-                cTrieEnds[x.second] = x.second->end();
-            }
+        range<member_iterator> operator*() const {
+            return make_range(
+                    cs->members.begin() + cs->offsets[cls], cs->members.begin() + cs->offsets[cls + 1]);
         }
 
-        /**
-         * Single Trie Version of initIterators
-         * Only initialise one trie iterator
-         * @param trie the trie that we point everything towards
-         */
-        void initIterator(std::shared_ptr<souffle::Trie<1>> trie) {
-            frontIter = trie->begin();
-            backIter = trie->begin();
-            cTrie = trie;
+        class_iterator& operator++() {
+            ++cls;
+            return *this;
         }
+    };
 
-        /**
-         * Fast forward the iterators in iterList (and also frontIter and backIter)
-         * s.t. they point to positions >= start
-         * @param startVal the first pair that the iterators should be fast forwarded to
-         */
-        void ffIterators(const TupleType& startVal) {
-            souffle::Trie<1>::iterator smallestFirst;
-            bool start = true;
-
-            for (auto& x : iterList) {
-                auto checkIter = x.first->begin();
-                auto tmpIter = checkIter;
-                auto endTrieIter = x.first->end();
-
-                // keep moving iterators forward until we hit something valid
-                // this is based off the assumption that all elements in iterList do not begin at .end()
-                while ((*x.second)[0] < startVal[0]) {
-                    ++x.second;
-
-                    if (x.second == x.first->end()) {
-                        // iterList.remove(x);
-                        // TODO: erase this trie from list - we should use .erase instead of remove(), as we
-                        // shouldn't iterate over the trie again!
-                        // prematurely continue the outerLoop, because we shouldn't consider this value
-                        goto breakLoop;
-                    }
-                }
-
-                // check if we have to discard this trie -
-                // this happens when the trie that contains startVal[0], does not have a value larger than
-                // startVal[1]
-                // todo: we are finding the last element inefficiently, should be a faster way to find it
-                // faster
-                if ((*x.second)[0] == startVal[0]) {
-                    while (checkIter != endTrieIter) {
-                        // lag the iterator one behind to capture the last element
-                        tmpIter = checkIter;
-                        ++checkIter;
-                    };
-                    if ((*tmpIter)[0] < startVal[1]) {
-                        ++x.second;
-
-                        if (x.second == x.first->end()) {
-                            // iterList.erase(x);
-                            // TODO: erase this trie from list - we should use .erase instead of remove(), as
-                            // we shouldn't iterate over the trie again!
-                            // prematurely continue the outerLoop, because we shouldn't consider this value
-                            goto breakLoop;
-                        }
-                    }
-                }
-
-                // update the frontIter to point to the front most trie now
-                if (start || ((*x.second) < *smallestFirst)) {
-                    smallestFirst = souffle::Trie<1>::iterator(x.second);
-                    cTrie = x.first;
-                    start = false;
-                }
+    /**
+     * Obtain a range over all equivalence classes of this relation.
+     * The member ranges remain valid as long as the class iterators are alive.
+     * @return the classes, ordered by their smallest member
+     */
+    range<class_iterator> getClasses() const {
+        auto cs = getClassSnapshot();
+        const size_t num = cs->numClasses();
+        return make_range(class_iterator(cs, 0), class_iterator(cs, num));
+    }
 
-            breakLoop:;
-            }
+    /**
+     * Obtain the number of equivalence classes of this relation
+     */
+    size_t getNumClasses() const {
+        return getClassSnapshot()->numClasses();
+    }
 
-            frontIter = smallestFirst;
-            backIter = cTrie->begin();
-            // fast forward the back iterator to point to its starting element
-            if ((*frontIter)[0] == startVal[0]) {
-                while ((*backIter)[0] < startVal[1]) ++backIter;
-            }
-        }
-    };
+    /**
+     * Obtain the sorted members of the class of the given value. The range is valid until the
+     * relation is modified.
+     * @param val the value whose class is requested
+     * @return the members of the class, empty if val is not present
+     */
+    range<member_iterator> getClass(DomainInt val) const {
+        auto cs = getClassSnapshot();
+        const size_t cls = findClass(*cs, val);
+        if (cls == cs->numClasses()) return make_range(cs->members.end(), cs->members.end());
+        return make_range(cs->members.begin() + cs->offsets[cls], cs->members.begin() + cs->offsets[cls + 1]);
+    }
 
-public:
     /**
      * iterator pointing to the beginning of the tuples, with no restrictions
      * @return the iterator that corresponds to the beginning of the binary relation
      */
     iterator begin() const {
-        // generate tries for all disjoint sets
-        for (auto rep = sds.beginReps(); rep != sds.endReps(); ++rep) {
-            generateTrieIfNone(*rep);
-        }
-
-        return iterator(this);
+        auto cs = getClassSnapshot();
+        const size_t n = cs->members.size();
+        return iterator(cs, 0, 0, 0, n);
     }
 
     /**
@@ -601,23 +514,21 @@ public:
      * @return the iterator which represents the end of the binary rel
      */
     iterator end() const {
-        return iterator(true, this);
+        return iterator();
     }
 
     /**
      * Begin an iterator at the requested point
      * @param start where the returned iterator should start from
-     * @return the iterator which starts at the requested element
+     * @return the iterator which starts at the requested element, or end() if it is not present
      */
     iterator find(const TupleType& start) const {
-        // generate tries for all disjoint sets
-        // std::for_each(sds.beginReps(), sds.endReps(), [&](DomainInt r) { generateTrieIfNone(r); });
+        if (!contains(start[0], start[1])) return end();
 
-        for (auto rep = sds.beginReps(); rep != sds.endReps(); ++rep) {
-            generateTrieIfNone(*rep);
-        }
-
-        return iterator(this, start);
+        auto cs = getClassSnapshot();
+        const size_t cls = findClass(*cs, start[0]);
+        const size_t n = cs->members.size();
+        return iterator(cs, cls, findMember(*cs, cls, start[0]), findMember(*cs, cls, start[1]), n);
     }
 
     /**
@@ -658,11 +569,8 @@ public:
             // need to test if the entry actually exists
             if (!sds.nodeExists(entry[0])) return make_range(end(), end());
 
-            std::list<DomainInt> x;
-            x.push_back(entry[0]);
-
             // if so return an iterator starting from the (entry[0], smallest) -> (entry[0], biggest)
-            return make_range(frontProduct(x), end());
+            return make_range(frontProduct(entry[0]), end());
         }
 
         if (levels == 2) {
@@ -682,50 +590,34 @@ public:
     }
 
     /**
-     * Begin an iterator at/after the requested point, and mark it to finish at/before the specified one
+     * Begin an iterator at the requested point, and mark it to finish at the specified one
+     * Both pairs need to be present, and end must not precede start in the iteration order
      * @param start the requested beginning to iterate from
      * @param end the requested end to iterate until
      * @return the resulting iterator that satisfies this
      */
     iterator findBetween(const TupleType& start, const TupleType& end) const {
-        // generate tries for all disjoint sets
-        std::for_each(sds.beginReps(), sds.endReps(), [&](DomainInt r) { generateTrieIfNone(r); });
+        if (!contains(start[0], start[1]) || !contains(end[0], end[1])) return this->end();
 
-        return iterator(this, start, end);
+        auto cs = getClassSnapshot();
+        const size_t cls = findClass(*cs, start[0]);
+        const size_t endCls = findClass(*cs, end[0]);
+        return iterator(cs, cls, findMember(*cs, cls, start[0]), findMember(*cs, cls, start[1]),
+                findMember(*cs, endCls, end[0]) + 1, findMember(*cs, endCls, end[1]) + 1);
     }
 
     /**
-     * Begin an iterator which generates all pairs (X, Y) s.t. X in start & Y in DjSet(X)
-     *      If that wasn't clear, so let's say there's an element e in start
-     *      The iterator will generate the pairs (e, a), (e, b), ... (e, n) - assuming the elements a,b...n
-     * are in e's disjoint set
-     * Requires that all elements in start are within the same disjoint set (and in order)
-     *      Changing this requires extensive changes to the underlying iterator(BinaryRelation*,
-     * std::vector<>) ctor
-     * @param start a list of front elements that must exist at the front pairing generated
+     * Begin an iterator which generates all pairs (x, Y) s.t. Y in DjSet(x)
+     * @param x the front element of all generated pairs
      * @return the resulting iterator that satisfies this
      */
-    iterator frontProduct(std::list<DomainInt> start) const {
-        if (start.size() == 0) throw "invalid sized vector for front product";
+    iterator frontProduct(DomainInt x) const {
+        auto cs = getClassSnapshot();
+        const size_t cls = findClass(*cs, x);
+        if (cls == cs->numClasses()) return end();
 
-        auto rep = sds.readOnlyFindNode(start.front());
-        if (std::any_of(start.begin(), start.end(),
-                    [&](DomainInt i) { return sds.readOnlyFindNode(i) != rep; })) {
-            throw "elements not within same disjoint set";
-        }
-
-        if (!std::is_sorted(start.begin(), start.end())) {
-            for (auto x : start) {
-                std::cout << x << '\t';
-            }
-            std::cout << std::endl;
-
-            throw "elements are not sorted";
-        }
-        // the trie that contains every value in start
-        auto trie = generateTrieIfNone(rep);
-
-        return iterator(this, start, trie);
+        const size_t pos = findMember(*cs, cls, x);
+        return iterator(cs, cls, pos, cs->offsets[cls], pos + 1);
     }
 
     /**
@@ -734,16 +626,17 @@ public:
      * @return an iterator that will generate all pairs within the disjoint set
      */
     iterator closure(DomainInt rep) const {
-        // the trie that contains this rep
-        auto trie = generateTrieIfNone(rep);
+        auto cs = getClassSnapshot();
+        const size_t cls = findClass(*cs, rep);
+        if (cls == cs->numClasses()) return end();
 
-        return iterator(this, rep, trie);
+        return iterator(cs, cls, cs->offsets[cls], cs->offsets[cls], cs->offsets[cls + 1]);
     }
 
     /**
      * Generate an approximate number of iterators for parallel iteration
-     * The iterators returned are not necessarily equal in size, but in practise are approximately similarly
-     * sized
+     * Partitions are formed by ranges of front elements, such that each covers a similar number of pairs.
+     * Small classes are grouped together, large classes are split across multiple partitions.
      * Depending on the structure of the data, there can be more or less partitions returned than requested.
      * @param chunks the number of requested partitions
      * @return a list of the iterators as ranges
@@ -751,11 +644,15 @@ public:
     std::vector<souffle::range<iterator>> partition(size_t chunks) const {
         std::vector<souffle::range<iterator>> ret;
 
-        for (auto rep = sds.beginReps(); rep != sds.endReps(); ++rep) {
-            generateTrieIfNone(*rep);
-        }
+        auto cs = getClassSnapshot();
+        const size_t n = cs->members.size();
+
         // num pairs
-        const size_t sz = this->size();
+        size_t sz = 0;
+        for (size_t i = 0; i < cs->numClasses(); ++i) {
+            const size_t cur = cs->offsets[i + 1] - cs->offsets[i];
+            sz += cur * cur;
+        }
 
         // 0 or 1 chunks
         if (chunks <= 1 || sz == 0) return {souffle::make_range(begin(), end())};
@@ -763,40 +660,36 @@ public:
         // how many pairs can we fit within each iterator? (integer ceil division)
         const size_t chunkSize = (sz + (chunks - 1)) / chunks;
 
-        for (auto djSet = sds.beginReps(); djSet != sds.endReps(); ++djSet) {
-            const DomainInt rep = *djSet;
-
-            const size_t djSetSize = sds.sizeOfRepresentativeSet(rep);
-            size_t cSize = 0;
-
-            // will the entire djSet's pairs fit within a single iterator?
-            if (djSetSize * djSetSize <= chunkSize) {
-                // fit all pairs within this disjoint set into a single iterator
-                ret.push_back(souffle::make_range(closure(rep), end()));
-
-            } else {
-                // add as many of this djSet closures into each iterator
-                std::list<DomainInt> fronts;
-
-                for (auto el = sds.begin(rep); el != sds.end(rep); ++el) {
-                    fronts.push_back(*el);
-                    cSize += djSetSize;
-
-                    // iterator is full now? push this iterator set onto the return val
-                    if (cSize >= chunkSize) {
-                        fronts.sort();
-
-                        ret.push_back(souffle::make_range(frontProduct(fronts), end()));
-
-                        fronts.clear();
-
-                        cSize = 0;
-                    }
+        // each front element x contributes |DjSet(x)| pairs
+        size_t first = 0;
+        size_t firstCls = 0;
+        size_t cSize = 0;
+        for (size_t cls = 0; cls < cs->numClasses(); ++cls) {
+            const size_t a = cs->offsets[cls];
+            const size_t b = cs->offsets[cls + 1];
+            const size_t djSetSize = b - a;
+
+            // as many front elements of this class as fit in the current chunk
+            for (size_t pos = a; pos < b;) {
+                const size_t take = std::min(b - pos, (chunkSize - cSize + djSetSize - 1) / djSetSize);
+                pos += take;
+                cSize += take * djSetSize;
+
+                // iterator is full now? push this iterator onto the return val
+                if (cSize >= chunkSize) {
+                    ret.push_back(souffle::make_range(
+                            iterator(cs, firstCls, first, cs->offsets[firstCls], pos), end()));
+                    first = pos;
+                    firstCls = (pos < b) ? cls : cls + 1;
+                    cSize = 0;
                 }
-                // if there's any remainder still
-                if (cSize != 0) ret.push_back(souffle::make_range(frontProduct(fronts), end()));
             }
         }
+        // if there's any remainder still
+        if (first < n) {
+            ret.push_back(
+                    souffle::make_range(iterator(cs, firstCls, first, cs->offsets[firstCls], n), end()));
+        }
         return ret;
     }
 };
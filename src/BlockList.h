@@ -39,6 +39,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <exception>
 #include <iostream>
@@ -273,6 +274,14 @@ public:
         return m_size;
     };
 
+    /**
+     * Determines the amount of memory used by this list
+     * @return the number of bytes allocated for the blocks and their index
+     */
+    size_t getMemoryUsage() const {
+        return sizeof(*this) + listData.size() * (BLOCKSIZE * sizeof(T) + sizeof(T*));
+    }
+
     /**
      * Add a value to the blocklist
      * @param val : value to be added
@@ -447,4 +456,127 @@ inline void BlockList<std::atomic<block_t>>::add(const std::atomic<block_t>& val
 
     ++m_size;
 }
+
+/**
+ * An array of elements stored in segments of geometrically increasing size.
+ * Segments are allocated on demand and never moved or released until the
+ * array is cleared, hence references to elements remain valid and reads do
+ * not require any synchronisation.
+ *
+ * Segment 0 covers the indices [0, BLOCKSIZE), segment k > 0 covers the
+ * indices [BLOCKSIZE << (k-1), BLOCKSIZE << k).
+ *
+ * Concurrent set operations on distinct indices are threadsafe. Clearing,
+ * copying or destructing is undefined behaviour if other operations are in progress.
+ */
+template <class T>
+class SegmentedArray {
+    // enough segments to address the full size_t index space
+    static constexpr size_t NUM_SEGMENTS = sizeof(size_t) * 8 - BLOCKBITS + 1;
+
+    std::atomic<T*> segments[NUM_SEGMENTS];
+
+    static size_t segmentSize(size_t seg) {
+        return (seg == 0) ? BLOCKSIZE : (BLOCKSIZE << (seg - 1));
+    }
+
+    static size_t segmentOf(size_t index) {
+        size_t block = index >> BLOCKBITS;
+        return (block == 0) ? 0 : (sizeof(unsigned long long) * 8 - __builtin_clzll(block));
+    }
+
+    static size_t offsetOf(size_t index, size_t seg) {
+        return (seg == 0) ? index : index - (BLOCKSIZE << (seg - 1));
+    }
+
+    /* obtain the given segment, allocating it if necessary */
+    T* getSegment(size_t seg) {
+        T* cur = segments[seg].load(std::memory_order_acquire);
+        if (cur != nullptr) return cur;
+
+        T* fresh = new T[segmentSize(seg)]();
+        if (segments[seg].compare_exchange_strong(cur, fresh, std::memory_order_acq_rel)) return fresh;
+
+        // another thread was faster
+        delete[] fresh;
+        return cur;
+    }
+
+public:
+    SegmentedArray() {
+        for (auto& cur : segments) cur.store(nullptr, std::memory_order_relaxed);
+    }
+
+    SegmentedArray(const SegmentedArray& other) : SegmentedArray() {
+        *this = other;
+    }
+
+    SegmentedArray& operator=(const SegmentedArray& other) {
+        if (this == &other) return *this;
+        clear();
+        for (size_t i = 0; i < NUM_SEGMENTS; ++i) {
+            const T* src = other.segments[i].load(std::memory_order_acquire);
+            if (src == nullptr) continue;
+            std::copy(src, src + segmentSize(i), getSegment(i));
+        }
+        return *this;
+    }
+
+    ~SegmentedArray() {
+        clear();
+    }
+
+    /**
+     * Store the given value at the given index, allocating space as required
+     * @param index position to be written
+     * @param val the value to be stored
+     */
+    void set(size_t index, const T& val) {
+        at(index) = val;
+    }
+
+    /**
+     * Retrieve a reference to the value at the given index, allocating space as required
+     * @param index position to be accessed
+     * @return the value at index
+     */
+    T& at(size_t index) {
+        size_t seg = segmentOf(index);
+        return getSegment(seg)[offsetOf(index, seg)];
+    }
+
+    /**
+     * Retrieve a reference to the value at the given index, which must have been set before
+     * @param index position to be read
+     * @return the value at index
+     */
+    T& get(size_t index) const {
+        size_t seg = segmentOf(index);
+        return segments[seg].load(std::memory_order_acquire)[offsetOf(index, seg)];
+    }
+
+    /**
+     * Determines the amount of memory used by this array
+     * @return the number of bytes allocated for the segments
+     */
+    size_t getMemoryUsage() const {
+        size_t res = sizeof(*this);
+        for (size_t i = 0; i < NUM_SEGMENTS; ++i) {
+            if (segments[i].load(std::memory_order_acquire) != nullptr) {
+                res += segmentSize(i) * sizeof(T);
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Release all segments
+     */
+    void clear() {
+        for (auto& cur : segments) {
+            delete[] cur.load(std::memory_order_relaxed);
+            cur.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+};
 }  // namespace souffle
@@ -0,0 +1,260 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file BloomFilter.h
+ *
+ * Blocked Bloom filters summarizing the projections of the tuples of a
+ * relation onto a subset of its columns. They are consulted before index
+ * probes of negations and existence checks, such that most negative
+ * probes are answered by a single cache line access.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "HashSet.h"
+#include "RamTypes.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * A blocked Bloom filter for a fixed number of elements. All bits of an element
+ * are located within a single block of 512 bits (a cache line).
+ *
+ * Inserts and membership tests may be conducted concurrently.
+ */
+class BloomFilter {
+    // the number of bits reserved per element
+    static const std::size_t BITS_PER_ELEMENT = 16;
+
+    // the number of 64-bit words per block
+    static const std::size_t BLOCK_WORDS = 8;
+
+    // the number of bits set per element (each position consumes 9 bits of a hash value)
+    static const unsigned NUM_PROBES = 7;
+
+    // the projection summarized by this filter
+    const SearchColumns columns;
+
+    // the maximum number of elements to be inserted before the false positive rate degrades
+    const std::size_t capacity;
+
+    const std::size_t numBlocks;
+
+    // the bits of the filter, words points to a cache-line aligned position within storage
+    std::unique_ptr<std::atomic<uint64_t>[]> storage;
+    std::atomic<uint64_t>* words;
+
+    // the number of insert operations conducted so far
+    std::atomic<std::size_t> numInserts;
+
+public:
+    BloomFilter(SearchColumns columns, std::size_t capacity)
+            : columns(columns), capacity(std::max<std::size_t>(capacity, 64)),
+              numBlocks((this->capacity * BITS_PER_ELEMENT + 511) / 512),
+              storage(new std::atomic<uint64_t>[numBlocks * BLOCK_WORDS + BLOCK_WORDS]), numInserts(0) {
+        // align blocks to cache lines
+        auto addr = reinterpret_cast<std::uintptr_t>(storage.get());
+        auto offset = ((64 - addr % 64) % 64) / sizeof(uint64_t);
+        words = storage.get() + offset;
+        for (std::size_t i = 0; i < numBlocks * BLOCK_WORDS + BLOCK_WORDS; ++i) {
+            storage[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    SearchColumns getColumns() const {
+        return columns;
+    }
+
+    std::size_t getCapacity() const {
+        return capacity;
+    }
+
+    /** Determines whether more elements than planned for have been inserted. */
+    bool isSaturated() const {
+        return numInserts.load(std::memory_order_relaxed) > capacity;
+    }
+
+    /**
+     * Adds the projection of the given tuple to this filter.
+     *
+     * @return false if the filter has become saturated, true otherwise
+     */
+    bool insert(const RamDomain* tuple) {
+        const uint64_t h = hash(tuple);
+        std::atomic<uint64_t>* block = getBlock(h);
+        uint64_t bits = detail::hash_mix(h);
+        for (unsigned i = 0; i < NUM_PROBES; ++i, bits >>= 9) {
+            block[(bits >> 6) & 7].fetch_or(uint64_t(1) << (bits & 63), std::memory_order_relaxed);
+        }
+        return numInserts.fetch_add(1, std::memory_order_relaxed) < capacity;
+    }
+
+    /**
+     * Tests whether the projection of the given tuple may have been inserted.
+     * A negative answer is definite, a positive answer might be a false positive.
+     */
+    bool mayContain(const RamDomain* tuple) const {
+        const uint64_t h = hash(tuple);
+        const std::atomic<uint64_t>* block = getBlock(h);
+        uint64_t bits = detail::hash_mix(h);
+        for (unsigned i = 0; i < NUM_PROBES; ++i, bits >>= 9) {
+            if (!(block[(bits >> 6) & 7].load(std::memory_order_relaxed) & (uint64_t(1) << (bits & 63)))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /** Obtains the amount of memory occupied by this filter in bytes. */
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this) + (numBlocks * BLOCK_WORDS + BLOCK_WORDS) * sizeof(uint64_t);
+    }
+
+private:
+    /* Computes the hash of the projection of the given tuple. */
+    uint64_t hash(const RamDomain* tuple) const {
+        typedef typename std::make_unsigned<RamDomain>::type value_t;
+        // a non-zero seed, such that all-zero projections do not collapse onto a single bit
+        uint64_t h = 0x9e3779b97f4a7c15ULL;
+        SearchColumns cols = columns;
+        for (std::size_t i = 0; cols != 0; ++i, cols >>= 1) {
+            if (cols & 1) {
+                h = detail::hash_mix(h ^ uint64_t(value_t(tuple[i])));
+            }
+        }
+        return h;
+    }
+
+    std::atomic<uint64_t>* getBlock(uint64_t h) const {
+        return words + ((h >> 32) * numBlocks >> 32) * BLOCK_WORDS;
+    }
+};
+
+/**
+ * A Bloom filter attached to a relation, summarizing the projection of its tuples onto a
+ * set of columns. The filter is built lazily from the content of the relation on the first
+ * test and kept up to date by inserts. Once more tuples have been inserted than planned for,
+ * the filter is re-built by the next test with twice the capacity.
+ *
+ * Following the evaluation discipline of stratified programs, a relation is never tested while
+ * it is being modified. Thus, tests may be conducted concurrently and inserts may be conducted
+ * concurrently, but the two must not be mixed.
+ */
+class RelationFilter {
+    const SearchColumns columns;
+
+    // the currently valid filter, nullptr if it needs to be (re-)built
+    std::atomic<BloomFilter*> filter;
+
+    // all filters built so far, retained for concurrent readers until the filter is cleared
+    std::vector<std::unique_ptr<BloomFilter>> filters;
+
+    // synchronizes the construction of filters
+    std::mutex lock;
+
+public:
+    RelationFilter(SearchColumns columns) : columns(columns), filter(nullptr) {}
+
+    RelationFilter(const RelationFilter&) = delete;
+    RelationFilter& operator=(const RelationFilter&) = delete;
+
+    SearchColumns getColumns() const {
+        return columns;
+    }
+
+    /** Determines whether there is a filter currently summarizing the relation. */
+    bool isBuilt() const {
+        return filter.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    /** Records a tuple newly inserted into the relation. */
+    void insert(const RamDomain* tuple) {
+        BloomFilter* f = filter.load(std::memory_order_relaxed);
+        if (f && !f->insert(tuple)) {
+            // the filter is saturated => re-build it on the next test
+            filter.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Tests whether a tuple of the given relation may match the given tuple on the
+     * summarized columns. A negative answer is definite.
+     */
+    template <typename Relation>
+    bool mayContain(const RamDomain* tuple, const Relation& rel) {
+        BloomFilter* f = filter.load(std::memory_order_acquire);
+        if (!f) {
+            f = build(rel);
+            // if some other thread is building the filter, the test has to be answered by the relation
+            if (!f) return true;
+        }
+        return f->mayContain(tuple);
+    }
+
+    /** Drops the summary of the relation, e.g. when the relation is purged. */
+    void clear() {
+        filter.store(nullptr, std::memory_order_relaxed);
+        filters.clear();
+    }
+
+    std::size_t getMemoryUsage() const {
+        std::size_t res = sizeof(*this);
+        for (const auto& cur : filters) {
+            res += cur->getMemoryUsage();
+        }
+        return res;
+    }
+
+private:
+    static const RamDomain* data(const RamDomain* tuple) {
+        return tuple;
+    }
+
+    template <typename Tuple>
+    static const RamDomain* data(const Tuple& tuple) {
+        return &tuple[0];
+    }
+
+    /* Builds a new filter covering the current content of the given relation. */
+    template <typename Relation>
+    BloomFilter* build(const Relation& rel) {
+        std::unique_lock<std::mutex> guard(lock, std::try_to_lock);
+        if (!guard.owns_lock()) return nullptr;
+
+        // check whether some other thread has been faster
+        BloomFilter* f = filter.load(std::memory_order_acquire);
+        if (f) return f;
+
+        // reserve space for the relation to double its size
+        std::size_t capacity = rel.size() * 2;
+        if (!filters.empty()) {
+            capacity = std::max(capacity, filters.back()->getCapacity() * 2);
+        }
+
+        f = new BloomFilter(columns, capacity);
+        filters.emplace_back(f);
+        for (const auto& cur : rel) {
+            f->insert(data(cur));
+        }
+        filter.store(f, std::memory_order_release);
+        return f;
+    }
+};
+
+}  // end namespace souffle
@@ -0,0 +1,416 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file Checkpoint.h
+ *
+ * Binary snapshots of an evaluation taken at stratum boundaries, such that
+ * an interrupted evaluation may be resumed after the last completed stratum.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "IODirectives.h"
+#include "RamTypes.h"
+#include "SymbolTable.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace souffle {
+
+/**
+ * The record tables of an evaluation, as saved and restored by checkpoints. Records of each
+ * arity are numbered consecutively starting from 1.
+ */
+class RecordTables {
+public:
+    virtual ~RecordTables() = default;
+
+    /** Obtains the arities of the records created so far */
+    virtual std::vector<int> getArities() const = 0;
+
+    /** Obtains the number of records of the given arity */
+    virtual std::size_t size(int arity) const = 0;
+
+    /** Obtains the record of the given arity and index */
+    virtual const RamDomain* unpack(int arity, RamDomain index) const = 0;
+
+    /** Obtains the index of the given record, creating the record if necessary */
+    virtual RamDomain pack(int arity, const RamDomain* tuple) = 0;
+};
+
+/**
+ * The checkpoints of an evaluation, kept within a directory.
+ *
+ * After each stratum, the relations computed by it are saved to one file each, followed by
+ * the symbols and records created by it and finally the index of the stratum. Since
+ * relations, symbols and records are never modified once created, a checkpoint only
+ * comprises the data created since the previous one.
+ *
+ * An evaluation of the same program on the same input resumes after the last stratum
+ * completed by a previous evaluation: the completed strata are not evaluated but restore
+ * their symbols, records and those relations that are still needed. Checkpoints of
+ * different programs or inputs are distinguished by a fingerprint of the program and of the
+ * files it reads. The checkpoints of an evaluation are cleared once it completes.
+ *
+ * A checkpoint created without a directory is disabled and does not save or restore data.
+ */
+class Checkpoint {
+    static const uint64_t MAGIC = 0x746e696f706b6373ull;  // "sckpoint"
+
+    // the directory holding the snapshots, empty if disabled
+    std::string directory;
+
+    uint64_t fingerprint;
+
+    // the last stratum completed by a previous evaluation, -1 if none
+    int64_t resumed;
+
+    // the number of symbols and records of each arity saved or restored so far
+    std::size_t numSymbols;
+    std::map<int, std::size_t> numRecords;
+
+public:
+    Checkpoint(const std::string& directory, uint64_t fingerprint)
+            : directory(directory), fingerprint(fingerprint), resumed(-1), numSymbols(0) {
+        if (directory.empty()) {
+            return;
+        }
+        std::ifstream in(getFileName("checkpoint"), std::ios::binary);
+        uint64_t magic = 0;
+        uint64_t print = 0;
+        int64_t stratum = -1;
+        read(in, magic);
+        read(in, print);
+        read(in, stratum);
+        if (in && magic == MAGIC && print == fingerprint) {
+            resumed = stratum;
+        }
+    }
+
+    bool isEnabled() const {
+        return !directory.empty();
+    }
+
+    /** Obtains the last stratum completed by a previous evaluation, -1 if none. */
+    int64_t getResumedStratum() const {
+        return resumed;
+    }
+
+    /** Determines whether the given stratum has been completed by a previous evaluation. */
+    bool isCompleted(std::size_t stratum) const {
+        return static_cast<int64_t>(stratum) <= resumed;
+    }
+
+    /** Determines whether a relation dropped after the given stratum is needed after resuming. */
+    bool isNeeded(std::size_t lastStratum) const {
+        return static_cast<int64_t>(lastStratum) > resumed;
+    }
+
+    /** Computes the fingerprint of a program from its textual representation. */
+    static uint64_t getFingerprint(const std::string& program) {
+        // FNV-1a
+        uint64_t res = 0xcbf29ce484222325ull;
+        for (char c : program) {
+            res = (res ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+        }
+        return res;
+    }
+
+    /**
+     * Folds the identity of the files read by the given inputs into the fingerprint of a program,
+     * such that a checkpoint is not resumed once an input has been modified.
+     */
+    static uint64_t getFingerprint(uint64_t fingerprint, const std::vector<IODirectives>& inputs) {
+        auto hash = [&](const void* data, std::size_t size) {
+            for (std::size_t i = 0; i < size; ++i) {
+                fingerprint = (fingerprint ^ static_cast<const unsigned char*>(data)[i]) * 0x100000001b3ull;
+            }
+        };
+        for (const IODirectives& input : inputs) {
+            for (const char* key : {"filename", "dbname"}) {
+                if (!input.has(key)) {
+                    continue;
+                }
+                const std::string& fileName = input.get(key);
+                hash(fileName.data(), fileName.size() + 1);
+                struct stat info;
+                if (stat(fileName.c_str(), &info) == 0) {
+                    const int64_t size = info.st_size;
+                    const int64_t time = info.st_mtime;
+                    hash(&size, sizeof(size));
+                    hash(&time, sizeof(time));
+                }
+            }
+        }
+        return fingerprint;
+    }
+
+    /** Saves the content of a relation. */
+    template <typename Relation>
+    void save(const std::string& name, std::size_t arity, const Relation& rel) {
+        if (!isEnabled()) {
+            return;
+        }
+        std::string fileName = getFileName(name + ".rel");
+        std::ofstream out(fileName + ".tmp", std::ios::binary);
+        uint64_t size = rel.size();
+        write(out, MAGIC);
+        write(out, uint64_t(arity));
+        write(out, size);
+        std::vector<RamDomain> buffer;
+        buffer.reserve(bufferSize);
+        for (const auto& cur : rel) {
+            const RamDomain* tuple = getData(cur);
+            buffer.insert(buffer.end(), tuple, tuple + arity);
+            if (buffer.size() >= bufferSize) {
+                write(out, buffer);
+            }
+        }
+        write(out, buffer);
+        close(out, fileName);
+    }
+
+    /** Restores the content of a relation saved by a previous evaluation. */
+    template <typename Relation>
+    void restore(const std::string& name, std::size_t arity, Relation& rel) {
+        std::string fileName = getFileName(name + ".rel");
+        std::ifstream in(fileName, std::ios::binary);
+        uint64_t magic = 0;
+        uint64_t storedArity = 0;
+        uint64_t size = 0;
+        read(in, magic);
+        read(in, storedArity);
+        read(in, size);
+        if (!in || magic != MAGIC || storedArity != arity) {
+            throw std::runtime_error("Cannot restore relation " + name + " from checkpoint " + fileName);
+        }
+        const RamDomain empty = 0;
+        std::vector<RamDomain> buffer;
+        while (size > 0) {
+            const std::size_t count = std::min<uint64_t>(size, bufferSize / std::max<std::size_t>(arity, 1));
+            buffer.resize(count * arity);
+            read(in, buffer);
+            if (!in) {
+                throw std::runtime_error("Cannot restore relation " + name + " from checkpoint " + fileName);
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                const RamDomain* tuple = (arity == 0) ? &empty : &buffer[i * arity];
+                rel.insert(tuple);
+            }
+            size -= count;
+        }
+    }
+
+    /**
+     * Completes the checkpoint of the given stratum by saving the symbols and records created
+     * since the previous one and the index of the stratum.
+     */
+    void commit(std::size_t stratum, const SymbolTable& symbolTable, const RecordTables& records) {
+        if (!isEnabled()) {
+            return;
+        }
+        std::string fileName = getFileName("stratum-" + std::to_string(stratum));
+        std::ofstream out(fileName + ".tmp", std::ios::binary);
+        write(out, MAGIC);
+
+        // symbols
+        const std::size_t size = symbolTable.size();
+        write(out, uint64_t(numSymbols));
+        write(out, uint64_t(size - numSymbols));
+        for (std::size_t i = numSymbols; i < size; ++i) {
+            write(out, std::string(symbolTable.resolve(i)));
+        }
+        numSymbols = size;
+
+        // records
+        const std::vector<int> arities = records.getArities();
+        write(out, uint64_t(arities.size()));
+        for (int arity : arities) {
+            std::size_t& from = numRecords[arity];
+            const std::size_t count = records.size(arity);
+            write(out, int64_t(arity));
+            write(out, uint64_t(from));
+            write(out, uint64_t(count - from));
+            std::vector<RamDomain> buffer;
+            for (std::size_t i = from + 1; i <= count; ++i) {
+                const RamDomain* tuple = records.unpack(arity, i);
+                buffer.insert(buffer.end(), tuple, tuple + arity);
+            }
+            write(out, buffer);
+            from = count;
+        }
+        close(out, fileName);
+
+        // the stratum is completed once it is recorded
+        out.open(getFileName("checkpoint.tmp"), std::ios::binary);
+        write(out, MAGIC);
+        write(out, fingerprint);
+        write(out, int64_t(stratum));
+        close(out, getFileName("checkpoint"));
+    }
+
+    /** Restores the symbols and records created by a stratum completed by a previous evaluation. */
+    void restoreTables(std::size_t stratum, SymbolTable& symbolTable, RecordTables& records) {
+        std::string fileName = getFileName("stratum-" + std::to_string(stratum));
+        std::ifstream in(fileName, std::ios::binary);
+        auto fail = [&]() {
+            throw std::runtime_error("Cannot restore stratum " + std::to_string(stratum) +
+                                     " from checkpoint " + fileName +
+                                     ", the checkpoint may not match the input of the program");
+        };
+        uint64_t magic = 0;
+        read(in, magic);
+        if (!in || magic != MAGIC) {
+            fail();
+        }
+
+        // symbols, symbols created by loading the input already exist
+        uint64_t from = 0;
+        uint64_t count = 0;
+        read(in, from);
+        read(in, count);
+        std::string symbol;
+        for (uint64_t i = 0; i < count; ++i) {
+            read(in, symbol);
+            if (!in || symbolTable.lookup(symbol.c_str()) != from + i) {
+                fail();
+            }
+        }
+        numSymbols = from + count;
+
+        // records
+        uint64_t numArities = 0;
+        read(in, numArities);
+        for (uint64_t i = 0; i < numArities; ++i) {
+            int64_t arity = 0;
+            read(in, arity);
+            read(in, from);
+            read(in, count);
+            std::vector<RamDomain> buffer(count * arity);
+            read(in, buffer);
+            if (!in) {
+                fail();
+            }
+            for (uint64_t j = 0; j < count; ++j) {
+                if (records.pack(arity, buffer.data() + j * arity) != RamDomain(from + j + 1)) {
+                    fail();
+                }
+            }
+            numRecords[int(arity)] = from + count;
+        }
+    }
+
+    /**
+     * Removes the checkpoints of a completed evaluation comprising the given number of strata
+     * and the given saved relations.
+     */
+    void clear(std::size_t numStrata, const std::vector<std::string>& relations) {
+        if (!isEnabled()) {
+            return;
+        }
+        // the checkpoint is invalidated first, such that an interrupted clearing is never resumed
+        std::remove(getFileName("checkpoint").c_str());
+        for (std::size_t i = 0; i < numStrata; ++i) {
+            std::remove(getFileName("stratum-" + std::to_string(i)).c_str());
+        }
+        for (const std::string& name : relations) {
+            std::remove(getFileName(name + ".rel").c_str());
+        }
+        resumed = -1;
+    }
+
+private:
+    // the number of values buffered while reading and writing relations
+    static const std::size_t bufferSize = 1 << 16;
+
+    std::string getFileName(const std::string& name) const {
+        return directory + "/" + name;
+    }
+
+    static const RamDomain* getData(const RamDomain* tuple) {
+        return tuple;
+    }
+
+    template <typename Tuple>
+    static const RamDomain* getData(const Tuple& tuple) {
+        return &tuple[0];
+    }
+
+    template <typename T>
+    static void write(std::ostream& out, T value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    static void write(std::ostream& out, const std::string& value) {
+        write(out, uint64_t(value.size()));
+        out.write(value.data(), value.size());
+    }
+
+    static void write(std::ostream& out, std::vector<RamDomain>& values) {
+        out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(RamDomain));
+        values.clear();
+    }
+
+    template <typename T>
+    static void read(std::istream& in, T& value) {
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+
+    static void read(std::istream& in, std::string& value) {
+        uint64_t size = 0;
+        read(in, size);
+        value.resize(size);
+        in.read(&value[0], size);
+    }
+
+    static void read(std::istream& in, std::vector<RamDomain>& values) {
+        in.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(RamDomain));
+    }
+
+    /* Flushes the given file or directory to the disk. */
+    static bool sync(const std::string& fileName) {
+        const int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd == -1) {
+            return false;
+        }
+        const bool res = fsync(fd) == 0;
+        ::close(fd);
+        return res;
+    }
+
+    /*
+     * Completes the given file and moves it to its final name, such that files are never partial.
+     * The content is on the disk before the file is renamed, since a stratum recorded as completed
+     * must not be followed by an empty file after a power loss.
+     */
+    void close(std::ofstream& out, const std::string& fileName) const {
+        out.close();
+        const std::string tmpName = fileName + ".tmp";
+        if (!out || !sync(tmpName) || std::rename(tmpName.c_str(), fileName.c_str()) != 0) {
+            throw std::runtime_error("Cannot write checkpoint " + fileName);
+        }
+        // persist the rename itself; not all file systems support syncing directories
+        sync(directory);
+    }
+};
+
+}  // end namespace souffle
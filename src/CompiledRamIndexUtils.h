@@ -20,6 +20,7 @@
 #include "BTree.h"
 #include "BinaryRelation.h"
 #include "CompiledRamTuple.h"
+#include "HashSet.h"
 #include "IterUtils.h"
 #include "ParallelUtils.h"
 #include "SymbolTable.h"
@@ -649,6 +650,10 @@ public:
         return index.getChunks(400);
     }
 
+    std::size_t getMemoryUsage() const {
+        return index.getMemoryUsage();
+    }
+
     static void printDescription(std::ostream& out) {
         out << "direct-btree-index(" << Index() << ")";
     }
@@ -756,6 +761,10 @@ public:
         return res;
     }
 
+    std::size_t getMemoryUsage() const {
+        return index.getMemoryUsage();
+    }
+
     static void printDescription(std::ostream& out) {
         out << "indirect-btree-index(" << Index() << ")";
     }
@@ -929,6 +938,10 @@ public:
         return make_range(iterator(r.begin()), iterator(r.end()));
     }
 
+    std::size_t getMemoryUsage() const {
+        return data.getMemoryUsage();
+    }
+
     static void printDescription(std::ostream& out) {
         out << "trie-index(" << Index() << ")";
     }
@@ -965,7 +978,7 @@ public:
     typedef typename data_type::operation_hints operation_hints;
 
     bool empty() const {
-        return data.size() == 0;
+        return data.empty();
     }
 
     /* returns the number of pairs (NOT the number of elements in the domain, but the number of possibly
@@ -1111,6 +1124,10 @@ public:
         return make_range(iterator(r.begin()), iterator(r.end()));
     }
 
+    std::size_t getMemoryUsage() const {
+        return data.getMemoryUsage();
+    }
+
     static void printDescription(std::ostream& out) {
         out << "disjoint-set-index(" << Index() << ")";
     }
@@ -1128,6 +1145,98 @@ private:
         return res;
     }
 };
+
+/**
+ * A hash index storing the indexed elements directly within an unordered,
+ * concurrent hash set. Since there is no order, only queries binding all
+ * columns of the stored tuples are supported.
+ *
+ * @tparam Tuple .. the type of tuple to be maintained by this index
+ * @tparam Index .. the index to be internally utilized (needs to be a full index)
+ */
+template <typename Tuple, typename Index>
+struct HashIndex {
+    static_assert((int)Tuple::arity == (int)Index::size, "Hash indices need to be full indices!");
+
+    typedef HashSet<Tuple> data_structure;
+
+    typedef typename data_structure::key_type key_type;
+
+    typedef typename data_structure::const_iterator iterator;
+
+    typedef typename data_structure::operation_hints operation_hints;
+
+private:
+    data_structure index;
+
+public:
+    bool empty() const {
+        return index.empty();
+    }
+
+    std::size_t size() const {
+        return index.size();
+    }
+
+    bool insert(const key_type& key, operation_hints& hints) {
+        // insert the element (insert is synchronized internally)
+        return index.insert(key, hints);
+    }
+
+    void insertAll(const HashIndex& other) {
+        index.insertAll(other.index);
+    }
+
+    bool contains(const key_type& key, operation_hints& hints) const {
+        return index.contains(key, hints);
+    }
+
+    iterator find(const key_type& key, operation_hints& hints) const {
+        return index.find(key, hints);
+    }
+
+    template <typename SubIndex>
+    range<iterator> equalRange(const key_type& key, operation_hints& hints) const {
+        static_assert((int)SubIndex::size == (int)Index::size, "Hash indices only support full-key queries!");
+        // there is at most one element with this value
+        auto pos = find(key, hints);
+        auto end = index.end();
+        if (pos != end) {
+            end = pos;
+            ++end;
+        }
+        return make_range(pos, end);
+    }
+
+    iterator begin() const {
+        return index.begin();
+    }
+
+    iterator end() const {
+        return index.end();
+    }
+
+    void clear() {
+        index.clear();
+    }
+
+    void truncate() {
+        index.truncate();
+    }
+
+    std::vector<range<iterator>> partition() const {
+        return index.getChunks(400);
+    }
+
+    std::size_t getMemoryUsage() const {
+        return index.getMemoryUsage();
+    }
+
+    static void printDescription(std::ostream& out) {
+        out << "hash-index(" << Index() << ")";
+    }
+};
+
 // -------------------------------------------------------------
 
 /* A direct index factory only supporting direct indices */
@@ -1322,6 +1431,12 @@ public:
         return nested.partition(index);
     }
 
+    // appends the memory used by this and the nested indices in bytes, in the order of the indices
+    void getMemoryUsage(std::vector<std::size_t>& res) const {
+        res.push_back(index.getMemoryUsage());
+        nested.getMemoryUsage(res);
+    }
+
     // prints a description of the organization of this index
     std::ostream& printDescription(std::ostream& out = std::cout) const {
         index_t::printDescription(out);
@@ -1392,6 +1507,8 @@ public:
         return 0;
     }
 
+    void getMemoryUsage(std::vector<std::size_t>&) const {}
+
     std::ostream& printDescription(std::ostream& out = std::cout) const {
         return out;
     }
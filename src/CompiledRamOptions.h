@@ -68,10 +68,32 @@ protected:
      */
     size_t num_jobs;
 
+    /**
+     * checkpointing flag
+     */
+    bool checkpointing;
+
+    /**
+     * checkpoint directory
+     */
+    std::string checkpoint_dir;
+
+    /**
+     * progress reporting flag
+     */
+    bool reporting;
+
+    /**
+     * progress filename
+     */
+    std::string progress_file;
+
 public:
     // all argument constructor
-    CmdOptions(const char* s, const char* id, const char* od, bool pe, const char* pfn, size_t nj)
-            : src(s), input_dir(id), output_dir(od), profiling(pe), profile_name(pfn), num_jobs(nj) {}
+    CmdOptions(const char* s, const char* id, const char* od, bool pe, const char* pfn, size_t nj,
+            bool ce = false, const char* cd = "", bool re = false, const char* rf = "")
+            : src(s), input_dir(id), output_dir(od), profiling(pe), profile_name(pfn), num_jobs(nj),
+              checkpointing(ce), checkpoint_dir(cd), reporting(re), progress_file(rf) {}
 
     /**
      * get source code name
@@ -115,6 +137,20 @@ public:
         return num_jobs;
     }
 
+    /**
+     * get checkpoint directory
+     */
+    const std::string& getCheckpointDir() {
+        return checkpoint_dir;
+    }
+
+    /**
+     * get filename of progress report
+     */
+    const std::string& getProgressFile() {
+        return progress_file;
+    }
+
     /**
      * Parses the given command line parameters, handles -h help requests or errors
      * and returns whether the parsing was successful or not.
@@ -135,7 +171,8 @@ public:
 #pragma GCC diagnostic ignored "-Wwrite-strings"
         // long options
         option longOptions[] = {{"facts", true, nullptr, 'F'}, {"output", true, nullptr, 'D'},
-                {"profile", true, nullptr, 'p'},
+                {"profile", true, nullptr, 'p'}, {"checkpoint", true, nullptr, 'k'},
+                {"progress", true, nullptr, 's'},
 #ifdef _OPENMP
                 {"jobs", true, nullptr, 'j'},
 #endif
@@ -147,7 +184,7 @@ public:
         bool ok = true;
 
         int c; /* command-line arguments processing */
-        while ((c = getopt_long(argc, argv, "D:F:hp:j:", longOptions, nullptr)) != EOF) {
+        while ((c = getopt_long(argc, argv, "D:F:hp:j:k:s:", longOptions, nullptr)) != EOF) {
             switch (c) {
                 /* Fact directories */
                 case 'F':
@@ -173,6 +210,26 @@ public:
                     }
                     profile_name = optarg;
                     break;
+                case 'k':
+                    if (!checkpointing) {
+                        std::cerr << "\nerror: checkpoints were not enabled in compilation\n\n";
+                        printHelpPage(exec_name);
+                        exit(1);
+                    }
+                    if (*optarg && !existDir(optarg)) {
+                        printf("Checkpoint directory %s does not exists!\n", optarg);
+                        ok = false;
+                    }
+                    checkpoint_dir = optarg;
+                    break;
+                case 's':
+                    if (!reporting) {
+                        std::cerr << "\nerror: progress reports were not enabled in compilation\n\n";
+                        printHelpPage(exec_name);
+                        exit(1);
+                    }
+                    progress_file = optarg;
+                    break;
 #ifdef _OPENMP
                 case 'j':
                     if (std::string(optarg) == "auto") {
@@ -231,6 +288,16 @@ private:
             std::cerr << "    -p <file>, --profile=<file>  -- Specify filename for profiling\n";
             std::cerr << "                                    (default: " << profile_name << ")\n";
         }
+        if (checkpointing) {
+            std::cerr << "    -k <DIR>, --checkpoint=<DIR> -- Specify directory for checkpoints\n";
+            std::cerr << "                                    (default: " << checkpoint_dir << ")\n";
+            std::cerr << "                                    (disable with \"\")\n";
+        }
+        if (reporting) {
+            std::cerr << "    -s <file>, --progress=<file> -- Specify filename for progress reports\n";
+            std::cerr << "                                    (default: " << progress_file << ")\n";
+            std::cerr << "                                    (disable with \"\")\n";
+        }
 #ifdef _OPENMP
         std::cerr << "    -j <NUM>, --jobs=<NUM>       -- Specify number of threads\n";
         if (num_jobs > 0) {
@@ -16,10 +16,12 @@
 
 #pragma once
 
+#include "Checkpoint.h"
 #include "CompiledRamTuple.h"
 #include "ParallelUtils.h"
 
 #include <limits>
+#include <map>
 #include <unordered_map>
 #include <vector>
 
@@ -70,11 +72,31 @@ bool isNull(RamDomain ref) {
 
 namespace detail {
 
+/**
+ * The arity-independent interface of record maps.
+ */
+class RecordMapBase {
+public:
+    virtual ~RecordMapBase() = default;
+    virtual std::size_t size() = 0;
+    virtual std::size_t getMemoryUsage() = 0;
+    virtual const RamDomain* unpackData(RamDomain index) = 0;
+    virtual RamDomain packData(const RamDomain* tuple) = 0;
+};
+
+/**
+ * The record maps created so far, by arity.
+ */
+inline std::map<int, RecordMapBase*>& getRecordMaps() {
+    static std::map<int, RecordMapBase*> maps;
+    return maps;
+}
+
 /**
  * A bidirectional mapping between tuples and reference indices.
  */
 template <typename Tuple>
-class RecordMap {
+class RecordMap : public RecordMapBase {
     // create blocks of a million entries
     static const std::size_t BLOCK_SIZE = 1 << 20;
     static const std::size_t NUM_BLOCKS = 1 << (sizeof(RamDomain) * 8 - 20);
@@ -95,10 +117,12 @@ class RecordMap {
     block_index_type i2r;
 
     /** a lock for the pack operation */
-    Lock pack_lock;
+    Lock pack_lock{LockSite::records};
 
 public:
-    RecordMap() {}
+    RecordMap() {
+        getRecordMaps()[tuple_type::arity] = this;
+    }
 
     /**
      * Packs the given tuple -- and may create a new reference if necessary.
@@ -144,6 +168,38 @@ public:
         // just look up the right spot
         return (*(i2r[index / BLOCK_SIZE]))[index % BLOCK_SIZE];
     }
+
+    std::size_t size() override {
+        auto leas = pack_lock.acquire();
+        (void)leas;
+        return r2i.size();
+    }
+
+    std::size_t getMemoryUsage() override {
+        auto leas = pack_lock.acquire();
+        (void)leas;
+        // the tuples are stored in the hash map and the allocated blocks
+        std::size_t res = sizeof(*this) + r2i.bucket_count() * sizeof(void*);
+        res += r2i.size() * (sizeof(tuple_type) + sizeof(RamDomain) + 2 * sizeof(void*));
+        for (const auto& cur : i2r) {
+            if (cur) {
+                res += sizeof(block_type);
+            }
+        }
+        return res;
+    }
+
+    const RamDomain* unpackData(RamDomain index) override {
+        return &unpack(index)[0];
+    }
+
+    RamDomain packData(const RamDomain* tuple) override {
+        tuple_type cur;
+        for (std::size_t i = 0; i < tuple_type::arity; ++i) {
+            cur[i] = tuple[i];
+        }
+        return pack(cur);
+    }
 };
 
 /**
@@ -166,4 +222,40 @@ const Tuple& unpack(RamDomain ref) {
     return detail::getRecordMap<Tuple>().unpack(ref);
 }
 
+/**
+ * The record tables of a generated program, as saved and restored by checkpoints. Only the
+ * record maps created so far are covered.
+ */
+class CompiledRecordTables : public RecordTables {
+public:
+    std::vector<int> getArities() const override {
+        std::vector<int> res;
+        for (const auto& cur : detail::getRecordMaps()) {
+            res.push_back(cur.first);
+        }
+        return res;
+    }
+
+    std::size_t size(int arity) const override {
+        return detail::getRecordMaps().at(arity)->size();
+    }
+
+    const RamDomain* unpack(int arity, RamDomain index) const override {
+        return detail::getRecordMaps().at(arity)->unpackData(index);
+    }
+
+    /** Obtains the amount of memory used by all record maps in bytes */
+    std::size_t getMemoryUsage() const {
+        std::size_t res = 0;
+        for (const auto& cur : detail::getRecordMaps()) {
+            res += cur.second->getMemoryUsage();
+        }
+        return res;
+    }
+
+    RamDomain pack(int arity, const RamDomain* tuple) override {
+        return detail::getRecordMaps().at(arity)->packData(tuple);
+    }
+};
+
 }  // end of namespace souffle
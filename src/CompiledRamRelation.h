@@ -18,6 +18,7 @@
 #pragma once
 
 #include "BTree.h"
+#include "BloomFilter.h"
 #include "CompiledRamIndexUtils.h"
 #include "CompiledRamTuple.h"
 #include "IOSystem.h"
@@ -27,7 +28,9 @@
 #include "Trie.h"
 #include "Util.h"
 
+#include <algorithm>
 #include <iterator>
+#include <memory>
 #include <mutex>
 #include <type_traits>
 
@@ -73,6 +76,17 @@ struct Brie;
  */
 struct EqRel;
 
+/**
+ * A setup utilizing hash sets for relations exclusively.
+ */
+struct Hash;
+
+/**
+ * A setup decorating the relations of another setup by Bloom filters.
+ */
+template <typename Setup, typename... Filters>
+struct Filtered;
+
 // -------------------------------------------------------------
 //                  Auto Setup Implementation
 // -------------------------------------------------------------
@@ -166,6 +180,73 @@ struct EqRel {
     using relation = detail::SingleIndexTypeRelation<eqrel_index_factory, arity, Indices...>;
 };
 
+// -------------------------------------------------------------
+//                  Hash Setup Implementation
+// -------------------------------------------------------------
+
+namespace detail {
+
+/**
+ * The relation type utilized to implement relations based on a single,
+ * unordered hash index.
+ */
+template <unsigned arity>
+class HashRelation;
+}  // namespace detail
+
+/**
+ * A setup utilizing hash sets for relations exclusively. Since hash sets
+ * are unordered, requested indices are ignored and queries not binding
+ * all columns are answered by filtered scans.
+ */
+struct Hash {
+    // determines the relation implementation for a given use case
+    template <unsigned arity, typename... Indices>
+    using relation = detail::HashRelation<arity>;
+};
+
+/**
+ * Obtains the tuples of a relation in lexicographical order. Relations using the
+ * hash setup enumerate their tuples in an arbitrary order, thus they are sorted
+ * before being written, such that their outputs match those of other setups.
+ */
+template <typename Rel>
+std::vector<typename std::decay<decltype(*std::declval<const Rel&>().begin())>::type> getSortedTuples(
+        const Rel& rel) {
+    std::vector<typename std::decay<decltype(*rel.begin())>::type> res(rel.begin(), rel.end());
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+// -------------------------------------------------------------
+//                  Filtered Setup Implementation
+// -------------------------------------------------------------
+
+namespace detail {
+
+/**
+ * The relation type decorating a relation by Bloom filters.
+ */
+template <typename Base, typename... Filters>
+class FilteredRelation;
+}  // namespace detail
+
+/**
+ * A setup decorating the relations of another setup by Bloom filters over the
+ * projections of their tuples onto the given lists of columns. The filters are
+ * consulted by negations and existence checks before probing an index.
+ *
+ * Filters require the inserted tuples to be exactly the tuples of the relation,
+ * thus they must not be applied to equivalence relations.
+ */
+template <typename Setup, typename... Filters>
+struct Filtered {
+    // determines the relation implementation for a given use case
+    template <unsigned arity, typename... Indices>
+    using relation =
+            detail::FilteredRelation<typename Setup::template relation<arity, Indices...>, Filters...>;
+};
+
 namespace detail {
 /**
  * A base class for partially specialized relation templates following below.
@@ -216,6 +297,17 @@ struct RelationBase {
         return static_cast<Derived*>(this)->insert(tuple, ctxt);
     }
 
+    // -- truncate wrapper --
+
+    /*
+     * Removes all tuples for the relation to be refilled. Only the tables and hash sets holding
+     * tuples retain their memory for subsequent inserts, the nodes of btree and brie indices are
+     * released like by purge(), which is the default.
+     */
+    void truncate() {
+        asDerived().purge();
+    }
+
     // -- IO --
 
     /* Provides a description of the internal organization of this relation. */
@@ -284,7 +376,7 @@ private:
     indices_t indices;
 
     // the lock utilized to synchronize inserts
-    Lock insert_lock;
+    Lock insert_lock{LockSite::relation};
 
     /* A utility to check whether a certain index is covered by this relation. */
     template <typename Index>
@@ -399,10 +491,32 @@ public:
         indices.clear();
     }
 
-    auto partition() -> decltype(indices.partition(primary_index())) {
+    /* Removes all tuples, retaining the blocks of the table but not the nodes of the indices. */
+    void truncate() {
+        data.truncate();
+        indices.clear();
+    }
+
+    auto partition() const -> decltype(indices.partition(primary_index())) {
         return indices.partition(primary_index());
     }
 
+    /* Determines the amount of memory used by this relation in bytes. */
+    std::size_t getMemoryUsage() const {
+        std::size_t res = data.getMemoryUsage();
+        for (std::size_t cur : getIndexMemoryUsage()) {
+            res += cur;
+        }
+        return res;
+    }
+
+    /* Determines the amount of memory used by each index of this relation, in the order of the indices. */
+    std::vector<std::size_t> getIndexMemoryUsage() const {
+        std::vector<std::size_t> res;
+        indices.getMemoryUsage(res);
+        return res;
+    }
+
     /* Prints a description of the internal structure of this relation. */
     std::ostream& printDescription(std::ostream& out = std::cout) const {
         out << "Relation of arity=" << arity << " with indices [ ";
@@ -546,10 +660,26 @@ public:
         indices.clear();
     }
 
-    auto partition() -> decltype(indices.partition(primary_index())) {
+    auto partition() const -> decltype(indices.partition(primary_index())) {
         return indices.partition(primary_index());
     }
 
+    /* Determines the amount of memory used by this relation in bytes. */
+    std::size_t getMemoryUsage() const {
+        std::size_t res = 0;
+        for (std::size_t cur : getIndexMemoryUsage()) {
+            res += cur;
+        }
+        return res;
+    }
+
+    /* Determines the amount of memory used by each index of this relation, in the order of the indices. */
+    std::vector<std::size_t> getIndexMemoryUsage() const {
+        std::vector<std::size_t> res;
+        indices.getMemoryUsage(res);
+        return res;
+    }
+
     /* Prints a description of the internal structure of this relation. */
     std::ostream& printDescription(std::ostream& out = std::cout) const {
         out << "DirectIndexedRelation of arity=" << arity << " with indices [ ";
@@ -740,6 +870,16 @@ public:
         return toVector(make_range(begin(), end()));
     }
 
+    /* Determines the amount of memory used by this relation in bytes. */
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this);
+    }
+
+    /* Determines the amount of memory used by each index of this relation, in the order of the indices. */
+    std::vector<std::size_t> getIndexMemoryUsage() const {
+        return std::vector<std::size_t>();
+    }
+
     /* Prints a description of the internal organization of this relation. */
     std::ostream& printDescription(std::ostream& out = std::cout) const {
         return out << "Nullary Relation";
@@ -876,6 +1016,16 @@ public:
         return data.partition();
     }
 
+    /* Determines the amount of memory used by this relation in bytes. */
+    std::size_t getMemoryUsage() const {
+        return data.getMemoryUsage();
+    }
+
+    /* Determines the amount of memory used by each index of this relation, in the order of the indices. */
+    std::vector<std::size_t> getIndexMemoryUsage() const {
+        return std::vector<std::size_t>(1, data.getMemoryUsage());
+    }
+
     /* Prints a description of the inner organization of this relation. */
     std::ostream& printDescription(std::ostream& out = std::cout) const {
         out << "Index-Organized Relation of arity=" << arity << " based on a ";
@@ -891,6 +1041,172 @@ template <unsigned arity, typename Index>
 class AutoRelation<arity, Index>
         : public SingleIndexRelation<arity, Index, index_utils::direct_index_factory> {};
 
+// ------------------------------------------------------------------------------------------
+//                                    HashRelation
+// ------------------------------------------------------------------------------------------
+
+/**
+ * A relation storing all its tuples in a single, concurrent hash set. Membership
+ * tests, inserts and queries binding all columns are served in constant time.
+ */
+template <unsigned arity>
+class HashRelation : public RelationBase<arity, HashRelation<arity>> {
+    // the full index covered by the hash set
+    typedef typename index_utils::get_full_index<arity>::type primary_index_t;
+
+    // a shortcut for the base class
+    typedef RelationBase<arity, HashRelation<arity>> base;
+
+public:
+    /* The tuple type handled by this relation. */
+    typedef typename base::tuple_type tuple_type;
+
+private:
+    typedef index_utils::HashIndex<tuple_type, primary_index_t> table_t;
+
+    /* The hashed data stored in this relation. */
+    table_t data;
+
+    /* A utility to determine whether a query binds all columns. */
+    template <typename I>
+    struct is_full {
+        enum { value = (int)I::size == (int)arity };
+    };
+
+public:
+    /* The iterator type utilized by this relation. */
+    typedef typename table_t::iterator iterator;
+
+    // import generic signatures from the base class
+    using base::contains;
+    using base::insert;
+
+    typedef typename table_t::operation_hints operation_context;
+
+    // --- most general implementation ---
+
+    operation_context createContext() {
+        return operation_context();
+    }
+
+    bool empty() const {
+        return data.empty();
+    }
+
+    std::size_t size() const {
+        return data.size();
+    }
+
+    bool contains(const tuple_type& tuple, operation_context& ctxt) const {
+        return data.contains(tuple, ctxt);
+    }
+
+    bool insert(const tuple_type& tuple, operation_context& ctxt) {
+        return data.insert(tuple, ctxt);
+    }
+
+    void insertAll(const HashRelation& other) {
+        data.insertAll(other.data);
+    }
+
+    template <typename Setup, typename... Idxs>
+    void insertAll(const Relation<Setup, arity, Idxs...>& other) {
+        operation_context ctxt;
+        for (const tuple_type& cur : other) {
+            insert(cur, ctxt);
+        }
+    }
+
+    template <typename I>
+    range<iterator> scan() const {
+        return make_range(data.begin(), data.end());
+    }
+
+private:
+    template <typename I>
+    typename std::enable_if<is_full<I>::value, range<iterator>>::type equalRangeInternal(
+            const tuple_type& value, operation_context& ctxt) const {
+        return data.template equalRange<I>(value, ctxt);
+    }
+
+    template <typename I>
+    typename std::enable_if<!is_full<I>::value, range<iterator_utils::filter_iterator<iterator, I>>>::type
+    equalRangeInternal(const tuple_type& value, operation_context&) const {
+        return make_range(iterator_utils::filter_iterator<iterator, I>(begin(), end(), value),
+                iterator_utils::filter_iterator<iterator, I>(end(), end(), value));
+    }
+
+public:
+    template <typename I>
+    auto equalRange(const tuple_type& value, operation_context& ctxt) const
+            -> decltype(this->equalRangeInternal<I>(value, ctxt)) {
+        return equalRangeInternal<I>(value, ctxt);
+    }
+
+    template <typename I>
+    auto equalRange(const tuple_type& value) const
+            -> decltype(this->equalRangeInternal<I>(value, std::declval<operation_context&>())) {
+        operation_context ctxt;
+        return equalRange<I>(value, ctxt);
+    }
+
+    template <unsigned... Columns>
+    auto equalRange(const tuple_type& value) const -> decltype(
+            this->equalRangeInternal<index<Columns...>>(value, std::declval<operation_context&>())) {
+        return equalRange<index<Columns...>>(value);
+    }
+
+    template <unsigned... Columns, typename Context>
+    auto equalRange(const tuple_type& value, Context& ctxt) const
+            -> decltype(this->equalRangeInternal<index<Columns...>>(value, ctxt)) {
+        return equalRange<index<Columns...>>(value, ctxt);
+    }
+
+    iterator begin() const {
+        return data.begin();
+    }
+
+    iterator end() const {
+        return data.end();
+    }
+
+    void purge() {
+        data.clear();
+    }
+
+    /* Removes all tuples, retaining the hash table for subsequent inserts. */
+    void truncate() {
+        data.truncate();
+    }
+
+    std::vector<range<iterator>> partition() const {
+        return data.partition();
+    }
+
+    /* Determines the amount of memory used by this relation in bytes. */
+    std::size_t getMemoryUsage() const {
+        return data.getMemoryUsage();
+    }
+
+    /* Determines the amount of memory used by each index of this relation, in the order of the indices. */
+    std::vector<std::size_t> getIndexMemoryUsage() const {
+        return std::vector<std::size_t>(1, data.getMemoryUsage());
+    }
+
+    /* Prints a description of the inner organization of this relation. */
+    std::ostream& printDescription(std::ostream& out = std::cout) const {
+        out << "Hash-Organized Relation of arity=" << arity << " based on a ";
+        table_t::printDescription(out);
+        return out;
+    }
+};
+
+/**
+ * A specialization for the case of a 0-arity relation, reusing the default.
+ */
+template <>
+class HashRelation<0> : public AutoRelation<0> {};
+
 // ------------------------------------------------------------------------------------------
 //                              SingleIndexTypeRelation
 // ------------------------------------------------------------------------------------------
@@ -928,6 +1244,153 @@ class SingleIndexTypeRelation<IndexFactory, arity>
 template <template <typename Tuple, typename Index, bool direct> class IndexFactory>
 class SingleIndexTypeRelation<IndexFactory, 0> : public AutoRelation<0> {};
 
+// ------------------------------------------------------------------------------------------
+//                                  FilteredRelation
+// ------------------------------------------------------------------------------------------
+
+/* A utility to obtain the search columns covered by an index. */
+template <typename Index>
+struct column_mask;
+
+template <>
+struct column_mask<index<>> {
+    static constexpr SearchColumns value = 0;
+};
+
+template <unsigned First, unsigned... Rest>
+struct column_mask<index<First, Rest...>> {
+    static constexpr SearchColumns value = (SearchColumns(1) << First) | column_mask<index<Rest...>>::value;
+};
+
+/* A utility to obtain the position of a type within a list of types. */
+template <typename E, typename... List>
+struct position;
+
+template <typename E, typename... Rest>
+struct position<E, E, Rest...> {
+    enum { value = 0 };
+};
+
+template <typename E, typename F, typename... Rest>
+struct position<E, F, Rest...> {
+    enum { value = 1 + position<E, Rest...>::value };
+};
+
+/**
+ * A relation maintaining Bloom filters over the projections of its tuples onto the
+ * given lists of columns on top of the given base relation.
+ *
+ * @tparam Base .. the relation to be decorated
+ * @tparam Filters .. the column lists to be summarized by filters (as index types)
+ */
+template <typename Base, typename... Filters>
+class FilteredRelation : public Base {
+    static_assert(sizeof...(Filters) > 0, "A filtered relation requires at least one filter!");
+
+public:
+    /* The tuple type handled by this relation. */
+    typedef typename Base::tuple_type tuple_type;
+
+    /* The context information to be utilized by operations on this relation. */
+    typedef typename Base::operation_context operation_context;
+
+private:
+    enum { arity = tuple_type::arity };
+
+    /* The filters, built lazily by read-only tests. */
+    std::unique_ptr<RelationFilter> filters[sizeof...(Filters)];
+
+public:
+    FilteredRelation()
+            : filters{std::unique_ptr<RelationFilter>(new RelationFilter(column_mask<Filters>::value))...} {}
+
+    // -- filter tests --
+
+    /**
+     * Tests whether this relation may contain a tuple matching the given tuple on the columns
+     * of the given index. A negative answer is definite. May be conducted concurrently to other
+     * read operations, but not to inserts.
+     */
+    template <typename Index>
+    bool mayContain(const tuple_type& tuple) const {
+        return filters[position<Index, Filters...>::value]->mayContain(
+                &tuple[0], static_cast<const Base&>(*this));
+    }
+
+    template <unsigned... Columns>
+    bool mayContain(const tuple_type& tuple) const {
+        return mayContain<index<Columns...>>(tuple);
+    }
+
+    // -- insert operations updating the filters --
+
+    bool insert(const tuple_type& tuple, operation_context& ctxt) {
+        if (!Base::insert(tuple, ctxt)) return false;
+        for (auto& cur : filters) {
+            cur->insert(&tuple[0]);
+        }
+        return true;
+    }
+
+    bool insert(const tuple_type& tuple) {
+        operation_context ctxt;
+        return insert(tuple, ctxt);
+    }
+
+    bool insert(const RamDomain* ramDomain) {
+        RamDomain data[arity];
+        std::copy(ramDomain, ramDomain + arity, data);
+        return insert(reinterpret_cast<const tuple_type&>(data));
+    }
+
+    template <typename... Args>
+    bool insert(Args... args) {
+        RamDomain data[arity] = {RamDomain(args)...};
+        return insert(reinterpret_cast<const tuple_type&>(data));
+    }
+
+    template <typename Other>
+    void insertAll(const Other& other) {
+        Base::insertAll(other);
+
+        // record the new tuples in all filters which have been built already
+        bool built = false;
+        for (const auto& cur : filters) {
+            built = built || cur->isBuilt();
+        }
+        if (!built) return;
+        for (const auto& tuple : other) {
+            for (auto& cur : filters) {
+                cur->insert(&tuple[0]);
+            }
+        }
+    }
+
+    void purge() {
+        Base::purge();
+        for (auto& cur : filters) {
+            cur->clear();
+        }
+    }
+
+    void truncate() {
+        Base::truncate();
+        for (auto& cur : filters) {
+            cur->clear();
+        }
+    }
+
+    // -- memory usage including the filters --
+
+    std::size_t getMemoryUsage() const {
+        std::size_t res = Base::getMemoryUsage();
+        for (const auto& cur : filters) {
+            res += cur->getMemoryUsage();
+        }
+        return res;
+    }
+};
+
 }  // end of namespace detail
 
 }  // end of namespace ram
@@ -20,7 +20,11 @@
 #include "CompiledRamOptions.h"
 #include "CompiledRamRecord.h"
 #include "CompiledRamRelation.h"
+#include "HashJoinTable.h"
+#include "IOThread.h"
 #include "ParallelUtils.h"
+#include "ProgressReport.h"
+#include "ProfileEvent.h"
 #include "RamLogger.h"
 #include "SignalHandler.h"
 #include "SouffleInterface.h"
@@ -28,8 +32,10 @@
 
 #include <array>
 #include <cmath>
+#include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <regex>
 
 #if defined(_OPENMP)
@@ -62,6 +68,67 @@ private:
     std::array<const char*, Arity> tupleType;
     std::array<const char*, Arity> tupleName;
 
+    // receives the tuples newly inserted through this wrapper
+    std::function<void(const TupleType&)> increment;
+
+    // the lookups supported by indexes of the relation, by their bound columns
+    std::map<SearchColumns, std::function<cursor*(const TupleType&)>> indexes;
+
+    // cursor over a range of tuples, skipping tuples not agreeing with the key on the checked columns
+    template <typename Iter>
+    class range_cursor : public cursor {
+        Iter cur;
+        Iter end;
+        SearchColumns checked;
+        TupleType key;
+
+    public:
+        range_cursor(const Iter& begin, const Iter& end, SearchColumns checked, const TupleType& key)
+                : cur(begin), end(end), checked(checked), key(key) {}
+        std::size_t next(RamDomain* buffer, std::size_t numTuples) override {
+            std::size_t res = 0;
+            for (; res < numTuples && cur != end; ++cur) {
+                const auto& t = *cur;
+                bool matches = true;
+                for (size_t i = 0; i < Arity && matches; i++) {
+                    matches = !((checked >> i) & 1) || t[i] == key[i];
+                }
+                if (matches) {
+                    for (size_t i = 0; i < Arity; i++) {
+                        *buffer++ = t[i];
+                    }
+                    res++;
+                }
+            }
+            return res;
+        }
+    };
+
+    template <typename Iter>
+    static cursor* makeCursor(
+            const Iter& begin, const Iter& end, SearchColumns checked, const TupleType& key) {
+        return new range_cursor<Iter>(begin, end, checked, key);
+    }
+
+    // cursor delivering at most a single tuple
+    class point_cursor : public cursor {
+        TupleType t;
+        bool found;
+
+    public:
+        point_cursor(const TupleType& t, bool found) : t(t), found(found) {}
+        std::size_t next(RamDomain* buffer, std::size_t numTuples) override {
+            if (!found || numTuples == 0) {
+                return 0;
+            }
+            for (size_t i = 0; i < Arity; i++) {
+                buffer[i] = t[i];
+            }
+            found = false;
+            return 1;
+        }
+    };
+
     class iterator_wrapper : public iterator_base {
         typename RelType::iterator it;
         const Relation* relation;
@@ -107,7 +174,59 @@ public:
         for (size_t i = 0; i < Arity; i++) {
             t[i] = arg[i];
         }
-        relation.insert(t);
+        if (relation.insert(t) && increment) {
+            increment(t);
+        }
+    }
+    void insert(const RamDomain* data, std::size_t numTuples) override {
+        // share one operation context, such that sorted tuples benefit from insertion hints
+        CREATE_OP_CONTEXT(ctxt, relation.createContext());
+        TupleType t;
+        for (std::size_t i = 0; i < numTuples; i++, data += Arity) {
+            for (size_t j = 0; j < Arity; j++) {
+                t[j] = data[j];
+            }
+            if (relation.insert(t, READ_OP_CONTEXT(ctxt)) && increment) {
+                increment(t);
+            }
+        }
+    }
+    void purge() override {
+        // the relation is expected to be refilled, thus the memory of its tuples is retained where
+        // supported by its representation
+        relation.truncate();
+    }
+    void setIncrement(const std::function<void(const TupleType&)>& fn) {
+        increment = fn;
+    }
+    template <unsigned... Columns>
+    void addIndex() {
+        SearchColumns columns = 0;
+        for (unsigned i : {Columns...}) {
+            columns |= SearchColumns(1) << i;
+        }
+        indexes[columns] = [this](const TupleType& key) -> cursor* {
+            auto range = relation.template equalRange<Columns...>(key);
+            return makeCursor(range.begin(), range.end(), 0, key);
+        };
+    }
+    bool hasIndex(SearchColumns columns) const override {
+        return columns == 0 || columns == (SearchColumns(1) << Arity) - 1 || indexes.count(columns);
+    }
+    std::unique_ptr<cursor> lookup(SearchColumns columns, const RamDomain* key) const override {
+        TupleType t;
+        for (size_t i = 0; i < Arity; i++) {
+            t[i] = key[i];
+        }
+        // all columns bound: a point query
+        if (columns == (SearchColumns(1) << Arity) - 1) {
+            return std::unique_ptr<cursor>(new point_cursor(t, relation.contains(t)));
+        }
+        auto pos = indexes.find(columns);
+        if (pos != indexes.end()) {
+            return std::unique_ptr<cursor>(pos->second(t));
+        }
+        return std::unique_ptr<cursor>(makeCursor(relation.begin(), relation.end(), columns, t));
     }
     bool contains(const tuple& arg) const {
         TupleType t;
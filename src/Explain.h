@@ -18,7 +18,6 @@
 
 #include <csignal>
 #include <iostream>
-#include <regex>
 #include <string>
 #include <ncurses.h>
 
@@ -301,64 +300,31 @@ struct elements {
 };
 const elements defaultElement = elements(std::vector<std::string>({"DEFAULT"}));
 
-// store provenance information as maps
+// look up provenance information in the annotation relations of the program, where the tuples of
+// the output and provenance relations are identified by their label in the first column
 class ProvenanceInfo {
 private:
     SouffleProgram& prog;
 
-    std::map<std::pair<std::string, elements>, plabel> valuesToLabel;
-    std::map<std::pair<std::string, plabel>, elements> labelToValue;
-    std::map<std::pair<std::string, plabel>, std::vector<plabel>> labelToProof;
+    // the provenance relations of each relation, one for each of its rules
+    std::map<std::string, std::vector<std::string>> provenanceRelations;
     std::map<std::string, std::vector<std::string>> info;
     std::map<std::pair<std::string, int>, std::string> rule;
 
+    // the tuples of relations without an index on the looked up columns, by the values of these
+    // columns; the tuples of a relation are only loaded when it is first looked up
+    typedef std::map<std::vector<RamDomain>, std::vector<RamDomain>> TupleMap;
+    std::map<std::pair<const Relation*, SearchColumns>, TupleMap> loaded;
+
     void load() {
         for (Relation* rel : prog.getAllRelations()) {
             std::string relName = rel->getName();
 
-            for (auto& tuple : *rel) {
-                plabel label;
-
-                if (relName.find("-output") != std::string::npos) {
-                    elements tuple_elements;
-                    tuple >> label;
-
-                    // construct tuple elements
-                    for (size_t i = 1; i < tuple.size(); i++) {
-                        if (*(rel->getAttrType(i)) == 'i' || *(rel->getAttrType(i)) == 'r') {
-                            plabel n;
-                            tuple >> n;
-                            tuple_elements.insert(n);
-                        } else if (*(rel->getAttrType(i)) == 's') {
-                            std::string s;
-                            tuple >> s;
-                            tuple_elements.insert(s);
-                        }
-                    }
-
-                    // insert into maps
-                    valuesToLabel.insert({std::make_pair(rel->getName(), tuple_elements), label});
-                    labelToValue.insert({std::make_pair(rel->getName(), label), tuple_elements});
-                } else if (relName.find("-provenance-") != std::string::npos) {
-                    std::vector<plabel> refs;
-                    tuple >> label;
-
-                    // construct vector of proof references
-                    for (size_t i = 1; i < tuple.size(); i++) {
-                        if (*(rel->getAttrType(i)) == 'i' || *(rel->getAttrType(i)) == 'r') {
-                            plabel n;
-                            tuple >> n;
-                            refs.push_back(n);
-                        } else if (*(rel->getAttrType(i)) == 's') {
-                            std::string s;
-                            tuple >> s;
-                            // insert placeholder to refs
-                            refs.push_back(-1);
-                        }
-                    }
-
-                    labelToProof.insert({std::make_pair(rel->getName(), label), refs});
-                } else if (relName.find("-info") != std::string::npos) {
+            size_t pos = relName.find("-provenance-");
+            if (pos != std::string::npos) {
+                provenanceRelations[relName.substr(0, pos)].push_back(relName);
+            } else if (relName.find("-info") != std::string::npos) {
+                for (auto& tuple : *rel) {
                     std::vector<std::string> rels;
                     for (size_t i = 0; i < tuple.size() - 2; i++) {
                         std::string s;
@@ -384,42 +350,133 @@ private:
         }
     }
 
+    // find a tuple agreeing with the key on the given columns, preferring an index of the relation
+    bool find(const Relation& rel, SearchColumns columns, const std::vector<RamDomain>& key,
+            std::vector<RamDomain>& tuple) {
+        const size_t arity = rel.getArity();
+        tuple.resize(arity);
+        if (rel.hasIndex(columns)) {
+            return rel.lookup(columns, key.data())->next(tuple.data(), 1) == 1;
+        }
+
+        auto pos = loaded.find(std::make_pair(&rel, columns));
+        if (pos == loaded.end()) {
+            pos = loaded.emplace(std::make_pair(&rel, columns), TupleMap()).first;
+            std::unique_ptr<Relation::cursor> all = rel.lookup(0, key.data());
+            std::vector<RamDomain> buffer(arity);
+            while (all->next(buffer.data(), 1) == 1) {
+                pos->second.emplace(project(buffer, columns), buffer);
+            }
+        }
+        auto res = pos->second.find(project(key, columns));
+        if (res == pos->second.end()) {
+            return false;
+        }
+        tuple = res->second;
+        return true;
+    }
+
+    // the values of the given columns of a tuple
+    static std::vector<RamDomain> project(const std::vector<RamDomain>& tuple, SearchColumns columns) {
+        std::vector<RamDomain> res;
+        for (size_t i = 0; i < tuple.size(); i++) {
+            if ((columns >> i) & 1) {
+                res.push_back(tuple[i]);
+            }
+        }
+        return res;
+    }
+
+    // a key binding the label column of a relation
+    static std::vector<RamDomain> getLabelKey(const Relation& rel, plabel l) {
+        std::vector<RamDomain> key(rel.getArity(), 0);
+        key[0] = l;
+        return key;
+    }
+
 public:
     ProvenanceInfo(SouffleProgram& p) : prog(p) {
         load();
     }
 
     plabel getLabel(std::string relName, elements e) {
-        auto key = std::make_pair(relName, e);
+        Relation* rel = prog.getRelation(relName);
+        if (rel == nullptr || rel->getArity() != e.order.size() + 1) {
+            return -1;
+        }
 
-        if (valuesToLabel.find(key) != valuesToLabel.end()) {
-            return valuesToLabel[key];
-        } else {
+        // the values of the tuple in all but the label column
+        const size_t arity = rel->getArity();
+        std::vector<RamDomain> key(arity, 0);
+        auto i_itr = e.integers.begin();
+        auto s_itr = e.strings.begin();
+        for (size_t i = 1; i < arity; i++) {
+            char type = *(rel->getAttrType(i));
+            if ((type == 'i' || type == 'r') && e.order[i - 1] == 'i') {
+                key[i] = *(i_itr++);
+            } else if (type == 's' && e.order[i - 1] == 's') {
+                // a symbol not in the table is not part of any tuple, and is not to be added by queries
+                size_t symbol;
+                if (!rel->getSymbolTable().find((s_itr++)->c_str(), symbol)) {
+                    return -1;
+                }
+                key[i] = symbol;
+            } else {
+                return -1;
+            }
+        }
+
+        std::vector<RamDomain> tuple;
+        if (!find(*rel, ((SearchColumns(1) << arity) - 1) & ~SearchColumns(1), key, tuple)) {
             return -1;
         }
+        return tuple[0];
     }
 
     elements getTuple(std::string relName, plabel l) {
-        auto key = std::make_pair(relName, l);
-
-        if (labelToValue.find(key) != labelToValue.end()) {
-            return labelToValue[key];
-        } else {
+        Relation* rel = prog.getRelation(relName);
+        std::vector<RamDomain> tuple;
+        if (rel == nullptr || !find(*rel, 1, getLabelKey(*rel, l), tuple)) {
             return defaultElement;
         }
+
+        // construct tuple elements
+        elements tuple_elements;
+        for (size_t i = 1; i < tuple.size(); i++) {
+            if (*(rel->getAttrType(i)) == 'i' || *(rel->getAttrType(i)) == 'r') {
+                tuple_elements.insert(tuple[i]);
+            } else if (*(rel->getAttrType(i)) == 's') {
+                tuple_elements.insert(std::string(rel->getSymbolTable().resolve(tuple[i])));
+            }
+        }
+        return tuple_elements;
     }
 
     std::vector<plabel> getSubproofs(std::string relName, plabel l) {
-        auto key = std::make_pair(relName, l);
-
-        if (labelToProof.find(key) != labelToProof.end()) {
-            return labelToProof[key];
-        } else {
+        Relation* rel = prog.getRelation(relName);
+        std::vector<RamDomain> tuple;
+        if (rel == nullptr || !find(*rel, 1, getLabelKey(*rel, l), tuple)) {
             return std::vector<plabel>();
         }
+
+        // construct vector of proof references
+        std::vector<plabel> refs;
+        for (size_t i = 1; i < tuple.size(); i++) {
+            if (*(rel->getAttrType(i)) == 'i' || *(rel->getAttrType(i)) == 'r') {
+                refs.push_back(tuple[i]);
+            } else if (*(rel->getAttrType(i)) == 's') {
+                // insert placeholder to refs
+                refs.push_back(-1);
+            }
+        }
+        return refs;
+    }
+
+    const std::vector<std::string>& getProvenanceRelations(std::string relName) {
+        return provenanceRelations[relName];
     }
 
-    std::vector<std::string> getInfo(std::string relName) {
+    const std::vector<std::string>& getInfo(std::string relName) {
         assert(info.find(relName) != info.end());
         return info[relName];
     }
@@ -443,18 +500,9 @@ private:
     int depthLimit;
 
     std::unique_ptr<TreeNode> explainLabel(std::string relName, plabel label, int depth) {
-        bool isEDB = true;
-        bool found = false;
-        for (auto rel : prog.getAllRelations()) {
-            if (rel->getName().find(relName) != std::string::npos) {
-                found = true;
-            }
-            std::regex provRelName(relName + "-provenance-[0-9]+", std::regex_constants::extended);
-            if (std::regex_match(rel->getName(), provRelName)) {
-                isEDB = false;
-                break;
-            }
-        }
+        const std::vector<std::string>& provRelNames = provInfo.getProvenanceRelations(relName);
+        bool isEDB = provRelNames.empty();
+        bool found = prog.getRelation(relName) != nullptr || prog.getRelation(relName + "-output") != nullptr;
 
         // check that relation is in the program
         if (!found) {
@@ -468,16 +516,16 @@ private:
         } else {
             if (depth > 1) {
                 std::string internalRelName;
+                std::vector<plabel> subproofs;
 
                 // find correct relation
-                for (auto rel : prog.getAllRelations()) {
-                    if (rel->getName().find(relName + "-provenance-") != std::string::npos) {
-                        // if relation contains the correct tuple label
-                        if (provInfo.getSubproofs(rel->getName(), label) != std::vector<plabel>()) {
-                            // found the correct relation
-                            internalRelName = rel->getName();
-                            break;
-                        }
+                for (const std::string& provRelName : provRelNames) {
+                    // if relation contains the correct tuple label
+                    subproofs = provInfo.getSubproofs(provRelName, label);
+                    if (!subproofs.empty()) {
+                        // found the correct relation
+                        internalRelName = provRelName;
+                        break;
                     }
                 }
 
@@ -503,12 +551,13 @@ private:
                 std::string infoKey = relName + "-info-" + ruleNum;
 
                 // recursively add all provenance values for this value
-                for (size_t i = 0; i < provInfo.getInfo(infoKey).size(); i++) {
-                    auto rel = provInfo.getInfo(infoKey)[i];
-                    if (std::regex_match(rel, std::regex("negated_.*"))) {
+                const std::vector<std::string>& rels = provInfo.getInfo(infoKey);
+                for (size_t i = 0; i < rels.size(); i++) {
+                    const std::string& rel = rels[i];
+                    if (rel.compare(0, 8, "negated_") == 0) {
                         inner->add_child(std::unique_ptr<TreeNode>(new LeafNode(rel)));
                     } else {
-                        auto newLab = provInfo.getSubproofs(internalRelName, label)[i];
+                        auto newLab = subproofs[i];
                         assert(newLab != -1 && "subproof refers to negation");
                         inner->add_child(explainLabel(rel, newLab, depth - 1));
                     }
@@ -721,7 +770,9 @@ public:
                 prefresh(treePad, 0, 0, 0, 0, maxy - 3, maxx - 1);
             } else {
                 std::cout << "Enter command > ";
-                getline(std::cin, line);
+                if (!getline(std::cin, line)) {
+                    break;
+                }
             }
 
             std::vector<std::string> command = split(line, ' ', 1);
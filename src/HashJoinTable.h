@@ -0,0 +1,252 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file HashJoinTable.h
+ *
+ * A temporary hash table over the tuples of a relation, keyed by a subset
+ * of its columns. It is built once before the evaluation of a query and
+ * probed by its hash-join operations instead of an ordered index.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "HashSet.h"
+#include "RamTypes.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * A chained hash table mapping the projection of tuples onto a set of key columns
+ * to the tuples themselves. The tuples are copied into the table, such that the
+ * relation it has been built from may be of any representation.
+ *
+ * Once built, the table may be probed concurrently.
+ */
+class HashJoinTable {
+    // the end-of-chain marker
+    static const std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+    // the arity of the stored tuples
+    const std::size_t arity;
+
+    // the key columns
+    const SearchColumns columns;
+
+    // the stored tuples, one after another
+    std::vector<RamDomain> data;
+
+    // the successor of each tuple within the chain of its bucket
+    std::vector<std::size_t> next;
+
+    // the first tuple of each bucket
+    std::unique_ptr<std::atomic<std::size_t>[]> buckets;
+
+    // the number of buckets - 1, the number of buckets is a power of 2
+    std::size_t mask;
+
+public:
+    /**
+     * An iterator enumerating the tuples of a bucket matching a given key.
+     */
+    class iterator : public std::iterator<std::forward_iterator_tag, const RamDomain*> {
+        const HashJoinTable* table;
+        const RamDomain* key;
+        std::size_t cur;
+
+    public:
+        iterator() : table(nullptr), key(nullptr), cur(NONE) {}
+
+        iterator(const HashJoinTable* table, const RamDomain* key, std::size_t pos)
+                : table(table), key(key), cur(pos) {
+            skip();
+        }
+
+        bool operator==(const iterator& other) const {
+            return cur == other.cur;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+
+        const RamDomain* operator*() const {
+            return &table->data[cur * table->arity];
+        }
+
+        iterator& operator++() {
+            cur = table->next[cur];
+            skip();
+            return *this;
+        }
+
+    private:
+        /* Moves forward to the next tuple matching the key. */
+        void skip() {
+            while (cur != NONE && !table->matches(&table->data[cur * table->arity], key)) {
+                cur = table->next[cur];
+            }
+        }
+    };
+
+    HashJoinTable(std::size_t arity, SearchColumns columns)
+            : arity(arity), columns(columns), buckets(new std::atomic<std::size_t>[1]), mask(0) {
+        buckets[0].store(NONE, std::memory_order_relaxed);
+    }
+
+    HashJoinTable(const HashJoinTable&) = delete;
+    HashJoinTable& operator=(const HashJoinTable&) = delete;
+
+    /** Obtains the number of tuples stored in this table. */
+    std::size_t size() const {
+        return next.size();
+    }
+
+    bool empty() const {
+        return next.empty();
+    }
+
+    /**
+     * Fills this table with the tuples of the given relation. Tuples are copied
+     * in parallel if the relation can be partitioned, and they are hashed and
+     * linked into their buckets in parallel.
+     */
+    template <typename Relation>
+    void build(const Relation& rel) {
+        // copy tuples
+        data.clear();
+        copy(rel, 0);
+        const std::size_t n = (arity == 0) ? 0 : data.size() / arity;
+
+        // allocate twice as many buckets as there are tuples
+        std::size_t numBuckets = 16;
+        while (numBuckets < 2 * n) {
+            numBuckets <<= 1;
+        }
+        mask = numBuckets - 1;
+        buckets.reset(new std::atomic<std::size_t>[numBuckets]);
+        for (std::size_t i = 0; i < numBuckets; ++i) {
+            buckets[i].store(NONE, std::memory_order_relaxed);
+        }
+
+        // link tuples into buckets
+        next.resize(n);
+#pragma omp parallel for
+        for (std::size_t i = 0; i < n; ++i) {
+            auto& head = buckets[hash(&data[i * arity]) & mask];
+            next[i] = head.exchange(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Obtains the range of tuples matching the given key on the key columns. The key
+     * has to remain valid while the range is being iterated over.
+     */
+    range<iterator> lookup(const RamDomain* key) const {
+        const std::size_t head = buckets[hash(key) & mask].load(std::memory_order_relaxed);
+        return make_range(iterator(this, key, head), iterator());
+    }
+
+    template <typename Tuple>
+    range<iterator> lookup(const Tuple& key) const {
+        return lookup(&key[0]);
+    }
+
+    /* The range refers to the key, which thus must not be a temporary. */
+    template <typename Tuple>
+    range<iterator> lookup(const Tuple&& key) const = delete;
+
+    /** Obtains the amount of memory occupied by this table in bytes. */
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this) + data.capacity() * sizeof(RamDomain) + next.capacity() * sizeof(std::size_t) +
+               (mask + 1) * sizeof(std::atomic<std::size_t>);
+    }
+
+private:
+    static const RamDomain* getData(const RamDomain* tuple) {
+        return tuple;
+    }
+
+    template <typename Tuple>
+    static const RamDomain* getData(const Tuple& tuple) {
+        return &tuple[0];
+    }
+
+    /* Copies the tuples of a relation which can be partitioned, one partition per thread. */
+    template <typename Relation>
+    auto copy(const Relation& rel, int) -> decltype(rel.partition(), void()) {
+        auto chunks = rel.partition();
+        std::vector<std::vector<RamDomain>> parts(chunks.size());
+#pragma omp parallel for schedule(dynamic)
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            for (const auto& cur : chunks[i]) {
+                const RamDomain* tuple = getData(cur);
+                parts[i].insert(parts[i].end(), tuple, tuple + arity);
+            }
+        }
+
+        // concatenate the partitions
+        std::vector<std::size_t> offsets(parts.size() + 1, 0);
+        for (std::size_t i = 0; i < parts.size(); ++i) {
+            offsets[i + 1] = offsets[i] + parts[i].size();
+        }
+        data.resize(offsets.back());
+#pragma omp parallel for
+        for (std::size_t i = 0; i < parts.size(); ++i) {
+            std::copy(parts[i].begin(), parts[i].end(), data.begin() + offsets[i]);
+        }
+    }
+
+    /* Copies the tuples of any other relation. */
+    template <typename Relation>
+    void copy(const Relation& rel, long) {
+        data.reserve(rel.size() * arity);
+        for (const auto& cur : rel) {
+            const RamDomain* tuple = getData(cur);
+            data.insert(data.end(), tuple, tuple + arity);
+        }
+    }
+
+    /* Computes the hash of the key columns of the given tuple. */
+    uint64_t hash(const RamDomain* tuple) const {
+        typedef typename std::make_unsigned<RamDomain>::type value_t;
+        uint64_t h = 0;
+        SearchColumns cols = columns;
+        for (std::size_t i = 0; cols != 0; ++i, cols >>= 1) {
+            if (cols & 1) {
+                h = detail::hash_mix(h + uint64_t(value_t(tuple[i])));
+            }
+        }
+        return h;
+    }
+
+    /* Determines whether the given tuple agrees with the given key on all key columns. */
+    bool matches(const RamDomain* tuple, const RamDomain* key) const {
+        SearchColumns cols = columns;
+        for (std::size_t i = 0; cols != 0; ++i, cols >>= 1) {
+            if ((cols & 1) && tuple[i] != key[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+}  // end namespace souffle
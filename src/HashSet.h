@@ -0,0 +1,500 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file HashSet.h
+ *
+ * An implementation of a concurrent, open-addressing hash set for
+ * trivially copyable keys (e.g. tuples) supporting concurrent inserts,
+ * lock-free membership tests and partitioned iteration.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ParallelUtils.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+
+namespace detail {
+
+/**
+ * A finalizer spreading the bits of a hash value over the full word
+ * (taken from MurmurHash3). Hash functions like std::hash<int> are the
+ * identity, which causes long probe sequences for dense keys otherwise.
+ */
+inline std::size_t hash_mix(std::size_t h) {
+    uint64_t k = h;
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return static_cast<std::size_t>(k);
+}
+
+}  // namespace detail
+
+/**
+ * A concurrent hash set based on open addressing with linear probing.
+ *
+ * Inserts may be conducted concurrently and are only blocked while the
+ * table is being grown. Membership tests are lock-free. Iteration and
+ * partitioning must not be conducted concurrently to inserts.
+ *
+ * Tables replaced while growing are retained until the set is cleared, such
+ * that concurrent readers never access released memory. Due to the geometric
+ * growth those retired tables never require more memory than the active one.
+ *
+ * @tparam Key .. the element type, required to be default constructible and copyable
+ * @tparam Hash .. the hash function for keys
+ * @tparam Equal .. the equality predicate for keys
+ */
+template <typename Key, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>>
+class HashSet {
+    // the states of a slot
+    enum : uint8_t { EMPTY = 0, BUSY = 1, FULL = 2 };
+
+    // the initial number of slots of a table (a power of two)
+    static const std::size_t INITIAL_CAPACITY = 16;
+
+    /* A single cell of the hash table. */
+    struct Slot {
+        std::atomic<uint8_t> state;
+        Key key;
+        Slot() : state(EMPTY) {}
+    };
+
+    /* A table of slots, sized by a power of two. */
+    struct Table {
+        std::size_t capacity;
+        std::unique_ptr<Slot[]> slots;
+        Table(std::size_t capacity) : capacity(capacity), slots(new Slot[capacity]) {}
+
+        // the maximal number of elements before the table needs to grow (load factor 3/4)
+        std::size_t limit() const {
+            return capacity - (capacity >> 2);
+        }
+    };
+
+public:
+    typedef Key key_type;
+    typedef Key value_type;
+    typedef std::size_t size_type;
+
+    /* Hash sets do not benefit from operation hints, this is for interface compatibility. */
+    struct operation_hints {};
+
+    /**
+     * The iterator type for hash sets, visiting all occupied slots of a
+     * section of the table.
+     */
+    class iterator : public std::iterator<std::forward_iterator_tag, Key> {
+        const Slot* cur;
+        const Slot* end;
+
+    public:
+        iterator(const Slot* cur = nullptr, const Slot* end = nullptr) : cur(cur), end(end) {
+            forward();
+        }
+
+        iterator(const iterator&) = default;
+        iterator& operator=(const iterator&) = default;
+
+        bool operator==(const iterator& other) const {
+            return cur == other.cur;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return cur != other.cur;
+        }
+
+        const Key& operator*() const {
+            return cur->key;
+        }
+
+        const Key* operator->() const {
+            return &cur->key;
+        }
+
+        iterator& operator++() {
+            ++cur;
+            forward();
+            return *this;
+        }
+
+    private:
+        // moves the iterator to the next occupied slot
+        void forward() {
+            while (cur != end && cur->state.load(std::memory_order_relaxed) != FULL) {
+                ++cur;
+            }
+        }
+    };
+
+    typedef iterator const_iterator;
+
+    typedef range<iterator> chunk;
+
+private:
+    // the currently active table
+    std::atomic<Table*> table;
+
+    // all tables allocated by this set (the active one and retired ones)
+    std::vector<std::unique_ptr<Table>> tables;
+
+    // the number of elements (including reservations of in-flight inserts)
+    std::atomic<std::size_t> numElements;
+
+    // inserts share this lock, growing the table requires exclusive access
+    ReadWriteLock lock{LockSite::hashSet};
+
+    Hash hash;
+    Equal equal;
+
+public:
+    HashSet() : numElements(0) {
+        reset(INITIAL_CAPACITY);
+    }
+
+    HashSet(const HashSet& other) : HashSet() {
+        insertAll(other);
+    }
+
+    HashSet& operator=(const HashSet& other) {
+        if (this != &other) {
+            clear();
+            insertAll(other);
+        }
+        return *this;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    size_type size() const {
+        return numElements.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Inserts the given key into this set.
+     *
+     * @return true if the key was not present before, false otherwise
+     */
+    bool insert(const Key& key) {
+        operation_hints hints;
+        return insert(key, hints);
+    }
+
+    /**
+     * Inserts the given key into this set. This operation may be
+     * conducted concurrently to other inserts and lookups.
+     *
+     * @return true if the key was not present before, false otherwise
+     */
+    bool insert(const Key& key, operation_hints&) {
+        return insertInternal(key, [](Key&) {}).second;
+    }
+
+    /**
+     * Locates the element equal to the given key, inserting it if not present.
+     * On insertion, the given initializer is applied to the stored copy of the
+     * key before it becomes visible to any other thread. In combination with a
+     * hash function and equality predicate considering only a part of the key,
+     * this enables the set to be utilized as a concurrent map.
+     *
+     * @return a reference to the stored element, valid until the set is cleared
+     */
+    template <typename Init>
+    const Key& findOrInsert(const Key& key, const Init& init) {
+        auto pos = find(key);
+        if (pos != end()) {
+            return *pos;
+        }
+        return *insertInternal(key, init).first;
+    }
+
+    /**
+     * Inserts all elements of the given range into this set.
+     */
+    template <typename Iter>
+    void insert(const Iter& a, const Iter& b) {
+        operation_hints hints;
+        for (Iter cur = a; cur != b; ++cur) {
+            insert(*cur, hints);
+        }
+    }
+
+    /**
+     * Inserts all elements of the given set into this set.
+     */
+    void insertAll(const HashSet& other) {
+        reserve(size() + other.size());
+        insert(other.begin(), other.end());
+    }
+
+    /**
+     * Determines whether the given key is a member of this set. This operation
+     * is lock-free and may be conducted concurrently to inserts.
+     */
+    bool contains(const Key& key) const {
+        return find(key) != end();
+    }
+
+    bool contains(const Key& key, operation_hints&) const {
+        return contains(key);
+    }
+
+    /**
+     * Locates the given key within this set. If not present, an end-iterator
+     * will be returned.
+     */
+    iterator find(const Key& key) const {
+        const Table* t = table.load(std::memory_order_acquire);
+        const std::size_t mask = t->capacity - 1;
+        for (std::size_t i = detail::hash_mix(hash(key)) & mask;; i = (i + 1) & mask) {
+            const Slot& slot = t->slots[i];
+            uint8_t state = slot.state.load(std::memory_order_acquire);
+            if (state == EMPTY) {
+                return end();
+            }
+            while (state == BUSY) {
+                state = slot.state.load(std::memory_order_acquire);
+            }
+            // the insert into this slot has been abandoned
+            if (state == EMPTY) {
+                return end();
+            }
+            if (equal(slot.key, key)) {
+                // the element is also present in the active table => point there
+                return (t == table.load(std::memory_order_acquire)) ? iterator(&slot, slot_end(t))
+                                                                    : find(key);
+            }
+        }
+    }
+
+    iterator find(const Key& key, operation_hints&) const {
+        return find(key);
+    }
+
+    /**
+     * Makes sure that the given number of elements can be inserted without
+     * growing the underlying table.
+     */
+    void reserve(std::size_t n) {
+        Table* t = table.load(std::memory_order_acquire);
+        std::size_t capacity = t->capacity;
+        while (capacity - (capacity >> 2) < n) {
+            capacity *= 2;
+        }
+        if (capacity != t->capacity) {
+            grow(t, capacity);
+        }
+    }
+
+    iterator begin() const {
+        const Table* t = table.load(std::memory_order_acquire);
+        return iterator(&t->slots[0], slot_end(t));
+    }
+
+    iterator end() const {
+        const Table* t = table.load(std::memory_order_acquire);
+        return iterator(slot_end(t), slot_end(t));
+    }
+
+    /**
+     * Partitions the elements of this set into up to the given number of
+     * non-empty chunks by splitting the underlying table into slot ranges
+     * of equal length.
+     */
+    std::vector<chunk> getChunks(size_type num) const {
+        std::vector<chunk> res;
+        const Table* t = table.load(std::memory_order_acquire);
+        const Slot* last = slot_end(t);
+        const std::size_t step = std::max<std::size_t>(1, t->capacity / std::max<size_type>(1, num));
+        for (std::size_t i = 0; i < t->capacity; i += step) {
+            const Slot* a = &t->slots[i];
+            const Slot* b = (i + step < t->capacity) ? &t->slots[i + step] : last;
+            iterator begin(a, b);
+            if (begin != iterator(b, b)) {
+                res.push_back(make_range(iterator(a, last), iterator(b, last)));
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Removes all elements from this set and releases all retired tables.
+     * Must not be conducted concurrently to any other operation.
+     */
+    void clear() {
+        reset(INITIAL_CAPACITY);
+    }
+
+    /**
+     * Removes all elements from this set, retaining the active table for
+     * subsequent inserts. Must not be conducted concurrently to any other operation.
+     */
+    void truncate() {
+        Table* cur = table.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < cur->capacity; ++i) {
+            cur->slots[i].state.store(EMPTY, std::memory_order_relaxed);
+        }
+        tables.erase(std::remove_if(tables.begin(), tables.end(),
+                             [&](const std::unique_ptr<Table>& t) { return t.get() != cur; }),
+                tables.end());
+        numElements.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * Obtains the amount of memory occupied by this set in bytes.
+     */
+    size_type getMemoryUsage() const {
+        size_type res = sizeof(*this);
+        for (const auto& cur : tables) {
+            res += sizeof(Table) + cur->capacity * sizeof(Slot);
+        }
+        return res;
+    }
+
+    void printStats(std::ostream& out = std::cout) const {
+        const Table* t = table.load(std::memory_order_acquire);
+        out << "---------------------------------\n";
+        out << "  Hash-Set Stats\n";
+        out << "---------------------------------\n";
+        out << "  Elements: " << size() << "\n";
+        out << "  Capacity: " << t->capacity << "\n";
+        out << "  Load-Factor: " << (size() / (double)t->capacity) << "\n";
+        out << "  Retired Tables: " << (tables.size() - 1) << "\n";
+        out << "  Memory Usage: " << (getMemoryUsage() / 1024.0 / 1024.0) << "MB\n";
+        out << "---------------------------------\n";
+    }
+
+private:
+    /**
+     * Inserts the given key unless already present. The initializer is applied
+     * to newly created elements before they are published.
+     *
+     * @return a pointer to the stored element and whether it has been inserted
+     */
+    template <typename Init>
+    std::pair<const Key*, bool> insertInternal(const Key& key, const Init& init) {
+        const std::size_t h = detail::hash_mix(hash(key));
+        while (true) {
+            lock.start_read();
+            Table* t = table.load(std::memory_order_relaxed);
+
+            // reserve space for the new element - grow the table if necessary
+            if (numElements.fetch_add(1, std::memory_order_relaxed) >= t->limit()) {
+                numElements.fetch_sub(1, std::memory_order_relaxed);
+                lock.end_read();
+                grow(t, t->capacity * 2);
+                continue;
+            }
+
+            const std::size_t mask = t->capacity - 1;
+            for (std::size_t i = h & mask;; i = (i + 1) & mask) {
+                Slot& slot = t->slots[i];
+                uint8_t state = slot.state.load(std::memory_order_acquire);
+
+                // try to claim an empty slot
+                if (state == EMPTY &&
+                        slot.state.compare_exchange_strong(state, BUSY, std::memory_order_acquire)) {
+                    try {
+                        slot.key = key;
+                        init(slot.key);
+                    } catch (...) {
+                        // release the slot and the table, such that other threads do not wait forever
+                        slot.state.store(EMPTY, std::memory_order_release);
+                        numElements.fetch_sub(1, std::memory_order_relaxed);
+                        lock.end_read();
+                        throw;
+                    }
+                    slot.state.store(FULL, std::memory_order_release);
+                    lock.end_read();
+                    return std::make_pair(&slot.key, true);
+                }
+
+                // wait for concurrent inserts into this slot to complete
+                while (state == BUSY) {
+                    state = slot.state.load(std::memory_order_acquire);
+                }
+
+                // the concurrent insert has been abandoned => try to claim the slot again
+                if (state == EMPTY) {
+                    i = (i - 1) & mask;
+                    continue;
+                }
+
+                // check whether the key is already present
+                if (equal(slot.key, key)) {
+                    numElements.fetch_sub(1, std::memory_order_relaxed);
+                    lock.end_read();
+                    return std::make_pair(&slot.key, false);
+                }
+            }
+        }
+    }
+
+    static const Slot* slot_end(const Table* t) {
+        return &t->slots[0] + t->capacity;
+    }
+
+    /* Resets this set to an empty table of the given capacity. */
+    void reset(std::size_t capacity) {
+        tables.clear();
+        tables.emplace_back(new Table(capacity));
+        table.store(tables.back().get(), std::memory_order_release);
+        numElements.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * Replaces the given table by a table of the given capacity unless
+     * some other thread has done so already.
+     */
+    void grow(Table* old, std::size_t capacity) {
+        lock.start_write();
+        if (table.load(std::memory_order_relaxed) == old) {
+            // re-hash all elements into the new table (no concurrent writes are possible)
+            std::unique_ptr<Table> next(new Table(capacity));
+            const std::size_t mask = capacity - 1;
+            for (std::size_t j = 0; j < old->capacity; ++j) {
+                const Slot& cur = old->slots[j];
+                if (cur.state.load(std::memory_order_relaxed) != FULL) {
+                    continue;
+                }
+                std::size_t i = detail::hash_mix(hash(cur.key)) & mask;
+                while (next->slots[i].state.load(std::memory_order_relaxed) != EMPTY) {
+                    i = (i + 1) & mask;
+                }
+                next->slots[i].key = cur.key;
+                next->slots[i].state.store(FULL, std::memory_order_relaxed);
+            }
+
+            // publish the new table, retaining the old one for concurrent readers
+            tables.push_back(std::move(next));
+            table.store(tables.back().get(), std::memory_order_release);
+        }
+        lock.end_write();
+    }
+};
+
+}  // end namespace souffle
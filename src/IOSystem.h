@@ -27,9 +27,12 @@
 #include "WriteStreamSQLite.h"
 #endif
 
+#include <exception>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace souffle {
 
@@ -87,4 +90,73 @@ private:
     std::map<std::string, std::shared_ptr<ReadStreamFactory>> inputFactories;
 };
 
+/**
+ * Loads a set of input relations concurrently. The inputs are read in parallel, each stream
+ * entering its symbols into a private table. Those are merged into the shared symbol table in
+ * the order the inputs have been added, such that symbols obtain the same indices as if the
+ * inputs were read one after another.
+ */
+class InputLoader {
+    struct Input {
+        SymbolMask symbolMask;
+        SymbolTable& symbolTable;
+        IODirectives ioDirectives;
+        std::function<void(ReadStream&)> insert;
+    };
+
+    std::vector<std::unique_ptr<Input>> inputs;
+
+public:
+    /** Registers an input to be read into the given relation. */
+    template <typename T>
+    void add(const SymbolMask& symbolMask, SymbolTable& symbolTable, const IODirectives& ioDirectives,
+            T& relation) {
+        inputs.emplace_back(new Input{symbolMask, symbolTable, ioDirectives,
+                [&relation](ReadStream& reader) { reader.insertAll(relation); }});
+    }
+
+    /**
+     * Reads all registered inputs. If some inputs fail, the error of the first of them is
+     * re-thrown once all inputs have been processed.
+     */
+    void run() {
+        std::vector<std::exception_ptr> errors(inputs.size());
+#pragma omp parallel for schedule(dynamic) ordered
+        for (size_t i = 0; i < inputs.size(); i++) {
+            Input& input = *inputs[i];
+            std::unique_ptr<ReadStream> reader;
+            try {
+                reader = IOSystem::getInstance().getReader(
+                        input.symbolMask, input.symbolTable, input.ioDirectives);
+                reader->fetchAll();
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+
+            // merge symbols in order of the inputs
+#pragma omp ordered
+            {
+                if (!errors[i]) {
+                    reader->internSymbols();
+                }
+            }
+
+            if (!errors[i]) {
+                try {
+                    input.insert(*reader);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            }
+        }
+        inputs.clear();
+
+        for (const auto& cur : errors) {
+            if (cur) {
+                std::rethrow_exception(cur);
+            }
+        }
+    }
+};
+
 } /* namespace souffle */
@@ -0,0 +1,126 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file IOThread.h
+ *
+ * A background thread conducting I/O operations, e.g. the writing of
+ * output relations, while the evaluation of a program continues.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <deque>
+#include <functional>
+
+#ifdef _OPENMP
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace souffle {
+
+#ifdef _OPENMP
+
+/**
+ * A single background thread processing submitted tasks in the order of their submission.
+ * The thread is started by the first submission. Destroying an IOThread waits for all
+ * submitted tasks to be completed.
+ */
+class IOThread {
+    // the tasks still to be processed
+    std::deque<std::function<void()>> tasks;
+
+    // the number of tasks submitted but not completed
+    std::size_t pending;
+
+    // set once no further tasks will be submitted
+    bool shutdown;
+
+    std::mutex lock;
+    std::condition_variable cv;
+
+    std::thread worker;
+
+public:
+    IOThread() : pending(0), shutdown(false) {}
+
+    IOThread(const IOThread&) = delete;
+    IOThread& operator=(const IOThread&) = delete;
+
+    ~IOThread() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            shutdown = true;
+        }
+        cv.notify_all();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    /** Adds a task to be processed after all tasks submitted so far. */
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            tasks.push_back(std::move(task));
+            ++pending;
+            if (!worker.joinable()) {
+                worker = std::thread([this]() { process(); });
+            }
+        }
+        cv.notify_all();
+    }
+
+    /** Waits until all tasks submitted so far have been completed. */
+    void wait() {
+        std::unique_lock<std::mutex> guard(lock);
+        cv.wait(guard, [this]() { return pending == 0; });
+    }
+
+private:
+    void process() {
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            cv.wait(guard, [this]() { return !tasks.empty() || shutdown; });
+            if (tasks.empty()) {
+                return;
+            }
+            std::function<void()> task = std::move(tasks.front());
+            tasks.pop_front();
+
+            guard.unlock();
+            task();
+            guard.lock();
+
+            --pending;
+            cv.notify_all();
+        }
+    }
+};
+
+#else
+
+/**
+ * A sequential replacement of the background thread, processing tasks on submission.
+ */
+class IOThread {
+public:
+    void submit(const std::function<void()>& task) {
+        task();
+    }
+
+    void wait() {}
+};
+
+#endif
+
+}  // end namespace souffle
@@ -0,0 +1,76 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file IndexStats.h
+ *
+ * The statistics of the lookups of relations by bound columns, recorded
+ * when profiling with -i/--profile-indices to judge the indices chosen
+ * for the search patterns of a program.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "RamTypes.h"
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+namespace souffle {
+
+/**
+ * The lookups of a relation by a single pattern of bound columns.
+ */
+struct IndexStats {
+    uint64_t probes = 0;  // the number of lookups
+    uint64_t hits = 0;    // the number of lookups finding at least one tuple
+    uint64_t tuples = 0;  // the number of tuples visited by all lookups
+
+    /** Records a lookup whose tuples are counted while they are visited */
+    bool probe(bool found) {
+        probes++;
+        hits += found;
+        return found;
+    }
+
+    /** Records a lookup testing for the existence of tuples, which thus visits at most one of them */
+    bool check(bool found) {
+        tuples += probe(found);
+        return found;
+    }
+
+    IndexStats& operator+=(const IndexStats& other) {
+        probes += other.probes;
+        hits += other.hits;
+        tuples += other.tuples;
+        return *this;
+    }
+};
+
+/**
+ * Obtains the label of the lookups of a relation by the given bound columns in a profile log. It is
+ * followed by the probes, hits and visited tuples, e.g. "@i-lookup;path;{0,2};10;8;24".
+ */
+inline std::string getLookupLabel(const std::string& relation, SearchColumns columns) {
+    std::stringstream label;
+    label << "@i-lookup;" << relation << ";{";
+    bool first = true;
+    for (int i = 0; columns != 0; i++, columns >>= 1) {
+        if (columns & 1) {
+            label << (first ? "" : ",") << i;
+            first = false;
+        }
+    }
+    label << "};";
+    return label.str();
+}
+
+}  // end of namespace souffle
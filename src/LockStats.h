@@ -0,0 +1,233 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file LockStats.h
+ *
+ * The statistics of the locks of the parallel utilities, recorded if
+ * souffle is configured with --enable-lock-stats to find the locks
+ * limiting the scalability of a parallel evaluation.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace souffle {
+
+/**
+ * The sites of locks, by which their use is aggregated.
+ */
+enum class LockSite : uint8_t {
+    other,      // locks not assigned to a site
+    btreeRoot,  // the root pointers of b-trees
+    btreeNode,  // the nodes of b-trees
+    hashSet,    // the tables of hash sets
+    relation,   // the inserts into the primary index of relations
+    records,    // the record tables
+    symbols,    // the symbol table
+    output      // the output of logs and profiles
+};
+
+/** The number of lock sites */
+const unsigned numLockSites = static_cast<unsigned>(LockSite::output) + 1;
+
+/** Obtains the name of a lock site in a profile log */
+inline const char* getName(LockSite site) {
+    switch (site) {
+        case LockSite::other:
+            return "other";
+        case LockSite::btreeRoot:
+            return "btree-root";
+        case LockSite::btreeNode:
+            return "btree-node";
+        case LockSite::hashSet:
+            return "hash-set";
+        case LockSite::relation:
+            return "relation";
+        case LockSite::records:
+            return "records";
+        case LockSite::symbols:
+            return "symbols";
+        case LockSite::output:
+            return "output";
+    }
+    return "";
+}
+
+/**
+ * The use of the locks of a site.
+ */
+struct LockCounts {
+    uint64_t acquisitions = 0;  // the number of times exclusive access has been granted
+    uint64_t reads = 0;         // the number of times shared or optimistic read access has been granted
+    uint64_t contentions = 0;   // the number of accesses which had to wait or were refused
+    uint64_t spins = 0;         // the number of iterations spent waiting by spinning accesses
+    uint64_t retries = 0;       // the number of optimistic reads and upgrades invalidated by writes
+
+    LockCounts& operator+=(const LockCounts& other) {
+        acquisitions += other.acquisitions;
+        reads += other.reads;
+        contentions += other.contentions;
+        spins += other.spins;
+        retries += other.retries;
+        return *this;
+    }
+};
+
+namespace detail {
+
+/**
+ * The counts of a lock site recorded by a thread, padded to a cache line such that threads do not
+ * share them. Threads beyond the number of slots share slots, thus counts are updated atomically.
+ */
+struct LockCounters {
+    enum { slots = 256 };
+
+    std::atomic<uint64_t> acquisitions;
+    std::atomic<uint64_t> reads;
+    std::atomic<uint64_t> contentions;
+    std::atomic<uint64_t> spins;
+    std::atomic<uint64_t> retries;
+    char padding[64 - 5 * sizeof(std::atomic<uint64_t>)];
+};
+
+/** Obtains the counters of all threads of the given site */
+inline LockCounters* getLockCounters(LockSite site) {
+    static LockCounters counters[numLockSites][LockCounters::slots];
+    return counters[static_cast<unsigned>(site)];
+}
+
+/** Obtains the counters of the calling thread of the given site */
+inline LockCounters& getThreadLockCounters(LockSite site) {
+    static std::atomic<unsigned> numThreads(0);
+    thread_local unsigned slot = numThreads++ % LockCounters::slots;
+    return getLockCounters(site)[slot];
+}
+
+}  // namespace detail
+
+/** Obtains the counts of the locks of the given site, summed over all threads */
+inline LockCounts getLockCounts(LockSite site) {
+    LockCounts res;
+    const detail::LockCounters* counters = detail::getLockCounters(site);
+    for (unsigned i = 0; i < detail::LockCounters::slots; i++) {
+        res.acquisitions += counters[i].acquisitions.load(std::memory_order_relaxed);
+        res.reads += counters[i].reads.load(std::memory_order_relaxed);
+        res.contentions += counters[i].contentions.load(std::memory_order_relaxed);
+        res.spins += counters[i].spins.load(std::memory_order_relaxed);
+        res.retries += counters[i].retries.load(std::memory_order_relaxed);
+    }
+    return res;
+}
+
+/** Resets the counts of the locks of all sites, e.g. at the start of an evaluation */
+inline void resetLockCounts() {
+    for (unsigned site = 0; site < numLockSites; site++) {
+        detail::LockCounters* counters = detail::getLockCounters(static_cast<LockSite>(site));
+        for (unsigned i = 0; i < detail::LockCounters::slots; i++) {
+            counters[i].acquisitions = 0;
+            counters[i].reads = 0;
+            counters[i].contentions = 0;
+            counters[i].spins = 0;
+            counters[i].retries = 0;
+        }
+    }
+}
+
+/**
+ * Obtains the label of the locks of a site in a profile log. It is followed by the acquisitions,
+ * reads, contentions, spins and retries, e.g. "@l-lock;btree-node;120;4000;12;800;3".
+ */
+inline std::string getLockLabel(LockSite site) {
+    return std::string("@l-lock;") + getName(site) + ";";
+}
+
+/**
+ * Writes the counts of the locks of all sites used since the last reset to a profile log.
+ */
+inline void logLockCounts(std::ostream& out) {
+    for (unsigned i = 0; i < numLockSites; i++) {
+        const LockCounts counts = getLockCounts(static_cast<LockSite>(i));
+        if (counts.acquisitions + counts.reads + counts.contentions == 0) {
+            continue;
+        }
+        out << getLockLabel(static_cast<LockSite>(i)) << counts.acquisitions << ";" << counts.reads << ";"
+            << counts.contentions << ";" << counts.spins << ";" << counts.retries << "\n";
+    }
+}
+
+#ifdef USE_LOCK_STATS
+
+/**
+ * Records the use of a lock for its site. Locks derive from it, such that it takes no space in
+ * their default build mode.
+ */
+class LockStats {
+    LockSite site;
+
+public:
+    enum { enabled = true };
+
+    LockStats(LockSite site) : site(site) {}
+
+    void recordAcquisition(unsigned spins) {
+        auto& counters = detail::getThreadLockCounters(site);
+        counters.acquisitions.fetch_add(1, std::memory_order_relaxed);
+        if (spins > 0) {
+            counters.contentions.fetch_add(1, std::memory_order_relaxed);
+            counters.spins.fetch_add(spins, std::memory_order_relaxed);
+        }
+    }
+
+    void recordRead(unsigned spins) {
+        auto& counters = detail::getThreadLockCounters(site);
+        counters.reads.fetch_add(1, std::memory_order_relaxed);
+        if (spins > 0) {
+            counters.contentions.fetch_add(1, std::memory_order_relaxed);
+            counters.spins.fetch_add(spins, std::memory_order_relaxed);
+        }
+    }
+
+    void recordContention() {
+        detail::getThreadLockCounters(site).contentions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void recordRetry() {
+        detail::getThreadLockCounters(site).retries.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+#else
+
+/**
+ * Locks do not record their use unless configured with --enable-lock-stats.
+ */
+class LockStats {
+public:
+    enum { enabled = false };
+
+    LockStats(LockSite /*site*/) {}
+
+    void recordAcquisition(unsigned /*spins*/) {}
+
+    void recordRead(unsigned /*spins*/) {}
+
+    void recordContention() {}
+
+    void recordRetry() {}
+};
+
+#endif
+
+}  // end of namespace souffle
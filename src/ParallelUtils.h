@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include "LockStats.h"
+
 #include <atomic>
 
 #ifdef _OPENMP
@@ -139,15 +141,18 @@ namespace souffle {
 /**
  * A small utility class for implementing simple locks.
  */
-class Lock {
+class Lock : LockStats {
     // the underlying mutex
     std::mutex mux;
 
 public:
+    Lock(LockSite site = LockSite::other) : LockStats(site) {}
+
     struct Lease {
         Lease(std::mutex& mux) : mux(&mux) {
             mux.lock();
         }
+        Lease(std::mutex& mux, std::adopt_lock_t) : mux(&mux) {}
         Lease(Lease&& other) : mux(other.mux) {
             other.mux = nullptr;
         }
@@ -164,15 +169,26 @@ public:
 
     // acquired the lock for the live-cycle of the returned guard
     Lease acquire() {
-        return Lease(mux);
+        lock();
+        return Lease(mux, std::adopt_lock);
     }
 
     void lock() {
-        mux.lock();
+        // contention is only detected if recorded, since the attempt costs another atomic operation
+        if (!enabled || !mux.try_lock()) {
+            recordContention();
+            mux.lock();
+        }
+        recordAcquisition(0);
     }
 
     bool try_lock() {
-        return mux.try_lock();
+        if (!mux.try_lock()) {
+            recordContention();
+            return false;
+        }
+        recordAcquisition(0);
+        return true;
     }
 
     void unlock() {
@@ -196,6 +212,13 @@ class Waiter {
 public:
     Waiter() : i(0) {}
 
+    /**
+     * Obtains the number of wait operations conducted so far.
+     */
+    unsigned getCount() const {
+        return i;
+    }
+
     /**
      * Conducts a wait operation.
      */
@@ -213,22 +236,32 @@ public:
 }  // namespace detail
 
 /* compare: http://en.cppreference.com/w/cpp/atomic/atomic_flag */
-class SpinLock {
+class SpinLock : LockStats {
     std::atomic<int> lck;
 
+    bool acquire() {
+        int should = 0;
+        return lck.compare_exchange_weak(should, 1, std::memory_order_acquire);
+    }
+
 public:
-    SpinLock() : lck(0) {}
+    SpinLock(LockSite site = LockSite::other) : LockStats(site), lck(0) {}
 
     void lock() {
         detail::Waiter wait;
-        while (!try_lock()) {
+        while (!acquire()) {
             wait();
         }
+        recordAcquisition(wait.getCount());
     }
 
     bool try_lock() {
-        int should = 0;
-        return lck.compare_exchange_weak(should, 1, std::memory_order_acquire);
+        if (!acquire()) {
+            recordContention();
+            return false;
+        }
+        recordAcquisition(0);
+        return true;
     }
 
     void unlock() {
@@ -240,7 +273,7 @@ public:
  * A read/write lock for increased access performance on a
  * read-heavy use case.
  */
-class ReadWriteLock {
+class ReadWriteLock : LockStats {
     /**
      * Based on paper:
      *         Scalable Reader-Writer Synchronization
@@ -256,7 +289,7 @@ class ReadWriteLock {
     std::atomic<int> lck;
 
 public:
-    ReadWriteLock() : lck(0) {}
+    ReadWriteLock(LockSite site = LockSite::other) : LockStats(site), lck(0) {}
 
     void start_read() {
         // add reader
@@ -275,6 +308,8 @@ public:
             r = lck.fetch_add(4, std::memory_order_acquire);
 
         }  // while there is a writer => spin
+
+        recordRead(wait.getCount());
     }
 
     void end_read() {
@@ -298,11 +333,18 @@ public:
             wait();
             should = 2;
         }
+
+        recordAcquisition(wait.getCount());
     }
 
     bool try_write() {
         int should = 0;
-        return lck.compare_exchange_strong(should, 1, std::memory_order_acquire, std::memory_order_relaxed);
+        if (!lck.compare_exchange_strong(should, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            recordContention();
+            return false;
+        }
+        recordAcquisition(0);
+        return true;
     }
 
     void end_write() {
@@ -311,7 +353,12 @@ public:
 
     bool try_upgrade_to_write() {
         int should = 4;
-        return lck.compare_exchange_strong(should, 1, std::memory_order_acquire, std::memory_order_relaxed);
+        if (!lck.compare_exchange_strong(should, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            recordContention();
+            return false;
+        }
+        recordAcquisition(0);
+        return true;
     }
 
     void downgrade_to_read() {
@@ -323,7 +370,7 @@ public:
 /**
  * An implementation of an optimistic r/w lock.
  */
-class OptimisticReadWriteLock {
+class OptimisticReadWriteLock : LockStats {
     /**
      * The version number utilized for the synchronization.
      *
@@ -351,7 +398,7 @@ public:
     /**
      * A default constructor initializing the lock.
      */
-    OptimisticReadWriteLock() : version(0) {}
+    OptimisticReadWriteLock(LockSite site = LockSite::other) : LockStats(site), version(0) {}
 
     /**
      * Starts a read phase, making sure that there is currently no
@@ -374,6 +421,7 @@ public:
         }
 
         // done
+        recordRead(wait.getCount());
         return Lease(v);
     }
 
@@ -385,7 +433,11 @@ public:
      */
     bool validate(const Lease& lease) {
         // check whether version number has changed in the mean-while
-        return lease.version == version.load(std::memory_order_consume);
+        if (lease.version != version.load(std::memory_order_consume)) {
+            recordRetry();
+            return false;
+        }
+        return true;
     }
 
     /**
@@ -418,6 +470,7 @@ public:
         }
 
         // done
+        recordAcquisition(wait.getCount());
     }
 
     /**
@@ -428,7 +481,12 @@ public:
      */
     bool try_start_write() {
         auto v = version.fetch_or(0x1, std::memory_order_acquire);
-        return !(v & 0x1);
+        if (v & 0x1) {
+            recordContention();
+            return false;
+        }
+        recordAcquisition(0);
+        return true;
     }
 
     /**
@@ -443,15 +501,23 @@ public:
         auto v = version.fetch_or(0x1, std::memory_order_acquire);
 
         // check whether write privileges have been gained
-        if (v & 0x1) return false;  // there is another writer already
+        if (v & 0x1) {
+            // there is another writer already
+            recordContention();
+            return false;
+        }
 
         // check whether there was no write since the gain of the read lock
-        if (lease.version == v) return true;
+        if (lease.version == v) {
+            recordAcquisition(0);
+            return true;
+        }
 
         // if there was, undo write update
         abort_write();
 
         // operation failed
+        recordRetry();
         return false;
     }
 
@@ -496,6 +562,8 @@ namespace souffle {
 struct Lock {
     class Lease {};
 
+    Lock(LockSite /*site*/ = LockSite::other) {}
+
     // no locking if there is no parallel execution
     Lease acquire() {
         return Lease();
@@ -515,7 +583,7 @@ struct Lock {
  */
 class SpinLock {
 public:
-    SpinLock() = default;
+    SpinLock(LockSite /*site*/ = LockSite::other) {}
 
     void lock() {}
 
@@ -528,7 +596,7 @@ public:
 
 class ReadWriteLock {
 public:
-    ReadWriteLock() = default;
+    ReadWriteLock(LockSite /*site*/ = LockSite::other) {}
 
     void start_read() {}
 
@@ -556,7 +624,7 @@ class OptimisticReadWriteLock {
 public:
     class Lease {};
 
-    OptimisticReadWriteLock() = default;
+    OptimisticReadWriteLock(LockSite /*site*/ = LockSite::other) {}
 
     Lease start_read() {
         return Lease();
@@ -0,0 +1,278 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file PerfCounters.h
+ *
+ * Hardware performance counters sampled by the profiler. Each thread of
+ * the evaluation counts its own events and reads only its own counters.
+ * The events of the threads taking part in a parallel region are added to
+ * the counts of the thread starting it once their part is completed.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace souffle {
+
+/**
+ * The hardware events counted during a region of the evaluation.
+ */
+struct PerfCounts {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cacheMisses = 0;  // misses of the last level cache
+    uint64_t branchMisses = 0;
+
+    PerfCounts operator-(const PerfCounts& other) const {
+        PerfCounts res;
+        res.cycles = cycles - other.cycles;
+        res.instructions = instructions - other.instructions;
+        res.cacheMisses = cacheMisses - other.cacheMisses;
+        res.branchMisses = branchMisses - other.branchMisses;
+        return res;
+    }
+};
+
+/**
+ * The counters of the threads evaluating a program. Counters are opened for each thread on its
+ * first use. Where counters are not supported, e.g. since the kernel does not permit them, a
+ * warning is issued and all counts are zero.
+ *
+ * Reading the counters only reads those of the calling thread. The threads taking part in a
+ * parallel region, other than the one starting it, add their events to a total of all workers
+ * when completing their part, which is included by reads outside of parallel regions. Reads within
+ * a parallel region only cover the calling thread, such that concurrent regions of the evaluation
+ * do not count the events of each other.
+ */
+class PerfCounters {
+    // the number of counted events, read as a group in the order of the fields of PerfCounts
+    enum { numEvents = 4 };
+
+    // distinguishes the counters of a process for the state cached by threads
+    const uint64_t serial;
+
+    // the file descriptors of the counters of all threads, the first of each group leading it
+    std::mutex lock;
+    std::vector<std::array<int, numEvents>> groups;
+    std::atomic<bool> available;
+
+    // the events counted by the workers of completed parallel regions
+    std::array<std::atomic<uint64_t>, numEvents> workers;
+
+    /* The counters of a thread and the number of parallel regions it is taking part in. */
+    struct ThreadState {
+        uint64_t serial = 0;
+        int leader = -1;
+        unsigned regions = 0;
+    };
+
+    static uint64_t getNextSerial() {
+        static std::atomic<uint64_t> counter(0);
+        return ++counter;
+    }
+
+#ifdef __linux__
+    static int open(uint64_t config, int group) {
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = (group == -1) ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+    }
+#endif
+
+    /** Opens the counters of the calling thread, returning the leader of the group or -1 */
+    int registerThread() {
+#ifdef __linux__
+        static const uint64_t configs[numEvents] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        std::array<int, numEvents> fds;
+        fds.fill(-1);
+        bool ok = true;
+        for (int i = 0; i < numEvents && ok; i++) {
+            fds[i] = open(configs[i], (i == 0) ? -1 : fds[0]);
+            ok = fds[i] != -1;
+        }
+        if (!ok) {
+            for (int fd : fds) {
+                if (fd != -1) {
+                    close(fd);
+                }
+            }
+            available = false;
+            return -1;
+        }
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        std::lock_guard<std::mutex> guard(lock);
+        groups.push_back(fds);
+        return fds[0];
+#else
+        available = false;
+        return -1;
+#endif
+    }
+
+    /** Obtains the state of the calling thread, opening its counters on its first use */
+    ThreadState& getThreadState() {
+        static thread_local ThreadState state;
+        if (state.serial != serial) {
+            state.serial = serial;
+            state.leader = available ? registerThread() : -1;
+            state.regions = 0;
+        }
+        return state;
+    }
+
+    /** Reads the counters of the calling thread */
+    PerfCounts readThread(const ThreadState& state) const {
+        PerfCounts res;
+#ifdef __linux__
+        // a group is read as its number of counters followed by their values
+        uint64_t values[numEvents + 1];
+        if (state.leader == -1 || ::read(state.leader, values, sizeof(values)) != sizeof(values)) {
+            return res;
+        }
+        res.cycles = values[1];
+        res.instructions = values[2];
+        res.cacheMisses = values[3];
+        res.branchMisses = values[4];
+#endif
+        return res;
+    }
+
+public:
+    PerfCounters() : serial(getNextSerial()), available(true) {
+        for (auto& cur : workers) {
+            cur = 0;
+        }
+        getThreadState();
+        if (!available) {
+            std::cerr << "Warning: hardware performance counters are not available, their counts are "
+                         "reported as zero\n";
+        }
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (const auto& fds : groups) {
+            for (int fd : fds) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    /** Determines whether the events of all threads are counted */
+    bool isAvailable() const {
+        return available;
+    }
+
+    /**
+     * Obtains the counts of the calling thread so far, including those of the workers of
+     * completed parallel regions unless the thread is taking part in a parallel region itself.
+     */
+    PerfCounts read() {
+        ThreadState& state = getThreadState();
+        PerfCounts res = readThread(state);
+        if (state.regions == 0) {
+            res.cycles += workers[0].load(std::memory_order_relaxed);
+            res.instructions += workers[1].load(std::memory_order_relaxed);
+            res.cacheMisses += workers[2].load(std::memory_order_relaxed);
+            res.branchMisses += workers[3].load(std::memory_order_relaxed);
+        }
+        return res;
+    }
+
+    /**
+     * The part of a thread in a parallel region, from its construction to its destruction.
+     * The events of a worker, i.e. a thread other than the one starting the region, are added
+     * to the total of all workers once its part is completed.
+     */
+    class Region {
+        PerfCounters* counters;
+        bool worker;
+        PerfCounts start;
+
+    public:
+        Region(PerfCounters* counters, bool worker) : counters(counters), worker(worker) {
+            if (!counters) {
+                return;
+            }
+            ThreadState& state = counters->getThreadState();
+            state.regions++;
+            if (worker) {
+                start = counters->readThread(state);
+            }
+        }
+
+        Region(const Region&) = delete;
+        Region& operator=(const Region&) = delete;
+
+        ~Region() {
+            if (!counters) {
+                return;
+            }
+            ThreadState& state = counters->getThreadState();
+            state.regions--;
+            if (worker) {
+                const PerfCounts diff = counters->readThread(state) - start;
+                counters->workers[0] += diff.cycles;
+                counters->workers[1] += diff.instructions;
+                counters->workers[2] += diff.cacheMisses;
+                counters->workers[3] += diff.branchMisses;
+            }
+        }
+    };
+};
+
+#ifdef _OPENMP
+/** Counts the events of the calling thread as its part of the innermost OpenMP parallel region */
+#define PERF_REGION(name, counters) souffle::PerfCounters::Region name(counters, omp_get_thread_num() != 0)
+#else
+#define PERF_REGION(name, counters)
+#endif
+
+/**
+ * Obtains the label of the counters of a timed region from the label of its timer, i.e. the
+ * prefix "@t-" is replaced by "@h-".
+ */
+inline std::string getCounterLabel(const std::string& timerLabel) {
+    return "@h-" + timerLabel.substr(3);
+}
+
+}  // end of namespace souffle
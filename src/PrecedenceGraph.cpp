@@ -415,43 +415,38 @@ void RelationSchedule::run(const AstTranslationUnit& translationUnit) {
 
 std::vector<std::set<const AstRelation*>> RelationSchedule::computeRelationExpirySchedule(
         const AstTranslationUnit& translationUnit) {
-    std::vector<std::set<const AstRelation*>> relationExpirySchedule;
-    /* Compute for each step in the reverse topological order
-       of evaluating the SCC the set of alive relations. */
+    /* Compute for each step in the reverse topological order of evaluating the SCCs the set
+       of relations that are alive after the step, i.e. read by a later step or retained
+       until the end of the evaluation. A relation expires at the step reading or computing
+       it last. */
 
     unsigned numSCCs = topsortSCCGraph->getSCCOrder().size();
+    std::vector<std::set<const AstRelation*>> relationExpirySchedule(numSCCs);
 
-    /* Alive set for each step */
-    std::vector<std::set<const AstRelation*>> alive(numSCCs);
-    /* Resize expired relations sets */
-    relationExpirySchedule.resize(numSCCs);
-
-    /* Mark the output relations as alive in the first step */
+    /* Output relations are alive after the last step */
+    std::set<const AstRelation*> alive;
     for (const AstRelation* relation : translationUnit.getProgram()->getRelations()) {
         if (relation->isComputed()) {
-            alive[0].insert(relation);
+            alive.insert(relation);
         }
     }
 
-    /* Compute all alive relations by iterating over all steps in reverse order
-       determine the dependencies */
-    for (unsigned orderedSCC = 1; orderedSCC < numSCCs; orderedSCC++) {
-        /* Add alive set of previous step */
-        alive[orderedSCC].insert(alive[orderedSCC - 1].begin(), alive[orderedSCC - 1].end());
+    for (unsigned i = numSCCs; i-- > 0;) {
+        unsigned scc = topsortSCCGraph->getSCCOrder()[i];
 
-        /* Add predecessors of relations computed in this step */
-        unsigned scc = topsortSCCGraph->getSCCOrder()[numSCCs - orderedSCC];
+        /* Collect the relations computed or read in this step */
+        std::set<const AstRelation*> used;
         for (const AstRelation* r : topsortSCCGraph->getSCCGraph()->getRelationsForSCC(scc)) {
+            used.insert(r);
             for (const AstRelation* predecessor : precedenceGraph->getPredecessors(r)) {
-                alive[orderedSCC].insert(predecessor);
+                used.insert(predecessor);
             }
         }
 
-        /* Compute expired relations in reverse topological order using the set difference of the alive sets
-           between steps. */
-        std::set_difference(alive[orderedSCC].begin(), alive[orderedSCC].end(), alive[orderedSCC - 1].begin(),
-                alive[orderedSCC - 1].end(), std::inserter(relationExpirySchedule[numSCCs - orderedSCC],
-                                                     relationExpirySchedule[numSCCs - orderedSCC].end()));
+        /* Relations used in this step but not alive afterwards expire here */
+        std::set_difference(used.begin(), used.end(), alive.begin(), alive.end(),
+                std::inserter(relationExpirySchedule[i], relationExpirySchedule[i].end()));
+        alive.insert(used.begin(), used.end());
     }
 
     return relationExpirySchedule;
@@ -0,0 +1,429 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ProfileEvent.h
+ *
+ * The binary profile log of generated programs. Events of fixed size are
+ * recorded into a ring buffer of each thread without locking and written
+ * to the log by a background thread. Timed statements may in addition
+ * record the hardware performance counters of their evaluation.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "IndexStats.h"
+#include "LockStats.h"
+#include "PerfCounters.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace souffle {
+
+/**
+ * Obtains a timestamp of the time stamp counter of the processor, or of the steady clock
+ * in nanoseconds where no such counter is available.
+ */
+inline uint64_t getProfileTimestamp() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+#endif
+}
+
+/**
+ * An event of a binary profile log.
+ */
+struct ProfileEvent {
+    enum Kind : uint32_t {
+        TIMER,              // the value is the duration of the labelled statement in timestamp ticks
+        SIZE,               // the value is the number of tuples of the labelled relation or rule
+        CALIBRATION,        // the value is the steady clock in nanoseconds at the time of the event
+        CYCLES,             // the values of the hardware performance counters of the labelled statement,
+        INSTRUCTIONS,       // recorded after its timer event in this order
+        CACHE_MISSES,
+        BRANCH_MISSES,
+        MEMORY,             // the value is the memory used by the labelled relation, index or table in bytes
+        LOOKUP_PROBES,      // the statistics of the lookups of the labelled relation by bound columns,
+        LOOKUP_HITS,        // recorded in this order at the end of the evaluation
+        LOOKUP_TUPLES,
+        LOCK_ACQUISITIONS,  // the use of the locks of the labelled site, recorded in this order at the end
+        LOCK_READS,         // of the evaluation if configured with --enable-lock-stats
+        LOCK_CONTENTIONS,
+        LOCK_SPINS,
+        LOCK_RETRIES
+    };
+
+    uint32_t label;  // the index of the label of the event
+    uint32_t kind;   // the kind of the event
+    uint64_t time;   // the timestamp at the end of the event
+    uint64_t value;  // the value of the event, depending on its kind
+};
+
+/** The first bytes of a binary profile log */
+inline const char* getProfileMagic() {
+    return "SFPROF1\n";
+}
+
+/**
+ * A binary profile log. It starts with the labels of its events, followed by the events in
+ * the order they have been written. Labels are those of the textual profile log, such that
+ * a timer event corresponds to a line of its label followed by its duration in seconds, and
+ * a size or memory event to a line of its label followed by its value. The counter events of a timed
+ * statement correspond to a line of the counter label of its timer followed by the counts, and the
+ * lookup events of a search pattern or the lock events of a lock site to a line of its label followed
+ * by the statistics.
+ */
+class ProfileEventStream {
+    // the number of events buffered by each thread
+    enum { capacity = 1 << 14 };
+
+    // the events recorded by a single thread and not yet written
+    struct Ring {
+        std::vector<ProfileEvent> events;
+        std::atomic<uint64_t> head;  // the number of events recorded
+        std::atomic<uint64_t> tail;  // the number of events written
+        Ring() : events(capacity), head(0), tail(0) {}
+    };
+
+    // distinguishes the streams of a process for the rings cached by threads
+    const uint64_t serial;
+
+    std::ofstream out;
+
+    // the rings of all threads recording events, registered under the lock
+    std::mutex lock;
+    std::vector<std::unique_ptr<Ring>> rings;
+
+    // the hardware performance counters sampled by timers, if enabled
+    std::unique_ptr<PerfCounters> counters;
+    std::vector<bool> counted;
+
+    // the thread periodically writing recorded events
+    std::atomic<bool> done;
+    std::thread flusher;
+
+    static uint64_t getNextSerial() {
+        static std::atomic<uint64_t> counter(0);
+        return ++counter;
+    }
+
+    /** Obtains the ring of the calling thread, registering it on its first event */
+    Ring& getRing() {
+        thread_local std::vector<std::pair<uint64_t, Ring*>> cache;
+        for (const auto& cur : cache) {
+            if (cur.first == serial) {
+                return *cur.second;
+            }
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        rings.emplace_back(new Ring());
+        cache.push_back(std::make_pair(serial, rings.back().get()));
+        return *rings.back();
+    }
+
+    /** Writes the events recorded so far */
+    void drain() {
+        std::vector<Ring*> current;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            for (const auto& cur : rings) {
+                current.push_back(cur.get());
+            }
+        }
+        for (Ring* ring : current) {
+            uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+            const uint64_t head = ring->head.load(std::memory_order_acquire);
+            while (tail != head) {
+                const uint64_t pos = tail % capacity;
+                const uint64_t num = std::min<uint64_t>(head - tail, capacity - pos);
+                out.write(reinterpret_cast<const char*>(&ring->events[pos]), num * sizeof(ProfileEvent));
+                tail += num;
+            }
+            ring->tail.store(tail, std::memory_order_release);
+        }
+        out.flush();
+    }
+
+    /** Records the relation of timestamps and the steady clock */
+    void calibrate() {
+        record(0, ProfileEvent::CALIBRATION, getProfileTimestamp(),
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch())
+                        .count());
+    }
+
+public:
+    ProfileEventStream(const std::string& filename, const std::vector<std::string>& labels,
+            bool countEvents = false)
+            : serial(getNextSerial()), out(filename, std::ios::binary), done(false) {
+        if (countEvents) {
+            counters.reset(new PerfCounters());
+            for (const std::string& label : labels) {
+                counted.push_back(label.compare(0, 3, "@t-") == 0);
+            }
+        }
+        out.write(getProfileMagic(), 8);
+        uint32_t num = labels.size();
+        out.write(reinterpret_cast<const char*>(&num), sizeof(num));
+        for (const std::string& label : labels) {
+            uint32_t length = label.size();
+            out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+            out.write(label.data(), length);
+        }
+        calibrate();
+        flusher = std::thread([this]() {
+            while (!done) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                calibrate();
+                drain();
+            }
+        });
+    }
+
+    ProfileEventStream(const ProfileEventStream&) = delete;
+    ProfileEventStream& operator=(const ProfileEventStream&) = delete;
+
+    ~ProfileEventStream() {
+        done = true;
+        flusher.join();
+        drain();
+        calibrate();
+        drain();
+    }
+
+    /** Records an event; waits for the background thread while the ring of the thread is full */
+    void record(uint32_t label, ProfileEvent::Kind kind, uint64_t time, uint64_t value) {
+        Ring& ring = getRing();
+        const uint64_t head = ring.head.load(std::memory_order_relaxed);
+        while (head - ring.tail.load(std::memory_order_acquire) >= capacity) {
+            std::this_thread::yield();
+        }
+        ring.events[head % capacity] = ProfileEvent{label, kind, time, value};
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+
+    /** Obtains the hardware performance counters of the evaluation, or null if they are not sampled */
+    PerfCounters* getCounters() const {
+        return counters.get();
+    }
+
+    /** Obtains the counters to be sampled by the timer of the given label, or null if there are none */
+    PerfCounters* getCounters(uint32_t label) const {
+        return (counters && counted[label]) ? counters.get() : nullptr;
+    }
+
+    /** Records the duration of a phase in timestamp ticks, as a timer event of the given label */
+    void logDuration(uint32_t label, uint64_t ticks) {
+        record(label, ProfileEvent::TIMER, getProfileTimestamp(), ticks);
+    }
+
+    /** Records the size of a relation */
+    void logSize(uint32_t label, uint64_t size) {
+        record(label, ProfileEvent::SIZE, getProfileTimestamp(), size);
+    }
+
+    /** Records the memory used by a relation, an index or a table */
+    void logMemory(uint32_t label, uint64_t bytes) {
+        record(label, ProfileEvent::MEMORY, getProfileTimestamp(), bytes);
+    }
+
+    /** Records the statistics of the lookups of a relation by a pattern of bound columns */
+    void logLookups(uint32_t label, const IndexStats& stats) {
+        const uint64_t time = getProfileTimestamp();
+        record(label, ProfileEvent::LOOKUP_PROBES, time, stats.probes);
+        record(label, ProfileEvent::LOOKUP_HITS, time, stats.hits);
+        record(label, ProfileEvent::LOOKUP_TUPLES, time, stats.tuples);
+    }
+
+    /** Records the use of the locks of a site, unless they have not been used */
+    void logLocks(uint32_t label, const LockCounts& counts) {
+        if (counts.acquisitions + counts.reads + counts.contentions == 0) {
+            return;
+        }
+        const uint64_t time = getProfileTimestamp();
+        record(label, ProfileEvent::LOCK_ACQUISITIONS, time, counts.acquisitions);
+        record(label, ProfileEvent::LOCK_READS, time, counts.reads);
+        record(label, ProfileEvent::LOCK_CONTENTIONS, time, counts.contentions);
+        record(label, ProfileEvent::LOCK_SPINS, time, counts.spins);
+        record(label, ProfileEvent::LOCK_RETRIES, time, counts.retries);
+    }
+};
+
+/**
+ * Records the execution time of the current scope as a timer event.
+ */
+class ProfileTimer {
+    ProfileEventStream& stream;
+    uint32_t label;
+    PerfCounters* counters;
+    PerfCounts counts;
+    uint64_t start;
+
+public:
+    ProfileTimer(ProfileEventStream& stream, uint32_t label)
+            : stream(stream), label(label), counters(stream.getCounters(label)) {
+        if (counters) {
+            counts = counters->read();
+        }
+        start = getProfileTimestamp();
+    }
+
+    ~ProfileTimer() {
+        const uint64_t end = getProfileTimestamp();
+        stream.record(label, ProfileEvent::TIMER, end, end - start);
+        if (counters) {
+            const PerfCounts diff = counters->read() - counts;
+            stream.record(label, ProfileEvent::CYCLES, end, diff.cycles);
+            stream.record(label, ProfileEvent::INSTRUCTIONS, end, diff.instructions);
+            stream.record(label, ProfileEvent::CACHE_MISSES, end, diff.cacheMisses);
+            stream.record(label, ProfileEvent::BRANCH_MISSES, end, diff.branchMisses);
+        }
+    }
+};
+
+/**
+ * Reads a binary profile log, possibly still being written, and converts its events into
+ * the lines of the equivalent textual profile log, which are passed to the consumer one by one.
+ * Returns false if the input is no binary profile log, leaving it at an unspecified position.
+ */
+inline bool readProfileEvents(std::istream& in, const std::function<void(const std::string&)>& consume) {
+    char magic[8];
+    if (!in.read(magic, 8) || std::memcmp(magic, getProfileMagic(), 8) != 0) {
+        return false;
+    }
+
+    uint32_t num = 0;
+    in.read(reinterpret_cast<char*>(&num), sizeof(num));
+    std::vector<std::string> labels(num);
+    for (std::string& label : labels) {
+        uint32_t length = 0;
+        in.read(reinterpret_cast<char*>(&length), sizeof(length));
+        label.resize(length);
+        in.read(&label[0], length);
+    }
+    if (!in) {
+        return true;
+    }
+
+    // events are written in batches of each thread, thus they have to be sorted by their time
+    std::vector<ProfileEvent> events;
+    ProfileEvent event;
+    while (in.read(reinterpret_cast<char*>(&event), sizeof(event))) {
+        events.push_back(event);
+    }
+    std::stable_sort(events.begin(), events.end(),
+            [](const ProfileEvent& a, const ProfileEvent& b) { return a.time < b.time; });
+
+    // convert timestamps to seconds using the first and the last calibration
+    const ProfileEvent* first = nullptr;
+    const ProfileEvent* last = nullptr;
+    for (const ProfileEvent& cur : events) {
+        if (cur.kind == ProfileEvent::CALIBRATION) {
+            first = (first) ? first : &cur;
+            last = &cur;
+        }
+    }
+    double ticksPerSecond = 1e9;
+    if (first && last->value > first->value && last->time > first->time) {
+        ticksPerSecond = (last->time - first->time) * 1e9 / (last->value - first->value);
+    }
+
+    // the counter events of a timer, the lookup and the lock events are collected until the last one is read
+    PerfCounts counts;
+    IndexStats lookups;
+    LockCounts locks;
+    for (const ProfileEvent& cur : events) {
+        if (cur.kind == ProfileEvent::CALIBRATION || cur.label >= labels.size()) {
+            continue;
+        }
+        std::ostringstream line;
+        if (cur.kind == ProfileEvent::CYCLES) {
+            counts.cycles = cur.value;
+            continue;
+        } else if (cur.kind == ProfileEvent::INSTRUCTIONS) {
+            counts.instructions = cur.value;
+            continue;
+        } else if (cur.kind == ProfileEvent::CACHE_MISSES) {
+            counts.cacheMisses = cur.value;
+            continue;
+        } else if (cur.kind == ProfileEvent::BRANCH_MISSES) {
+            line << getCounterLabel(labels[cur.label]) << counts.cycles << ";" << counts.instructions << ";"
+                 << counts.cacheMisses << ";" << cur.value;
+            consume(line.str());
+            continue;
+        } else if (cur.kind == ProfileEvent::LOOKUP_PROBES) {
+            lookups.probes = cur.value;
+            continue;
+        } else if (cur.kind == ProfileEvent::LOOKUP_HITS) {
+            lookups.hits = cur.value;
+            continue;
+        } else if (cur.kind == ProfileEvent::LOOKUP_TUPLES) {
+            line << labels[cur.label] << lookups.probes << ";" << lookups.hits << ";" << cur.value;
+            consume(line.str());
+            continue;
+        } else if (cur.kind == ProfileEvent::LOCK_ACQUISITIONS) {
+            locks.acquisitions = cur.value;
+            continue;
+        } else if (cur.kind == ProfileEvent::LOCK_READS) {
+            locks.reads = cur.value;
+            continue;
+        } else if (cur.kind == ProfileEvent::LOCK_CONTENTIONS) {
+            locks.contentions = cur.value;
+            continue;
+        } else if (cur.kind == ProfileEvent::LOCK_SPINS) {
+            locks.spins = cur.value;
+            continue;
+        } else if (cur.kind == ProfileEvent::LOCK_RETRIES) {
+            line << labels[cur.label] << locks.acquisitions << ";" << locks.reads << ";" << locks.contentions
+                 << ";" << locks.spins << ";" << cur.value;
+            consume(line.str());
+            continue;
+        }
+        line << labels[cur.label];
+        if (cur.kind == ProfileEvent::TIMER) {
+            line << cur.value / ticksPerSecond;
+        } else {
+            line << cur.value;
+        }
+        consume(line.str());
+    }
+    return true;
+}
+
+/**
+ * Reads a binary profile log into the lines of the equivalent textual profile log.
+ */
+inline bool readProfileEvents(std::istream& in, std::vector<std::string>& lines) {
+    return readProfileEvents(in, [&](const std::string& line) { lines.push_back(line); });
+}
+
+}  // end of namespace souffle
@@ -0,0 +1,286 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ProgressReport.h
+ *
+ * A status file reporting the progress of a running evaluation, such that
+ * external tools can estimate its completion or detect runaway recursion.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "RamLogger.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace souffle {
+
+/**
+ * The progress of an evaluation, periodically written as a JSON object to a status file. The file
+ * is replaced atomically, thus readers never observe a partially written status. For example:
+ *
+ *   {"state":"running","elapsed":12.5,"rss":104857600,"peak":209715200,"strata":14,
+ *    "current":{"index":6,"iteration":41,"elapsed":9.2,
+ *               "relations":{"path":1200000},"deltas":{"path":3500}},
+ *    "completed":[{"index":0,"iterations":0,"elapsed":0.1}, ...]}
+ *
+ * The evaluation enters each stratum and, for recursive strata, each iteration of the fixpoint
+ * computation. Entering is cheap: the sizes of relations, which may take linear time to compute,
+ * are only sampled by the evaluation once they are due to be written.
+ *
+ * A report created without a file is disabled and does not record anything.
+ */
+class ProgressReport {
+public:
+    typedef std::vector<std::pair<std::string, std::size_t>> Sizes;
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    // a stratum evaluated so far
+    struct Stratum {
+        std::size_t index;
+        std::size_t iterations;
+        double elapsed;
+    };
+
+    // the status file, empty if disabled
+    std::string file;
+
+    // the number of strata of the program
+    std::size_t numStrata;
+
+    // the time between two writes of the status file
+    std::chrono::milliseconds interval;
+
+    clock::time_point start;
+
+    // the stratum being evaluated, its iteration, start and last sampled sizes
+    bool running = false;
+    std::size_t index = 0;
+    std::size_t iteration = 0;
+    clock::time_point stratumStart;
+    Sizes relations;
+    Sizes deltas;
+
+    std::vector<Stratum> completed;
+
+    // set once the sizes of relations are due to be sampled
+    std::atomic<bool> due;
+
+    // set once the evaluation is done
+    bool done = false;
+
+#ifdef _OPENMP
+    std::mutex lock;
+    std::condition_variable cv;
+    std::thread writer;
+#else
+    clock::time_point nextWrite;
+#endif
+
+public:
+    ProgressReport(const std::string& file, std::size_t numStrata,
+            std::chrono::milliseconds interval = std::chrono::seconds(1))
+            : file(file), numStrata(numStrata), interval(interval), start(clock::now()), due(true) {
+        if (!isEnabled()) {
+            return;
+        }
+        write();
+#ifdef _OPENMP
+        writer = std::thread([this]() { run(); });
+#else
+        nextWrite = start + interval;
+#endif
+    }
+
+    ProgressReport(const ProgressReport&) = delete;
+    ProgressReport& operator=(const ProgressReport&) = delete;
+
+    /** Writes the final status of the evaluation */
+    ~ProgressReport() {
+        if (!isEnabled()) {
+            return;
+        }
+#ifdef _OPENMP
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            complete();
+            done = true;
+        }
+        cv.notify_all();
+        writer.join();
+#else
+        complete();
+        done = true;
+#endif
+        write();
+    }
+
+    bool isEnabled() const {
+        return !file.empty();
+    }
+
+    /**
+     * Enters the given stratum, or its next iteration if it is the current stratum.
+     *
+     * @return true if the sizes of the relations of the stratum are due to be sampled
+     */
+    bool enter(std::size_t stratum) {
+        if (!isEnabled()) {
+            return false;
+        }
+#ifdef _OPENMP
+        std::lock_guard<std::mutex> guard(lock);
+#endif
+        if (running && stratum == index) {
+            iteration++;
+        } else {
+            complete();
+            running = true;
+            index = stratum;
+            iteration = 0;
+            stratumStart = clock::now();
+        }
+#ifndef _OPENMP
+        // without a writer thread, the status is written by the evaluation itself
+        if (clock::now() >= nextWrite) {
+            due = true;
+            nextWrite = clock::now() + interval;
+            write();
+        }
+#endif
+        return due.load(std::memory_order_relaxed);
+    }
+
+    /** Records the sizes of the relations of the current stratum and of their deltas */
+    void sample(Sizes rels, Sizes dels) {
+#ifdef _OPENMP
+        std::lock_guard<std::mutex> guard(lock);
+#endif
+        relations = std::move(rels);
+        deltas = std::move(dels);
+        due.store(false, std::memory_order_relaxed);
+    }
+
+    /** Prints the status of the evaluation as a JSON object */
+    void print(std::ostream& out) const {
+        auto seconds = [](clock::duration duration) {
+            return std::chrono::duration_cast<std::chrono::duration<double>>(duration).count();
+        };
+        auto printSizes = [&](const Sizes& sizes) {
+            out << "{";
+            for (std::size_t i = 0; i < sizes.size(); i++) {
+                out << (i == 0 ? "" : ",");
+                printString(out, sizes[i].first);
+                out << ":" << sizes[i].second;
+            }
+            out << "}";
+        };
+        const clock::time_point now = clock::now();
+
+        out << "{\"state\":\"" << (done ? "done" : "running") << "\"";
+        out << ",\"elapsed\":" << seconds(now - start);
+        out << ",\"rss\":" << getResidentMemoryUsage();
+        out << ",\"peak\":" << getPeakMemoryUsage();
+        out << ",\"strata\":" << numStrata;
+        if (running) {
+            out << ",\"current\":{\"index\":" << index << ",\"iteration\":" << iteration;
+            out << ",\"elapsed\":" << seconds(now - stratumStart);
+            out << ",\"relations\":";
+            printSizes(relations);
+            out << ",\"deltas\":";
+            printSizes(deltas);
+            out << "}";
+        }
+        out << ",\"completed\":[";
+        for (std::size_t i = 0; i < completed.size(); i++) {
+            out << (i == 0 ? "" : ",") << "{\"index\":" << completed[i].index
+                << ",\"iterations\":" << completed[i].iterations
+                << ",\"elapsed\":" << completed[i].elapsed << "}";
+        }
+        out << "]}\n";
+    }
+
+private:
+    /** Completes the current stratum, if any */
+    void complete() {
+        if (running) {
+            completed.push_back({index, iteration,
+                    std::chrono::duration_cast<std::chrono::duration<double>>(clock::now() - stratumStart)
+                            .count()});
+            running = false;
+            relations.clear();
+            deltas.clear();
+        }
+    }
+
+    /** Replaces the status file by the current status */
+    void write() {
+        std::stringstream status;
+        print(status);
+        write(status.str());
+    }
+
+    /** Replaces the status file by the given status */
+    void write(const std::string& status) {
+        const std::string tmp = file + ".tmp";
+        {
+            std::ofstream out(tmp);
+            out << status;
+        }
+        std::rename(tmp.c_str(), file.c_str());
+    }
+
+#ifdef _OPENMP
+    /** Writes the status file periodically until the evaluation is done */
+    void run() {
+        std::unique_lock<std::mutex> guard(lock);
+        while (!cv.wait_for(guard, interval, [this]() { return done; })) {
+            // the evaluation is not blocked while the file is written
+            std::stringstream status;
+            print(status);
+            due = true;
+            guard.unlock();
+            write(status.str());
+            guard.lock();
+        }
+    }
+#endif
+
+    static void printString(std::ostream& out, const std::string& str) {
+        out << "\"";
+        for (char c : str) {
+            if (c == '"' || c == '\\') {
+                out << '\\';
+            }
+            out << c;
+        }
+        out << "\"";
+    }
+};
+
+}  // end namespace souffle
@@ -78,6 +78,17 @@ public:
         return card(cols) < orders[idx].size();
     }
 
+    /** check whether the table is only searched with keys covering all of its columns,
+        in which case no ordered index is required */
+    bool hasOnlyTotalSearches(size_t arity) const {
+        for (SearchColumns cols : searches) {
+            if (card(cols) != arity) {
+                return false;
+            }
+        }
+        return !searches.empty();
+    }
+
     /** map the keys in the key set to lexicographical order */
     void solve();
 
@@ -19,8 +19,13 @@
 #include "AstVisitor.h"
 #include "BinaryConstraintOps.h"
 #include "BinaryFunctorOps.h"
+#include "Checkpoint.h"
 #include "Global.h"
+#include "HashJoinTable.h"
 #include "IOSystem.h"
+#include "IOThread.h"
+#include "LockStats.h"
+#include "ProgressReport.h"
 #include "RamAutoIndex.h"
 #include "RamData.h"
 #include "RamLogger.h"
@@ -32,8 +37,10 @@
 #include "UnaryFunctorOps.h"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <functional>
 #include <memory>
 #include <regex>
 #include <utility>
@@ -56,6 +63,18 @@ bool useNoIndex() {
     return flag;
 }
 
+/** Whether negations and existence checks should consult Bloom filters before probing an index */
+bool useBloomFilters() {
+    static bool flag = Global::config().has("bloom-filter");
+    return flag;
+}
+
+/** Whether output relations should be written asynchronously once computed */
+bool streamOutput() {
+    static bool flag = Global::config().has("stream-output");
+    return flag;
+}
+
 // See the CPPIdentifierMap, (it is a singleton class).
 CPPIdentifierMap* CPPIdentifierMap::instance = nullptr;
 
@@ -69,8 +88,135 @@ static const std::string getOpContextName(const RamRelationIdentifier& rel) {
     return getRelationName(rel) + "_op_ctxt";
 }
 
+// Prints the code writing the given relation according to its output directives.
+static void printStoreCode(std::ostream& os, const RamRelationIdentifier& rel, const std::string& dirname) {
+    for (IODirectives ioDirectives : rel.getOutputDirectives()) {
+        os << "try {";
+        os << "std::map<std::string, std::string> directiveMap(" << ioDirectives << ");\n";
+        os << "if (!" << dirname << ".empty() && directiveMap[\"IO\"] == \"file\" && ";
+        os << "directiveMap[\"filename\"].front() != '/') {";
+        os << "directiveMap[\"filename\"] = " << dirname << " + \"/\" + directiveMap[\"filename\"];";
+        os << "}\n";
+        os << "IODirectives ioDirectives(directiveMap);\n";
+        // the tuples of hash relations are written in order, as those of other relations
+        if (rel.isHash()) {
+            os << "auto tuples = getSortedTuples(*" << getRelationName(rel) << ");\n";
+        }
+        os << "IOSystem::getInstance().getWriter(";
+        os << "SymbolMask({" << rel.getSymbolMask() << "})";
+        os << ", symTable, ioDirectives";
+        os << ")->writeAll(" << (rel.isHash() ? "tuples" : "*" + getRelationName(rel)) << ");\n";
+
+        os << "} catch (std::exception& e) {std::cerr << e.what();exit(1);}\n";
+    }
+}
+
 namespace {
 
+/**
+ * Calls the given function for each operation looking up a relation by bound columns within the
+ * given node, i.e. each range scan, aggregate and negation, with the relation and the bound columns.
+ */
+void visitLookups(const RamNode& root,
+        const std::function<void(const RamNode&, const RamRelationIdentifier&, SearchColumns)>& fun) {
+    visitDepthFirst(root, [&](const RamScan& scan) {
+        if (scan.getRangeQueryColumns() != 0) {
+            fun(scan, scan.getRelation(), scan.getRangeQueryColumns());
+        }
+    });
+    visitDepthFirst(root, [&](const RamAggregate& aggregate) {
+        if (aggregate.getRangeQueryColumns() != 0) {
+            fun(aggregate, aggregate.getRelation(), aggregate.getRangeQueryColumns());
+        }
+    });
+    visitDepthFirst(root, [&](const RamNotExists& ne) {
+        if (ne.getKey() != 0) {
+            fun(ne, ne.getRelation(), ne.getKey());
+        }
+    });
+}
+
+/**
+ * Determines whether the hash table of the given hash join, nested directly within the given full
+ * scan of the outermost level, may be built on the scanned relation instead of the joined relation,
+ * i.e. whether the join key consists of distinct columns of the scanned tuples only. If so, the
+ * column of the scanned relation matched by each column of the joined relation is returned, -1 for
+ * columns not being matched. Otherwise, the result is empty.
+ */
+std::vector<int> getOuterJoinColumns(const RamScan& scan, const RamHashJoin& join) {
+    const RamRelationIdentifier& rel = scan.getRelation();
+    if (scan.getLevel() != 0 || scan.getRangeQueryColumns() != 0 || scan.isPureExistenceCheck() ||
+            rel.isTemp() || rel.isEqRel() || rel.getArity() == 0) {
+        return {};
+    }
+
+    std::vector<int> res;
+    std::set<size_t> matched;
+    for (const RamValue* value : join.getKeyPattern()) {
+        if (!value) {
+            res.push_back(-1);
+            continue;
+        }
+        const RamElementAccess* access = dynamic_cast<const RamElementAccess*>(value);
+        if (!access || access->getLevel() != scan.getLevel() || !matched.insert(access->getElement()).second) {
+            return {};
+        }
+        res.push_back(access->getElement());
+    }
+    return res;
+}
+
+/**
+ * Obtains the hash join nested directly within the outermost scan of the given query if its
+ * table may be built on the scanned relation, null otherwise.
+ */
+const RamHashJoin* getOuterHashJoin(const RamInsert& insert) {
+    auto scan = dynamic_cast<const RamScan*>(&insert.getOperation());
+    auto join = scan ? dynamic_cast<const RamHashJoin*>(scan->getNestedOperation()) : nullptr;
+    return (join && !getOuterJoinColumns(*scan, *join).empty()) ? join : nullptr;
+}
+
+/** Obtains the key columns of the table built on the scanned relation of a hash join */
+SearchColumns getOuterKeyColumns(const std::vector<int>& columns) {
+    SearchColumns res = 0;
+    for (int cur : columns) {
+        if (cur >= 0) {
+            res |= (SearchColumns(1) << cur);
+        }
+    }
+    return res;
+}
+
+/**
+ * Registers the Bloom filters consulted by the negations and existence checks of the given
+ * program with the given environment. Since the content of swapped relations is exchanged
+ * along with their filters, the filters of both partners of a swap are alike.
+ */
+void registerFilters(const RamStatement& stmt, RamEnvironment& env) {
+    std::map<std::string, std::set<SearchColumns>> filters;
+    visitDepthFirst(stmt, [&](const RamScan& scan) {
+        if (scan.isPureExistenceCheck() && scan.getRangeQueryColumns() != 0) {
+            filters[scan.getRelation().getName()].insert(scan.getRangeQueryColumns());
+        }
+    });
+    visitDepthFirst(stmt, [&](const RamNotExists& ne) {
+        if (ne.getKey() != 0) {
+            filters[ne.getRelation().getName()].insert(ne.getKey());
+        }
+    });
+    visitDepthFirst(stmt, [&](const RamSwap& swap) {
+        auto& first = filters[swap.getFirstRelation().getName()];
+        auto& second = filters[swap.getSecondRelation().getName()];
+        first.insert(second.begin(), second.end());
+        second = first;
+    });
+    for (const auto& cur : filters) {
+        for (SearchColumns columns : cur.second) {
+            env.addFilter(cur.first, columns);
+        }
+    }
+}
+
 class EvalContext {
     std::vector<const RamDomain*> data;
 
@@ -296,6 +442,14 @@ bool eval(const RamCondition& cond, RamEnvironment& env, const EvalContext& ctxt
                     tuple[i] = (values[i]) ? eval(values[i], env, ctxt) : MIN_RAM_DOMAIN;
                 }
 
+                // most negated tuples are not present => try to answer by the filter first
+                if (useBloomFilters() && arity > 0 && !rel.mayContain(ne.getKey(), tuple)) {
+                    return true;
+                }
+
+                if (IndexStats* stats = env.getLookupStats(ne)) {
+                    return !stats->check(rel.exists(tuple));
+                }
                 return !rel.exists(tuple);
             }
 
@@ -307,6 +461,10 @@ bool eval(const RamCondition& cond, RamEnvironment& env, const EvalContext& ctxt
                 high[i] = (values[i]) ? low[i] : MAX_RAM_DOMAIN;
             }
 
+            if (useBloomFilters() && arity > 0 && !rel.mayContain(ne.getKey(), low)) {
+                return true;
+            }
+
             // obtain index
             auto idx = ne.getIndex();
             if (!idx) {
@@ -315,6 +473,9 @@ bool eval(const RamCondition& cond, RamEnvironment& env, const EvalContext& ctxt
             }
 
             auto range = idx->lowerUpperBound(low, high);
+            if (IndexStats* stats = env.getLookupStats(ne)) {
+                stats->check(range.first != range.second);
+            }
             return range.first == range.second;  // if there are none => done
         }
 
@@ -382,6 +543,9 @@ void apply(const RamOperation& op, RamEnvironment& env) {
         RamEnvironment& env;
         EvalContext& ctxt;
 
+        // the hash tables of the hash joins of this query
+        std::map<const RamHashJoin*, std::unique_ptr<HashJoinTable>> tables;
+
     public:
         Interpreter(RamEnvironment& env, EvalContext& ctxt) : env(env), ctxt(ctxt) {}
 
@@ -410,6 +574,12 @@ void apply(const RamOperation& op, RamEnvironment& env) {
                     return;
                 }
 
+                // a hash join with a larger relation builds its table on this side instead
+                auto join = dynamic_cast<const RamHashJoin*>(scan.getNestedOperation());
+                if (join && visitOuterHashJoin(scan, *join)) {
+                    return;
+                }
+
                 // if scan is unrestricted => use simple iterator
                 for (const RamDomain* cur : rel) {
                     ctxt[scan.getLevel()] = cur;
@@ -433,6 +603,12 @@ void apply(const RamOperation& op, RamEnvironment& env) {
                 }
             }
 
+            // if this scan is not binding anything, the filter may already rule out any match
+            if (scan.isPureExistenceCheck() && useBloomFilters() &&
+                    !rel.mayContain(scan.getRangeQueryColumns(), low)) {
+                return;
+            }
+
             // obtain index
             auto idx = scan.getIndex();
             if (!idx || rel.getID().isTemp()) {
@@ -442,9 +618,13 @@ void apply(const RamOperation& op, RamEnvironment& env) {
 
             // get iterator range
             auto range = idx->lowerUpperBound(low, hig);
+            IndexStats* stats = env.getLookupStats(scan);
 
             // if this scan is not binding anything ...
             if (scan.isPureExistenceCheck()) {
+                if (stats) {
+                    stats->check(range.first != range.second);
+                }
                 if (range.first != range.second) {
                     visitSearch(scan);
                 }
@@ -452,13 +632,85 @@ void apply(const RamOperation& op, RamEnvironment& env) {
             }
 
             // conduct range query
+            if (stats) {
+                stats->probe(range.first != range.second);
+            }
             for (auto ip = range.first; ip != range.second; ++ip) {
                 const RamDomain* data = *(ip);
                 ctxt[scan.getLevel()] = data;
+                if (stats) {
+                    stats->tuples++;
+                }
                 visitSearch(scan);
             }
         }
 
+        void visitHashJoin(const RamHashJoin& join) override {
+            // build the hash table on the first visit within this evaluation of the query
+            std::unique_ptr<HashJoinTable>& table = tables[&join];
+            if (!table) {
+                const RamRelation& rel = env.getRelation(join.getRelation());
+                table = std::unique_ptr<HashJoinTable>(
+                        new HashJoinTable(rel.getArity(), join.getKeyColumns()));
+                table->build(rel);
+            }
+
+            // create key tuple for probing the table
+            auto arity = join.getRelation().getArity();
+            RamDomain key[arity];
+            auto pattern = join.getKeyPattern();
+            for (size_t i = 0; i < arity; i++) {
+                key[i] = (pattern[i] != nullptr) ? eval(pattern[i], env, ctxt) : 0;
+            }
+
+            // process all matching tuples
+            for (const RamDomain* cur : table->lookup(key)) {
+                ctxt[join.getLevel()] = cur;
+                visitSearch(join);
+            }
+        }
+
+        /**
+         * Evaluates the given scan and the hash join nested within it by building the hash table
+         * on the scanned relation and enumerating the joined relation, if the scanned relation
+         * is the smaller one. Returns false if the join has to be evaluated the regular way.
+         */
+        bool visitOuterHashJoin(const RamScan& scan, const RamHashJoin& join) {
+            const RamRelation& outer = env.getRelation(scan.getRelation());
+            const RamRelation& inner = env.getRelation(join.getRelation());
+            if (outer.size() >= inner.size()) {
+                return false;
+            }
+            std::vector<int> columns = getOuterJoinColumns(scan, join);
+            if (columns.empty()) {
+                return false;
+            }
+
+            HashJoinTable table(outer.getArity(), getOuterKeyColumns(columns));
+            table.build(outer);
+
+            auto arity = outer.getArity();
+            RamDomain key[arity];
+            std::fill(key, key + arity, 0);
+            for (const RamDomain* cur : inner) {
+                for (size_t i = 0; i < columns.size(); i++) {
+                    if (columns[i] >= 0) {
+                        key[columns[i]] = cur[i];
+                    }
+                }
+                for (const RamDomain* match : table.lookup(key)) {
+                    ctxt[scan.getLevel()] = match;
+                    ctxt[join.getLevel()] = cur;
+                    auto condition = scan.getCondition();
+                    if (condition && !eval(*condition, env, ctxt)) {
+                        continue;
+                    }
+                    visitSearch(join);
+                }
+            }
+            return true;
+        }
+
         void visitLookup(const RamLookup& lookup) override {
             // get reference
             RamDomain ref = ctxt[lookup.getReferenceLevel()][lookup.getReferencePosition()];
@@ -527,6 +779,10 @@ void apply(const RamOperation& op, RamEnvironment& env) {
 
             // get iterator range
             auto range = idx->lowerUpperBound(low, hig);
+            IndexStats* stats = env.getLookupStats(aggregate);
+            if (stats) {
+                stats->probe(range.first != range.second);
+            }
 
             // check for emptiness
             if (aggregate.getFunction() != RamAggregate::COUNT) {
@@ -540,6 +796,9 @@ void apply(const RamOperation& op, RamEnvironment& env) {
                 // link tuple
                 const RamDomain* data = *(ip);
                 ctxt[aggregate.getLevel()] = data;
+                if (stats) {
+                    stats->tuples++;
+                }
 
                 // count is easy
                 if (aggregate.getFunction() == RamAggregate::COUNT) {
@@ -620,18 +879,35 @@ void apply(const RamOperation& op, RamEnvironment& env) {
 }
 
 void run(const QueryExecutionStrategy& executor, std::ostream* report, std::ostream* profile,
-        const RamStatement& stmt, RamEnvironment& env, RamData* data) {
+        PerfCounters* counters, const RamStatement& stmt, RamEnvironment& env, RamData* data) {
     class Interpreter : public RamVisitor<bool> {
         RamEnvironment& env;
         const QueryExecutionStrategy& queryExecutor;
         std::ostream* report;
         std::ostream* profile;
+        PerfCounters* counters;
         RamData* data;
 
+        // the thread writing output relations if those are streamed
+        IOThread* output;
+
+        // the nanoseconds spent writing output relations, reported as a phase of their own
+        std::atomic<uint64_t>& saveTime;
+
+        // the checkpoints taken after each stratum
+        Checkpoint& checkpoint;
+        RamRecordTables records;
+
+        // the progress of the evaluation reported to external tools
+        ProgressReport& progress;
+
     public:
         Interpreter(RamEnvironment& env, const QueryExecutionStrategy& executor, std::ostream* report,
-                std::ostream* profile, RamData* data)
-                : env(env), queryExecutor(executor), report(report), profile(profile), data(data) {}
+                std::ostream* profile, PerfCounters* counters, RamData* data, IOThread* output,
+                std::atomic<uint64_t>& saveTime, Checkpoint& checkpoint, ProgressReport& progress)
+                : env(env), queryExecutor(executor), report(report), profile(profile), counters(counters),
+                  data(data), output(output), saveTime(saveTime), checkpoint(checkpoint),
+                  progress(progress) {}
 
         // -- Statements -----------------------------
 
@@ -665,6 +941,7 @@ void run(const QueryExecutionStrategy& executor, std::ostream* report, std::ostr
             bool cond = true;
 #pragma omp parallel for reduction(&& : cond)
             for (size_t i = 0; i < stmts.size(); i++) {
+                PERF_REGION(region, counters);
                 cond = cond && visit(stmts[i]);
             }
             return cond;
@@ -680,8 +957,45 @@ void run(const QueryExecutionStrategy& executor, std::ostream* report, std::ostr
             return !eval(exit.getCondition(), env);
         }
 
+        bool visitStratum(const RamStratum& stratum) override {
+            const size_t index = stratum.getIndex();
+            try {
+                // a completed stratum restores its results instead of computing them
+                if (checkpoint.isCompleted(index)) {
+                    checkpoint.restoreTables(index, env.getSymbolTable(), records);
+                    for (const auto& cur : stratum.getRelations()) {
+                        if (checkpoint.isNeeded(cur.second)) {
+                            checkpoint.restore(cur.first.getName(), cur.first.getArity(),
+                                    env.getRelation(cur.first));
+                        }
+                    }
+                    return true;
+                }
+
+                bool res = visit(stratum.getBody());
+                for (const auto& cur : stratum.getRelations()) {
+                    if (cur.second > index) {
+                        checkpoint.save(
+                                cur.first.getName(), cur.first.getArity(), env.getRelation(cur.first));
+                    }
+                }
+                checkpoint.commit(index, env.getSymbolTable(), records);
+                return res;
+            } catch (std::exception& e) {
+                std::cerr << e.what() << "\n";
+                exit(1);
+            }
+        }
+
+        bool visitIncremental(const RamIncremental& incremental) override {
+            // the interpreter evaluates a program only once
+            return visit(incremental.getInitial());
+        }
+
         bool visitLogTimer(const RamLogTimer& timer) override {
-            RamLogger logger(timer.getLabel().c_str(), *profile);
+            // hardware performance counters are only reported for rules and relations
+            bool counted = timer.getLabel().compare(0, 3, "@t-") == 0;
+            RamLogger logger(timer.getLabel().c_str(), *profile, counted ? counters : nullptr);
             return visit(timer.getNested());
         }
 
@@ -701,6 +1015,12 @@ void run(const QueryExecutionStrategy& executor, std::ostream* report, std::ostr
         }
 
         bool visitDrop(const RamDrop& drop) override {
+            if (output && drop.getRelation().isOutput()) {
+                // the relation may still be written, thus only its content is dropped once written
+                auto& rel = env.getRelation(drop.getRelation());
+                output->submit([&rel]() { rel.purge(); });
+                return true;
+            }
             env.dropRelation(drop.getRelation());
             return true;
         }
@@ -719,6 +1039,52 @@ void run(const QueryExecutionStrategy& executor, std::ostream* report, std::ostr
             return true;
         }
 
+        bool visitLogMemory(const RamLogMemory& log) override {
+            auto lease = getOutputLock().acquire();
+            (void)lease;
+            for (const RamRelationIdentifier& id : log.getRelations()) {
+                if (!env.hasRelation(id.getName())) {
+                    continue;
+                }
+                const RamRelation& rel = env.getRelation(id);
+                *profile << log.getRelationLabel(id) << rel.getMemoryUsage() << "\n";
+                for (const auto& cur : rel.getIndexMemoryUsage()) {
+                    std::vector<int> order;
+                    for (size_t i = 0; i < cur.first.size(); i++) {
+                        order.push_back(cur.first[i]);
+                    }
+                    const std::string name = "<" + toString(join(order, ",")) + ">";
+                    *profile << log.getIndexLabel(id, name) << cur.second << "\n";
+                }
+            }
+            *profile << log.getLabel("records") << records.getMemoryUsage() << "\n";
+            *profile << log.getLabel("symbols") << env.getSymbolTable().getMemoryUsage() << "\n";
+            *profile << log.getLabel("peak") << getPeakMemoryUsage() << "\n";
+            return true;
+        }
+
+        bool visitLogProgress(const RamLogProgress& log) override {
+            // the sizes of relations are only computed once they are due to be reported
+            if (!progress.enter(log.getIndex())) {
+                return true;
+            }
+            const auto& relations = log.getRelations();
+            const auto& deltas = log.getDeltas();
+            ProgressReport::Sizes relationSizes;
+            ProgressReport::Sizes deltaSizes;
+            for (size_t i = 0; i < relations.size(); i++) {
+                auto size = [&](const RamRelationIdentifier& id) {
+                    return env.hasRelation(id.getName()) ? env.getRelation(id).size() : 0;
+                };
+                relationSizes.push_back(std::make_pair(relations[i].getName(), size(relations[i])));
+                if (!deltas.empty()) {
+                    deltaSizes.push_back(std::make_pair(relations[i].getName(), size(deltas[i])));
+                }
+            }
+            progress.sample(std::move(relationSizes), std::move(deltaSizes));
+            return true;
+        }
+
         bool visitLoad(const RamLoad& load) override {
 #ifdef USE_JAVAI
             if (load.getRelation().isData()) {
@@ -739,16 +1105,7 @@ void run(const QueryExecutionStrategy& executor, std::ostream* report, std::ostr
                 return !err;
             }
 #endif
-            try {
-                RamRelation& relation = env.getRelation(load.getRelation());
-                std::unique_ptr<ReadStream> reader =
-                        IOSystem::getInstance().getReader(load.getRelation().getSymbolMask(),
-                                env.getSymbolTable(), load.getRelation().getInputDirectives());
-                reader->readAll(relation);
-            } catch (std::exception& e) {
-                std::cerr << e.what();
-                return false;
-            }
+            // inputs have been loaded before the evaluation has been started
             return true;
         }
 
@@ -759,16 +1116,29 @@ void run(const QueryExecutionStrategy& executor, std::ostream* report, std::ostr
             }
 #endif
             auto& rel = env.getRelation(store.getRelation());
-            for (IODirectives ioDirectives : store.getRelation().getOutputDirectives()) {
-                try {
-                    IOSystem::getInstance()
-                            .getWriter(
-                                    store.getRelation().getSymbolMask(), env.getSymbolTable(), ioDirectives)
-                            ->writeAll(rel);
-                } catch (std::exception& e) {
-                    std::cerr << e.what();
-                    exit(1);
+            const RamRelationIdentifier& id = store.getRelation();
+            SymbolTable& symbolTable = env.getSymbolTable();
+            std::atomic<uint64_t>& saveTime = this->saveTime;
+            auto write = [&rel, &id, &symbolTable, &saveTime]() {
+                auto start = now();
+                for (IODirectives ioDirectives : id.getOutputDirectives()) {
+                    try {
+                        IOSystem::getInstance()
+                                .getWriter(id.getSymbolMask(), symbolTable, ioDirectives)
+                                ->writeAll(rel);
+                    } catch (std::exception& e) {
+                        std::cerr << e.what();
+                        exit(1);
+                    }
                 }
+                saveTime += duration_in_ns(start, now());
+            };
+
+            // streamed outputs are written while the evaluation continues
+            if (output) {
+                output->submit(write);
+            } else {
+                write();
             }
             return true;
         }
@@ -820,12 +1190,72 @@ void run(const QueryExecutionStrategy& executor, std::ostream* report, std::ostr
         }
     };
 
+    // report the progress of the evaluation including the loading of its inputs
+    size_t numStrata = 0;
+    visitDepthFirst(
+            stmt, [&](const RamLogProgress& log) { numStrata = std::max(numStrata, log.getIndex() + 1); });
+    ProgressReport progress(Global::config().get("progress"), numStrata);
+
+    // load all input relations concurrently
+    InputLoader loader;
+    std::vector<IODirectives> inputs;
+    visitDepthFirst(stmt, [&](const RamLoad& load) {
+#ifdef USE_JAVAI
+        if (load.getRelation().isData()) {
+            return;
+        }
+#endif
+        loader.add(load.getRelation().getSymbolMask(), env.getSymbolTable(),
+                load.getRelation().getInputDirectives(), env.getRelation(load.getRelation()));
+        inputs.push_back(load.getRelation().getInputDirectives());
+    });
+    try {
+        // the loading of the inputs is profiled as a phase of its own
+        std::unique_ptr<RamLogger> logger(profile ? new RamLogger("@loadtime;", *profile) : nullptr);
+        loader.run();
+    } catch (std::exception& e) {
+        std::cerr << e.what();
+        return;
+    }
+
+    // resume from the checkpoint of an interrupted evaluation of the same program on the same inputs
+    Checkpoint checkpoint(Global::config().get("checkpoint"),
+            Checkpoint::getFingerprint(Checkpoint::getFingerprint(toString(stmt)), inputs));
+
     // create and run interpreter
-    Interpreter(env, executor, report, profile, data).visit(stmt);
+    std::atomic<uint64_t> saveTime(0);
+    if (Global::config().has("stream-output")) {
+        IOThread output;
+        Interpreter(env, executor, report, profile, counters, data, &output, saveTime, checkpoint, progress)
+                .visit(stmt);
+    } else {
+        Interpreter(env, executor, report, profile, counters, data, nullptr, saveTime, checkpoint, progress)
+                .visit(stmt);
+    }
+
+    // the checkpoints of a completed evaluation are no longer needed
+    size_t numCheckpoints = 0;
+    std::vector<std::string> saved;
+    visitDepthFirst(stmt, [&](const RamStratum& stratum) {
+        numCheckpoints = std::max(numCheckpoints, stratum.getIndex() + 1);
+        for (const auto& cur : stratum.getRelations()) {
+            saved.push_back(cur.first.getName());
+        }
+    });
+    checkpoint.clear(numCheckpoints, saved);
+
+    // outputs are written during the evaluation, thus their time is also part of the total runtime
+    if (profile) {
+        *profile << "@savetime;" << saveTime / 1e9 << std::endl;
+    }
 }
 }  // namespace
 
 void RamGuidedInterpreter::applyOn(const RamStatement& stmt, RamEnvironment& env, RamData* data) const {
+    if (useBloomFilters()) {
+        registerFilters(stmt, env);
+    }
+
     if (Global::config().has("profile")) {
         std::string fname = Global::config().get("profile");
         // open output stream
@@ -834,9 +1264,36 @@ void RamGuidedInterpreter::applyOn(const RamStatement& stmt, RamEnvironment& env
             throw std::invalid_argument("Cannot open profile log file <" + fname + ">");
         }
         os << "@start-debug\n";
-        run(queryStrategy, report, &os, stmt, env, data);
+        std::unique_ptr<PerfCounters> counters;
+        if (Global::config().has("profile-counters")) {
+            counters.reset(new PerfCounters());
+        }
+        if (Global::config().has("profile-indices")) {
+            visitLookups(stmt, [&](const RamNode& op, const RamRelationIdentifier&, SearchColumns) {
+                env.recordLookups(op);
+            });
+        }
+#ifdef USE_LOCK_STATS
+        resetLockCounts();
+#endif
+        run(queryStrategy, report, &os, counters.get(), stmt, env, data);
+
+        // the statistics of the lookups are summed up by relation and bound columns
+        std::map<std::pair<std::string, SearchColumns>, IndexStats> lookups;
+        visitLookups(stmt, [&](const RamNode& op, const RamRelationIdentifier& rel, SearchColumns columns) {
+            if (IndexStats* stats = env.getLookupStats(op)) {
+                lookups[std::make_pair(rel.getName(), columns)] += *stats;
+            }
+        });
+        for (const auto& cur : lookups) {
+            os << getLookupLabel(cur.first.first, cur.first.second) << cur.second.probes << ";"
+               << cur.second.hits << ";" << cur.second.tuples << "\n";
+        }
+#ifdef USE_LOCK_STATS
+        logLockCounts(os);
+#endif
     } else {
-        run(queryStrategy, report, nullptr, stmt, env, data);
+        run(queryStrategy, report, nullptr, nullptr, stmt, env, data);
     }
 }
 
@@ -1011,11 +1468,28 @@ class IndexMap {
 
     std::map<RamRelationIdentifier, RamAutoIndex> data;
 
+    // the column sets summarized by Bloom filters for each relation
+    std::map<RamRelationIdentifier, std::set<SearchColumns>> filters;
+
 public:
     RamAutoIndex& operator[](const RamRelationIdentifier& rel) {
         return data[rel];
     }
 
+    void addFilter(const RamRelationIdentifier& rel, SearchColumns cols) {
+        filters[rel].insert(cols);
+    }
+
+    const std::set<SearchColumns>& getFilters(const RamRelationIdentifier& rel) const {
+        const static std::set<SearchColumns> empty;
+        auto pos = filters.find(rel);
+        return (pos != filters.end()) ? pos->second : empty;
+    }
+
+    bool hasFilter(const RamRelationIdentifier& rel, SearchColumns cols) const {
+        return getFilters(rel).count(cols) > 0;
+    }
+
     const RamAutoIndex& operator[](const RamRelationIdentifier& rel) const {
         const static RamAutoIndex empty;
         auto pos = data.find(rel);
@@ -1031,21 +1505,48 @@ public:
     }
 };
 
-std::string getRelationType(
-        const RamRelationIdentifier& rel, std::size_t arity, const RamAutoIndex& indices) {
+std::string toIndex(SearchColumns key);
+
+/** Determines whether the tuples of the given relation are stored in a single hash set */
+bool isHashRelation(const RamRelationIdentifier& rel, std::size_t arity, const RamAutoIndex& indices) {
+    if (rel.isBTree() || rel.isBrie() || rel.isEqRel()) {
+        return false;
+    }
+    // only existence checks of full tuples => no order required, unless the tuples are
+    // enumerated through the program interface
+    return rel.isHash() || (!useNoIndex() && arity > 0 && indices.hasOnlyTotalSearches(arity) &&
+                                   !rel.isInput() && !rel.isComputed());
+}
+
+std::string getRelationType(const RamRelationIdentifier& rel, std::size_t arity, const RamAutoIndex& indices,
+        const std::set<SearchColumns>& filters = {}) {
     std::stringstream res;
     res << "ram::Relation";
     res << "<";
 
+    if (!filters.empty()) {
+        res << "ram::Filtered<";
+    }
+
     if (rel.isBTree()) {
-        res << "BTree,";
+        res << "BTree";
     } else if (rel.isBrie()) {
-        res << "Brie,";
+        res << "Brie";
     } else if (rel.isEqRel()) {
-        res << "EqRel,";
+        res << "EqRel";
+    } else if (isHashRelation(rel, arity, indices)) {
+        res << "Hash";
     } else {
-        res << "Auto,";
+        res << "Auto";
+    }
+
+    if (!filters.empty()) {
+        for (auto cols : filters) {
+            res << ", ram::index" << toIndex(cols);
+        }
+        res << ">";
     }
+    res << ",";
 
     res << arity;
     if (!useNoIndex()) {
@@ -1059,6 +1560,31 @@ std::string getRelationType(
     return res.str();
 }
 
+/**
+ * Obtains the orders of the indices maintained by a relation of the type given by getRelationType,
+ * in the order of their declaration. Partial orders are extended by the remaining columns.
+ */
+std::vector<std::string> getIndexOrders(
+        const RamRelationIdentifier& rel, std::size_t arity, const RamAutoIndex& indices) {
+    std::vector<std::string> res;
+    if (arity == 0) {
+        return res;
+    }
+    RamAutoIndex::OrderCollection orders = indices.getAllOrders();
+    if (useNoIndex() || orders.empty() || isHashRelation(rel, arity, indices)) {
+        orders = RamAutoIndex::OrderCollection(1);
+    }
+    for (auto& cur : orders) {
+        for (int i = 0; i < (int)arity; i++) {
+            if (!contains(cur, i)) {
+                cur.push_back(i);
+            }
+        }
+        res.push_back("<" + toString(join(cur, ",")) + ">");
+    }
+    return res;
+}
+
 std::string toIndex(SearchColumns key) {
     std::stringstream tmp;
     tmp << "<";
@@ -1098,7 +1624,17 @@ std::set<RamRelationIdentifier> getReferencedRelations(const RamOperation& op) {
 }
 
 class Printer : public RamVisitor<void, std::ostream&> {
-    // const IndexMap& indices;
+    const IndexMap& indices;
+
+    // the labels of profile events, identified by their position
+    std::vector<std::string>& profileLabels;
+    std::map<std::string, size_t> profileLabelIds;
+
+    // the statistics of the lookups, if recorded: the labels of the slots of all patterns of bound
+    // columns of a relation, and the slot of each lookup within the current query
+    std::vector<size_t>& lookupLabels;
+    std::map<std::pair<std::string, SearchColumns>, size_t> lookupSlots;
+    std::map<const RamNode*, size_t> queryLookups;
 
     std::function<void(std::ostream&, const RamNode*)> rec;
 
@@ -1114,10 +1650,28 @@ class Printer : public RamVisitor<void, std::ostream&> {
     };
 
 public:
-    Printer(const IndexMap& /*indexMap*/) {
+    Printer(const IndexMap& indexMap, std::vector<std::string>& profileLabels,
+            std::vector<size_t>& lookupLabels)
+            : indices(indexMap), profileLabels(profileLabels), lookupLabels(lookupLabels) {
         rec = [&](std::ostream& out, const RamNode* node) { this->visit(*node, out); };
     }
 
+    /** Obtains the identifier of the given label of profile events */
+    size_t getProfileLabel(const std::string& label) {
+        auto pos = profileLabelIds.find(label);
+        if (pos != profileLabelIds.end()) {
+            return pos->second;
+        }
+        profileLabels.push_back(label);
+        return profileLabelIds[label] = profileLabels.size() - 1;
+    }
+
+    /** Obtains the statistics of the lookups of the given operation within the current query, if recorded */
+    std::string getLookupStats(const RamNode& op) const {
+        auto pos = queryLookups.find(&op);
+        return (pos != queryLookups.end()) ? "private_lookups[" + toString(pos->second) + "]" : "";
+    }
+
     // -- relation statements --
 
     void visitCreate(const RamCreate& /*create*/, std::ostream& /*out*/) override {}
@@ -1129,12 +1683,20 @@ public:
 
     void visitLoad(const RamLoad& /*load*/, std::ostream& /*out*/) override {}
 
-    void visitStore(const RamStore& /*store*/, std::ostream& /*out*/) override {}
+    void visitStore(const RamStore& store, std::ostream& out) override {
+        // unless streamed, outputs are written by printAll()
+        if (streamOutput()) {
+            out << "outputThread.submit([this]() {\n";
+            printStoreCode(out, store.getRelation(), "outputDirectory");
+            out << "});\n";
+        }
+    }
 
     void visitInsert(const RamInsert& insert, std::ostream& out) override {
         // enclose operation with a check for an empty relation
         std::set<RamRelationIdentifier> input_relations;
         visitDepthFirst(insert, [&](const RamScan& scan) { input_relations.insert(scan.getRelation()); });
+        visitDepthFirst(insert, [&](const RamHashJoin& join) { input_relations.insert(join.getRelation()); });
         if (!input_relations.empty()) {
             out << "if (" << join(input_relations, "&&", [&](std::ostream& out,
                                                                  const RamRelationIdentifier& rel) {
@@ -1155,6 +1717,30 @@ public:
             out << "std::atomic<uint64_t> num_failed_proofs(0);\n";
         }
 
+        // build the hash tables of all hash joins before entering the loop nest; the table of a join
+        // with the outermost scan is built on the smaller of the two relations
+        const RamHashJoin* outerJoin = getOuterHashJoin(insert);
+        visitDepthFirst(insert, [&](const RamHashJoin& join) {
+            const auto& rel = join.getRelation();
+            auto level = join.getLevel();
+            out << "HashJoinTable join" << level << "(" << rel.getArity() << "," << join.getKeyColumns()
+                << ");\n";
+            if (&join != outerJoin) {
+                out << "join" << level << ".build(*" << getRelationName(rel) << ");\n";
+                return;
+            }
+            const auto& scan = static_cast<const RamScan&>(insert.getOperation());
+            const auto& outer = scan.getRelation();
+            out << "const bool flip" << level << " = " << getRelationName(outer) << "->size() < "
+                << getRelationName(rel) << "->size();\n";
+            out << "HashJoinTable outerJoin" << level << "(" << outer.getArity() << ","
+                << getOuterKeyColumns(getOuterJoinColumns(scan, join)) << ");\n";
+            out << "if (flip" << level << ") outerJoin" << level << ".build(*" << getRelationName(outer)
+                << ");\n";
+            out << "else join" << level << ".build(*" << getRelationName(rel) << ");\n";
+            out << "auto outerPart" << level << " = " << getRelationName(rel) << "->partition();\n";
+        });
+
         // check whether loop nest can be parallelized
         bool parallel = false;
         if (const RamScan* scan = dynamic_cast<const RamScan*>(&insert.getOperation())) {
@@ -1169,6 +1755,9 @@ public:
 
                 // build a parallel block around this loop nest
                 out << "PARALLEL_START;\n";
+                if (Global::config().has("profile-counters")) {
+                    out << "PERF_REGION(perfRegion,profile.getCounters());\n";
+                }
             }
         }
 
@@ -1177,6 +1766,26 @@ public:
             out << "uint64_t private_num_failed_proofs = 0;\n";
         }
 
+        // the lookups of each thread are counted separately, the slots of the program being assigned
+        // to the patterns of bound columns of a relation in the order of their first lookup
+        std::vector<size_t> slots;
+        if (Global::config().has("profile-indices")) {
+            visitLookups(insert,
+                    [&](const RamNode& op, const RamRelationIdentifier& rel, SearchColumns columns) {
+                        auto pattern = std::make_pair(rel.getName(), columns);
+                        auto res = lookupSlots.insert(std::make_pair(pattern, 0));
+                        if (res.second) {
+                            res.first->second = lookupLabels.size();
+                            lookupLabels.push_back(getProfileLabel(getLookupLabel(rel.getName(), columns)));
+                        }
+                        queryLookups[&op] = slots.size();
+                        slots.push_back(res.first->second);
+                    });
+        }
+        if (!slots.empty()) {
+            out << "IndexStats private_lookups[" << slots.size() << "];\n";
+        }
+
         // create operation contexts for this operation
         for (const RamRelationIdentifier& rel : getReferencedRelations(insert.getOperation())) {
             out << "CREATE_OP_CONTEXT(" << getOpContextName(rel) << "," << getRelationName(rel) << "->"
@@ -1190,6 +1799,17 @@ public:
             out << "num_failed_proofs += private_num_failed_proofs;\n";
         }
 
+        // aggregate the statistics of the lookups
+        if (!slots.empty()) {
+            out << "{\n";
+            out << "std::lock_guard<std::mutex> guard(lookupsLock);\n";
+            for (size_t i = 0; i < slots.size(); i++) {
+                out << "lookups[" << slots[i] << "] += private_lookups[" << i << "];\n";
+            }
+            out << "}\n";
+        }
+        queryLookups.clear();
+
         if (parallel) {
             out << "PARALLEL_END;\n";  // end parallel
 
@@ -1211,11 +1831,8 @@ public:
                  << ";";
             std::string label = line.str();
 
-            // print log entry
-            out << "{ auto lease = getOutputLock().acquire(); ";
-            out << "(void)lease;\n";
-            out << "profile << R\"(#" << label << ";)\" << num_failed_proofs << std::endl;\n";
-            out << "}";
+            // log entry
+            out << "profile.logSize(" << getProfileLabel("#" + label + ";") << ",num_failed_proofs);\n";
         }
 
         out << "}\n";  // end lambda
@@ -1234,8 +1851,13 @@ public:
     }
 
     void visitDrop(const RamDrop& drop, std::ostream& out) override {
-        if (drop.getRelation().isTemp()) {
-            out << getRelationName(drop.getRelation()) << "->"
+        const auto& rel = drop.getRelation();
+        if (rel.isOutput() && streamOutput()) {
+            // free streamed outputs once written
+            out << "outputThread.submit([this]() { " << getRelationName(rel) << "->purge(); });\n";
+        } else if (!rel.isInput() && !rel.isComputed()) {
+            // relations exposed by the program interface are retained, e.g. outputs for printAll()
+            out << getRelationName(rel) << "->"
                 << "purge();\n";
         }
     }
@@ -1243,13 +1865,52 @@ public:
     void visitPrintSize(const RamPrintSize& /*print*/, std::ostream& /*out*/) override {}
 
     void visitLogSize(const RamLogSize& print, std::ostream& out) override {
-        out << "{ auto lease = getOutputLock().acquire(); \n";
-        out << "(void)lease;\n";
-        out << "profile << R\"(" << print.getLabel() << ")\" <<  ";
-        out << getRelationName(print.getRelation());
-        out << "->"
-            << "size() << std::endl;\n"
-            << "}";
+        out << "profile.logSize(" << getProfileLabel(print.getLabel()) << ",";
+        out << getRelationName(print.getRelation()) << "->size());\n";
+    }
+
+    void visitLogMemory(const RamLogMemory& log, std::ostream& out) override {
+        for (const RamRelationIdentifier& rel : log.getRelations()) {
+            const std::string name = getRelationName(rel);
+            out << "profile.logMemory(" << getProfileLabel(log.getRelationLabel(rel)) << "," << name
+                << "->getMemoryUsage());\n";
+            const auto orders = getIndexOrders(rel, rel.getArity(), indices[rel]);
+            if (orders.empty()) {
+                continue;
+            }
+            out << "{\n";
+            out << "const auto usage = " << name << "->getIndexMemoryUsage();\n";
+            for (size_t i = 0; i < orders.size(); i++) {
+                out << "profile.logMemory(" << getProfileLabel(log.getIndexLabel(rel, orders[i]))
+                    << ",usage[" << i << "]);\n";
+            }
+            out << "}\n";
+        }
+        out << "profile.logMemory(" << getProfileLabel(log.getLabel("records"))
+            << ",CompiledRecordTables().getMemoryUsage());\n";
+        out << "profile.logMemory(" << getProfileLabel(log.getLabel("symbols"))
+            << ",symTable.getMemoryUsage());\n";
+        out << "profile.logMemory(" << getProfileLabel(log.getLabel("peak")) << ",getPeakMemoryUsage());\n";
+    }
+
+    void visitLogProgress(const RamLogProgress& log, std::ostream& out) override {
+        // the sizes of relations are only computed once they are due to be reported
+        auto sizes = [&](const std::vector<RamRelationIdentifier>& rels) {
+            const auto& names = log.getRelations();
+            out << "{";
+            for (size_t i = 0; i < rels.size(); i++) {
+                out << (i == 0 ? "" : ",") << "{R\"(" << names[i].getName() << ")\","
+                    << getRelationName(rels[i]) << "->size()}";
+            }
+            out << "}";
+        };
+        out << "if (progress.enter(" << log.getIndex() << ")) {\n";
+        out << "progress.sample(";
+        sizes(log.getRelations());
+        out << ",";
+        sizes(log.getDeltas());
+        out << ");\n";
+        out << "}\n";
     }
 
     // -- control flow statements --
@@ -1282,6 +1943,9 @@ public:
         // put each thread in another section
         for (const auto& cur : stmts) {
             out << "SECTION_START;\n";
+            if (Global::config().has("profile-counters")) {
+                out << "PERF_REGION(perfRegion,profile.getCounters());\n";
+            }
             out << print(cur);
             out << "SECTION_END\n";
         }
@@ -1310,12 +1974,49 @@ public:
         out << "if(" << print(exit.getCondition()) << ") break;\n";
     }
 
+    void visitStratum(const RamStratum& stratum, std::ostream& out) override {
+        const size_t index = stratum.getIndex();
+
+        // a completed stratum restores its results instead of computing them
+        out << "if (checkpoint.isCompleted(" << index << ")) {\n";
+        out << "try {";
+        out << "checkpoint.restoreTables(" << index << ", symTable, records);\n";
+        for (const auto& cur : stratum.getRelations()) {
+            out << "if (checkpoint.isNeeded(" << cur.second << ")) ";
+            out << "checkpoint.restore(R\"(" << cur.first.getName() << ")\", " << cur.first.getArity()
+                << ", *" << getRelationName(cur.first) << ");\n";
+        }
+        out << "} catch (std::exception& e) {std::cerr << e.what() << \"\\n\";exit(1);}\n";
+        out << "} else {\n";
+        visit(stratum.getBody(), out);
+        out << "try {";
+        for (const auto& cur : stratum.getRelations()) {
+            if (cur.second > index) {
+                out << "checkpoint.save(R\"(" << cur.first.getName() << ")\", " << cur.first.getArity()
+                    << ", *" << getRelationName(cur.first) << ");\n";
+            }
+        }
+        out << "checkpoint.commit(" << index << ", symTable, records);\n";
+        out << "} catch (std::exception& e) {std::cerr << e.what() << \"\\n\";exit(1);}\n";
+        out << "}\n";
+    }
+
+    void visitIncremental(const RamIncremental& incremental, std::ostream& out) override {
+        // the first run evaluates the program, subsequent runs update it
+        out << "if (!evaluated) {\n";
+        visit(incremental.getInitial(), out);
+        out << "evaluated = true;\n";
+        out << "} else {\n";
+        visit(incremental.getUpdate(), out);
+        out << "}\n";
+    }
+
     void visitLogTimer(const RamLogTimer& timer, std::ostream& out) override {
         // create local scope for name resolution
         out << "{\n";
 
         // create local timer
-        out << "\tRamLogger logger(R\"(" << timer.getLabel() << ")\",profile);\n";
+        out << "\tProfileTimer logger(profile," << getProfileLabel(timer.getLabel()) << ");\n";
 
         // insert statement to be measured
         visit(timer.getNested(), out);
@@ -1362,6 +2063,17 @@ public:
                 visitSearch(scan, out);
                 out << "}\n";
             } else if (scan.getLevel() == 0) {
+                // a hash join with a larger relation enumerates that relation instead
+                auto join = dynamic_cast<const RamHashJoin*>(scan.getNestedOperation());
+                std::vector<int> columns;
+                if (join) {
+                    columns = getOuterJoinColumns(scan, *join);
+                }
+                if (!columns.empty()) {
+                    visitOuterHashJoin(scan, *join, columns, out);
+                    out << "else {\n";
+                }
+
                 // make this loop parallel
                 out << "pfor(auto it = part.begin(); it<part.end(); ++it) \n";
                 out << "try{";
@@ -1369,6 +2081,10 @@ public:
                 visitSearch(scan, out);
                 out << "}\n";
                 out << "} catch(std::exception &e) { SignalHandler::instance()->error(e.what());}\n";
+
+                if (!columns.empty()) {
+                    out << "}\n";
+                }
             } else {
                 out << "for(const auto& env" << level << " : "
                     << "*" << relName << ") {\n";
@@ -1404,21 +2120,98 @@ public:
         out << "const Tuple<RamDomain," << arity << "> key({";
         printKeyTuple();
         out << "});\n";
+
+        // consult the Bloom filter of existence checks before probing the index
+        bool filtered = scan.isPureExistenceCheck() && indices.hasFilter(rel, keys);
+        if (filtered) {
+            out << "if(" << relName << "->mayContain" << index << "(key)) {\n";
+        }
+
         out << "auto range = " << relName << "->"
             << "equalRange" << index << "(key," << ctxName << ");\n";
         if (Global::config().has("profile")) {
             out << "if (range.empty()) ++private_num_failed_proofs;\n";
         }
+        const std::string stats = getLookupStats(scan);
         if (scan.isPureExistenceCheck()) {
-            out << "if(!range.empty()) {\n";
+            if (stats.empty()) {
+                out << "if(!range.empty()) {\n";
+            } else {
+                out << "if(" << stats << ".check(!range.empty())) {\n";
+            }
         } else {
+            if (!stats.empty()) {
+                out << stats << ".probe(!range.empty());\n";
+            }
             out << "for(const auto& env" << level << " : range) {\n";
+            if (!stats.empty()) {
+                out << "++" << stats << ".tuples;\n";
+            }
         }
         visitSearch(scan, out);
         out << "}\n";
+        if (filtered) {
+            out << "}\n";
+        }
         return;
     }
 
+    /* Prints the evaluation of a hash join whose table has been built on the relation of the enclosing scan */
+    void visitOuterHashJoin(const RamScan& scan, const RamHashJoin& hashJoin, const std::vector<int>& columns,
+            std::ostream& out) {
+        auto level = hashJoin.getLevel();
+        out << "if (flip" << level << ") {\n";
+        out << "pfor(auto it = outerPart" << level << ".begin(); it<outerPart" << level << ".end(); ++it) \n";
+        out << "try{";
+        out << "for(const auto& env" << level << " : *it) {\n";
+
+        // probe the table by the values of the join columns
+        std::vector<std::string> key(scan.getRelation().getArity(), "0");
+        for (size_t i = 0; i < columns.size(); i++) {
+            if (columns[i] >= 0) {
+                key[columns[i]] = "env" + toString(level) + "[" + toString(i) + "]";
+            }
+        }
+        out << "const Tuple<RamDomain," << key.size() << "> key({" << join(key, ",") << "});\n";
+        out << "for(const auto& env" << scan.getLevel() << " : outerJoin" << level << ".lookup(key)) {\n";
+        auto condition = scan.getCondition();
+        if (condition) {
+            out << "if( " << print(condition) << ") {\n";
+        }
+        visitSearch(hashJoin, out);
+        if (condition) {
+            out << "}\n";
+        }
+        out << "}\n";
+        out << "}\n";
+        out << "} catch(std::exception &e) { SignalHandler::instance()->error(e.what());}\n";
+        out << "}\n";
+    }
+
+    void visitHashJoin(const RamHashJoin& hashJoin, std::ostream& out) override {
+        const auto& rel = hashJoin.getRelation();
+        auto arity = rel.getArity();
+        auto level = hashJoin.getLevel();
+
+        // probe the hash table built for this join
+        out << "const Tuple<RamDomain," << arity << "> key({";
+        out << join(hashJoin.getKeyPattern(), ",", [&](std::ostream& out, RamValue* value) {
+            if (!value) {
+                out << "0";
+            } else {
+                visit(*value, out);
+            }
+        });
+        out << "});\n";
+        out << "auto range = join" << level << ".lookup(key);\n";
+        if (Global::config().has("profile")) {
+            out << "if (range.empty()) ++private_num_failed_proofs;\n";
+        }
+        out << "for(const auto& env" << level << " : range) {\n";
+        visitSearch(hashJoin, out);
+        out << "}\n";
+    }
+
     void visitLookup(const RamLookup& lookup, std::ostream& out) override {
         auto arity = lookup.getArity();
 
@@ -1511,6 +2304,10 @@ public:
             out << "auto range = " << relName << "->"
                 << "equalRange" << index << "(key," << ctxName << ");\n";
         }
+        const std::string stats = getLookupStats(aggregate);
+        if (!stats.empty()) {
+            out << stats << ".probe(!range.empty());\n";
+        }
 
         // add existence check
         if (aggregate.getFunction() != RamAggregate::COUNT) {
@@ -1519,6 +2316,9 @@ public:
 
         // aggregate result
         out << "for(const auto& cur : range) {\n";
+        if (!stats.empty()) {
+            out << "++" << stats << ".tuples;\n";
+        }
 
         // create aggregation code
         if (aggregate.getFunction() == RamAggregate::COUNT) {
@@ -1716,27 +2516,48 @@ public:
         auto ctxName = "READ_OP_CONTEXT(" + getOpContextName(rel) + ")";
         auto arity = rel.getArity();
 
-        // if it is total we use the contains function
-        if (ne.isTotal()) {
-            out << "!" << relName << "->"
-                << "contains(Tuple<RamDomain," << arity << ">({" << join(ne.getValues(), ",", rec) << "}),"
-                << ctxName << ")";
-            return;
-        }
+        // a lambda for printing the test for the absence of the given key; if lookups are recorded,
+        // it is counted as an existence check
+        const std::string stats = getLookupStats(ne);
+        auto printAbsent = [&](const std::string& key) {
+            if (!stats.empty()) {
+                out << "!" << stats << ".check(";
+                out << (ne.isTotal() ? "" : "!");
+            } else {
+                out << (ne.isTotal() ? "!" : "");
+            }
+            if (ne.isTotal()) {
+                out << relName << "->contains(" << key << "," << ctxName << ")";
+            } else {
+                out << relName << "->equalRange" << toIndex(ne.getKey()) << "(" << key << "," << ctxName
+                    << ").empty()";
+            }
+            out << (stats.empty() ? "" : ")");
+        };
 
-        // else we conduct a range query
-        out << relName << "->"
-            << "equalRange";
-        out << toIndex(ne.getKey());
-        out << "(Tuple<RamDomain," << arity << ">({";
-        out << join(ne.getValues(), ",", [&](std::ostream& out, RamValue* value) {
+        // create the key tuple, where unbound columns are 0
+        std::stringstream key;
+        key << "Tuple<RamDomain," << arity << ">({";
+        key << join(ne.getValues(), ",", [&](std::ostream& out, RamValue* value) {
             if (!value) {
                 out << "0";
             } else {
                 visit(*value, out);
             }
         });
-        out << "})," << ctxName << ").empty()";
+        key << "})";
+
+        // if there is a Bloom filter, it is consulted before the relation itself
+        if (indices.hasFilter(rel, ne.getKey())) {
+            out << "[&](const Tuple<RamDomain," << arity << ">& key) -> bool {\n";
+            out << "return !" << relName << "->mayContain" << toIndex(ne.getKey()) << "(key) || ";
+            printAbsent("key");
+            out << ";\n";
+            out << "}(" << key.str() << ")";
+            return;
+        }
+
+        printAbsent(key.str());
     }
 
     // -- values --
@@ -1924,9 +2745,10 @@ private:
     }
 };
 
-void genCode(std::ostream& out, const RamStatement& stmt, const IndexMap& indices) {
+void genCode(std::ostream& out, const RamStatement& stmt, const IndexMap& indices,
+        std::vector<std::string>& profileLabels, std::vector<size_t>& lookupLabels) {
     // use printer
-    Printer(indices).visit(stmt, out);
+    Printer(indices, profileLabels, lookupLabels).visit(stmt, out);
 }
 }  // namespace
 
@@ -1960,6 +2782,36 @@ std::string RamCompiler::generateCode(
         }
     });
 
+    // collect the column sets of negations and existence checks to be accelerated by Bloom filters
+    if (useBloomFilters()) {
+        // references to delta relations within rules do not carry the properties of their
+        // declaration, thus those are obtained from the creation of the relations
+        std::map<std::string, RamRelationIdentifier> declarations;
+        visitDepthFirst(stmt, [&](const RamCreate& create) {
+            declarations[create.getRelation().getName()] = create.getRelation();
+        });
+
+        auto addFilter = [&](const RamRelationIdentifier& ref, SearchColumns cols) {
+            // filters have to observe every tuple of a relation, which does not hold for the
+            // implicit pairs of equivalence relations nor for swapped temporary relations
+            auto pos = declarations.find(ref.getName());
+            const RamRelationIdentifier& rel = (pos != declarations.end()) ? pos->second : ref;
+            if (cols != 0 && rel.getArity() > 0 && !rel.isTemp() && !rel.isEqRel()) {
+                indices.addFilter(rel, cols);
+            }
+        };
+        visitDepthFirst(stmt, [&](const RamNode& node) {
+            if (const RamScan* scan = dynamic_cast<const RamScan*>(&node)) {
+                if (scan->isPureExistenceCheck()) {
+                    addFilter(scan->getRelation(), scan->getRangeQueryColumns());
+                }
+            }
+            if (const RamNotExists* ne = dynamic_cast<const RamNotExists*>(&node)) {
+                addFilter(ne->getRelation(), ne->getKey());
+            }
+        });
+    }
+
     // compute smallest number of indices (and report)
     if (report) {
         *report << "------ Auto-Index-Generation Report -------\n";
@@ -1978,6 +2830,9 @@ std::string RamCompiler::generateCode(
                 }
                 *report << "\n";
             }
+            if (cur.second.hasOnlyTotalSearches(cur.first.getArity())) {
+                *report << "\tOnly total searches: hash set representation applicable\n";
+            }
             *report << "\tNumber of Indexes: " << cur.second.getAllOrders().size() << "\n";
             for (auto& order : cur.second.getAllOrders()) {
                 *report << "\t\t";
@@ -2050,6 +2905,35 @@ std::string RamCompiler::generateCode(
 
     if (Global::config().has("profile")) {
         os << "std::string profiling_fname;\n";
+        // the log outlives run(), such that the writing of the outputs by printAll() is profiled as well
+        os << "std::unique_ptr<ProfileEventStream> profileLog;\n";
+        os << "uint64_t loadTicks = 0;\n";
+    }
+    if (streamOutput()) {
+        os << "std::string outputDirectory = \".\";\n";
+    }
+
+    // checkpoints are taken after each stratum if the program has been translated for it
+    bool checkpoint = false;
+    visitDepthFirst(stmt, [&](const RamStratum&) { checkpoint = true; });
+    if (checkpoint) {
+        os << "std::string checkpointDirectory;\n";
+        os << "std::vector<IODirectives> inputDirectives;\n";
+    }
+
+    // the progress of the evaluation is reported if the program has been translated for it
+    size_t numStrata = 0;
+    visitDepthFirst(
+            stmt, [&](const RamLogProgress& log) { numStrata = std::max(numStrata, log.getIndex() + 1); });
+    if (numStrata > 0) {
+        os << "std::string progressFile;\n";
+    }
+
+    // programs translated for incremental evaluation are updated by subsequent runs
+    const RamIncremental* incremental = nullptr;
+    visitDepthFirst(stmt, [&](const RamIncremental& cur) { incremental = &cur; });
+    if (incremental) {
+        os << "bool evaluated = false;\n";
     }
 
     // declare symbol table
@@ -2060,8 +2944,16 @@ std::string RamCompiler::generateCode(
     std::string initCons;      // initialization of constructor
     std::string deleteForNew;  // matching deletes for each new, used in the destructor
     std::string registerRel;   // registration of relations
+    std::string purgeAll;      // purging of all relations, such that the program may be run again
     int relCtr = 0;
-    std::string tempType;  // string to hold the type of the temporary relations
+
+    // relations exchanged by swaps need to be of the same type
+    std::map<std::string, std::string> swapPartners;
+    visitDepthFirst(stmt, [&](const RamSwap& swap) {
+        swapPartners[swap.getFirstRelation().getName()] = swap.getSecondRelation().getName();
+        swapPartners[swap.getSecondRelation().getName()] = swap.getFirstRelation().getName();
+    });
+    std::map<std::string, std::string> tempTypes;  // the types of the temporary relations
     visitDepthFirst(stmt, [&](const RamCreate& create) {
 
         // get some table details
@@ -2070,12 +2962,19 @@ std::string RamCompiler::generateCode(
         const std::string& raw_name = rel.getName();
         const std::string& name = getRelationName(rel);
 
-        // ensure that the type of the new knowledge is the same as that of the delta knowledge
-        tempType = (rel.isTemp() && raw_name.find("@delta") != std::string::npos)
-                           ? getRelationType(rel, rel.getArity(), indices[rel])
-                           : tempType;
-        const std::string& type =
-                (rel.isTemp()) ? tempType : getRelationType(rel, rel.getArity(), indices[rel]);
+        // a temporary relation adopts the type of its swap partner if that has been created before
+        std::string type;
+        if (rel.isTemp()) {
+            auto partner = swapPartners.find(raw_name);
+            if (partner != swapPartners.end() && tempTypes.count(partner->second)) {
+                type = tempTypes[partner->second];
+            } else {
+                type = getRelationType(rel, rel.getArity(), indices[rel]);
+            }
+            tempTypes[raw_name] = type;
+        } else {
+            type = getRelationType(rel, rel.getArity(), indices[rel], indices.getFilters(rel));
+        }
 
         // defining table
         os << "// -- Table: " << raw_name << "\n";
@@ -2085,7 +2984,9 @@ std::string RamCompiler::generateCode(
         }
         initCons += name + "(new " + type + "())";
         deleteForNew += "delete " + name + ";\n";
-        if ((rel.isInput() || rel.isComputed()) && !rel.isTemp()) {
+        purgeAll += name + "->truncate();\n";
+        // provenance queries look up the annotations of tuples in all relations
+        if ((rel.isInput() || rel.isComputed() || Global::config().has("provenance")) && !rel.isTemp()) {
             os << "souffle::RelationWrapper<";
             os << relCtr++ << ",";
             os << type << ",";
@@ -2117,6 +3018,26 @@ std::string RamCompiler::generateCode(
                         tupleType + "," + tupleName + ")";
             registerRel += "addRelation(\"" + raw_name + "\",&wrapper_" + name + "," +
                            std::to_string(rel.isInput()) + "," + std::to_string(rel.isOutput()) + ");\n";
+
+            // expose the indexes of the relation to lookups through the program interface
+            if (!useNoIndex()) {
+                for (SearchColumns cols : indices[rel].getSearches()) {
+                    if (cols != 0 && cols != (SearchColumns(1) << arity) - 1) {
+                        registerRel += "wrapper_" + name + ".addIndex" + toIndex(cols) + "();\n";
+                    }
+                }
+            }
+        }
+
+        // collect the tuples inserted into inputs for updates
+        if (incremental) {
+            for (const auto& cur : incremental->getIncrements()) {
+                if (cur.first == rel && !rel.isTemp()) {
+                    registerRel += "wrapper_" + name + ".setIncrement([this](const Tuple<RamDomain," +
+                                   std::to_string(arity) + ">& t) { " + getRelationName(cur.second) +
+                                   "->insert(t); });\n";
+                }
+            }
         }
     });
 
@@ -2171,36 +3092,125 @@ std::string RamCompiler::generateCode(
         os << "#endif\n\n";
     }
 
+    // writes output relations while the evaluation continues
+    if (streamOutput()) {
+        os << "IOThread outputThread;\n";
+    }
+
+    // resume from the checkpoint of an interrupted evaluation of the same program
+    if (checkpoint) {
+        os << "Checkpoint checkpoint(checkpointDirectory, Checkpoint::getFingerprint("
+           << Checkpoint::getFingerprint(toString(stmt)) << "ull, inputDirectives));\n";
+        os << "CompiledRecordTables records;\n";
+
+        // create the record maps of all arities, such that their records can be restored
+        std::set<size_t> arities;
+        visitDepthFirst(stmt, [&](const RamPack& pack) { arities.insert(pack.getValues().size()); });
+        visitDepthFirst(stmt, [&](const RamLookup& lookup) { arities.insert(lookup.getArity()); });
+        for (size_t arity : arities) {
+            os << "souffle::detail::getRecordMap<ram::Tuple<RamDomain," << arity << ">>();\n";
+        }
+    }
+
+    // report the progress of the evaluation to the status file
+    if (numStrata > 0) {
+        os << "ProgressReport progress(progressFile, " << numStrata << ");\n";
+    }
+
     // add actual program body
     os << "// -- query evaluation --\n";
+    // the phases of loading inputs and writing outputs are logged by the first two labels
+    std::vector<std::string> profileLabels = {"@loadtime;", "@savetime;"};
+    std::vector<size_t> lookupLabels;
     if (Global::config().has("profile")) {
-        os << "std::ofstream profile(profiling_fname);\n";
-        os << "profile << \"@start-debug\\n\";\n";
-        genCode(os, stmt, indices);
+        // the labels of the events are written to the head of the profile log
+        std::stringstream body;
+        genCode(body, stmt, indices, profileLabels, lookupLabels);
+
+        // the locks of all sites are logged if the program is built with --enable-lock-stats
+        const size_t lockLabels = profileLabels.size();
+        for (unsigned i = 0; i < numLockSites; i++) {
+            profileLabels.push_back(getLockLabel(static_cast<LockSite>(i)));
+        }
+        os << "profileLog.reset(new ProfileEventStream(profiling_fname, {";
+        os << join(profileLabels, ",", [](std::ostream& out, const std::string& label) {
+            out << "R\"(" << label << ")\"";
+        });
+        os << "}" << (Global::config().has("profile-counters") ? ", true" : "") << "));\n";
+        os << "ProfileEventStream& profile = *profileLog;\n";
+        os << "profile.logDuration(0, loadTicks);\n";
+        os << "loadTicks = 0;\n";
+        os << "#ifdef USE_LOCK_STATS\n";
+        os << "resetLockCounts();\n";
+        os << "#endif\n";
+
+        // the statistics of the lookups are summed up by the queries and logged after the evaluation
+        if (!lookupLabels.empty()) {
+            os << "IndexStats lookups[" << lookupLabels.size() << "];\n";
+            os << "std::mutex lookupsLock;\n";
+        }
+        os << body.str();
+        for (size_t i = 0; i < lookupLabels.size(); i++) {
+            os << "profile.logLookups(" << lookupLabels[i] << ",lookups[" << i << "]);\n";
+        }
+        os << "#ifdef USE_LOCK_STATS\n";
+        os << "for (unsigned i = 0; i < numLockSites; i++) {\n";
+        os << "profile.logLocks(" << lockLabels << " + i, getLockCounts(static_cast<LockSite>(i)));\n";
+        os << "}\n";
+        os << "#endif\n";
     } else {
-        genCode(os, stmt, indices);
+        genCode(os, stmt, indices, profileLabels, lookupLabels);
+    }
+
+    // the checkpoints of a completed evaluation are no longer needed
+    if (checkpoint) {
+        size_t numCheckpoints = 0;
+        std::vector<std::string> saved;
+        visitDepthFirst(stmt, [&](const RamStratum& stratum) {
+            numCheckpoints = std::max(numCheckpoints, stratum.getIndex() + 1);
+            for (const auto& cur : stratum.getRelations()) {
+                saved.push_back("R\"(" + cur.first.getName() + ")\"");
+            }
+        });
+        os << "checkpoint.clear(" << numCheckpoints << ", {" << join(saved, ",") << "});\n";
     }
     os << "}\n";  // end of run() method
 
+    // issue the setter of the directory of streamed outputs
+    if (streamOutput()) {
+        os << "public:\n";
+        os << "void setOutputDirectory(std::string dirname) {\n";
+        os << "outputDirectory = dirname;\n";
+        os << "}\n";
+    }
+
+    // issue the setter of the directory of checkpoints
+    if (checkpoint) {
+        os << "public:\n";
+        os << "void setCheckpointDirectory(std::string dirname) {\n";
+        os << "checkpointDirectory = dirname;\n";
+        os << "}\n";
+    }
+
+    // issue the setter of the status file reporting the progress
+    if (numStrata > 0) {
+        os << "public:\n";
+        os << "void setProgressFile(std::string filename) {\n";
+        os << "progressFile = filename;\n";
+        os << "}\n";
+    }
+
     // issue printAll method
     os << "public:\n";
     os << "void printAll(std::string dirname) {\n";
+    if (Global::config().has("profile")) {
+        os << "const uint64_t start = getProfileTimestamp();\n";
+    }
     visitDepthFirst(stmt, [&](const RamStatement& node) {
         if (auto store = dynamic_cast<const RamStore*>(&node)) {
-            for (IODirectives ioDirectives : store->getRelation().getOutputDirectives()) {
-                os << "try {";
-                os << "std::map<std::string, std::string> directiveMap(" << ioDirectives << ");\n";
-                os << "if (!dirname.empty() && directiveMap[\"IO\"] == \"file\" && ";
-                os << "directiveMap[\"filename\"].front() != '/') {";
-                os << "directiveMap[\"filename\"] = dirname + \"/\" + directiveMap[\"filename\"];";
-                os << "}\n";
-                os << "IODirectives ioDirectives(directiveMap);\n";
-                os << "IOSystem::getInstance().getWriter(";
-                os << "SymbolMask({" << store->getRelation().getSymbolMask() << "})";
-                os << ", symTable, ioDirectives";
-                os << ")->writeAll(*" << getRelationName(store->getRelation()) << ");\n";
-
-                os << "} catch (std::exception& e) {std::cerr << e.what();exit(1);}\n";
+            // streamed outputs are written by run()
+            if (!streamOutput()) {
+                printStoreCode(os, store->getRelation(), "dirname");
             }
         } else if (auto print = dynamic_cast<const RamPrintSize*>(&node)) {
             os << "{ auto lease = getOutputLock().acquire(); \n";
@@ -2211,16 +3221,23 @@ std::string RamCompiler::generateCode(
             os << "}";
         }
     });
+    if (Global::config().has("profile")) {
+        os << "if (profileLog) {\n";
+        os << "profileLog->logDuration(1, getProfileTimestamp() - start);\n";
+        os << "}\n";
+    }
     os << "}\n";  // end of printAll() method
 
     // issue loadAll method
     os << "public:\n";
     os << "void loadAll(std::string dirname) {\n";
+    os << "InputLoader loader;\n";
+    if (checkpoint) {
+        os << "inputDirectives.clear();\n";
+    }
     visitDepthFirst(stmt, [&](const RamLoad& load) {
-        IODirectives ioDirectives = load.getRelation().getInputDirectives();
-
         // get some table details
-        os << "try {";
+        os << "{";
         os << "std::map<std::string, std::string> directiveMap(";
         os << load.getRelation().getInputDirectives() << ");\n";
         os << "if (!dirname.empty() && directiveMap[\"IO\"] == \"file\" && ";
@@ -2228,12 +3245,25 @@ std::string RamCompiler::generateCode(
         os << "directiveMap[\"filename\"] = dirname + \"/\" + directiveMap[\"filename\"];";
         os << "}\n";
         os << "IODirectives ioDirectives(directiveMap);\n";
-        os << "IOSystem::getInstance().getReader(";
+        os << "loader.add(";
         os << "SymbolMask({" << load.getRelation().getSymbolMask() << "})";
-        os << ", symTable, ioDirectives)->readAll(*" << getRelationName(load.getRelation());
+        os << ", symTable, ioDirectives, *" << getRelationName(load.getRelation());
         os << ");\n";
-        os << "} catch (std::exception& e) {std::cerr << e.what();exit(1);}\n";
+        if (checkpoint) {
+            os << "inputDirectives.push_back(ioDirectives);\n";
+        }
+        os << "}\n";
     });
+    // read all inputs concurrently
+    if (Global::config().has("profile")) {
+        os << "const uint64_t start = getProfileTimestamp();\n";
+    }
+    os << "try {";
+    os << "loader.run();\n";
+    os << "} catch (std::exception& e) {std::cerr << e.what();exit(1);}\n";
+    if (Global::config().has("profile")) {
+        os << "loadTicks += getProfileTimestamp() - start;\n";
+    }
     os << "}\n";  // end of loadAll() method
 
     // issue dump methods
@@ -2273,6 +3303,14 @@ std::string RamCompiler::generateCode(
     });
     os << "}\n";  // end of dumpOutputs() method
 
+    os << "public:\n";
+    os << "void purge() {\n";
+    os << purgeAll;
+    if (incremental) {
+        os << "evaluated = false;\n";
+    }
+    os << "}\n";  // end of purge() method
+
     os << "public:\n";
     os << "const SymbolTable &getSymbolTable() const {\n";
     os << "return symTable;\n";
@@ -2312,8 +3350,19 @@ std::string RamCompiler::generateCode(
         os << "false,\n";
         os << "R\"()\",\n";
     }
-    os << std::stoi(Global::config().get("jobs")) << "\n";
-    os << ");\n";
+    os << std::stoi(Global::config().get("jobs"));
+    if (checkpoint) {
+        os << ",\ntrue,\n";
+        os << "R\"(" << Global::config().get("checkpoint") << ")\"";
+    } else if (numStrata > 0) {
+        os << ",\nfalse,\n";
+        os << "R\"()\"";
+    }
+    if (numStrata > 0) {
+        os << ",\ntrue,\n";
+        os << "R\"(" << Global::config().get("progress") << ")\"";
+    }
+    os << "\n);\n";
 
     os << "if (!opt.parse(argc,argv)) return 1;\n";
 
@@ -2329,6 +3378,15 @@ std::string RamCompiler::generateCode(
     }
 
     os << "obj.loadAll(opt.getInputFileDir());\n";
+    if (streamOutput()) {
+        os << "obj.setOutputDirectory(opt.getOutputFileDir());\n";
+    }
+    if (checkpoint) {
+        os << "obj.setCheckpointDirectory(opt.getCheckpointDir());\n";
+    }
+    if (numStrata > 0) {
+        os << "obj.setProgressFile(opt.getProgressFile());\n";
+    }
     os << "obj.run();\n";
     os << "obj.printAll(opt.getOutputFileDir());\n";
     if (Global::config().get("provenance") == "1") {
@@ -214,6 +214,11 @@ public:
         set.clear();
     }
 
+    /** determines the amount of memory used by this index in bytes */
+    size_t getMemoryUsage() const {
+        return sizeof(*this) - sizeof(set) + set.getMemoryUsage();
+    }
+
     /** enables the index to be printed */
     void print(std::ostream& out) const {
         set.printStats(out);
@@ -16,6 +16,8 @@
 
 #include "RamInterface.h"
 
+#include <algorithm>
+
 namespace souffle {
 
 void RamRelationInterface::iterator_base::operator++() {
@@ -70,10 +72,95 @@ void RamRelationInterface::insert(const tuple& t) {
     ramRelation.insert(convertTupleToNums(t));
 }
 
+void RamRelationInterface::insert(const RamDomain* data, std::size_t numTuples) {
+    const size_t arity = getArity();
+    for (std::size_t i = 0; i < numTuples; i++) {
+        ramRelation.insert(data + i * arity);
+    }
+}
+
+void RamRelationInterface::purge() {
+    ramRelation.purge();
+}
+
 bool RamRelationInterface::contains(const tuple& t) const {
     return ramRelation.exists(convertTupleToNums(t));
 }
 
+namespace {
+
+/* cursor over a range of an index of the interpreter */
+class RamIndexCursor : public Relation::cursor {
+    RamIndex::iterator cur;
+    RamIndex::iterator end;
+    size_t arity;
+
+public:
+    RamIndexCursor(const std::pair<RamIndex::iterator, RamIndex::iterator>& range, size_t arity)
+            : cur(range.first), end(range.second), arity(arity) {}
+
+    std::size_t next(RamDomain* buffer, std::size_t numTuples) override {
+        std::size_t res = 0;
+        for (; res < numTuples && cur != end; ++cur, ++res) {
+            for (size_t i = 0; i < arity; i++) {
+                *buffer++ = (*cur)[i];
+            }
+        }
+        return res;
+    }
+};
+
+/* cursor filtering all tuples of a relation of the interpreter */
+class RamScanCursor : public Relation::cursor {
+    RamRelation::iterator cur;
+    RamRelation::iterator end;
+    SearchColumns columns;
+    std::vector<RamDomain> key;
+
+public:
+    RamScanCursor(const RamRelation& rel, SearchColumns columns, const RamDomain* key)
+            : cur(rel.begin()), end(rel.end()), columns(columns), key(key, key + rel.getArity()) {}
+
+    std::size_t next(RamDomain* buffer, std::size_t numTuples) override {
+        std::size_t res = 0;
+        for (; res < numTuples && cur != end; ++cur) {
+            const RamDomain* tuple = *cur;
+            bool match = true;
+            for (size_t i = 0; match && i < key.size(); i++) {
+                match = !((columns >> i) & 1) || tuple[i] == key[i];
+            }
+            if (match) {
+                buffer = std::copy(tuple, tuple + key.size(), buffer);
+                res++;
+            }
+        }
+        return res;
+    }
+};
+}  // namespace
+
+bool RamRelationInterface::hasIndex(SearchColumns columns) const {
+    return columns == 0 || ramRelation.findIndex(columns) != nullptr;
+}
+
+std::unique_ptr<Relation::cursor> RamRelationInterface::lookup(
+        SearchColumns columns, const RamDomain* key) const {
+    // indexes are not created by lookups, which may be conducted concurrently to the evaluation
+    RamIndex* index = (columns == 0) ? nullptr : ramRelation.findIndex(columns);
+    if (index == nullptr) {
+        return std::unique_ptr<cursor>(new RamScanCursor(ramRelation, columns, key));
+    }
+    const size_t arity = getArity();
+    RamDomain low[arity];
+    RamDomain high[arity];
+    for (size_t i = 0; i < arity; i++) {
+        bool bound = (columns >> i) & 1;
+        low[i] = bound ? key[i] : MIN_RAM_DOMAIN;
+        high[i] = bound ? key[i] : MAX_RAM_DOMAIN;
+    }
+    return std::unique_ptr<cursor>(new RamIndexCursor(index->lowerUpperBound(low, high), arity));
+}
+
 typename RamRelationInterface::iterator RamRelationInterface::begin() const {
     return RamRelationInterface::iterator(
             new RamRelationInterface::iterator_base(id, this, ramRelation.begin()));
@@ -65,9 +65,21 @@ public:
     // insert a new tuple into the relation
     void insert(const tuple& t) override;
 
+    // insert tuples stored one after another
+    void insert(const RamDomain* data, std::size_t numTuples) override;
+
+    // remove all tuples from the relation
+    void purge() override;
+
     // check whether a tuple exists in the relation
     bool contains(const tuple& t) const override;
 
+    // only indexes created by the evaluation support lookups
+    bool hasIndex(SearchColumns columns) const override;
+
+    // look up the tuples agreeing with a key on the bound columns
+    std::unique_ptr<cursor> lookup(SearchColumns columns, const RamDomain* key) const override;
+
     // begin and end iterator
     iterator begin() const override;
     iterator end() const override;
@@ -132,6 +144,12 @@ public:
         std::cerr << "Cannot load facts for interpreter program" << std::endl;
     }
 
+    void purge() {
+        for (auto* interface : interfaces) {
+            interface->purge();
+        }
+    }
+
     // print methods
     void printAll(std::string) {}
     void dumpInputs(std::ostream&) {}
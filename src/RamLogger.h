@@ -18,20 +18,57 @@
 #pragma once
 
 #include "ParallelUtils.h"
+#include "PerfCounters.h"
 
 #include <chrono>
+#include <cstddef>
+#include <fstream>
 #include <iostream>
 
+#include <sys/resource.h>
+#include <unistd.h>
+
 namespace souffle {
 
 /**
  * Obtains a reference to the lock synchronizing output operations.
  */
 inline Lock& getOutputLock() {
-    static Lock output_lock;
+    static Lock output_lock(LockSite::output);
     return output_lock;
 }
 
+/**
+ * Obtains the peak memory resident in main memory of this process in bytes, or zero if it is
+ * not available.
+ */
+inline std::size_t getPeakMemoryUsage() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    // reported in kilobytes
+    return usage.ru_maxrss * 1024;
+#endif
+}
+
+/**
+ * Obtains the memory currently resident in main memory of this process in bytes, or zero if it
+ * is not available.
+ */
+inline std::size_t getResidentMemoryUsage() {
+    std::ifstream in("/proc/self/statm");
+    std::size_t size = 0;
+    std::size_t resident = 0;
+    if (!(in >> size >> resident)) {
+        return 0;
+    }
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
 /**
  * The class utilized to times for the souffle profiling tool. This class
  * is utilized by both -- the interpreted and compiled version -- to conduct
@@ -54,18 +91,34 @@ class RamLogger {
     // an output stream to report to
     std::ostream& out;
 
+    // the hardware performance counters to be reported, if any, and their counts at the start
+    PerfCounters* counters;
+    PerfCounts counts;
+
 public:
-    RamLogger(const char* label, std::ostream& out = std::cout) : label(label), out(out) {
+    RamLogger(const char* label, std::ostream& out = std::cout, PerfCounters* counters = nullptr)
+            : label(label), out(out), counters(counters) {
+        if (counters) {
+            counts = counters->read();
+        }
         start = clock::now();
     }
 
     ~RamLogger() {
         auto duration = clock::now() - start;
+        PerfCounts diff;
+        if (counters) {
+            diff = counters->read() - counts;
+        }
 
         auto leas = getOutputLock().acquire();
         (void)leas;  // avoid warning
         out << label << std::chrono::duration_cast<std::chrono::duration<double>>(duration).count()
             << std::endl;
+        if (counters) {
+            out << getCounterLabel(label) << diff.cycles << ";" << diff.instructions << ";"
+                << diff.cacheMisses << ";" << diff.branchMisses << std::endl;
+        }
     }
 };
 
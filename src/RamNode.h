@@ -42,6 +42,7 @@ enum RamNodeType {
     RN_Project,
     RN_Lookup,
     RN_Scan,
+    RN_HashJoin,
     RN_Aggregate,
 
     // statements
@@ -54,6 +55,8 @@ enum RamNodeType {
     RN_Drop,
     RN_PrintSize,
     RN_LogSize,
+    RN_LogMemory,
+    RN_LogProgress,
 
     RN_Merge,
     RN_Swap,
@@ -61,6 +64,8 @@ enum RamNodeType {
     // control flow
     RN_Sequence,
     RN_Loop,
+    RN_Stratum,
+    RN_Incremental,
     RN_Parallel,
     RN_Exit,
     RN_LogTimer,
@@ -156,6 +156,37 @@ void RamScan::print(std::ostream& os, int tabpos) const {
     }
 }
 
+/*
+ * Class HashJoin
+ */
+
+/** print search */
+void RamHashJoin::print(std::ostream& os, int tabpos) const {
+    os << times('\t', tabpos);
+
+    os << "HASH JOIN " << relation.getName() << " AS t" << level << " ON ";
+    bool first = true;
+    for (size_t i = 0; i < relation.getArity(); i++) {
+        if (keyPattern[i] != nullptr) {
+            if (first) {
+                first = false;
+            } else {
+                os << "and ";
+            }
+            os << "t" << level << "." << relation.getArg(i) << "=";
+            keyPattern[i]->print(os);
+            os << " ";
+        }
+    }
+    if (auto condition = getCondition()) {
+        os << "WHERE ";
+        condition->print(os);
+    }
+
+    os << "\n";
+    getNestedOperation()->print(os, tabpos + 1);
+}
+
 /*
  * Class Lookup
  */
@@ -69,6 +69,11 @@ public:
         return condition.get();
     }
 
+    /** take the optional condition on this level */
+    std::unique_ptr<RamCondition> takeCondition() {
+        return std::move(condition);
+    }
+
     /** Obtains a list of child nodes */
     std::vector<const RamNode*> getChildNodes() const override {
         if (!condition) {
@@ -99,6 +104,11 @@ public:
         nestedOperation.swap(o);
     }
 
+    /** take nested operation */
+    std::unique_ptr<RamOperation> takeNestedOperation() {
+        return std::move(nestedOperation);
+    }
+
     /** Add condition */
     void addCondition(std::unique_ptr<RamCondition> c, RamOperation* root) override;
 
@@ -168,6 +178,11 @@ public:
         return toPtrVector(queryPattern);
     }
 
+    /** Takes the pattern of values utilized as the input for a range query. */
+    std::vector<std::unique_ptr<RamValue>> takeRangePattern() {
+        return std::move(queryPattern);
+    }
+
     /** Determines whether this scan step is merely checking the existence of some value */
     bool isPureExistenceCheck() const {
         return pureExistenceCheck;
@@ -206,6 +221,63 @@ public:
     }
 };
 
+/**
+ * Joins the tuples of a relation with the bindings of the enclosing levels by probing
+ * a temporary hash table keyed by the join columns. The table is built once for each
+ * evaluation of the enclosing query, such that no ordered index has to be maintained
+ * for the join columns.
+ */
+class RamHashJoin : public RamSearch {
+    /** the joined relation */
+    RamRelationIdentifier relation;
+
+    /** values of the join columns (nullptr for other columns) */
+    std::vector<std::unique_ptr<RamValue>> keyPattern;
+
+    /** the columns to be matched */
+    SearchColumns keys;
+
+public:
+    RamHashJoin(const RamRelationIdentifier& r, std::vector<std::unique_ptr<RamValue>> pattern,
+            SearchColumns keys, std::unique_ptr<RamCondition> cond, std::unique_ptr<RamOperation> nested)
+            : RamSearch(RN_HashJoin, std::move(nested)), relation(r), keyPattern(std::move(pattern)),
+              keys(keys) {
+        assert(keys != 0 && keyPattern.size() == relation.getArity());
+        condition = std::move(cond);
+    }
+
+    ~RamHashJoin() override = default;
+
+    /** Obtains the id of the joined relation */
+    const RamRelationIdentifier& getRelation() const {
+        return relation;
+    }
+
+    /** Obtains a mask indicating the join columns */
+    SearchColumns getKeyColumns() const {
+        return keys;
+    }
+
+    /** Obtains the values to be matched by the join columns */
+    std::vector<RamValue*> getKeyPattern() const {
+        return toPtrVector(keyPattern);
+    }
+
+    /** print search */
+    void print(std::ostream& os, int tabpos) const override;
+
+    /** Obtains a list of child nodes */
+    std::vector<const RamNode*> getChildNodes() const override {
+        auto res = RamSearch::getChildNodes();
+        for (auto& cur : keyPattern) {
+            if (cur) {
+                res.push_back(cur.get());
+            }
+        }
+        return res;
+    }
+};
+
 /** Lookup of records */
 class RamLookup : public RamSearch {
     /** The level of the tuple containing the reference to resolve */
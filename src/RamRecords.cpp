@@ -86,14 +86,52 @@ public:
 
         return res;
     }
+
+    /**
+     * Obtains the amount of memory used by the stored tuples and their mappings.
+     */
+    size_t getMemoryUsage() {
+        size_t res;
+
+#pragma omp critical(record_unpack)
+        {
+            // each tuple is stored in both directions, the mapping to indices in a tree node
+            const size_t tuple = sizeof(vector<RamDomain>) + arity * sizeof(RamDomain);
+            res = sizeof(*this) + i2r.capacity() * sizeof(vector<RamDomain>) +
+                  i2r.size() * arity * sizeof(RamDomain);
+            res += r2i.size() * (tuple + sizeof(RamDomain) + 4 * sizeof(void*));
+        }
+
+        return res;
+    }
+
+    /**
+     * Obtains the number of stored tuples.
+     */
+    size_t size() {
+        size_t res;
+
+#pragma omp critical(record_unpack)
+        res = i2r.size() - 1;
+
+        return res;
+    }
 };
 
+/**
+ * The record maps of all arities.
+ */
+map<int, RecordMap>& getMaps() {
+    static map<int, RecordMap> maps;
+    return maps;
+}
+
 /**
  * The static access function for record maps of certain arities.
  */
 RecordMap& getForArity(int arity) {
     // the static container -- filled on demand
-    static map<int, RecordMap> maps;
+    auto& maps = getMaps();
 
     // get container if present
     auto pos = maps.find(arity);
@@ -125,4 +163,32 @@ bool isNull(RamDomain ref) {
     return ref == 0;
 }
 
+std::vector<int> RamRecordTables::getArities() const {
+    std::vector<int> res;
+    for (const auto& cur : getMaps()) {
+        res.push_back(cur.first);
+    }
+    return res;
+}
+
+std::size_t RamRecordTables::size(int arity) const {
+    return getForArity(arity).size();
+}
+
+const RamDomain* RamRecordTables::unpack(int arity, RamDomain index) const {
+    return getForArity(arity).unpack(index);
+}
+
+RamDomain RamRecordTables::pack(int arity, const RamDomain* tuple) {
+    return getForArity(arity).pack(tuple);
+}
+
+std::size_t RamRecordTables::getMemoryUsage() const {
+    std::size_t res = 0;
+    for (auto& cur : getMaps()) {
+        res += cur.second.getMemoryUsage();
+    }
+    return res;
+}
+
 }  // end of namespace souffle
@@ -16,8 +16,11 @@
 
 #pragma once
 
+#include "Checkpoint.h"
 #include "RamTypes.h"
 
+#include <vector>
+
 namespace souffle {
 
 /**
@@ -41,4 +44,18 @@ RamDomain getNull();
  */
 bool isNull(RamDomain ref);
 
+/**
+ * The record tables of the interpreter, as saved and restored by checkpoints.
+ */
+class RamRecordTables : public RecordTables {
+public:
+    std::vector<int> getArities() const override;
+    std::size_t size(int arity) const override;
+    const RamDomain* unpack(int arity, RamDomain index) const override;
+    RamDomain pack(int arity, const RamDomain* tuple) override;
+
+    /** Obtains the amount of memory used by all record tables in bytes */
+    std::size_t getMemoryUsage() const;
+};
+
 }  // end of namespace souffle
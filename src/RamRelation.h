@@ -21,7 +21,9 @@
 
 #pragma once
 
+#include "BloomFilter.h"
 #include "IODirectives.h"
+#include "IndexStats.h"
 #include "RamIndex.h"
 #include "RamTypes.h"
 #include "SymbolMask.h"
@@ -31,13 +33,16 @@
 
 #include <list>
 #include <map>
+#include <set>
 #include <string>
+#include <vector>
 #include <pthread.h>
 
 namespace souffle {
 
 // forward declaration
 class RamEnvironment;
+class RamNode;
 class RamRelation;
 
 class RamRelationIdentifier {
@@ -52,6 +57,7 @@ class RamRelationIdentifier {
     bool btree;
     bool brie;
     bool eqrel;
+    bool hashset;
 
     bool isdata;
     bool istemp;
@@ -66,7 +72,7 @@ class RamRelationIdentifier {
 public:
     RamRelationIdentifier()
             : arity(0), mask(arity), input(false), computed(false), output(false), btree(false), brie(false),
-              eqrel(false), isdata(false), istemp(false), last(nullptr), rel(nullptr) {}
+              eqrel(false), hashset(false), isdata(false), istemp(false), last(nullptr), rel(nullptr) {}
 
     RamRelationIdentifier(const std::string& name, unsigned arity, const bool istemp)
             : RamRelationIdentifier(name, arity) {
@@ -78,13 +84,14 @@ public:
             std::vector<std::string> attributeTypeQualifiers = {}, const SymbolMask& mask = SymbolMask(0),
             const bool input = false, const bool computed = false, const bool output = false,
             const bool btree = false, const bool brie = false, const bool eqrel = false,
-            const bool isdata = false, const IODirectives inputDirectives = IODirectives(),
+            const bool hashset = false, const bool isdata = false,
+            const IODirectives inputDirectives = IODirectives(),
             const std::vector<IODirectives> outputDirectives = {}, const bool istemp = false)
             : name(name), arity(arity), attributeNames(attributeNames),
               attributeTypeQualifiers(attributeTypeQualifiers), mask(mask), input(input), computed(computed),
-              output(output), btree(btree), brie(brie), eqrel(eqrel), isdata(isdata), istemp(istemp),
-              inputDirectives(inputDirectives), outputDirectives(outputDirectives), last(nullptr),
-              rel(nullptr) {
+              output(output), btree(btree), brie(brie), eqrel(eqrel), hashset(hashset), isdata(isdata),
+              istemp(istemp), inputDirectives(inputDirectives), outputDirectives(outputDirectives),
+              last(nullptr), rel(nullptr) {
         assert(this->attributeNames.size() == arity || this->attributeNames.empty());
         assert(this->attributeTypeQualifiers.size() == arity || this->attributeTypeQualifiers.empty());
     }
@@ -135,6 +142,10 @@ public:
         return eqrel;
     }
 
+    const bool isHash() const {
+        return hashset;
+    }
+
     const bool isTemp() const {
         return istemp;
     }
@@ -214,6 +225,9 @@ class RamRelation {
 
     mutable RamIndex* totalIndex;
 
+    /** Bloom filters for negations and existence checks, registered before the evaluation */
+    std::vector<std::unique_ptr<RelationFilter>> filters;
+
     /** lock for parallel execution */
     mutable pthread_mutex_t lock;
 
@@ -234,6 +248,7 @@ public:
         // take over ownership
         head.swap(other.head);
         indices.swap(other.indices);
+        filters.swap(other.filters);
 
         allocatedBlocks.swap(other.allocatedBlocks);
     }
@@ -255,6 +270,7 @@ public:
         // take over ownership
         head.swap(other.head);
         indices.swap(other.indices);
+        filters.swap(other.filters);
 
         return *this;
     }
@@ -317,6 +333,11 @@ public:
             cur.second->insert(newTuple);
         }
 
+        // update all filters with new tuple
+        for (const auto& cur : filters) {
+            cur->insert(newTuple);
+        }
+
         // increment relation size
         num_tuples++;
     }
@@ -424,9 +445,39 @@ public:
         for (const auto& cur : indices) {
             cur.second->purge();
         }
+        for (const auto& cur : filters) {
+            cur->clear();
+        }
         num_tuples = 0;
     }
 
+    /** Determines the amount of memory used by the tuples, indices and filters of this relation in bytes */
+    size_t getMemoryUsage() const {
+        size_t res = sizeof(*this);
+        for (const Block* cur = head.get(); cur != nullptr; cur = cur->next.get()) {
+            res += sizeof(Block) + cur->size * sizeof(RamDomain);
+        }
+        res += allocatedBlocks.size() * (2 * sizeof(RamDomain) + 3 * sizeof(void*));
+        for (const auto& cur : getIndexMemoryUsage()) {
+            res += cur.second;
+        }
+        for (const auto& cur : filters) {
+            res += cur->getMemoryUsage();
+        }
+        return res;
+    }
+
+    /** Determines the amount of memory used by each index of this relation in bytes */
+    std::vector<std::pair<RamIndexOrder, size_t>> getIndexMemoryUsage() const {
+        std::vector<std::pair<RamIndexOrder, size_t>> res;
+        pthread_mutex_lock(&lock);
+        for (const auto& cur : indices) {
+            res.push_back(std::make_pair(cur.first, cur.second->getMemoryUsage()));
+        }
+        pthread_mutex_unlock(&lock);
+        return res;
+    }
+
     /** get index for a given set of keys using a cached index as a helper. Keys are encoded as bits for each
      * column */
     RamIndex* getIndex(const SearchColumns& key, RamIndex* cachedIndex) const {
@@ -436,19 +487,13 @@ public:
         return getIndex(cachedIndex->order());
     }
 
-    /** get index for a given set of keys. Keys are encoded as bits for each column */
-    RamIndex* getIndex(const SearchColumns& key) const {
-        // suffix for order, if no matching prefix exists
-        std::vector<unsigned char> suffix;
-        suffix.reserve(getArity());
-
-        // convert to order
+    /** get an existing index for a given set of keys, nullptr if there is none. Keys are encoded as bits
+     * for each column */
+    RamIndex* findIndex(const SearchColumns& key) const {
         RamIndexOrder order;
         for (size_t k = 1, i = 0; i < getArity(); i++, k *= 2) {
             if (key & k) {
                 order.append(i);
-            } else {
-                suffix.push_back(i);
             }
         }
 
@@ -461,15 +506,27 @@ public:
             }
         }
         pthread_mutex_unlock(&lock);
+        return res;
+    }
 
+    /** get index for a given set of keys. Keys are encoded as bits for each column */
+    RamIndex* getIndex(const SearchColumns& key) const {
         // if found, use compatible index
-        if (res) {
+        if (RamIndex* res = findIndex(key)) {
             return res;
         }
 
         // extend index to full index
-        for (auto cur : suffix) {
-            order.append(cur);
+        RamIndexOrder order;
+        for (size_t k = 1, i = 0; i < getArity(); i++, k *= 2) {
+            if (key & k) {
+                order.append(i);
+            }
+        }
+        for (size_t k = 1, i = 0; i < getArity(); i++, k *= 2) {
+            if (!(key & k)) {
+                order.append(i);
+            }
         }
         assert(order.isComplete());
 
@@ -514,6 +571,31 @@ public:
         return totalIndex->exists(tuple);
     }
 
+    /**
+     * Tests whether there may be a tuple in the relation matching the given tuple on the
+     * given columns using a Bloom filter. A negative answer is definite.
+     */
+    bool mayContain(const SearchColumns& key, const RamDomain* tuple) const {
+        // a relation carries few filters, thus a linear search is cheapest
+        for (const auto& cur : filters) {
+            if (cur->getColumns() == key) {
+                return cur->mayContain(tuple, *this);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Adds a Bloom filter summarizing the given columns to this relation. Not thread
+     * safe, filters have to be added before the relation is tested.
+     */
+    void addFilter(const SearchColumns& key) {
+        for (const auto& cur : filters) {
+            if (cur->getColumns() == key) return;
+        }
+        filters.emplace_back(new RelationFilter(key));
+    }
+
     /** input table as memory */
     bool load(std::vector<std::vector<std::string>> data, SymbolTable& symTable, const SymbolMask& mask);
 
@@ -611,6 +693,12 @@ class RamEnvironment {
     /** The increment counter utilized by some RAM language constructs */
     int counter;
 
+    /** The statistics of the lookups of each operation, if recorded */
+    std::map<const RamNode*, IndexStats> lookups;
+
+    /** The columns summarized by Bloom filters for each relation */
+    std::map<std::string, std::set<SearchColumns>> filters;
+
 public:
     RamEnvironment(SymbolTable& symbolTable) : symbolTable(symbolTable), counter(0) {}
 
@@ -636,6 +724,44 @@ public:
         return counter++;
     }
 
+    /**
+     * Records the lookups of the given operation. All operations have to
+     * be registered before the evaluation, which may update their
+     * statistics concurrently.
+     */
+    void recordLookups(const RamNode& op) {
+        lookups[&op];
+    }
+
+    /**
+     * Registers a Bloom filter summarizing the given columns of the given relation,
+     * which is attached to the relation when it is created. All filters have to be
+     * registered before the evaluation.
+     */
+    void addFilter(const std::string& rel, SearchColumns columns) {
+        filters[rel].insert(columns);
+        auto pos = data.find(rel);
+        if (pos != data.end()) {
+            pos->second.addFilter(columns);
+        }
+    }
+
+    /**
+     * Obtains the statistics of the lookups of the given operation, or
+     * null if those are not recorded.
+     */
+    IndexStats* getLookupStats(const RamNode& op) {
+        auto pos = lookups.find(&op);
+        return (pos != lookups.end()) ? &pos->second : nullptr;
+    }
+
+    /**
+     * Obtains the statistics of the lookups of all recorded operations.
+     */
+    const std::map<const RamNode*, IndexStats>& getLookupStats() const {
+        return lookups;
+    }
+
     /**
      * Obtains a mutable reference to one of the relations maintained
      * by this environment. If the addressed relation does not exist,
@@ -653,6 +779,12 @@ public:
             res = &(pos->second);
         } else {
             res = &(data.emplace(id.getName(), id).first->second);
+            auto filter = filters.find(id.getName());
+            if (filter != filters.end()) {
+                for (SearchColumns columns : filter->second) {
+                    res->addFilter(columns);
+                }
+            }
         }
 
         // cache result
@@ -219,6 +219,111 @@ public:
     }
 };
 
+/**
+ * Logs the memory used by the given relations, their indices, the record tables and the symbol
+ * table once a stratum has been evaluated, together with the peak memory of the process so far.
+ */
+class RamLogMemory : public RamStatement {
+    // the index of the stratum after which the memory is sampled
+    size_t index;
+
+    // the relations still present after the stratum
+    std::vector<RamRelationIdentifier> relations;
+
+public:
+    RamLogMemory(size_t index, const std::vector<RamRelationIdentifier>& relations)
+            : RamStatement(RN_LogMemory), index(index), relations(relations) {}
+
+    size_t getIndex() const {
+        return index;
+    }
+
+    const std::vector<RamRelationIdentifier>& getRelations() const {
+        return relations;
+    }
+
+    /** Obtains the label of the memory of the given relation, to be followed by its number of bytes */
+    std::string getRelationLabel(const RamRelationIdentifier& rel) const {
+        return "@m-relation;" + rel.getName() + ";" + std::to_string(index) + ";";
+    }
+
+    /** Obtains the label of the memory of the index of the given relation of the given order */
+    std::string getIndexLabel(const RamRelationIdentifier& rel, const std::string& order) const {
+        return "@m-index;" + rel.getName() + ";" + std::to_string(index) + ";" + order + ";";
+    }
+
+    /** Obtains the label of the memory of the program of the given kind, i.e. records, symbols or peak */
+    std::string getLabel(const std::string& kind) const {
+        return "@m-" + kind + ";" + std::to_string(index) + ";";
+    }
+
+    void print(std::ostream& os, int tabpos) const override {
+        for (int i = 0; i < tabpos; ++i) {
+            os << '\t';
+        }
+        os << "LOGMEMORY " << index << " ("
+           << join(relations, ",", [](std::ostream& out, const RamRelationIdentifier& cur) {
+                  out << cur.getName();
+              })
+           << ")";
+    }
+
+    /** Obtains a list of child nodes */
+    std::vector<const RamNode*> getChildNodes() const override {
+        return std::vector<const RamNode*>();  // no child nodes
+    }
+};
+
+/**
+ * Reports the progress of the evaluation on entering a stratum or an iteration of its fixpoint
+ * computation, together with the sizes of its relations and of their deltas if they are due.
+ */
+class RamLogProgress : public RamStatement {
+    // the index of the stratum
+    size_t index;
+
+    // the relations computed by the stratum
+    std::vector<RamRelationIdentifier> relations;
+
+    // the deltas of the relations within an iteration, empty on entering the stratum
+    std::vector<RamRelationIdentifier> deltas;
+
+public:
+    RamLogProgress(size_t index, const std::vector<RamRelationIdentifier>& relations,
+            const std::vector<RamRelationIdentifier>& deltas = {})
+            : RamStatement(RN_LogProgress), index(index), relations(relations), deltas(deltas) {
+        ASSERT(deltas.empty() || deltas.size() == relations.size());
+    }
+
+    size_t getIndex() const {
+        return index;
+    }
+
+    const std::vector<RamRelationIdentifier>& getRelations() const {
+        return relations;
+    }
+
+    const std::vector<RamRelationIdentifier>& getDeltas() const {
+        return deltas;
+    }
+
+    void print(std::ostream& os, int tabpos) const override {
+        auto names = [](std::ostream& out, const RamRelationIdentifier& cur) { out << cur.getName(); };
+        for (int i = 0; i < tabpos; ++i) {
+            os << '\t';
+        }
+        os << "LOGPROGRESS " << index << " (" << join(relations, ",", names) << ")";
+        if (!deltas.empty()) {
+            os << " DELTAS (" << join(deltas, ",", names) << ")";
+        }
+    }
+
+    /** Obtains a list of child nodes */
+    std::vector<const RamNode*> getChildNodes() const override {
+        return std::vector<const RamNode*>();  // no child nodes
+    }
+};
+
 /** A relational algebra query */
 class RamInsert : public RamStatement {
     std::unique_ptr<const AstClause> clause;
@@ -240,6 +345,10 @@ public:
         return *operation;
     }
 
+    RamOperation& getOperation() {
+        return *operation;
+    }
+
     void print(std::ostream& os, int tabpos) const override {
         for (int i = 0; i < tabpos; ++i) {
             os << '\t';
@@ -427,6 +536,133 @@ public:
     }
 };
 
+/**
+ * The evaluation of a stratum of the program, i.e. of the relations of an SCC of the precedence
+ * graph, as a unit of checkpointing. Once the body has been evaluated, the relations computed
+ * by it are saved, unless they are dropped right after the stratum. A resumed evaluation skips
+ * completed strata and restores those of their relations still needed.
+ */
+class RamStratum : public RamStatement {
+    std::unique_ptr<RamStatement> body;
+
+    // the index of this stratum within the program
+    size_t index;
+
+    // the relations computed by this stratum with the last stratum they are retained for
+    std::vector<std::pair<RamRelationIdentifier, size_t>> relations;
+
+public:
+    RamStratum(std::unique_ptr<RamStatement> b, size_t index,
+            const std::vector<std::pair<RamRelationIdentifier, size_t>>& relations)
+            : RamStatement(RN_Stratum), body(std::move(b)), index(index), relations(relations) {
+        ASSERT(body);
+    }
+
+    ~RamStratum() override = default;
+
+    const RamStatement& getBody() const {
+        return *body;
+    }
+
+    size_t getIndex() const {
+        return index;
+    }
+
+    const std::vector<std::pair<RamRelationIdentifier, size_t>>& getRelations() const {
+        return relations;
+    }
+
+    void print(std::ostream& os, int tabpos) const override {
+        for (int i = 0; i < tabpos; ++i) {
+            os << '\t';
+        }
+        os << "BEGIN STRATUM " << index << " ("
+           << join(relations, ",",
+                      [](std::ostream& out, const std::pair<RamRelationIdentifier, size_t>& cur) {
+                          out << cur.first.getName() << ":" << cur.second;
+                      })
+           << ")\n";
+        body->print(os, tabpos + 1);
+        os << "\n";
+        for (int i = 0; i < tabpos; ++i) {
+            os << '\t';
+        }
+        os << "END STRATUM " << index;
+    }
+
+    /** Obtains a list of child nodes */
+    std::vector<const RamNode*> getChildNodes() const override {
+        return toVector<const RamNode*>(body.get());
+    }
+};
+
+/**
+ * A program evaluated once on its inputs and re-evaluated by a separate update statement when
+ * tuples have been inserted into its input relations afterwards. The tuples inserted into an
+ * input relation are collected in an associated increment relation.
+ */
+class RamIncremental : public RamStatement {
+    std::unique_ptr<RamStatement> initial;
+    std::unique_ptr<RamStatement> update;
+
+    // the input relations with the relations collecting the tuples inserted into them
+    std::vector<std::pair<RamRelationIdentifier, RamRelationIdentifier>> increments;
+
+public:
+    RamIncremental(std::unique_ptr<RamStatement> i, std::unique_ptr<RamStatement> u,
+            const std::vector<std::pair<RamRelationIdentifier, RamRelationIdentifier>>& increments)
+            : RamStatement(RN_Incremental), initial(std::move(i)), update(std::move(u)),
+              increments(increments) {
+        ASSERT(initial && update);
+    }
+
+    ~RamIncremental() override = default;
+
+    /** Obtains the statement evaluating the program for the first time */
+    const RamStatement& getInitial() const {
+        return *initial;
+    }
+
+    /** Obtains the statement re-evaluating the program after inserting tuples into its inputs */
+    const RamStatement& getUpdate() const {
+        return *update;
+    }
+
+    const std::vector<std::pair<RamRelationIdentifier, RamRelationIdentifier>>& getIncrements() const {
+        return increments;
+    }
+
+    void print(std::ostream& os, int tabpos) const override {
+        for (int i = 0; i < tabpos; ++i) {
+            os << '\t';
+        }
+        typedef std::pair<RamRelationIdentifier, RamRelationIdentifier> increment;
+        os << "BEGIN INCREMENTAL ("
+           << join(increments, ",",
+                      [](std::ostream& out, const increment& cur) {
+                          out << cur.first.getName() << ":" << cur.second.getName();
+                      })
+           << ")\n";
+        initial->print(os, tabpos + 1);
+        os << "\n";
+        for (int i = 0; i < tabpos; ++i) {
+            os << '\t';
+        }
+        os << "ON UPDATE\n";
+        update->print(os, tabpos + 1);
+        os << "\n";
+        for (int i = 0; i < tabpos; ++i) {
+            os << '\t';
+        }
+        os << "END INCREMENTAL";
+    }
+
+    /** Obtains a list of child nodes */
+    std::vector<const RamNode*> getChildNodes() const override {
+        return toVector<const RamNode*>(initial.get(), update.get());
+    }
+};
+
 /** Swap operation for temporary relations. */
 class RamSwap : public RamStatement {
     RamRelationIdentifier first;
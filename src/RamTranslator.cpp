@@ -25,7 +25,9 @@
 #include "BinaryConstraintOps.h"
 #include "Global.h"
 #include "PrecedenceGraph.h"
+#include "RamAutoIndex.h"
 #include "RamStatement.h"
+#include "RamVisitor.h"
 
 namespace souffle {
 
@@ -131,7 +133,14 @@ RamRelationIdentifier getRamRelationIdentifier(std::string name, unsigned arity,
     }
     return RamRelationIdentifier(name, arity, attributeNames, attributeTypeQualifiers,
             getSymbolMask(*rel, *typeEnv), rel->isInput(), rel->isComputed(), rel->isOutput(), rel->isBTree(),
-            rel->isBrie(), rel->isEqRel(), rel->isData(), inputDirectives, outputDirectives, istemp);
+            rel->isBrie(), rel->isEqRel(), rel->isHash(), rel->isData(), inputDirectives, outputDirectives,
+            istemp);
+}
+
+/** Obtains the relation collecting the tuples added to the given relation by an update */
+RamRelationIdentifier getIncrementIdentifier(const AstRelation* rel, const TypeEnvironment* typeEnv) {
+    return getRamRelationIdentifier(
+            "inc_" + getRelationName(rel->getName()), rel->getArity(), rel, typeEnv, true);
 }
 }  // namespace
 
@@ -734,6 +743,11 @@ std::unique_ptr<RamStatement> RamTranslator::translateNonRecursiveRelation(const
         // translate clause
         std::unique_ptr<RamStatement> rule = translateClause(*clause, program, &typeEnv);
 
+        // the rule is evaluated once => its joins may be realized by hash joins
+        if (RamInsert* insert = dynamic_cast<RamInsert*>(rule.get())) {
+            oneShotQueries.push_back(insert);
+        }
+
         // add logging
         if (logging) {
             std::string clauseText = stringify(toString(*clause));
@@ -820,7 +834,8 @@ void nameUnnamedVariables(AstClause* clause) {
 /** generate RAM code for recursive relations in a strongly-connected component */
 std::unique_ptr<RamStatement> RamTranslator::translateRecursiveRelation(
         const std::set<const AstRelation*>& scc, const AstProgram* program,
-        const RecursiveClauses* recursiveClauses, const TypeEnvironment& typeEnv) {
+        const RecursiveClauses* recursiveClauses, const TypeEnvironment& typeEnv,
+        const std::set<const AstRelation*>* changed) {
     // initialize sections
     std::unique_ptr<RamStatement> preamble;
     std::unique_ptr<RamSequence> updateTable(new RamSequence());
@@ -833,6 +848,18 @@ std::unique_ptr<RamStatement> RamTranslator::translateRecursiveRelation(
     std::map<const AstRelation*, RamRelationIdentifier> relDelta;
     std::map<const AstRelation*, RamRelationIdentifier> relNew;
 
+    /* the statements merging the new knowledge into a relation, an update also collects it */
+    auto getUpdateStmt = [&](const AstRelation* rel) {
+        std::unique_ptr<RamStatement> res(new RamMerge(rrel[rel], relNew[rel]));
+        if (changed) {
+            appendStmt(res, std::unique_ptr<RamStatement>(
+                                    new RamMerge(getIncrementIdentifier(rel, &typeEnv), relNew[rel])));
+        }
+        appendStmt(res, std::unique_ptr<RamStatement>(new RamSwap(relDelta[rel], relNew[rel])));
+        appendStmt(res, std::unique_ptr<RamStatement>(new RamClear(relNew[rel])));
+        return res;
+    };
+
     /* Compute non-recursive clauses for relations in scc and push
        the results in their delta tables. */
     for (const AstRelation* rel : scc) {
@@ -846,11 +873,7 @@ std::unique_ptr<RamStatement> RamTranslator::translateRecursiveRelation(
         relNew[rel] = getRamRelationIdentifier("new_" + relName, rel->getArity(), rel, &typeEnv, true);
 
         /* create update statements for fixpoint (even iteration) */
-        appendStmt(updateRelTable,
-                std::unique_ptr<RamStatement>(
-                        new RamSequence(std::unique_ptr<RamStatement>(new RamMerge(rrel[rel], relNew[rel])),
-                                std::unique_ptr<RamStatement>(new RamSwap(relDelta[rel], relNew[rel])),
-                                std::unique_ptr<RamStatement>(new RamClear(relNew[rel])))));
+        appendStmt(updateRelTable, getUpdateStmt(rel));
 
         /* measure update time for each relation */
         if (logging) {
@@ -865,16 +888,35 @@ std::unique_ptr<RamStatement> RamTranslator::translateRecursiveRelation(
                                       std::unique_ptr<RamStatement>(new RamDrop(relDelta[rel])),
                                       std::unique_ptr<RamStatement>(new RamDrop(relNew[rel])))));
 
-        /* Generate code for non-recursive part of relation */
-        appendStmt(preamble, translateNonRecursiveRelation(*rel, program, recursiveClauses, typeEnv));
+        if (!changed) {
+            /* Generate code for non-recursive part of relation */
+            appendStmt(preamble, translateNonRecursiveRelation(*rel, program, recursiveClauses, typeEnv));
 
-        /* Generate merge operation for temp tables */
-        appendStmt(preamble, std::unique_ptr<RamStatement>(new RamMerge(relDelta[rel], rrel[rel])));
+            /* Generate merge operation for temp tables */
+            appendStmt(preamble, std::unique_ptr<RamStatement>(new RamMerge(relDelta[rel], rrel[rel])));
+        } else {
+            /* Start from the tuples inserted into the relation itself, if it is an input */
+            if (rel->isInput()) {
+                appendStmt(preamble, std::unique_ptr<RamStatement>(new RamMerge(
+                                             relNew[rel], getIncrementIdentifier(rel, &typeEnv))));
+            }
+
+            /* Derive the consequences of the tuples added to relations of preceding strata */
+            appendStmt(preamble,
+                    translateIncrementalClauses(*rel, relNew[rel], program, *changed, scc, typeEnv));
+        }
 
         /* Add update operations of relations to parallel statements */
         updateTable->add(std::move(updateRelTable));
     }
 
+    /* An update starts the fixpoint from the consequences of the added tuples */
+    if (changed) {
+        for (const AstRelation* rel : scc) {
+            appendStmt(preamble, getUpdateStmt(rel));
+        }
+    }
+
     // --- build main loop ---
 
     std::unique_ptr<RamParallel> loopSeq(new RamParallel());
@@ -990,16 +1032,152 @@ std::unique_ptr<RamStatement> RamTranslator::translateRecursiveRelation(
     }
 
     /* construct fixpoint loop  */
-    return std::unique_ptr<RamStatement>(new RamSequence(std::move(preamble),
-            std::unique_ptr<RamStatement>(new RamLoop(std::move(loopSeq),
-                    std::unique_ptr<RamStatement>(new RamExit(std::move(exitCond))), std::move(updateTable))),
-            std::move(postamble)));
+    std::unique_ptr<RamStatement> exit(new RamExit(std::move(exitCond)));
+    std::unique_ptr<RamStatement> loop;
+    if (Global::config().has("progress")) {
+        /* report the progress of the evaluation at the start of each iteration */
+        std::vector<RamRelationIdentifier> relations;
+        std::vector<RamRelationIdentifier> deltas;
+        for (const AstRelation* rel : scc) {
+            relations.push_back(rrel[rel]);
+            deltas.push_back(relDelta[rel]);
+        }
+        loop = std::unique_ptr<RamStatement>(
+                new RamLoop(std::unique_ptr<RamStatement>(new RamLogProgress(stratum, relations, deltas)),
+                        std::move(loopSeq), std::move(exit), std::move(updateTable)));
+    } else {
+        loop = std::unique_ptr<RamStatement>(
+                new RamLoop(std::move(loopSeq), std::move(exit), std::move(updateTable)));
+    }
+    return std::unique_ptr<RamStatement>(
+            new RamSequence(std::move(preamble), std::move(loop), std::move(postamble)));
 
     assert(false && "Not Implemented");
     return nullptr;
 }
 
+/** generate RAM code deriving the consequences of tuples added to relations for the clauses of a relation */
+std::unique_ptr<RamStatement> RamTranslator::translateIncrementalClauses(const AstRelation& rel,
+        const RamRelationIdentifier& target, const AstProgram* program,
+        const std::set<const AstRelation*>& changed, const std::set<const AstRelation*>& excluded,
+        const TypeEnvironment& typeEnv) {
+    std::unique_ptr<RamStatement> res;
+
+    for (AstClause* clause : rel.getClauses()) {
+        // facts do not change
+        if (clause->isFact()) {
+            continue;
+        }
+
+        // each atom of a changed relation results in a version reading the added tuples only
+        const auto& atoms = clause->getAtoms();
+        for (size_t j = 0; j < atoms.size(); ++j) {
+            const AstRelation* atomRelation = getAtomRelation(atoms[j], program);
+            if (!changed.count(atomRelation) || excluded.count(atomRelation)) {
+                continue;
+            }
+
+            // modify the processed rule to read the added tuples and to write new tuples to the target
+            std::unique_ptr<AstClause> r1(clause->clone());
+            r1->getHead()->setName(target.getName());
+            r1->getAtoms()[j]->setName(getIncrementIdentifier(atomRelation, &typeEnv).getName());
+            r1->addToBody(std::unique_ptr<AstLiteral>(
+                    new AstNegation(std::unique_ptr<AstAtom>(clause->getHead()->clone()))));
+            nameUnnamedVariables(r1.get());
+
+            std::unique_ptr<RamStatement> rule = translateClause(*r1, program, &typeEnv);
+
+            // add debug info
+            std::ostringstream ds;
+            ds << toString(*clause) << "\nin file ";
+            ds << clause->getSrcLoc();
+            rule = std::unique_ptr<RamStatement>(new RamDebugInfo(std::move(rule), ds.str()));
+
+            appendStmt(res, std::move(rule));
+        }
+    }
+
+    return res;
+}
+
 /** translates the given datalog program into an equivalent RAM program  */
+namespace {
+
+/** Computes the number of indices required for the given searches on a relation of the given arity. */
+size_t getNumIndices(const std::multiset<SearchColumns>& searches, size_t arity) {
+    RamAutoIndex indices;
+    for (SearchColumns cur : searches) {
+        indices.addSearch(cur);
+    }
+
+    // relations without searches or only total searches are covered by a single index
+    if (indices.getSearches().empty() || indices.hasOnlyTotalSearches(arity)) {
+        return 1;
+    }
+    indices.solve();
+    return indices.getAllOrders().size();
+}
+}  // namespace
+
+void RamTranslator::selectHashJoins(const RamStatement& program) {
+    // collect all searches conducted on each relation
+    std::map<RamRelationIdentifier, std::multiset<SearchColumns>> searches;
+    visitDepthFirst(program, [&](const RamNode& node) {
+        if (const RamScan* scan = dynamic_cast<const RamScan*>(&node)) {
+            searches[scan->getRelation()].insert(scan->getRangeQueryColumns());
+        } else if (const RamAggregate* agg = dynamic_cast<const RamAggregate*>(&node)) {
+            searches[agg->getRelation()].insert(agg->getRangeQueryColumns());
+        } else if (const RamNotExists* ne = dynamic_cast<const RamNotExists*>(&node)) {
+            searches[ne->getRelation()].insert(ne->getKey());
+        }
+    });
+
+    // The cost model: for a query evaluated once, building a hash table over the joined
+    // relation is linear in its size, which is no more than the cost of building an ordered
+    // index. Thus, a join is realized by a hash join iff this way one index less has to be
+    // maintained for the joined relation. Otherwise the required index exists anyway and
+    // probing it is cheaper than building a temporary table. The sizes of the relations are
+    // only known when the query is evaluated, thus a join with the outermost scan builds its
+    // table on the smaller of the two relations at that point.
+    for (RamInsert* insert : oneShotQueries) {
+        RamRelationIdentifier target;
+        visitDepthFirst(*insert, [&](const RamProject& project) { target = project.getRelation(); });
+
+        // the outermost level has nothing to join with
+        RamOperation* op = &insert->getOperation();
+        while (RamSearch* search = dynamic_cast<RamSearch*>(op)) {
+            op = search->getNestedOperation();
+
+            RamScan* scan = dynamic_cast<RamScan*>(op);
+            if (!scan || scan->isPureExistenceCheck() || scan->getRangeQueryColumns() == 0) {
+                continue;
+            }
+
+            // the joined relation must not change while the query is evaluated
+            const RamRelationIdentifier& rel = scan->getRelation();
+            if (rel.isTemp() || rel.isEqRel() || rel.getName() == target.getName()) {
+                continue;
+            }
+
+            // check whether the search can be dropped without adding an index
+            auto& cur = searches[rel];
+            auto numIndices = getNumIndices(cur, rel.getArity());
+            cur.erase(cur.find(scan->getRangeQueryColumns()));
+            if (getNumIndices(cur, rel.getArity()) == numIndices) {
+                cur.insert(scan->getRangeQueryColumns());
+                continue;
+            }
+
+            // replace the scan by a hash join
+            SearchColumns keys = scan->getRangeQueryColumns();
+            std::unique_ptr<RamOperation> join(new RamHashJoin(rel, scan->takeRangePattern(), keys,
+                    scan->takeCondition(), scan->takeNestedOperation()));
+            op = join.get();
+            search->setNestedOperation(std::move(join));
+        }
+    }
+}
+
 std::unique_ptr<RamStatement> RamTranslator::translateProgram(const AstTranslationUnit& translationUnit) {
     const TypeEnvironment& typeEnv =
             translationUnit.getAnalysis<TypeEnvironmentAnalysis>()->getTypeEnvironment();
@@ -1016,6 +1194,64 @@ std::unique_ptr<RamStatement> RamTranslator::translateProgram(const AstTranslati
 
     /* Get relations of the program */
     auto rels = translationUnit.getProgram()->getRelations();
+    const AstProgram* program = translationUnit.getProgram();
+    const auto& schedule = relationSchedule->getSchedule();
+
+    // an incremental program re-evaluates only the consequences of tuples inserted into its inputs
+    bool incremental = Global::config().has("incremental");
+
+    // the relations changed by inserting into inputs, and those of them an update has to recompute
+    std::set<const AstRelation*> changed;
+    std::set<const AstRelation*> recomputed;
+    if (incremental) {
+        PrecedenceGraph* precedenceGraph = translationUnit.getAnalysis<PrecedenceGraph>();
+        for (const RelationScheduleStep& step : schedule) {
+            bool isChanged = false;
+            bool isRecomputed = false;
+            for (const AstRelation* rel : step.getComputedRelations()) {
+                isChanged = isChanged || rel->isInput();
+                isRecomputed = isRecomputed || rel->isEqRel();
+                for (const AstRelation* pred : precedenceGraph->getPredecessors(rel)) {
+                    isChanged = isChanged || changed.count(pred);
+                    isRecomputed = isRecomputed || recomputed.count(pred);
+                }
+
+                // negations and aggregates are not monotone in the changed relations
+                for (const AstClause* clause : rel->getClauses()) {
+                    visitDepthFirst(*clause, [&](const AstNegation& neg) {
+                        isRecomputed = isRecomputed || changed.count(getAtomRelation(neg.getAtom(), program));
+                    });
+                    visitDepthFirst(*clause, [&](const AstAggregator& agg) {
+                        visitDepthFirst(agg, [&](const AstAtom& atom) {
+                            isRecomputed = isRecomputed || changed.count(getAtomRelation(&atom, program));
+                        });
+                    });
+                }
+            }
+            if (!isChanged) {
+                continue;
+            }
+            for (const AstRelation* rel : step.getComputedRelations()) {
+                changed.insert(rel);
+                if (!isRecomputed) {
+                    continue;
+                }
+                // the inserted tuples of an input relation would be lost by recomputing it
+                if (rel->isInput()) {
+                    if (!Global::config().has("no-warn")) {
+                        std::cerr << "Warning: incremental evaluation disabled since input relation "
+                                  << rel->getName() << " depends non-monotonically on changed relations\n";
+                    }
+                    incremental = false;
+                }
+                recomputed.insert(rel);
+            }
+        }
+    }
+    if (!incremental) {
+        changed.clear();
+        recomputed.clear();
+    }
 
     /* Initialize all relations */
     for (AstRelation* rel : rels) {
@@ -1024,6 +1260,12 @@ std::unique_ptr<RamStatement> RamTranslator::translateProgram(const AstTranslati
                 getRamRelationIdentifier(getRelationName(rel->getName()), rel->getArity(), rel, &typeEnv);
         appendStmt(res, std::unique_ptr<RamStatement>(new RamCreate(rrel)));
 
+        // create the relation collecting the tuples added by an update
+        if (changed.count(rel)) {
+            appendStmt(res,
+                    std::unique_ptr<RamStatement>(new RamCreate(getIncrementIdentifier(rel, &typeEnv))));
+        }
+
         // optional: load inputs
         if (rel->isInput()) {
             appendStmt(res, std::unique_ptr<RamStatement>(new RamLoad(rrel)));
@@ -1044,8 +1286,87 @@ std::unique_ptr<RamStatement> RamTranslator::translateProgram(const AstTranslati
 
     std::unique_ptr<RamStatement> comp;
 
-    for (const RelationScheduleStep& step : relationSchedule->getSchedule()) {
+    // output relations may be stored and dropped at the end of the step computing them
+    const bool streamOutput = Global::config().has("stream-output");
+
+    // the output relations to be dropped after each step, i.e. after the last step reading them
+    std::vector<std::vector<const AstRelation*>> expiredOutputs(schedule.size());
+    if (streamOutput) {
+        PrecedenceGraph* precedenceGraph = translationUnit.getAnalysis<PrecedenceGraph>();
+        std::map<const AstRelation*, size_t> lastUse;
+        for (size_t i = 0; i < schedule.size(); i++) {
+            for (const AstRelation* rel : schedule[i].getComputedRelations()) {
+                lastUse[rel] = i;
+                for (const AstRelation* pred : precedenceGraph->getPredecessors(rel)) {
+                    lastUse[pred] = i;
+                }
+            }
+        }
+        for (const AstRelation* rel : rels) {
+            if (rel->isOutput() && !rel->isPrintSize() && lastUse.count(rel)) {
+                expiredOutputs[lastUse[rel]].push_back(rel);
+            }
+        }
+    }
+
+    // the step after which each relation is dropped, a checkpoint only saves relations retained
+    // beyond the step computing them
+    const bool checkpoint = Global::config().has("checkpoint");
+    std::map<const AstRelation*, size_t> dropStep;
+    if (checkpoint) {
+        for (size_t i = 0; i < schedule.size(); i++) {
+            if (!Global::config().has("provenance")) {
+                for (const AstRelation* rel : schedule[i].getExpiredRelations()) {
+                    dropStep[rel] = i;
+                }
+            }
+            for (const AstRelation* rel : expiredOutputs[i]) {
+                dropStep[rel] = i;
+            }
+        }
+    }
+
+    // the re-evaluation of an incremental program after inserting tuples into its inputs
+    std::unique_ptr<RamStatement> update;
+
+    // the relations present after each step, whose memory is logged when profiling
+    std::map<std::string, RamRelationIdentifier> present;
+
+    for (size_t i = 0; i < schedule.size(); i++) {
+        const RelationScheduleStep& step = schedule[i];
         const std::set<const AstRelation*>& scc = step.getComputedRelations();
+        stratum = i;
+
+        /* An update derives the consequences of the added tuples only, or recomputes the step */
+        if (changed.count(*scc.begin())) {
+            std::unique_ptr<RamStatement> stmt;
+            if (recomputed.count(*scc.begin())) {
+                for (const AstRelation* rel : scc) {
+                    RamRelationIdentifier rrel = getRamRelationIdentifier(
+                            getRelationName(rel->getName()), rel->getArity(), rel, &typeEnv);
+                    appendStmt(stmt, std::unique_ptr<RamStatement>(new RamClear(rrel)));
+                }
+                if (!step.isRecursive()) {
+                    appendStmt(stmt, translateNonRecursiveRelation(**scc.begin(), program, recursiveClauses,
+                                             typeEnv));
+                } else {
+                    appendStmt(stmt, translateRecursiveRelation(scc, program, recursiveClauses, typeEnv));
+                }
+            } else if (!step.isRecursive()) {
+                const AstRelation* rel = *scc.begin();
+                RamRelationIdentifier inc = getIncrementIdentifier(rel, &typeEnv);
+                stmt = translateIncrementalClauses(*rel, inc, program, changed, {}, typeEnv);
+                if (stmt) {
+                    RamRelationIdentifier rrel = getRamRelationIdentifier(
+                            getRelationName(rel->getName()), rel->getArity(), rel, &typeEnv);
+                    appendStmt(stmt, std::unique_ptr<RamStatement>(new RamMerge(rrel, inc)));
+                }
+            } else {
+                stmt = translateRecursiveRelation(scc, program, recursiveClauses, typeEnv, &changed);
+            }
+            appendStmt(update, std::move(stmt));
+        }
+
         std::unique_ptr<RamStatement> stmt;
         if (!step.isRecursive()) {
             ASSERT(scc.size() == 1 && "SCC contains more than one relation");
@@ -1056,15 +1377,92 @@ std::unique_ptr<RamStatement> RamTranslator::translateProgram(const AstTranslati
         } else {
             stmt = translateRecursiveRelation(scc, translationUnit.getProgram(), recursiveClauses, typeEnv);
         }
+
+        /* Store output relations once computed */
+        if (streamOutput) {
+            for (const AstRelation* rel : scc) {
+                if (rel->isOutput()) {
+                    appendStmt(stmt, std::unique_ptr<RamStatement>(new RamStore(getRamRelationIdentifier(
+                                             getRelationName(rel->getName()), rel->getArity(), rel,
+                                             &typeEnv))));
+                }
+            }
+        }
+
+        /* Make the step a unit of checkpointing */
+        if (checkpoint && stmt) {
+            std::vector<std::pair<RamRelationIdentifier, size_t>> relations;
+            for (const AstRelation* rel : scc) {
+                relations.push_back(std::make_pair(getRamRelationIdentifier(getRelationName(rel->getName()),
+                                                           rel->getArity(), rel, &typeEnv),
+                        dropStep.count(rel) ? dropStep[rel] : schedule.size()));
+            }
+            stmt = std::unique_ptr<RamStatement>(new RamStratum(std::move(stmt), i, relations));
+        }
+
+        /* Report the progress of the evaluation on entering the step */
+        if (Global::config().has("progress")) {
+            std::vector<RamRelationIdentifier> relations;
+            for (const AstRelation* rel : scc) {
+                relations.push_back(getRamRelationIdentifier(
+                        getRelationName(rel->getName()), rel->getArity(), rel, &typeEnv));
+            }
+            appendStmt(comp, std::unique_ptr<RamStatement>(new RamLogProgress(i, relations)));
+        }
         appendStmt(comp, std::move(stmt));
 
-        /* Drop the tables of all expired relations to save memory */
-        if (!Global::config().has("provenance")) {
+        /* Log the memory of all relations present at the end of the step */
+        if (logging) {
+            for (const AstRelation* rel : scc) {
+                RamRelationIdentifier rrel = getRamRelationIdentifier(
+                        getRelationName(rel->getName()), rel->getArity(), rel, &typeEnv);
+                present.insert(std::make_pair(rrel.getName(), rrel));
+            }
+            std::vector<RamRelationIdentifier> relations;
+            for (const auto& cur : present) {
+                relations.push_back(cur.second);
+            }
+            appendStmt(comp, std::unique_ptr<RamStatement>(new RamLogMemory(i, relations)));
+        }
+
+        /* Drop the tables of all expired relations to save memory, unless needed by updates */
+        if (!Global::config().has("provenance") && !incremental) {
             for (const auto& rel : step.getExpiredRelations()) {
                 appendStmt(comp, std::unique_ptr<RamStatement>(new RamDrop(getRamRelationIdentifier(
                                          getRelationName(rel->getName()), rel->getArity(), rel, &typeEnv))));
+                present.erase(getRelationName(rel->getName()));
+            }
+        }
+
+        /* Drop output relations once no longer read */
+        for (const AstRelation* rel : expiredOutputs[i]) {
+            if (!incremental) {
+                appendStmt(comp, std::unique_ptr<RamStatement>(new RamDrop(getRamRelationIdentifier(
+                                         getRelationName(rel->getName()), rel->getArity(), rel, &typeEnv))));
+                present.erase(getRelationName(rel->getName()));
+            }
+        }
+    }
+
+    /* Make the computation re-evaluable by updates */
+    if (comp && update) {
+        // each evaluation consumes the tuples added so far
+        std::vector<std::pair<RamRelationIdentifier, RamRelationIdentifier>> increments;
+        for (const AstRelation* rel : rels) {
+            if (!changed.count(rel)) {
+                continue;
+            }
+            RamRelationIdentifier inc = getIncrementIdentifier(rel, &typeEnv);
+            appendStmt(comp, std::unique_ptr<RamStatement>(new RamClear(inc)));
+            appendStmt(update, std::unique_ptr<RamStatement>(new RamClear(inc)));
+            if (rel->isInput()) {
+                increments.push_back(std::make_pair(getRamRelationIdentifier(getRelationName(rel->getName()),
+                                                            rel->getArity(), rel, &typeEnv),
+                        inc));
             }
         }
+        comp = std::unique_ptr<RamStatement>(
+                new RamIncremental(std::move(comp), std::move(update), increments));
     }
 
     // add logging entry for pure computation time
@@ -1075,19 +1473,25 @@ std::unique_ptr<RamStatement> RamTranslator::translateProgram(const AstTranslati
     for (AstRelation* rel : rels) {
         RamRelationIdentifier rrel =
                 getRamRelationIdentifier(getRelationName(rel->getName()), rel->getArity(), rel, &typeEnv);
-        if (rel->isOutput()) {
+        if (rel->isOutput() && !streamOutput) {
             appendStmt(res, std::unique_ptr<RamStatement>(new RamStore(rrel)));
         }
         if (rel->isPrintSize()) {
             appendStmt(res, std::unique_ptr<RamStatement>(new RamPrintSize(rrel)));
         }
-        if (rel->isOutput()) {
-            if (!Global::config().has("provenance")) {
+        if (rel->isOutput() && (!streamOutput || rel->isPrintSize())) {
+            if (!Global::config().has("provenance") && !incremental) {
                 appendStmt(res, std::unique_ptr<RamStatement>(new RamDrop(rrel)));
             }
         }
     }
 
+    // realize joins by hash joins where this saves indices
+    if (res) {
+        selectHashJoins(*res);
+    }
+    oneShotQueries.clear();
+
     if (res && logging) {
         res = std::unique_ptr<RamStatement>(new RamLogTimer(std::move(res), "@runtime;"));
     }
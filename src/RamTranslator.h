@@ -20,6 +20,7 @@
 #include "RamRelation.h"
 
 #include <map>
+#include <set>
 #include <vector>
 
 namespace souffle {
@@ -30,6 +31,7 @@ class AstAtom;
 class AstClause;
 class AstProgram;
 
+class RamInsert;
 class RamStatement;
 
 class RecursiveClauses;
@@ -42,6 +44,18 @@ class RamTranslator {
     /** If true, created constructs will be annotated with logging information */
     bool logging;
 
+    /** The index of the stratum being translated, whose iterations report their progress */
+    size_t stratum = 0;
+
+    /** The queries translated so far which are evaluated only once */
+    std::vector<RamInsert*> oneShotQueries;
+
+    /**
+     * Replaces joins of queries evaluated only once by hash joins wherever this
+     * saves an index of the joined relation.
+     */
+    void selectHashJoins(const RamStatement& program);
+
 public:
     /**
      * A constructor for this translators.
@@ -68,9 +82,25 @@ public:
             const AstProgram* program, const RecursiveClauses* recursiveClauses,
             const TypeEnvironment& typeEnv);
 
-    /** generate RAM code for recursive relations in a strongly-connected component */
+    /**
+     * Generates RAM code for recursive relations in a strongly-connected component. Given the
+     * relations changed by an update, the code extends the previous fixpoint by the consequences
+     * of the tuples added to them instead.
+     */
     std::unique_ptr<RamStatement> translateRecursiveRelation(const std::set<const AstRelation*>& scc,
             const AstProgram* program, const RecursiveClauses* recursiveClauses,
+            const TypeEnvironment& typeEnv, const std::set<const AstRelation*>* changed = nullptr);
+
+    /**
+     * Generates RAM code deriving the consequences of the tuples added to the changed relations
+     * by an update for the clauses of the given relation, writing tuples not yet contained in the
+     * relation to the given target. Atoms of excluded relations are treated as unchanged.
+     *
+     * @return a corresponding statement or null if no clause depends on a changed relation.
+     */
+    std::unique_ptr<RamStatement> translateIncrementalClauses(const AstRelation& rel,
+            const RamRelationIdentifier& target, const AstProgram* program,
+            const std::set<const AstRelation*>& changed, const std::set<const AstRelation*>& excluded,
             const TypeEnvironment& typeEnv);
 
     /** translates the given datalog program into an equivalent RAM program  */
@@ -91,6 +91,7 @@ struct RamVisitor : public ram_visitor_tag {
             FORWARD(Project);
             FORWARD(Lookup);
             FORWARD(Scan);
+            FORWARD(HashJoin);
             FORWARD(Aggregate);
 
             // statements
@@ -103,6 +104,8 @@ struct RamVisitor : public ram_visitor_tag {
             FORWARD(Drop);
             FORWARD(PrintSize);
             FORWARD(LogSize);
+            FORWARD(LogMemory);
+            FORWARD(LogProgress);
 
             FORWARD(Merge);
             FORWARD(Swap);
@@ -110,6 +113,8 @@ struct RamVisitor : public ram_visitor_tag {
             // control flow
             FORWARD(Sequence);
             FORWARD(Loop);
+            FORWARD(Stratum);
+            FORWARD(Incremental);
             FORWARD(Parallel);
             FORWARD(Exit);
             FORWARD(LogTimer);
@@ -145,6 +150,8 @@ protected:
     LINK(Drop, RelationStatement);
     LINK(PrintSize, RelationStatement);
     LINK(LogSize, RelationStatement);
+    LINK(LogMemory, Statement);
+    LINK(LogProgress, Statement);
 
     LINK(RelationStatement, Statement);
 
@@ -153,6 +160,8 @@ protected:
 
     LINK(Sequence, Statement);
     LINK(Loop, Statement);
+    LINK(Stratum, Statement);
+    LINK(Incremental, Statement);
     LINK(Parallel, Statement);
     LINK(Exit, Statement);
     LINK(LogTimer, Statement);
@@ -164,6 +173,7 @@ protected:
     LINK(Project, Operation)
     LINK(Lookup, Search)
     LINK(Scan, Search)
+    LINK(HashJoin, Search)
     LINK(Aggregate, Search)
     LINK(Search, Operation)
 
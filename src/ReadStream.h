@@ -20,21 +20,66 @@
 #include "SymbolTable.h"
 
 #include <memory>
+#include <vector>
 
 namespace souffle {
 
 class ReadStream {
 public:
     ReadStream(const SymbolMask& symbolMask, SymbolTable& symbolTable)
-            : symbolMask(symbolMask), symbolTable(symbolTable) {}
+            : symbolMask(symbolMask), sharedSymbolTable(symbolTable), numTuples(0) {}
+
     template <typename T>
     void readAll(T& relation) {
-        auto lease = symbolTable.acquireLock();
-        (void)lease;
+        fetchAll();
+        internSymbols();
+        insertAll(relation);
+    }
+
+    /**
+     * Reads all tuples of the input into a buffer. Symbols are entered into a table private
+     * to this stream, such that several streams may be read concurrently.
+     */
+    void fetchAll() {
+        const size_t arity = symbolMask.getArity();
         while (const auto next = readNextTuple()) {
-            const RamDomain* ramDomain = next.get();
-            relation.insert(ramDomain);
+            buffer.insert(buffer.end(), next.get(), next.get() + arity);
+            ++numTuples;
+        }
+    }
+
+    /**
+     * Enters the symbols of the buffered tuples into the shared symbol table and translates
+     * the buffered tuples accordingly. Symbols obtain their indices in the order they have
+     * been read in.
+     */
+    void internSymbols() {
+        const size_t arity = symbolMask.getArity();
+        if (symbolTable.size() == 0) {
+            return;
+        }
+        const std::vector<size_t> indices = sharedSymbolTable.merge(symbolTable);
+        for (size_t i = 0; i < buffer.size(); i += arity) {
+            for (size_t j = 0; j < arity; ++j) {
+                if (symbolMask.isSymbol(j)) {
+                    buffer[i + j] = indices[buffer[i + j]];
+                }
+            }
         }
+        symbolTable = SymbolTable();
+    }
+
+    /** Inserts the buffered tuples into the given relation. */
+    template <typename T>
+    void insertAll(T& relation) {
+        const size_t arity = symbolMask.getArity();
+        const RamDomain empty = 0;
+        for (size_t i = 0; i < numTuples; ++i) {
+            const RamDomain* tuple = (arity == 0) ? &empty : &buffer[i * arity];
+            relation.insert(tuple);
+        }
+        std::vector<RamDomain>().swap(buffer);
+        numTuples = 0;
     }
 
     virtual ~ReadStream() = default;
@@ -42,7 +87,14 @@ public:
 protected:
     virtual std::unique_ptr<RamDomain[]> readNextTuple() = 0;
     const SymbolMask& symbolMask;
-    SymbolTable& symbolTable;
+
+    /** The symbols read by this stream, merged into the shared symbol table by internSymbols() */
+    SymbolTable symbolTable;
+
+private:
+    SymbolTable& sharedSymbolTable;
+    std::vector<RamDomain> buffer;
+    size_t numTuples;
 };
 
 class ReadStreamFactory {
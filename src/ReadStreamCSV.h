@@ -63,6 +63,10 @@ protected:
         bool error = false;
 
         if (!getline(file, line)) {
+            // a failure of the underlying stream, e.g. a corrupt compressed file, is not the end
+            if (file.bad()) {
+                throw std::invalid_argument("cannot read input\n");
+            }
             return nullptr;
         }
         ++lineNumber;
@@ -93,7 +97,7 @@ protected:
                 continue;
             }
             ++columnsFilled;
-            if (symbolMask.isSymbol(column)) {
+            if (symbolMask.isSymbol(inputMap[column])) {
                 tuple[inputMap[column]] = symbolTable.unsafeLookup(element.c_str());
             } else {
                 try {
@@ -24,11 +24,18 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <utility>
 
 #include <sqlite3.h>
 
 namespace souffle {
 
+/**
+ * A reader of relations stored in an SQLite database. Relations written by Souffle, whose symbol
+ * columns refer to the symbol table of the database, are read from their underlying table, while
+ * the symbols referenced by the relation are loaded once. Other relations are read from their view.
+ */
 class ReadStreamSQLite : public ReadStream {
 public:
     ReadStreamSQLite(const std::string& dbFilename, const std::string& relationName,
@@ -52,34 +59,95 @@ protected:
      * @return
      */
     std::unique_ptr<RamDomain[]> readNextTuple() override {
-        if (sqlite3_step(selectStatement) != SQLITE_ROW) {
-            return nullptr;
-        }
-
         std::unique_ptr<RamDomain[]> tuple(new RamDomain[symbolMask.getArity()]);
 
-        for (uint32_t column = 0; column < symbolMask.getArity(); column++) {
-            std::string element(reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, column)));
-
-            if (element == "") {
-                element = "n/a";
+        // tuples referring to unknown symbols are skipped, as by the view
+        bool valid;
+        do {
+            if (sqlite3_step(selectStatement) != SQLITE_ROW) {
+                return nullptr;
             }
-            if (symbolMask.isSymbol(column)) {
-                tuple[column] = symbolTable.unsafeLookup(element.c_str());
-            } else {
-                try {
-                    tuple[column] = std::stoi(element.c_str());
-                } catch (...) {
-                    std::stringstream errorMessage;
-                    errorMessage << "Error converting number in column " << (column) + 1;
-                    throw std::invalid_argument(errorMessage.str());
+            valid = true;
+            for (uint32_t column = 0; valid && column < symbolMask.getArity(); column++) {
+                if (symbolMask.isSymbol(column)) {
+                    valid = readSymbol(column, tuple[column]);
+                } else {
+                    tuple[column] = readNumber(column);
                 }
             }
-        }
+        } while (!valid);
 
         return tuple;
     }
 
+    RamDomain readNumber(uint32_t column) {
+        if (sqlite3_column_type(selectStatement, column) == SQLITE_INTEGER) {
+            return sqlite3_column_int(selectStatement, column);
+        }
+        const char* element = reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, column));
+        try {
+            return std::stoi(element ? element : "");
+        } catch (...) {
+            std::stringstream errorMessage;
+            errorMessage << "Error converting number in column " << (column) + 1;
+            throw std::invalid_argument(errorMessage.str());
+        }
+    }
+
+    bool readSymbol(uint32_t column, RamDomain& value) {
+        if (useSymbolIds && sqlite3_column_type(selectStatement, column) == SQLITE_INTEGER) {
+            auto pos = symbols.find(sqlite3_column_int64(selectStatement, column));
+            if (pos == symbols.end()) {
+                return false;
+            }
+            // symbols are entered into the symbol table on their first use
+            if (pos->second.second < 0) {
+                pos->second.second = lookup(pos->second.first.c_str());
+            }
+            value = pos->second.second;
+            return true;
+        }
+        const char* element = reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, column));
+        value = lookup(element ? element : "");
+        return true;
+    }
+
+    RamDomain lookup(const char* symbol) {
+        return symbolTable.unsafeLookup((*symbol == '\0') ? "n/a" : symbol);
+    }
+
+    /* Loads the symbols of the database referenced by the symbol columns of the relation. */
+    void loadSymbols() {
+        std::stringstream selectSQL;
+        selectSQL << "SELECT id, symbol FROM '" << symbolTableName << "' WHERE id IN (";
+        bool first = true;
+        for (uint32_t column = 0; column < symbolMask.getArity(); column++) {
+            if (symbolMask.isSymbol(column)) {
+                selectSQL << (first ? "" : " UNION ") << "SELECT \"" << column << "\" FROM '_" << relationName
+                          << "'";
+                first = false;
+            }
+        }
+        selectSQL << ");";
+        if (first) {
+            return;
+        }
+        sqlite3_stmt* symbolStatement;
+        const char* tail = nullptr;
+        if (sqlite3_prepare_v2(db, selectSQL.str().c_str(), -1, &symbolStatement, &tail) != SQLITE_OK) {
+            throwError("SQLite error in sqlite3_prepare_v2: ");
+        }
+        int rc;
+        while ((rc = sqlite3_step(symbolStatement)) == SQLITE_ROW) {
+            const char* symbol = reinterpret_cast<const char*>(sqlite3_column_text(symbolStatement, 1));
+            symbols[sqlite3_column_int64(symbolStatement, 0)] = std::make_pair(symbol ? symbol : "", -1);
+        }
+        sqlite3_finalize(symbolStatement);
+        if (rc != SQLITE_DONE) {
+            throwError("SQLite error in sqlite3_step: ");
+        }
+    }
+
     void executeSQL(const std::string& sql) {
         assert(db && "Database connection is closed");
 
@@ -104,7 +172,12 @@ protected:
 
     void prepareSelectStatement() {
         std::stringstream selectSQL;
-        selectSQL << "SELECT * FROM '" << relationName << "'";
+        if (useSymbolIds) {
+            loadSymbols();
+            selectSQL << "SELECT * FROM '_" << relationName << "'";
+        } else {
+            selectSQL << "SELECT * FROM '" << relationName << "'";
+        }
         const char* tail = nullptr;
         if (sqlite3_prepare_v2(db, selectSQL.str().c_str(), -1, &selectStatement, &tail) != SQLITE_OK) {
             throwError("SQLite error in sqlite3_prepare_v2: ");
@@ -135,14 +208,39 @@ protected:
             int count = sqlite3_column_int(tableStatement, 0);
             if (count == 2) {
                 sqlite3_finalize(tableStatement);
+                useSymbolIds = hasSymbolTable();
                 return;
             }
         }
         sqlite3_finalize(tableStatement);
         throw std::invalid_argument("Required table and view does not exist for relation " + relationName);
     }
+
+    /* Determines whether the relation is stored in a table referring to the symbol table. */
+    bool hasSymbolTable() {
+        sqlite3_stmt* tableStatement;
+        std::stringstream selectSQL;
+        selectSQL << "SELECT count(*) FROM sqlite_master WHERE type = 'table' AND ";
+        selectSQL << " name IN ('_" << relationName << "', '" << symbolTableName << "');";
+        const char* tail = nullptr;
+
+        if (sqlite3_prepare_v2(db, selectSQL.str().c_str(), -1, &tableStatement, &tail) != SQLITE_OK) {
+            throwError("SQLite error in sqlite3_prepare_v2: ");
+        }
+        bool res = sqlite3_step(tableStatement) == SQLITE_ROW && sqlite3_column_int(tableStatement, 0) == 2;
+        sqlite3_finalize(tableStatement);
+        return res;
+    }
     const std::string& dbFilename;
     const std::string& relationName;
+    const std::string symbolTableName = "__SymbolTable";
+
+    // whether symbol columns hold ids of the symbol table of the database
+    bool useSymbolIds = false;
+
+    // the symbols of the database by their id, with their index once entered into the symbol table
+    std::unordered_map<int64_t, std::pair<std::string, RamDomain>> symbols;
+
     sqlite3_stmt* selectStatement;
     sqlite3* db;
 };
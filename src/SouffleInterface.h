@@ -22,6 +22,7 @@
 #include <initializer_list>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -98,9 +99,39 @@ public:
     // insert a new tuple into the relation
     virtual void insert(const tuple& t) = 0;
 
+    // insert the given number of tuples stored one after another in the given array, where
+    // symbols are given by their index in the symbol table; by default each tuple is inserted
+    // on its own
+    virtual void insert(const RamDomain* data, std::size_t numTuples);
+
+    // remove all tuples from the relation
+    virtual void purge() = 0;
+
     // check whether a tuple exists in the relation
     virtual bool contains(const tuple& t) const = 0;
 
+    // cursor delivering the tuples found by a lookup in batches
+    class cursor {
+    public:
+        virtual ~cursor() {}
+
+        // copy up to the given number of further tuples one after another into the given buffer,
+        // where symbols are given by their index in the symbol table; fewer tuples than requested
+        // are only copied once all tuples have been delivered
+        virtual std::size_t next(RamDomain* buffer, std::size_t numTuples) = 0;
+    };
+
+    // check whether an index of the relation supports lookups on the given bound columns,
+    // where bit i of the columns denotes column i; by default there are no indexes
+    virtual bool hasIndex(SearchColumns) const {
+        return false;
+    }
+
+    // look up the tuples agreeing with the given key on the given bound columns, where the key
+    // holds a value for each column; lookups without a supporting index scan the relation, and
+    // the cursor is invalidated by modifying the relation
+    virtual std::unique_ptr<cursor> lookup(SearchColumns columns, const RamDomain* key) const;
+
     // begin and end iterator
     virtual iterator begin() const = 0;
     virtual iterator end() const = 0;
@@ -229,6 +260,54 @@ public:
     }
 };
 
+inline void Relation::insert(const RamDomain* data, std::size_t numTuples) {
+    const std::size_t arity = getArity();
+    for (std::size_t i = 0; i < numTuples; i++, data += arity) {
+        tuple t(this);
+        for (std::size_t j = 0; j < arity; j++) {
+            t[j] = data[j];
+        }
+        insert(t);
+    }
+}
+
+namespace detail {
+
+/* cursor filtering all tuples of a relation, for relations without indexes */
+class scan_cursor : public Relation::cursor {
+    Relation::iterator cur;
+    Relation::iterator end;
+    SearchColumns columns;
+    std::vector<RamDomain> key;
+
+public:
+    scan_cursor(const Relation& rel, SearchColumns columns, const RamDomain* key)
+            : cur(rel.begin()), end(rel.end()), columns(columns), key(key, key + rel.getArity()) {}
+
+    std::size_t next(RamDomain* buffer, std::size_t numTuples) override {
+        std::size_t res = 0;
+        for (; res < numTuples && cur != end; ++cur) {
+            const tuple& t = *cur;
+            bool match = true;
+            for (std::size_t i = 0; match && i < key.size(); i++) {
+                match = !((columns >> i) & 1) || t[i] == key[i];
+            }
+            if (match) {
+                for (std::size_t i = 0; i < key.size(); i++) {
+                    *buffer++ = t[i];
+                }
+                res++;
+            }
+        }
+        return res;
+    }
+};
+}  // namespace detail
+
+inline std::unique_ptr<Relation::cursor> Relation::lookup(SearchColumns columns, const RamDomain* key) const {
+    return std::unique_ptr<cursor>(new detail::scan_cursor(*this, columns, key));
+}
+
 /**
  * Abstract base class for generated Datalog programs
  */
@@ -267,6 +346,14 @@ public:
     // print all relations
     virtual void printAll(std::string dirname = ".") = 0;
 
+    // remove all tuples from all relations, such that the program may be run again on new
+    // inputs; the symbol table is retained
+    virtual void purge() {
+        for (Relation* rel : getAllRelations()) {
+            rel->purge();
+        }
+    }
+
     // print input relations (for debug purposes)
     virtual void dumpInputs(std::ostream& out = std::cout) = 0;
 
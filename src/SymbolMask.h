@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <ostream>
 #include <vector>
 
@@ -35,6 +36,11 @@ public:
         return index < getArity() && mask[index];
     }
 
+    /** Determines whether any column holds symbols. */
+    bool hasSymbols() const {
+        return std::find(mask.begin(), mask.end(), true) != mask.end();
+    }
+
     void setSymbol(size_t index, bool value = true) {
         if (index < getArity()) {
             mask[index] = value;
@@ -36,7 +36,7 @@ namespace souffle {
  */
 class SymbolTable {
     /** A lock to synchronize parallel accesses */
-    mutable Lock access;
+    mutable Lock access{LockSite::symbols};
 
 private:
     /** Map indices to strings. */
@@ -138,6 +138,18 @@ public:
         return newSymbolOfIndex(symbol);
     }
 
+    /** Find the index of a symbol in the table without inserting it, returns false if it does not exist. */
+    bool find(const char* symbol, size_t& idx) const {
+        auto lease = access.acquire();
+        (void)lease;  // avoid warning;
+        auto it = strToNum.find(symbol);
+        if (it == strToNum.end()) {
+            return false;
+        }
+        idx = it->second;
+        return true;
+    }
+
     /** Find a symbol in the table by its index, note that this gives an error if the index is out of bounds.
      */
     const char* resolve(const size_t idx) const {
@@ -155,11 +167,33 @@ public:
         return numToStr[idx];
     }
 
+    /** Obtains the strings of all symbols currently held, indexed by the symbols. The strings remain
+     * valid while further symbols are inserted. */
+    std::vector<const char*> getSymbols() const {
+        auto lease = access.acquire();
+        (void)lease;  // avoid warning;
+        return std::vector<const char*>(numToStr.begin(), numToStr.end());
+    }
+
     /* Return the size of the symbol table, being the number of symbols it currently holds. */
     const size_t size() const {
         return numToStr.size();
     }
 
+    /** Determines the amount of memory used by the symbols and their mappings in bytes. */
+    size_t getMemoryUsage() const {
+        auto lease = access.acquire();
+        (void)lease;  // avoid warning;
+        size_t res = sizeof(*this) + numToStr.capacity() * sizeof(char*);
+        res += strToNum.bucket_count() * sizeof(void*);
+        for (const auto& cur : strToNum) {
+            // each symbol is stored in its copy and as a key of a node of the map
+            const size_t length = cur.first.size() + 1;
+            res += 2 * length + sizeof(std::string) + sizeof(size_t) + sizeof(void*);
+        }
+        return res;
+    }
+
     /** Bulk insert symbols into the table, note that this operation is more efficient than repeated inserts
      * of single symbols. */
     void insert(const char** symbols, const size_t n) {
@@ -172,6 +206,19 @@ public:
         }
     }
 
+    /** Enter all symbols of the given table into this table, as a single operation. Returns the indices of
+     * the symbols in this table, listed in the order of their indices in the given table. */
+    std::vector<size_t> merge(const SymbolTable& other) {
+        std::vector<size_t> indices;
+        indices.reserve(other.size());
+        auto lease = access.acquire();
+        (void)lease;  // avoid warning;
+        for (const char* symbol : other.numToStr) {
+            indices.push_back(newSymbolOfIndex(symbol));
+        }
+        return indices;
+    }
+
     /** Insert a single symbol into the table, not that this operation should not be used if inserting symbols
      * in bulk. */
     void insert(const char* symbol) {
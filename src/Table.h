@@ -45,6 +45,9 @@ class Table {
     Block* head;
     Block* tail;
 
+    // blocks retained by truncate() for subsequent inserts
+    Block* spare;
+
     std::size_t count;
 
 public:
@@ -87,7 +90,7 @@ public:
         }
     };
 
-    Table() : head(nullptr), tail(nullptr), count(0) {}
+    Table() : head(nullptr), tail(nullptr), spare(nullptr), count(0) {}
 
     ~Table() {
         clear();
@@ -101,16 +104,28 @@ public:
         return count;
     }
 
+    // Determines the amount of memory used by this data structure
+    std::size_t getMemoryUsage() const {
+        std::size_t res = sizeof(*this);
+        for (Block* cur = head; cur != nullptr; cur = cur->next) {
+            res += sizeof(Block);
+        }
+        for (Block* cur = spare; cur != nullptr; cur = cur->next) {
+            res += sizeof(Block);
+        }
+        return res;
+    }
+
     const T& insert(const T& element) {
         // check whether the head is initialized
         if (!head) {
-            head = new Block();
+            head = newBlock();
             tail = head;
         }
 
         // check whether tail is full
         if (tail->isFull()) {
-            tail->next = new Block();
+            tail->next = newBlock();
             tail = tail->next;
         }
 
@@ -130,15 +145,37 @@ public:
     }
 
     void clear() {
-        while (head != nullptr) {
-            auto cur = head;
-            head = head->next;
+        truncate();
+        while (spare != nullptr) {
+            auto cur = spare;
+            spare = spare->next;
             delete cur;
         }
+    }
+
+    // Removes all elements, retaining the allocated blocks for subsequent inserts
+    void truncate() {
+        if (tail != nullptr) {
+            tail->next = spare;
+            spare = head;
+        }
         count = 0;
         head = nullptr;
         tail = nullptr;
     }
+
+private:
+    // Obtains an empty block, reusing a retained one if possible
+    Block* newBlock() {
+        if (spare == nullptr) {
+            return new Block();
+        }
+        Block* res = spare;
+        spare = spare->next;
+        res->next = nullptr;
+        res->used = 0;
+        return res;
+    }
 };
 
 }  // end namespace souffle
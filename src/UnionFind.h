@@ -40,6 +40,7 @@
 #pragma once
 
 #include "BlockList.h"
+#include "HashSet.h"
 #include "Util.h"
 
 #include <atomic>
@@ -48,7 +49,9 @@
 #include <limits>
 #include <list>
 #include <mutex>
+#include <stdexcept>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace souffle {
@@ -64,11 +67,11 @@ constexpr block_t rank_mask = (2ul << split_size) - 1;
  * Structure that emulates a Disjoint Set, i.e. a data structure that supports efficient union-find operations
  */
 class DisjointSet {
-    /* store blocks of atomics */
-    BlockList<std::atomic<block_t>> a_blocks;
+    /* store blocks of atomics, which never move, such that nodes are created without locking */
+    SegmentedArray<std::atomic<block_t>> a_blocks;
 
-    // read/write mutex for inserting new nodes
-    mutable souffle::shared_mutex nodeLock;
+    /* the number of nodes created so far */
+    std::atomic<size_t> numNodes;
 
     /* whether the generated iterator needs to be updated */
     std::atomic<bool> isStale;
@@ -79,13 +82,17 @@ class DisjointSet {
     std::unordered_map<parent_t, BlockList<parent_t>> repToSubords;
 
 public:
-    DisjointSet() : isStale(true), mapStale(true){};
+    DisjointSet() : numNodes(0), isStale(true), mapStale(true){};
 
     // Not a thread safe operation
     DisjointSet& operator=(const DisjointSet& old) {
         if (this == &old) return *this;
 
-        a_blocks = old.a_blocks;
+        a_blocks.clear();
+        for (size_t i = 0; i < old.size(); ++i) {
+            a_blocks.at(i).store(old.get(i).load());
+        }
+        numNodes.store(old.size());
         repToSubords = old.repToSubords;
         isStale.store(old.isStale.load());
         mapStale.store(old.mapStale.load());
@@ -94,10 +101,22 @@ public:
     }
 
     inline size_t size() const {
-        auto sz = a_blocks.size();
-        return sz;
+        return numNodes.load(std::memory_order_acquire);
     };
 
+    /**
+     * Determines the amount of memory used by this disjoint set, not thread safe
+     * @return the number of bytes allocated for the nodes and the cached members of the sets
+     */
+    size_t getMemoryUsage() const {
+        size_t res = sizeof(*this) + a_blocks.getMemoryUsage();
+        res += repToSubords.bucket_count() * sizeof(void*);
+        for (const auto& cur : repToSubords) {
+            res += sizeof(void*) + sizeof(cur.first) + cur.second.getMemoryUsage();
+        }
+        return res;
+    }
+
     inline bool staleList() const {
         return isStale;
     };
@@ -305,15 +324,12 @@ public:
     void clear() {
         // Warning! Not threadsafe..
 
-        nodeLock.lock();
-
         isStale = true;
         mapStale = true;
 
         repToSubords.clear();
         a_blocks.clear();
-
-        nodeLock.unlock();
+        numNodes.store(0);
     }
 
     /**
@@ -382,23 +398,17 @@ public:
      * @return the newly created block
      */
     inline block_t makeNode() {
-        nodeLock.lock();
-
         isStale.store(true);
         mapStale.store(true);
 
-        // its parent is itself (size indicates the position in the listData structure)
-        parent_t xpar = (parent_t)a_blocks.size();
+        // reserve the position of the node, its parent is itself; the node is visible to
+        // enumerations of all nodes once concurrent inserts have completed
+        parent_t xpar = (parent_t)numNodes.fetch_add(1, std::memory_order_acq_rel);
         rank_t xrank = 0;
 
         block_t x = pr2b(xpar, xrank);
 
-        a_blocks.add(x);
-
-        isStale.store(true);
-        mapStale.store(true);
-
-        nodeLock.unlock();
+        a_blocks.at(xpar).store(x, std::memory_order_release);
 
         return x;
     };
@@ -472,16 +482,27 @@ public:
 
 template <typename SparseDomain>
 class SparseDisjointSet {
-    // lock on write operations - STL containers only support 1 writer at all times
-    // mutable std::mutex modLock;
-    // read/write lock on sparseToDenseMap & denseToSparseMap
-    mutable souffle::shared_mutex mapsLock;
-
     DisjointSet ds;
 
-    // values stored in here to those in the dense disjoint set
-    std::unordered_map<SparseDomain, parent_t> sparseToDenseMap;
-    std::vector<SparseDomain> denseToSparseMap;
+    /* an entry of the sparse->dense mapping, only the sparse value is considered for hashing/equality */
+    typedef std::pair<SparseDomain, parent_t> Mapping;
+
+    struct MappingHash {
+        std::size_t operator()(const Mapping& m) const {
+            return std::hash<SparseDomain>()(m.first);
+        }
+    };
+
+    struct MappingEqual {
+        bool operator()(const Mapping& a, const Mapping& b) const {
+            return a.first == b.first;
+        }
+    };
+
+    // values stored in here to those in the dense disjoint set (lock-free lookups)
+    HashSet<Mapping, MappingHash, MappingEqual> sparseToDenseMap;
+    // dense values to their sparse counterparts - the storage never moves, so reads are lock-free
+    SegmentedArray<SparseDomain> denseToSparseMap;
 
 private:
     /**
@@ -490,41 +511,21 @@ private:
      * @return the corresponding dense value
      */
     parent_t toDense(const SparseDomain in) {
-        mapsLock.lock_shared();
-        auto it = sparseToDenseMap.find(in);
-
-        // use the pre-existing value
-        if (it != sparseToDenseMap.end()) {
-            auto ret = it->second;
-            mapsLock.unlock_shared();
-            return ret;
-        }
-        mapsLock.unlock_shared();
-
-        // create node in conversion
-        mapsLock.lock();
-
-        it = sparseToDenseMap.find(in);
-        // use the pre-existing value (as perhaps, it may have been written twice)
-        if (it != sparseToDenseMap.end()) {
-            auto ret = it->second;
-            mapsLock.unlock();
-            return ret;
-        }
-
-        size_t j = denseToSparseMap.size();
-        // check if we create a dense value outside of the bounds that can be stored
-        if (j > std::numeric_limits<parent_t>::max()) throw std::runtime_error("out of bounds dense value");
-        parent_t jClipped = static_cast<parent_t>(j);
-
-        // we create the node
-        ds.makeNode();
-        denseToSparseMap.push_back(in);
-        sparseToDenseMap[in] = jClipped;
-
-        mapsLock.unlock();
-
-        return jClipped;
+        // the node is only created by the thread successfully inserting the mapping, other threads
+        // looking up the same value wait until the dense value has been published
+        return sparseToDenseMap
+                .findOrInsert(Mapping(in, 0),
+                        [&](Mapping& m) {
+                            // check if we create a dense value outside of the bounds that can be stored
+                            if (ds.size() >= std::numeric_limits<parent_t>::max())
+                                throw std::runtime_error("out of bounds dense value");
+
+                            // we create the node
+                            parent_t j = DisjointSet::b2p(ds.makeNode());
+                            denseToSparseMap.set(j, in);
+                            m.second = j;
+                        })
+                .second;
     }
 
 public:
@@ -615,11 +616,8 @@ public:
      * @return the sparse value from the denseToSparseMap
      */
     inline const SparseDomain toSparse(const parent_t in) const {
-        mapsLock.lock_shared();
-        auto ret = denseToSparseMap.at(in);
-        mapsLock.unlock_shared();
-
-        return ret;
+        if (in >= ds.size()) throw std::out_of_range("invalid dense value");
+        return denseToSparseMap.get(in);
     };
 
     /* a wrapper to enable checking in the sparse set - however also adds them if not already existing */
@@ -648,10 +646,8 @@ public:
         // we should clear this first, as we want to reduce how many locks are blocking at one given moment
         ds.clear();
 
-        mapsLock.lock();
         sparseToDenseMap.clear();
         denseToSparseMap.clear();
-        mapsLock.unlock();
     }
 
     /**
@@ -664,6 +660,15 @@ public:
         return ds.numInSet(ds.readOnlyFindNode(inD));
     }
 
+    /**
+     * Determines the amount of memory used by this disjoint set, not thread safe
+     * @return the number of bytes allocated for the dense set and the mappings of its values
+     */
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this) - sizeof(ds) - sizeof(sparseToDenseMap) - sizeof(denseToSparseMap) +
+               ds.getMemoryUsage() + sparseToDenseMap.getMemoryUsage() + denseToSparseMap.getMemoryUsage();
+    }
+
     /* wrapper for node creation */
     inline void makeNode(SparseDomain val) {
         toDense(val);
@@ -671,11 +676,7 @@ public:
 
     /* whether we the supplied node exists */
     inline bool nodeExists(const SparseDomain val) const {
-        mapsLock.lock_shared();
-        bool result = sparseToDenseMap.find(val) != sparseToDenseMap.end();
-        mapsLock.unlock_shared();
-
-        return result;
+        return sparseToDenseMap.contains(Mapping(val, 0));
     };
 
     inline bool contains(SparseDomain v1, SparseDomain v2) {
@@ -18,6 +18,13 @@
 #include "RamTypes.h"
 #include "SymbolMask.h"
 #include "SymbolTable.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace souffle {
 
@@ -26,12 +33,20 @@ public:
     WriteStream(const SymbolMask& symbolMask, const SymbolTable& symbolTable)
             : symbolMask(symbolMask), symbolTable(symbolTable) {}
     template <typename T>
-    void writeAll(const T& relation) {
-        auto lease = symbolTable.acquireLock();
-        (void)lease;
-        for (const auto& current : relation) {
-            writeNext(current);
+    void writeAll(T& relation) {
+        // symbols are resolved through a snapshot, such that the evaluation may add symbols while
+        // the relation is written in the background
+        if (symbolMask.hasSymbols()) {
+            symbols = symbolTable.getSymbols();
+        }
+        if (isBuffered()) {
+            writeChunks(relation);
+        } else {
+            for (const auto& current : relation) {
+                writeNext(current);
+            }
         }
+        writeEnd();
     }
     virtual ~WriteStream() = default;
 
@@ -41,8 +56,110 @@ protected:
     void writeNext(const Tuple tuple) {
         writeNextTuple(tuple.data);
     }
+
+    /** Whether tuples are formatted into buffers by formatTuple() and written by writeBuffer(). */
+    virtual bool isBuffered() const {
+        return false;
+    }
+
+    /** Appends the representation of the given tuple to the given buffer, may be called concurrently. */
+    virtual void formatTuple(std::string& /* buffer */, const RamDomain* /* tuple */) const {}
+
+    /** Writes a buffer of formatted tuples. */
+    virtual void writeBuffer(const std::string& /* buffer */) {}
+
+    /** Completes writing a relation once writeAll() has written all of its tuples without error. */
+    virtual void writeEnd() {}
+
+    /** Obtains the string of a symbol of a tuple written by writeAll(). */
+    const char* resolveSymbol(RamDomain symbol) const {
+        return symbols[symbol];
+    }
+
     const SymbolMask& symbolMask;
     const SymbolTable& symbolTable;
+
+    /** The strings of all symbols at the time the current relation is written */
+    std::vector<const char*> symbols;
+
+private:
+    template <typename Tuple>
+    static const RamDomain* getData(const Tuple& tuple) {
+        return &tuple[0];
+    }
+
+    /* Obtains the partition of a relation supporting it. */
+    template <typename T>
+    static auto getChunks(const T& relation, size_t, int) -> decltype(relation.partition()) {
+        return relation.partition();
+    }
+
+    /* Partitions any other relation into chunks of consecutive tuples. */
+    template <typename T>
+    static std::vector<range<decltype(std::declval<const T&>().begin())>> getChunks(
+            const T& relation, size_t size, long) {
+        typedef decltype(relation.begin()) iter;
+        const size_t chunkSize = std::max<size_t>(size / 400, 1024);
+        std::vector<range<iter>> res;
+        iter begin = relation.begin();
+        iter cur = begin;
+        size_t count = 0;
+        while (cur != relation.end()) {
+            ++cur;
+            if (++count == chunkSize) {
+                res.push_back(make_range(begin, cur));
+                begin = cur;
+                count = 0;
+            }
+        }
+        if (count > 0) {
+            res.push_back(make_range(begin, cur));
+        }
+        return res;
+    }
+
+    /* Formats the chunks of the given relation in parallel and writes them in order. */
+    template <typename T>
+    void writeChunks(T& relation) {
+        // relations of the program interface only offer a non-const size()
+        const size_t size = relation.size();
+        const auto chunks = getChunks(relation, size, 0);
+        if (chunks.empty()) {
+            return;
+        }
+
+        // combine small chunks, such that buffers hold a few thousand tuples
+        const size_t tuplesPerChunk = std::max<size_t>(size / chunks.size(), 1);
+        const size_t chunksPerBuffer = (4096 + tuplesPerChunk - 1) / tuplesPerChunk;
+        const size_t numBuffers = (chunks.size() + chunksPerBuffer - 1) / chunksPerBuffer;
+
+        // errors of writing are raised once the parallel loop, which must not be left by them, completes
+        const bool nullary = symbolMask.getArity() == 0;
+        std::exception_ptr error;
+#pragma omp parallel for schedule(dynamic) ordered
+        for (size_t i = 0; i < numBuffers; i++) {
+            std::string buffer;
+            const size_t last = std::min((i + 1) * chunksPerBuffer, chunks.size());
+            for (size_t j = i * chunksPerBuffer; j < last; j++) {
+                for (const auto& cur : chunks[j]) {
+                    formatTuple(buffer, nullary ? nullptr : getData(cur));
+                }
+            }
+#pragma omp ordered
+            {
+                if (!error) {
+                    try {
+                        writeBuffer(buffer);
+                    } catch (...) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
 };
 
 class WriteStreamFactory {
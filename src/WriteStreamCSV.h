@@ -21,6 +21,7 @@
 #include "gzfstream.h"
 #endif
 
+#include <cstdint>
 #include <fstream>
 #include <memory>
 #include <ostream>
@@ -28,86 +29,107 @@
 
 namespace souffle {
 
-class WriteFileCSV : public WriteStream {
+/**
+ * The common base of CSV writers. Tuples are formatted concurrently into buffers, which are
+ * written by the individual writers in order.
+ */
+class WriteStreamCSV : public WriteStream {
 public:
-    WriteFileCSV(const std::string& filename, const SymbolMask& symbolMask, const SymbolTable& symbolTable,
-            std::string delimiter = "\t")
-            : WriteStream(symbolMask, symbolTable), delimiter(std::move(delimiter)), file(filename) {}
+    WriteStreamCSV(const SymbolMask& symbolMask, const SymbolTable& symbolTable, std::string delimiter)
+            : WriteStream(symbolMask, symbolTable), delimiter(std::move(delimiter)) {}
 
-    ~WriteFileCSV() override = default;
+    ~WriteStreamCSV() override = default;
 
 protected:
     void writeNextTuple(const RamDomain* tuple) override {
+        std::string buffer;
+        formatTuple(buffer, tuple);
+        writeBuffer(buffer);
+    }
+
+    bool isBuffered() const override {
+        return true;
+    }
+
+    void formatTuple(std::string& buffer, const RamDomain* tuple) const override {
         size_t arity = symbolMask.getArity();
         if (arity == 0) {
-            file << "()\n";
+            buffer += "()\n";
             return;
         }
 
-        if (symbolMask.isSymbol(0)) {
-            file << symbolTable.unsafeResolve(tuple[0]);
-        } else {
-            file << static_cast<int32_t>(tuple[0]);
-        }
-        for (size_t col = 1; col < arity; ++col) {
-            file << delimiter;
+        for (size_t col = 0; col < arity; ++col) {
+            if (col > 0) {
+                buffer += delimiter;
+            }
             if (symbolMask.isSymbol(col)) {
-                file << symbolTable.unsafeResolve(tuple[col]);
+                buffer += resolveSymbol(tuple[col]);
             } else {
-                file << static_cast<int32_t>(tuple[col]);
+                appendNumber(buffer, static_cast<int32_t>(tuple[col]));
             }
         }
-        file << "\n";
+        buffer += '\n';
     }
 
-protected:
     const std::string delimiter;
+
+private:
+    /* Appends the decimal representation of a number, avoiding the overhead of streams. */
+    static void appendNumber(std::string& buffer, int32_t value) {
+        char digits[12];
+        char* end = digits + sizeof(digits);
+        char* pos = end;
+        uint32_t magnitude = (value < 0) ? 0u - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+        do {
+            *--pos = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+        if (value < 0) {
+            *--pos = '-';
+        }
+        buffer.append(pos, end - pos);
+    }
+};
+
+class WriteFileCSV : public WriteStreamCSV {
+public:
+    WriteFileCSV(const std::string& filename, const SymbolMask& symbolMask, const SymbolTable& symbolTable,
+            std::string delimiter = "\t")
+            : WriteStreamCSV(symbolMask, symbolTable, std::move(delimiter)), file(filename) {}
+
+    ~WriteFileCSV() override = default;
+
+protected:
+    void writeBuffer(const std::string& buffer) override {
+        file.write(buffer.data(), buffer.size());
+    }
+
     std::ofstream file;
 };
 
 #ifdef USE_LIBZ
-class WriteGZipFileCSV : public WriteStream {
+class WriteGZipFileCSV : public WriteStreamCSV {
 public:
     WriteGZipFileCSV(const std::string& filename, const SymbolMask& symbolMask,
             const SymbolTable& symbolTable, std::string delimiter = "\t")
-            : WriteStream(symbolMask, symbolTable), delimiter(std::move(delimiter)), file(filename) {}
+            : WriteStreamCSV(symbolMask, symbolTable, std::move(delimiter)), file(filename) {}
 
     ~WriteGZipFileCSV() override = default;
 
 protected:
-    void writeNextTuple(const RamDomain* tuple) override {
-        size_t arity = symbolMask.getArity();
-        if (arity == 0) {
-            file << "()\n";
-            return;
-        }
-
-        if (symbolMask.isSymbol(0)) {
-            file << symbolTable.unsafeResolve(tuple[0]);
-        } else {
-            file << static_cast<int32_t>(tuple[0]);
-        }
-        for (size_t col = 1; col < arity; ++col) {
-            file << delimiter;
-            if (symbolMask.isSymbol(col)) {
-                file << symbolTable.unsafeResolve(tuple[col]);
-            } else {
-                file << static_cast<int32_t>(tuple[col]);
-            }
-        }
-        file << "\n";
+    void writeBuffer(const std::string& buffer) override {
+        file.write(buffer.data(), buffer.size());
     }
 
-    const std::string delimiter;
     gzfstream::ogzfstream file;
 };
 #endif
 
-class WriteCoutCSV : public WriteStream {
+class WriteCoutCSV : public WriteStreamCSV {
 public:
     WriteCoutCSV(const std::string& relationName, const SymbolMask& symbolMask,
             const SymbolTable& symbolTable, std::string delimiter = "\t")
-            : WriteStream(symbolMask, symbolTable), delimiter(std::move(delimiter)) {
+            : WriteStreamCSV(symbolMask, symbolTable, std::move(delimiter)) {
         std::cout << "---------------\n" << relationName << "\n===============\n";
     }
 
@@ -116,30 +138,9 @@ public:
     }
 
 protected:
-    void writeNextTuple(const RamDomain* tuple) override {
-        size_t arity = symbolMask.getArity();
-        if (arity == 0) {
-            std::cout << "()\n";
-            return;
-        }
-
-        if (symbolMask.isSymbol(0)) {
-            std::cout << symbolTable.unsafeResolve(tuple[0]);
-        } else {
-            std::cout << static_cast<int32_t>(tuple[0]);
-        }
-        for (size_t col = 1; col < arity; ++col) {
-            std::cout << delimiter;
-            if (symbolMask.isSymbol(col)) {
-                std::cout << symbolTable.unsafeResolve(tuple[col]);
-            } else {
-                std::cout << static_cast<int32_t>(tuple[col]);
-            }
-        }
-        std::cout << "\n";
+    void writeBuffer(const std::string& buffer) override {
+        std::cout.write(buffer.data(), buffer.size());
     }
-
-    const std::string delimiter;
 };
 
 class WriteCSVFactory {
@@ -18,58 +18,100 @@
 #include "SymbolTable.h"
 #include "WriteStream.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <sqlite3.h>
 
 namespace souffle {
 
+/**
+ * A writer storing a relation in an SQLite database. Symbols are stored in a symbol table shared
+ * by all relations of the database, symbol columns of the relation refer to its entries.
+ *
+ * All data of a relation is written within a single transaction, committed once all tuples have
+ * been written and rolled back if writing fails. Tuples are written in batches by multi-row insert
+ * statements, preceded by the bulk insertion of the symbols not yet known to the database.
+ */
 class WriteStreamSQLite : public WriteStream {
 public:
     WriteStreamSQLite(const std::string& dbFilename, const std::string& relationName,
             const SymbolMask& symbolMask, const SymbolTable& symbolTable)
-            : WriteStream(symbolMask, symbolTable), dbFilename(dbFilename), relationName(relationName) {
+            : WriteStream(symbolMask, symbolTable), dbFilename(dbFilename), relationName(relationName),
+              rowsPerStatement(getRowsPerStatement(symbolMask.getArity())) {
         openDB();
+        executeSQL("BEGIN TRANSACTION", db);
         createTables();
         prepareStatements();
-        //        executeSQL("BEGIN TRANSACTION", db);
     }
 
     ~WriteStreamSQLite() override {
         sqlite3_finalize(insertStatement);
+        sqlite3_finalize(batchInsertStatement);
         sqlite3_finalize(symbolInsertStatement);
         sqlite3_finalize(symbolSelectStatement);
+        // a relation not written completely is discarded
+        if (!committed) {
+            sqlite3_exec(db, "ROLLBACK TRANSACTION", nullptr, nullptr, nullptr);
+        }
         sqlite3_close(db);
     }
 
 protected:
-    void writeNextTuple(const RamDomain* tuple) override {
-        if (symbolMask.getArity() == 0) {
+    bool isBuffered() const override {
+        return true;
+    }
+
+    /* Tuples are buffered in their binary representation. */
+    void formatTuple(std::string& buffer, const RamDomain* tuple) const override {
+        buffer.append(reinterpret_cast<const char*>(tuple), symbolMask.getArity() * sizeof(RamDomain));
+    }
+
+    void writeBuffer(const std::string& buffer) override {
+        const std::size_t arity = symbolMask.getArity();
+        if (arity == 0) {
             return;
         }
+        std::vector<RamDomain> tuples(buffer.size() / sizeof(RamDomain));
+        std::memcpy(tuples.data(), buffer.data(), tuples.size() * sizeof(RamDomain));
+        const std::size_t numTuples = tuples.size() / arity;
 
-        for (size_t i = 0; i < symbolMask.getArity(); i++) {
-            int32_t value;
-            if (symbolMask.isSymbol(i)) {
-                value = getSymbolTableID(tuple[i]);
-            } else {
-                value = (int32_t)tuple[i];
-            }
-            if (sqlite3_bind_int(insertStatement, i + 1, value) != SQLITE_OK) {
-                throwError("SQLite error in sqlite3_bind_text: ");
+        insertSymbols(tuples);
+
+        std::size_t i = 0;
+        for (; i + rowsPerStatement <= numTuples; i += rowsPerStatement) {
+            for (std::size_t j = 0; j < rowsPerStatement; ++j) {
+                bindTuple(batchInsertStatement, j * arity, &tuples[(i + j) * arity]);
             }
+            executeStatement(batchInsertStatement);
         }
-        if (sqlite3_step(insertStatement) != SQLITE_DONE) {
-            throwError("SQLite error in sqlite3_step: ");
+        for (; i < numTuples; ++i) {
+            bindTuple(insertStatement, 0, &tuples[i * arity]);
+            executeStatement(insertStatement);
         }
-        sqlite3_clear_bindings(insertStatement);
-        sqlite3_reset(insertStatement);
+    }
+
+    void writeEnd() override {
+        executeSQL("COMMIT TRANSACTION", db);
+        committed = true;
+    }
+
+    void writeNextTuple(const RamDomain* tuple) override {
+        std::string buffer;
+        formatTuple(buffer, tuple);
+        writeBuffer(buffer);
     }
 
 private:
+    // limits on the size of statements, the parameter limit is the lowest default of SQLite
+    static constexpr std::size_t maxParameters = 999;
+    static constexpr std::size_t maxRowsPerStatement = 256;
+
     void executeSQL(const std::string& sql, sqlite3* db) {
         assert(db && "Database connection is closed");
 
@@ -92,41 +134,89 @@ private:
         throw std::invalid_argument(error.str());
     }
 
-    uint64_t getSymbolTableIDFromDB(int index) {
-        if (sqlite3_bind_text(symbolSelectStatement, 1, symbolTable.unsafeResolve(index), -1,
-                    SQLITE_TRANSIENT) != SQLITE_OK) {
-            throwError("SQLite error in sqlite3_bind_text: ");
+    static std::size_t getRowsPerStatement(std::size_t arity) {
+        const std::size_t rows = (arity == 0) ? 1 : maxParameters / arity;
+        return std::max(std::size_t(1), std::min(rows, std::size_t(maxRowsPerStatement)));
+    }
+
+    void bindTuple(sqlite3_stmt* statement, std::size_t offset, const RamDomain* tuple) {
+        for (std::size_t i = 0; i < symbolMask.getArity(); i++) {
+            int32_t value;
+            if (symbolMask.isSymbol(i)) {
+                value = dbSymbolTable[tuple[i]];
+            } else {
+                value = (int32_t)tuple[i];
+            }
+            if (sqlite3_bind_int(statement, offset + i + 1, value) != SQLITE_OK) {
+                throwError("SQLite error in sqlite3_bind_int: ");
+            }
         }
-        if (sqlite3_step(symbolSelectStatement) != SQLITE_ROW) {
+    }
+
+    void executeStatement(sqlite3_stmt* statement) {
+        if (sqlite3_step(statement) != SQLITE_DONE) {
             throwError("SQLite error in sqlite3_step: ");
         }
-        uint64_t rowid = sqlite3_column_int64(symbolSelectStatement, 0);
-        sqlite3_clear_bindings(symbolSelectStatement);
-        sqlite3_reset(symbolSelectStatement);
-        return rowid;
+        sqlite3_reset(statement);
     }
-    uint64_t getSymbolTableID(int index) {
-        if (dbSymbolTable.count(index) != 0) {
-            return dbSymbolTable[index];
-        }
 
-        if (sqlite3_bind_text(symbolInsertStatement, 1, symbolTable.unsafeResolve(index), -1,
-                    SQLITE_TRANSIENT) != SQLITE_OK) {
-            throwError("SQLite error in sqlite3_bind_text: ");
+    sqlite3_stmt* prepare(const std::string& sql) {
+        sqlite3_stmt* statement = nullptr;
+        const char* tail = nullptr;
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &statement, &tail) != SQLITE_OK) {
+            throwError("SQLite error in sqlite3_prepare_v2: ");
         }
-        // Either the insert succeeds and we have a new row id or it already exists and a select is needed.
-        uint64_t rowid;
-        if (sqlite3_step(symbolInsertStatement) != SQLITE_DONE) {
-            // The symbol already exists so select it.
-            rowid = getSymbolTableIDFromDB(index);
-        } else {
-            rowid = sqlite3_last_insert_rowid(db);
+        return statement;
+    }
+
+    /* Enters the symbols of the given tuples not yet known into the symbol table of the database. */
+    void insertSymbols(const std::vector<RamDomain>& tuples) {
+        const std::size_t arity = symbolMask.getArity();
+        std::vector<RamDomain> missing;
+        for (std::size_t i = 0; i < tuples.size(); i += arity) {
+            for (std::size_t j = 0; j < arity; j++) {
+                if (symbolMask.isSymbol(j) && dbSymbolTable.insert(std::make_pair(tuples[i + j], 0)).second) {
+                    missing.push_back(tuples[i + j]);
+                }
+            }
         }
-        sqlite3_clear_bindings(symbolInsertStatement);
-        sqlite3_reset(symbolInsertStatement);
 
-        dbSymbolTable[index] = rowid;
-        return rowid;
+        for (std::size_t i = 0; i < missing.size(); i += maxRowsPerStatement) {
+            const std::size_t count = std::min(missing.size() - i, std::size_t(maxRowsPerStatement));
+            sqlite3_stmt* insert = symbolInsertStatement;
+            sqlite3_stmt* select = symbolSelectStatement;
+            if (count != maxRowsPerStatement) {
+                insert = prepare(getSymbolInsertSQL(count));
+                select = prepare(getSymbolSelectSQL(count));
+            }
+
+            std::unordered_map<std::string, RamDomain> indices;
+            for (std::size_t j = 0; j < count; j++) {
+                const char* symbol = resolveSymbol(missing[i + j]);
+                indices[symbol] = missing[i + j];
+                if (sqlite3_bind_text(insert, j + 1, symbol, -1, SQLITE_STATIC) != SQLITE_OK ||
+                        sqlite3_bind_text(select, j + 1, symbol, -1, SQLITE_STATIC) != SQLITE_OK) {
+                    throwError("SQLite error in sqlite3_bind_text: ");
+                }
+            }
+
+            // insert the symbols unless they exist and obtain the ids of all of them
+            executeStatement(insert);
+            int rc;
+            while ((rc = sqlite3_step(select)) == SQLITE_ROW) {
+                const char* symbol = reinterpret_cast<const char*>(sqlite3_column_text(select, 1));
+                dbSymbolTable[indices[symbol]] = sqlite3_column_int64(select, 0);
+            }
+            if (rc != SQLITE_DONE) {
+                throwError("SQLite error in sqlite3_step: ");
+            }
+            sqlite3_reset(select);
+
+            if (count != maxRowsPerStatement) {
+                sqlite3_finalize(insert);
+                sqlite3_finalize(select);
+            }
+        }
     }
 
     void openDB() {
@@ -139,42 +229,44 @@ private:
     }
 
     void prepareStatements() {
-        prepareInsertStatement();
-        prepareSymbolInsertStatement();
-        prepareSymbolSelectStatement();
+        insertStatement = prepare(getInsertSQL(1));
+        batchInsertStatement = prepare(getInsertSQL(rowsPerStatement));
+        symbolInsertStatement = prepare(getSymbolInsertSQL(maxRowsPerStatement));
+        symbolSelectStatement = prepare(getSymbolSelectSQL(maxRowsPerStatement));
     }
-    void prepareSymbolInsertStatement() {
+
+    std::string getSymbolInsertSQL(std::size_t count) const {
         std::stringstream insertSQL;
-        insertSQL << "INSERT INTO " << symbolTableName;
-        insertSQL << " VALUES(null,@V0);";
-        const char* tail = nullptr;
-        if (sqlite3_prepare_v2(db, insertSQL.str().c_str(), -1, &symbolInsertStatement, &tail) != SQLITE_OK) {
-            throwError("SQLite error in sqlite3_prepare_v2: ");
+        insertSQL << "INSERT OR IGNORE INTO " << symbolTableName << " (symbol) VALUES (?)";
+        for (std::size_t i = 1; i < count; i++) {
+            insertSQL << ",(?)";
         }
+        insertSQL << ";";
+        return insertSQL.str();
     }
 
-    void prepareSymbolSelectStatement() {
+    std::string getSymbolSelectSQL(std::size_t count) const {
         std::stringstream selectSQL;
-        selectSQL << "SELECT id FROM " << symbolTableName;
-        selectSQL << " WHERE symbol = @V0;";
-        const char* tail = nullptr;
-        if (sqlite3_prepare_v2(db, selectSQL.str().c_str(), -1, &symbolSelectStatement, &tail) != SQLITE_OK) {
-            throwError("SQLite error in sqlite3_prepare_v2: ");
+        selectSQL << "SELECT id, symbol FROM " << symbolTableName << " WHERE symbol IN (?";
+        for (std::size_t i = 1; i < count; i++) {
+            selectSQL << ",?";
         }
+        selectSQL << ");";
+        return selectSQL.str();
     }
 
-    void prepareInsertStatement() {
+    std::string getInsertSQL(std::size_t count) const {
         std::stringstream insertSQL;
-        insertSQL << "INSERT INTO _" << relationName << " VALUES ";
-        insertSQL << "(@V0";
-        for (unsigned int i = 1; i < symbolMask.getArity(); i++) {
-            insertSQL << ",@V" << i;
-        }
-        insertSQL << ");";
-        const char* tail = nullptr;
-        if (sqlite3_prepare_v2(db, insertSQL.str().c_str(), -1, &insertStatement, &tail) != SQLITE_OK) {
-            throwError("SQLite error in sqlite3_prepare_v2: ");
+        insertSQL << "INSERT INTO '_" << relationName << "' VALUES ";
+        for (std::size_t i = 0; i < count; i++) {
+            insertSQL << ((i == 0) ? "(?" : ",(?");
+            for (unsigned int j = 1; j < symbolMask.getArity(); j++) {
+                insertSQL << ",?";
+            }
+            insertSQL << ")";
         }
+        insertSQL << ";";
+        return insertSQL.str();
     }
 
     void createTables() {
@@ -244,11 +336,19 @@ private:
     const std::string& relationName;
     const std::string symbolTableName = "__SymbolTable";
 
-    std::unordered_map<uint64_t, uint64_t> dbSymbolTable;
-    sqlite3_stmt* insertStatement;
-    sqlite3_stmt* symbolInsertStatement;
-    sqlite3_stmt* symbolSelectStatement;
+    // the number of tuples inserted by batchInsertStatement
+    const std::size_t rowsPerStatement;
+
+    // the ids of the symbols in the symbol table of the database
+    std::unordered_map<RamDomain, uint64_t> dbSymbolTable;
+    sqlite3_stmt* insertStatement = nullptr;
+    sqlite3_stmt* batchInsertStatement = nullptr;
+    sqlite3_stmt* symbolInsertStatement = nullptr;
+    sqlite3_stmt* symbolSelectStatement = nullptr;
     sqlite3* db;
+
+    // whether the transaction writing the relation has been committed
+    bool committed = false;
 };
 
 class WriteSQLiteFactory : public WriteStreamFactory {
@@ -9,14 +9,31 @@
 /************************************************************************
  *
  * @file gzfstream.h
- * A simple zlib wrapper to provide gzip file streams.
+ * A simple zlib wrapper to provide gzip file streams. Compression and
+ * decompression are conducted by background threads.
  *
  ***********************************************************************/
 
 #pragma once
 
+#include <algorithm>
+#include <cstdio>
 #include <cstring>
+#include <exception>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#endif
 
 #include <zlib.h>
 
@@ -26,11 +43,427 @@ namespace gzfstream {
 
 namespace internal {
 
+/**
+ * A writer of gzip files compressing its input in independent blocks, as done by pigz. Each
+ * block is compressed as a raw deflate stream primed with the tail of the preceding block and
+ * ended by a sync flush, such that the concatenation of the compressed blocks forms a single
+ * deflate stream, which is ended by the last block. The checksums of the blocks are combined
+ * in order. Data fitting into a single block is thus compressed exactly as by gzwrite.
+ *
+ * Multiple blocks are compressed concurrently by a fixed set of background threads while the
+ * caller continues to produce data; compressed blocks are written in the order of their creation.
+ * Compression errors are reported by exceptions.
+ */
+class gzblockwriter {
+    // the amount of uncompressed data per block
+    static constexpr std::size_t blockSize = 1 << 18;
+
+    // the size of the window primed from the preceding block
+    static constexpr std::size_t dictionarySize = 1 << 15;
+
+    struct block {
+        std::string data;
+        uLong crc;
+        uLong length;
+    };
+
+    std::FILE* file;
+
+    // the data of the block currently being filled
+    std::string current;
+
+    // the tail of the last submitted block
+    std::string dictionary;
+
+    // the blocks being compressed, in order
+#ifdef _OPENMP
+    std::deque<std::future<block>> pending;
+    const std::size_t maxPending;
+
+    // the compression tasks not yet started and the threads conducting them, started on demand
+    std::deque<std::packaged_task<block()>> tasks;
+    std::vector<std::thread> workers;
+    bool stop;
+    std::mutex lock;
+    std::condition_variable cv;
+#endif
+
+    // the checksum and length (mod 2^32) of the data written so far
+    uLong crc;
+    uLong length;
+
+    bool ok;
+
+public:
+    explicit gzblockwriter(const std::string& filename)
+            : file(std::fopen(filename.c_str(), "wb")),
+#ifdef _OPENMP
+              maxPending(std::max(2u, std::thread::hardware_concurrency())), stop(false),
+#endif
+              crc(crc32(0L, Z_NULL, 0)), length(0), ok(file != nullptr) {
+        // header: magic, deflate, no flags, no time, no extra flags, unix
+        static const unsigned char header[10] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 3};
+        if (ok) {
+            ok = std::fwrite(header, 1, sizeof(header), file) == sizeof(header);
+        }
+        current.reserve(blockSize);
+    }
+
+    gzblockwriter(const gzblockwriter&) = delete;
+    gzblockwriter& operator=(const gzblockwriter&) = delete;
+
+    ~gzblockwriter() {
+        try {
+            close();
+        } catch (...) {
+            // Don't throw exceptions.
+        }
+    }
+
+    bool is_open() const {
+        return file != nullptr;
+    }
+
+    bool write(const char* data, std::size_t size) {
+        while (size > 0) {
+            std::size_t n = std::min(size, blockSize - current.size());
+            current.append(data, n);
+            data += n;
+            size -= n;
+            if (current.size() == blockSize) {
+                submit();
+            }
+        }
+        return ok;
+    }
+
+    /** Writes all remaining data, the end of the stream and the trailer, and closes the file. */
+    bool close() {
+        if (!file) {
+            return false;
+        }
+        // the last block ends the deflate stream, without data an empty final block does
+        bool empty = current.empty();
+        std::exception_ptr error;
+        try {
+            if (!empty) {
+                submit(true);
+            }
+#ifdef _OPENMP
+            while (!pending.empty()) {
+                retire();
+            }
+#endif
+        } catch (...) {
+            error = std::current_exception();
+        }
+#ifdef _OPENMP
+        pending.clear();
+        stopWorkers();
+#endif
+        if (error) {
+            std::fclose(file);
+            file = nullptr;
+            std::rethrow_exception(error);
+        }
+
+        unsigned char trailer[10] = {3, 0};
+        for (int i = 0; i < 4; ++i) {
+            trailer[2 + i] = (crc >> (8 * i)) & 0xff;
+            trailer[6 + i] = (length >> (8 * i)) & 0xff;
+        }
+        const std::size_t offset = empty ? 0 : 2;
+        const std::size_t size = sizeof(trailer) - offset;
+        ok = std::fwrite(trailer + offset, 1, size, file) == size && ok;
+        ok = std::fclose(file) == 0 && ok;
+        file = nullptr;
+        return ok;
+    }
+
+private:
+    /* Hands the current block over to be compressed. */
+    void submit(bool last = false) {
+        std::string next = current.size() > dictionarySize
+                                   ? current.substr(current.size() - dictionarySize)
+                                   : dictionary.substr(std::min(dictionary.size(), current.size())) + current;
+#ifdef _OPENMP
+        while (pending.size() >= maxPending) {
+            retire();
+        }
+        std::packaged_task<block()> task(
+                std::bind(&gzblockwriter::compress, std::move(current), std::move(dictionary), last));
+        pending.push_back(task.get_future());
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            tasks.push_back(std::move(task));
+        }
+        cv.notify_one();
+
+        // the caller produces data, thus one thread less than the blocks in flight suffices
+        if (workers.empty()) {
+            for (std::size_t i = 1; i < maxPending; ++i) {
+                workers.emplace_back([this]() { work(); });
+            }
+        }
+#else
+        append(compress(std::move(current), std::move(dictionary), last));
+#endif
+        dictionary = std::move(next);
+        current.clear();
+        current.reserve(blockSize);
+    }
+
+#ifdef _OPENMP
+    /* Writes the oldest block being compressed. */
+    void retire() {
+        std::future<block> next = std::move(pending.front());
+        pending.pop_front();
+        append(next.get());
+    }
+
+    /* Conducts compression tasks until stopped. */
+    void work() {
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            cv.wait(guard, [this]() { return !tasks.empty() || stop; });
+            if (tasks.empty()) {
+                return;
+            }
+            std::packaged_task<block()> task = std::move(tasks.front());
+            tasks.pop_front();
+            guard.unlock();
+            task();
+            guard.lock();
+        }
+    }
+
+    /* Completes the remaining tasks and terminates the worker threads. */
+    void stopWorkers() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stop = true;
+        }
+        cv.notify_all();
+        for (auto& cur : workers) {
+            cur.join();
+        }
+        workers.clear();
+    }
+#endif
+
+    void append(const block& b) {
+        ok = ok && std::fwrite(b.data.data(), 1, b.data.size(), file) == b.data.size();
+        crc = crc32_combine(crc, b.crc, b.length);
+        length += b.length;
+    }
+
+    /* Compresses a block of data, may be called concurrently. */
+    static block compress(const std::string& data, const std::string& dictionary, bool last) {
+        block res;
+        res.length = data.size();
+        res.crc = crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(data.data()), data.size());
+
+        z_stream stream;
+        std::memset(&stream, 0, sizeof(stream));
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            throw std::runtime_error("cannot initialize gzip compression");
+        }
+        if (!dictionary.empty() &&
+                deflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(dictionary.data()),
+                        dictionary.size()) != Z_OK) {
+            deflateEnd(&stream);
+            throw std::runtime_error("cannot set the dictionary of gzip compression");
+        }
+
+        // a sync flush adds at most an empty stored block to the bound
+        const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+        res.data.resize(deflateBound(&stream, data.size()) + 16);
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        stream.avail_in = data.size();
+        stream.next_out = reinterpret_cast<Bytef*>(&res.data[0]);
+        stream.avail_out = res.data.size();
+        int status;
+        while ((status = deflate(&stream, flush)) == Z_OK && stream.avail_out == 0) {
+            std::size_t done = res.data.size();
+            res.data.resize(2 * done);
+            stream.next_out = reinterpret_cast<Bytef*>(&res.data[done]);
+            stream.avail_out = res.data.size() - done;
+        }
+        res.data.resize(stream.total_out);
+        deflateEnd(&stream);
+
+        // a flush which exactly filled the output leaves nothing to do for the next call
+        const bool done = last ? status == Z_STREAM_END
+                               : (status == Z_OK || status == Z_BUF_ERROR) && stream.avail_in == 0;
+        if (!done) {
+            throw std::runtime_error("cannot compress gzip data");
+        }
+        return res;
+    }
+};
+
+/**
+ * A reader of gzip files decompressing ahead of its consumer. Blocks of decompressed data are
+ * produced by a background thread into a ring of buffers and handed out in order by read().
+ */
+class gzblockreader {
+    // the amount of decompressed data per buffer
+    static constexpr std::size_t blockSize = 1 << 18;
+
+    gzFile file;
+
+#ifdef _OPENMP
+    static constexpr std::size_t numSlots = 4;
+
+    // the ring of buffers and the amount of data within each
+    std::vector<char> slots[numSlots];
+    std::size_t sizes[numSlots];
+
+    // the number of buffers filled by the producer and consumed by read()
+    std::size_t produced;
+    std::size_t consumed;
+
+    bool stop;
+
+    // whether the producer has stopped on an error rather than at the end of the file
+    bool failed;
+
+    std::mutex lock;
+    std::condition_variable cv;
+
+    std::thread producer;
+#endif
+
+public:
+    explicit gzblockreader(const std::string& filename) : file(gzopen(filename.c_str(), "rb")) {
+#ifdef _OPENMP
+        produced = consumed = 0;
+        stop = failed = false;
+        if (file) {
+            for (auto& cur : slots) {
+                cur.resize(blockSize);
+            }
+            producer = std::thread([this]() { produce(); });
+        }
+#endif
+    }
+
+    gzblockreader(const gzblockreader&) = delete;
+    gzblockreader& operator=(const gzblockreader&) = delete;
+
+    ~gzblockreader() {
+        close();
+    }
+
+    bool is_open() const {
+        return file != nullptr;
+    }
+
+    /** The maximum amount of data obtained by a single read. */
+    static constexpr std::size_t maxRead() {
+        return blockSize;
+    }
+
+    /**
+     * Copies the next block of decompressed data to the given buffer, returns 0 at the end.
+     * Throws an exception if the file cannot be decompressed.
+     */
+    std::size_t read(char* buffer) {
+#ifdef _OPENMP
+        std::unique_lock<std::mutex> guard(lock);
+        cv.wait(guard, [this]() { return produced > consumed; });
+        guard.unlock();
+
+        // the slot is not refilled before it has been consumed
+        std::size_t slot = consumed % numSlots;
+        std::size_t size = sizes[slot];
+        std::memcpy(buffer, slots[slot].data(), size);
+
+        guard.lock();
+        if (size > 0) {
+            ++consumed;
+        } else if (failed) {
+            throw std::runtime_error("cannot decompress gzip file");
+        }
+        guard.unlock();
+        cv.notify_all();
+        return size;
+#else
+        int res = readBlock(buffer);
+        if (res < 0) {
+            throw std::runtime_error("cannot decompress gzip file");
+        }
+        return res;
+#endif
+    }
+
+    bool close() {
+        if (!file) {
+            return false;
+        }
+#ifdef _OPENMP
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stop = true;
+        }
+        cv.notify_all();
+        producer.join();
+#endif
+        bool res = gzclose(file) == Z_OK;
+        file = nullptr;
+        return res;
+    }
+
+private:
+    /* Decompresses the next block, returns -1 on errors including the unexpected end of the file. */
+    int readBlock(char* buffer) {
+        int res = gzread(file, buffer, blockSize);
+        if (res == 0) {
+            int error;
+            gzerror(file, &error);
+            if (error == Z_BUF_ERROR) {
+                return -1;
+            }
+        }
+        return res;
+    }
+
+#ifdef _OPENMP
+    void produce() {
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            cv.wait(guard, [this]() { return produced - consumed < numSlots || stop; });
+            if (stop) {
+                return;
+            }
+            std::size_t slot = produced % numSlots;
+            guard.unlock();
+
+            int res = readBlock(slots[slot].data());
+            sizes[slot] = (res > 0) ? res : 0;
+
+            guard.lock();
+            failed = res < 0;
+            ++produced;
+            cv.notify_all();
+            if (sizes[slot] == 0) {
+                // the end of the file or an error is reported as an empty block which is never consumed
+                return;
+            }
+        }
+    }
+#endif
+};
+
+/**
+ * A stream buffer for gzip files. Data written is compressed by a gzblockwriter, data read is
+ * decompressed by a gzblockreader.
+ */
 class gzfstreambuf : public std::streambuf {
 public:
     gzfstreambuf() {
-        setp(buffer, buffer + (bufferSize - 1));
-        setg(buffer + reserveSize, buffer + reserveSize, buffer + reserveSize);
+        setp(nullptr, nullptr);
+        setg(nullptr, nullptr, nullptr);
     }
 
     gzfstreambuf(const gzfstreambuf&) = delete;
@@ -46,11 +479,22 @@ public:
         }
 
         this->mode = mode;
-        std::string gzmode(mode & std::ios::in ? "rb" : "wb");
-        fileHandle = gzopen(filename.c_str(), gzmode.c_str());
-
-        if (!fileHandle) {
-            return nullptr;
+        if (mode & std::ios::in) {
+            reader.reset(new gzblockreader(filename));
+            if (!reader->is_open()) {
+                reader.reset();
+                return nullptr;
+            }
+            buffer.resize(reserveSize + gzblockreader::maxRead());
+            setg(&buffer[reserveSize], &buffer[reserveSize], &buffer[reserveSize]);
+        } else {
+            writer.reset(new gzblockwriter(filename));
+            if (!writer->is_open()) {
+                writer.reset();
+                return nullptr;
+            }
+            buffer.resize(bufferSize);
+            setp(&buffer[0], &buffer[0] + (bufferSize - 1));
         }
         isOpen = true;
 
@@ -59,9 +503,10 @@ public:
 
     gzfstreambuf* close() {
         if (is_open()) {
-            sync();
+            bool ok = sync() == 0;
             isOpen = false;
-            if (gzclose(fileHandle) == Z_OK) {
+            ok = (reader ? reader->close() : writer->close()) && ok;
+            if (ok) {
                 return this;
             }
         }
@@ -91,7 +536,7 @@ protected:
             pbump(1);
         }
         int toWrite = pptr() - pbase();
-        if (gzwrite(fileHandle, pbase(), toWrite) != toWrite) {
+        if (!writer->write(pbase(), toWrite)) {
             return EOF;
         }
         pbump(-toWrite);
@@ -99,6 +544,20 @@ protected:
         return c;
     }
 
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        if (!(mode & std::ios::out) || !isOpen) {
+            return 0;
+        }
+        // large writes bypass the buffer
+        if (n < static_cast<std::streamsize>(bufferSize)) {
+            return std::streambuf::xsputn(s, n);
+        }
+        if (sync() != 0 || !writer->write(s, n)) {
+            return 0;
+        }
+        return n;
+    }
+
     int_type underflow() override {
         if (!(mode & std::ios::in) || !isOpen) {
             return EOF;
@@ -111,14 +570,14 @@ protected:
         if (charsPutBack > reserveSize) {
             charsPutBack = reserveSize;
         }
-        memcpy(buffer + reserveSize - charsPutBack, gptr() - charsPutBack, charsPutBack);
+        memmove(&buffer[reserveSize - charsPutBack], gptr() - charsPutBack, charsPutBack);
 
-        int charsRead = gzread(fileHandle, buffer + reserveSize, bufferSize - reserveSize);
-        if (charsRead <= 0) {
+        std::size_t charsRead = reader->read(&buffer[reserveSize]);
+        if (charsRead == 0) {
             return EOF;
         }
 
-        setg(buffer + reserveSize - charsPutBack, buffer + reserveSize, buffer + reserveSize + charsRead);
+        setg(&buffer[reserveSize - charsPutBack], &buffer[reserveSize], &buffer[reserveSize + charsRead]);
 
         return traits_type::to_int_type(*gptr());
     }
@@ -126,7 +585,7 @@ protected:
     int sync() override {
         if (pptr() && pptr() > pbase()) {
             int toWrite = pptr() - pbase();
-            if (gzwrite(fileHandle, pbase(), toWrite) != toWrite) {
+            if (!writer->write(pbase(), toWrite)) {
                 return -1;
             }
             pbump(-toWrite);
@@ -138,8 +597,9 @@ private:
     static constexpr unsigned int bufferSize = 4096;
     static constexpr unsigned int reserveSize = 16;
 
-    char buffer[bufferSize];
-    gzFile fileHandle;
+    std::vector<char> buffer;
+    std::unique_ptr<gzblockreader> reader;
+    std::unique_ptr<gzblockwriter> writer;
     bool isOpen = false;
     std::ios_base::openmode mode;
 };
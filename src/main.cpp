@@ -125,8 +125,27 @@ int main(int argc, char** argv) {
                             {"dl-program", 'o', "FILE", "", false,
                                     "Generate C++ source code and compile this to a binary executable "
                                     "written to <FILE>."},
+                            {"bloom-filter", 'B', "", "", false,
+                                    "Accelerate negations and existence checks by Bloom filters."},
+                            {"stream-output", 'S', "", "", false,
+                                    "Write output relations asynchronously as soon as they are computed."},
+                            {"checkpoint", 'k', "DIR", "", false,
+                                    "Save the state of the evaluation to <DIR> after each stratum and resume "
+                                    "an interrupted evaluation from there."},
+                            {"progress", 's', "FILE", "", false,
+                                    "Report the progress of the evaluation in JSON to <FILE>, rewritten "
+                                    "every second."},
+                            {"incremental", 'u', "", "", false,
+                                    "Generate programs which, when run again after inserting tuples into "
+                                    "their inputs, only derive the consequences of the inserted tuples."},
                             {"profile", 'p', "FILE", "", false,
                                     "Enable profiling and write profile data to <FILE>."},
+                            {"profile-counters", 'P', "", "", false,
+                                    "Record the hardware performance counters of rules and relations when "
+                                    "profiling."},
+                            {"profile-indices", 'i', "", "", false,
+                                    "Record the lookups of relations by bound columns, their hits and "
+                                    "visited tuples when profiling."},
                             {"bddbddb", 'b', "FILE", "", false, "Convert input into bddbddb file format."},
                             {"debug-report", 'r', "FILE", "", false, "Write HTML debug report to <FILE>."},
 #ifdef USE_PROVENANCE
@@ -179,6 +198,36 @@ int main(int argc, char** argv) {
             ERROR("output directory " + Global::config().get("output-dir") + " does not exists");
         }
 
+        /* if a checkpoint directory is given, check it exists */
+        if (Global::config().has("checkpoint") && !existDir(Global::config().get("checkpoint"))) {
+            ERROR("checkpoint directory " + Global::config().get("checkpoint") + " does not exists");
+        }
+
+        /* outputs streamed by completed strata are not written again when resuming from a checkpoint */
+        if (Global::config().has("stream-output") && Global::config().has("checkpoint")) {
+            ERROR("option -S/--stream-output cannot be combined with option -k/--checkpoint");
+        }
+
+        /* provenance queries require all relations to be retained after the evaluation */
+        if (Global::config().has("stream-output") && Global::config().has("provenance")) {
+            ERROR("option -S/--stream-output cannot be combined with provenance");
+        }
+
+        /* provenance relations are not maintained by updates */
+        if (Global::config().has("incremental") && Global::config().has("provenance")) {
+            ERROR("option -u/--incremental cannot be combined with provenance");
+        }
+
+        /* hardware performance counters are part of the profile */
+        if (Global::config().has("profile-counters") && !Global::config().has("profile")) {
+            ERROR("option -P/--profile-counters requires option -p/--profile");
+        }
+
+        /* the statistics of lookups are part of the profile */
+        if (Global::config().has("profile-indices") && !Global::config().has("profile")) {
+            ERROR("option -i/--profile-indices requires option -p/--profile");
+        }
+
         /* turn on compilation if auto-scheduling is enabled */
         if (Global::config().has("auto-schedule") && !Global::config().has("compile")) {
             Global::config().set("compile");
@@ -189,6 +238,12 @@ int main(int argc, char** argv) {
             ERROR("no executable is specified for auto-scheduling (option -o <FILE>)");
         }
 
+        /* only compiled programs can be run again, the interpreter evaluates a program once */
+        if (Global::config().has("incremental") && !Global::config().has("compile") &&
+                !Global::config().has("generate")) {
+            ERROR("option -u/--incremental requires compilation (option -c, -o or -g)");
+        }
+
         /* collect all input directories for the c pre-processor */
         if (Global::config().has("include-dir")) {
             std::string currentInclude = "";
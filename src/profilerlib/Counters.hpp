@@ -0,0 +1,38 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/*
+ * Hardware performance counters of a rule, iteration or relation, summed over all threads
+ */
+class Counters {
+public:
+    long cycles = 0;
+    long instructions = 0;
+    long cache_misses = 0;
+    long branch_misses = 0;
+
+    Counters() = default;
+
+    // parse the four counters starting at the given position of a log line
+    Counters(const std::vector<std::string>& data, size_t pos)
+            : cycles(std::stol(data[pos])), instructions(std::stol(data[pos + 1])),
+              cache_misses(std::stol(data[pos + 2])), branch_misses(std::stol(data[pos + 3])) {}
+
+    inline Counters& operator+=(const Counters& other) {
+        cycles += other.cycles;
+        instructions += other.instructions;
+        cache_misses += other.cache_misses;
+        branch_misses += other.branch_misses;
+        return *this;
+    }
+};
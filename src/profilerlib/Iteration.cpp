@@ -10,7 +10,7 @@
 
 #include <iostream>
 
-void Iteration::addRule(std::vector<std::string> data, std::string rec_id) {
+void Iteration::addRule(const std::vector<std::string>& data, const std::string& rec_id) {
     std::string strTemp = data[4] + data[3] + data[2];
 
     if (data[0].at(0) == 't') {
@@ -33,6 +33,10 @@ void Iteration::addRule(std::vector<std::string> data, std::string rec_id) {
         rul_rec->setNum_tuples(std::stol(data[5]) - prev_num_tuples);
         this->prev_num_tuples = std::stol(data[5]);
         rul_rec_map[strTemp] = rul_rec;
+    } else if (data[0].at(0) == 'h') {
+        auto got = rul_rec_map.find(strTemp);
+        assert(got != rul_rec_map.end() && "missing t tag");
+        got->second->addCounters(Counters(data, 5));
     }
 }
 
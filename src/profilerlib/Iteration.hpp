@@ -26,18 +26,24 @@ private:
     double copy_time = 0;
     std::string locator = "";
     long prev_num_tuples = 0;
+    Counters counters;
 
     std::unordered_map<std::string, std::shared_ptr<Rule>> rul_rec_map;
 
 public:
     Iteration() : rul_rec_map() {}
 
-    void addRule(std::vector<std::string> data, std::string rec_id);
+    void addRule(const std::vector<std::string>& data, const std::string& rec_id);
 
-    inline std::unordered_map<std::string, std::shared_ptr<Rule>> getRul_rec() {
+    inline const std::unordered_map<std::string, std::shared_ptr<Rule>>& getRul_rec() {
         return this->rul_rec_map;
     }
 
+    // the rules are keyed by their name, locator and version
+    inline void setRule(const std::string& key, std::shared_ptr<Rule> rule) {
+        rul_rec_map[key] = rule;
+    }
+
     std::string toString();
 
     inline double getRuntime() {
@@ -56,6 +62,14 @@ public:
         this->num_tuples = num_tuples;
     }
 
+    inline const Counters& getCounters() {
+        return counters;
+    }
+
+    inline void setCounters(const Counters& counters) {
+        this->counters = counters;
+    }
+
     inline double getCopy_time() {
         return copy_time;
     }
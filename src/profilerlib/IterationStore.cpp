@@ -0,0 +1,40 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+#include "IterationStore.hpp"
+
+#include <stdexcept>
+
+uint64_t IterationStore::append(const std::string& record) {
+    std::lock_guard<std::mutex> guard(lock);
+    uint64_t offset = size;
+    if (file != nullptr) {
+        // switching between reading and writing requires a seek
+        fseeko(file, offset, SEEK_SET);
+        if (std::fwrite(record.data(), 1, record.size(), file) != record.size()) {
+            throw std::runtime_error("cannot write iterations to temporary file");
+        }
+    } else {
+        buffer.append(record);
+    }
+    size += record.size();
+    return offset;
+}
+
+std::string IterationStore::read(uint64_t offset, size_t length) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (file == nullptr) {
+        return buffer.substr(offset, length);
+    }
+    std::string res(length, '\0');
+    fseeko(file, offset, SEEK_SET);
+    if (std::fread(&res[0], 1, length, file) != length) {
+        throw std::runtime_error("cannot read iterations from temporary file");
+    }
+    return res;
+}
@@ -0,0 +1,52 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+/*
+ * On-disk storage of the completed iterations of recursive relations, such that the iterations
+ * of huge profile logs are not kept in memory. Iterations are appended as compact binary records
+ * while the log is read and are paged in by their offsets when a relation is displayed.
+ *
+ * The records are kept in an anonymous temporary file, or in memory if none can be created.
+ */
+class IterationStore {
+private:
+    std::FILE* file;
+
+    // the records if no temporary file is available
+    std::string buffer;
+
+    uint64_t size = 0;
+
+    // the reader appends records while the user interface reads them
+    std::mutex lock;
+
+public:
+    IterationStore() : file(std::tmpfile()) {}
+
+    IterationStore(const IterationStore&) = delete;
+    IterationStore& operator=(const IterationStore&) = delete;
+
+    ~IterationStore() {
+        if (file != nullptr) {
+            std::fclose(file);
+        }
+    }
+
+    /** Appends a record, returning its offset */
+    uint64_t append(const std::string& record);
+
+    /** Reads the given number of bytes of the record at the given offset */
+    std::string read(uint64_t offset, size_t length);
+};
@@ -0,0 +1,42 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+#pragma once
+
+#include <map>
+
+/*
+ * Memory used by a relation, an index or a table, sampled at the end of each stratum
+ */
+class Memory {
+public:
+    // the bytes used by stratum, in the order of evaluation
+    std::map<int, long> samples;
+
+    inline void add(int stratum, long bytes) {
+        samples[stratum] = bytes;
+    }
+
+    inline bool empty() const {
+        return samples.empty();
+    }
+
+    // the largest sample
+    long getPeak() const {
+        long peak = 0;
+        for (const auto& cur : samples) {
+            peak = (cur.second > peak) ? cur.second : peak;
+        }
+        return peak;
+    }
+
+    // the sample of the last stratum, at which the relation was still present
+    long getLast() const {
+        return samples.empty() ? 0 : samples.rbegin()->second;
+    }
+};
@@ -19,6 +19,10 @@
  * ROW[6] = ID
  * ROW[7] = SRC
  * ROW[8] = PERFOR
+ * ROW[9] = CYCLES
+ * ROW[10]= INSTR
+ * ROW[11]= LLC_MISS
+ * ROW[12]= BR_MISS
  *
  */
 Table OutputProcessor::getRelTable() {
@@ -26,7 +30,7 @@ Table OutputProcessor::getRelTable() {
     Table table;
     for (auto& rel : relation_map) {
         std::shared_ptr<Relation> r = rel.second;
-        Row row(9);
+        Row row(13);
         double total_time = r->getNonRecTime() + r->getRecTime() + r->getCopyTime();
         row[0] = std::shared_ptr<CellInterface>(new Cell<double>(total_time));
         row[1] = std::shared_ptr<CellInterface>(new Cell<double>(r->getNonRecTime()));
@@ -41,6 +45,7 @@ Table OutputProcessor::getRelTable() {
         } else {
             row[8] = std::shared_ptr<CellInterface>(new Cell<double>(r->getNum_tuplesRel() / 1.0));
         }
+        setCounters(row, 9, r->getCounters());
 
         table.addRow(std::make_shared<Row>(row));
     }
@@ -59,17 +64,22 @@ Table OutputProcessor::getRelTable() {
  * ROW[8] = PERFOR
  * ROW[9] = VER
  * ROW[10]= REL_NAME
+ * ROW[11]= CYCLES
+ * ROW[12]= INSTR
+ * ROW[13]= LLC_MISS
+ * ROW[14]= BR_MISS
  */
 Table OutputProcessor::getRulTable() {
     std::unordered_map<std::string, std::shared_ptr<Relation>>& relation_map = programRun->getRelation_map();
     std::unordered_map<std::string, std::shared_ptr<Row>> rule_map;
+    std::unordered_map<std::string, Counters> counter_map;
 
     double tot_rec_tup = programRun->getTotNumRecTuples();
     double tot_copy_time = programRun->getTotCopyTime();
 
     for (auto& rel : relation_map) {
         for (auto& _rul : rel.second->getRuleMap()) {
-            Row row(11);
+            Row row(15);
             std::shared_ptr<Rule> rul = _rul.second;
             row[1] = std::shared_ptr<CellInterface>(new Cell<double>(rul->getRuntime()));
             row[2] = std::shared_ptr<CellInterface>(new Cell<double>(0.0));
@@ -82,32 +92,32 @@ Table OutputProcessor::getRulTable() {
             row[10] = std::shared_ptr<CellInterface>(new Cell<std::string>(rul->getLocator()));
 
             rule_map.emplace(rul->getName(), std::make_shared<Row>(row));
+            counter_map[rul->getName()] += rul->getCounters();
         }
-        for (auto& iter : rel.second->getIterations()) {
-            for (auto& _rul : iter->getRul_rec()) {
-                std::shared_ptr<Rule> rul = _rul.second;
-                if (rule_map.find(rul->getName()) != rule_map.end()) {
-                    std::shared_ptr<Row> _row = rule_map[rul->getName()];
-                    Row row = *_row;
-                    row[2] = std::shared_ptr<CellInterface>(
-                            new Cell<double>(row[2]->getDoubVal() + rul->getRuntime()));
-                    row[4] = std::shared_ptr<CellInterface>(
-                            new Cell<long>(row[4]->getLongVal() + rul->getNum_tuples()));
-                    row[0] = std::shared_ptr<CellInterface>(new Cell<double>(rul->getRuntime()));
-                    rule_map[rul->getName()] = std::make_shared<Row>(row);
-                } else {
-                    Row row(11);
-                    row[1] = std::shared_ptr<CellInterface>(new Cell<double>(0.0));
-                    row[2] = std::shared_ptr<CellInterface>(new Cell<double>(rul->getRuntime()));
-                    row[3] = std::shared_ptr<CellInterface>(new Cell<double>(0.0));
-                    row[4] = std::shared_ptr<CellInterface>(new Cell<long>(rul->getNum_tuples()));
-                    row[5] = std::shared_ptr<CellInterface>(new Cell<std::string>(rul->getName()));
-                    row[6] = std::shared_ptr<CellInterface>(new Cell<std::string>(rul->getId()));
-                    row[7] = std::shared_ptr<CellInterface>(new Cell<std::string>(rel.second->getName()));
-                    row[8] = std::shared_ptr<CellInterface>(new Cell<long>(rul->getVersion()));
-                    row[0] = std::shared_ptr<CellInterface>(new Cell<double>(rul->getRuntime()));
-                    rule_map[rul->getName()] = std::make_shared<Row>(row);
-                }
+        // the recursive rules are summed over all iterations by version
+        for (auto& rul : rel.second->getRuleRecList()) {
+            counter_map[rul->getName()] += rul->getCounters();
+            if (rule_map.find(rul->getName()) != rule_map.end()) {
+                std::shared_ptr<Row> _row = rule_map[rul->getName()];
+                Row row = *_row;
+                row[2] = std::shared_ptr<CellInterface>(
+                        new Cell<double>(row[2]->getDoubVal() + rul->getRuntime()));
+                row[4] = std::shared_ptr<CellInterface>(
+                        new Cell<long>(row[4]->getLongVal() + rul->getNum_tuples()));
+                row[0] = std::shared_ptr<CellInterface>(new Cell<double>(rul->getRuntime()));
+                rule_map[rul->getName()] = std::make_shared<Row>(row);
+            } else {
+                Row row(15);
+                row[1] = std::shared_ptr<CellInterface>(new Cell<double>(0.0));
+                row[2] = std::shared_ptr<CellInterface>(new Cell<double>(rul->getRuntime()));
+                row[3] = std::shared_ptr<CellInterface>(new Cell<double>(0.0));
+                row[4] = std::shared_ptr<CellInterface>(new Cell<long>(rul->getNum_tuples()));
+                row[5] = std::shared_ptr<CellInterface>(new Cell<std::string>(rul->getName()));
+                row[6] = std::shared_ptr<CellInterface>(new Cell<std::string>(rul->getId()));
+                row[7] = std::shared_ptr<CellInterface>(new Cell<std::string>(rel.second->getName()));
+                row[8] = std::shared_ptr<CellInterface>(new Cell<long>(rul->getVersion()));
+                row[0] = std::shared_ptr<CellInterface>(new Cell<double>(rul->getRuntime()));
+                rule_map[rul->getName()] = std::make_shared<Row>(row);
             }
         }
         for (auto& _row : rule_map) {
@@ -128,6 +138,7 @@ Table OutputProcessor::getRulTable() {
             } else {
                 t[9] = std::shared_ptr<CellInterface>(new Cell<double>(t[4]->getLongVal() / 1.0));
             }
+            setCounters(t, 11, counter_map[_row.first]);
             _row.second = std::make_shared<Row>(t);
         }
     }
@@ -139,6 +150,13 @@ Table OutputProcessor::getRulTable() {
     return table;
 }
 
+void OutputProcessor::setCounters(Row& row, size_t pos, const Counters& counters) {
+    row[pos] = std::shared_ptr<CellInterface>(new Cell<long>(counters.cycles));
+    row[pos + 1] = std::shared_ptr<CellInterface>(new Cell<long>(counters.instructions));
+    row[pos + 2] = std::shared_ptr<CellInterface>(new Cell<long>(counters.cache_misses));
+    row[pos + 3] = std::shared_ptr<CellInterface>(new Cell<long>(counters.branch_misses));
+}
+
 /*
  * ver table :
  * ROW[0] = TOT_T
@@ -163,35 +181,33 @@ Table OutputProcessor::getVersions(std::string strRel, std::string strRul) {
     for (auto& _rel : relation_map) {
         std::shared_ptr<Relation> rel = _rel.second;
         if (rel->getId().compare(strRel) == 0) {
-            for (auto& iter : rel->getIterations()) {
-                for (auto& _rul : iter->getRul_rec()) {
-                    std::shared_ptr<Rule> rul = _rul.second;
-                    if (rul->getId().compare(strRul) == 0) {
-                        std::string strTemp =
-                                rul->getName() + rul->getLocator() + std::to_string(rul->getVersion());
+            // the recursive rules are summed over all iterations by version
+            for (auto& rul : rel->getRuleRecList()) {
+                if (rul->getId().compare(strRul) == 0) {
+                    std::string strTemp =
+                            rul->getName() + rul->getLocator() + std::to_string(rul->getVersion());
 
-                        if (rule_map.find(strTemp) != rule_map.end()) {
-                            std::shared_ptr<Row> _row = rule_map[strTemp];
-                            Row row = *_row;
-                            row[2] = std::shared_ptr<CellInterface>(
-                                    new Cell<double>(row[2]->getDoubVal() + rul->getRuntime()));
-                            row[4] = std::shared_ptr<CellInterface>(
-                                    new Cell<long>(row[4]->getLongVal() + rul->getNum_tuples()));
-                            row[0] = std::shared_ptr<CellInterface>(new Cell<double>(rul->getRuntime()));
-                            rule_map[strTemp] = std::make_shared<Row>(row);
-                        } else {
-                            Row row(10);
-                            row[1] = std::shared_ptr<CellInterface>(new Cell<double>(0.0));
-                            row[2] = std::shared_ptr<CellInterface>(new Cell<double>(rul->getRuntime()));
-                            row[4] = std::shared_ptr<CellInterface>(new Cell<long>(rul->getNum_tuples()));
-                            row[5] = std::shared_ptr<CellInterface>(new Cell<std::string>(rul->getName()));
-                            row[6] = std::shared_ptr<CellInterface>(new Cell<std::string>(rul->getId()));
-                            row[7] = std::shared_ptr<CellInterface>(new Cell<std::string>(rel->getName()));
-                            row[8] = std::shared_ptr<CellInterface>(new Cell<long>(rul->getVersion()));
-                            row[9] = std::shared_ptr<CellInterface>(new Cell<std::string>(rul->getLocator()));
-                            row[0] = std::shared_ptr<CellInterface>(new Cell<double>(rul->getRuntime()));
-                            rule_map[strTemp] = std::make_shared<Row>(row);
-                        }
+                    if (rule_map.find(strTemp) != rule_map.end()) {
+                        std::shared_ptr<Row> _row = rule_map[strTemp];
+                        Row row = *_row;
+                        row[2] = std::shared_ptr<CellInterface>(
+                                new Cell<double>(row[2]->getDoubVal() + rul->getRuntime()));
+                        row[4] = std::shared_ptr<CellInterface>(
+                                new Cell<long>(row[4]->getLongVal() + rul->getNum_tuples()));
+                        row[0] = std::shared_ptr<CellInterface>(new Cell<double>(rul->getRuntime()));
+                        rule_map[strTemp] = std::make_shared<Row>(row);
+                    } else {
+                        Row row(10);
+                        row[1] = std::shared_ptr<CellInterface>(new Cell<double>(0.0));
+                        row[2] = std::shared_ptr<CellInterface>(new Cell<double>(rul->getRuntime()));
+                        row[4] = std::shared_ptr<CellInterface>(new Cell<long>(rul->getNum_tuples()));
+                        row[5] = std::shared_ptr<CellInterface>(new Cell<std::string>(rul->getName()));
+                        row[6] = std::shared_ptr<CellInterface>(new Cell<std::string>(rul->getId()));
+                        row[7] = std::shared_ptr<CellInterface>(new Cell<std::string>(rel->getName()));
+                        row[8] = std::shared_ptr<CellInterface>(new Cell<long>(rul->getVersion()));
+                        row[9] = std::shared_ptr<CellInterface>(new Cell<std::string>(rul->getLocator()));
+                        row[0] = std::shared_ptr<CellInterface>(new Cell<double>(rul->getRuntime()));
+                        rule_map[strTemp] = std::make_shared<Row>(row);
                     }
                 }
             }
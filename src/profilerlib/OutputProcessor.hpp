@@ -40,6 +40,9 @@ public:
 
     Table getVersions(std::string strRel, std::string strRul);
 
+    // set the four cells of the hardware performance counters starting at the given position
+    void setCounters(Row& row, size_t pos, const Counters& counters);
+
     std::string formatTime(double number) {
         return Tools::formatTime(number);
     }
@@ -8,9 +8,13 @@
 
 #pragma once
 
+#include "../IndexStats.h"
+#include "../LockStats.h"
+#include "Memory.hpp"
 #include "Relation.hpp"
 #include "StringUtils.hpp"
 
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -23,8 +27,26 @@ class ProgramRun {
 private:
     std::unordered_map<std::string, std::shared_ptr<Relation>> relation_map;
     double runtime;
+    // the time of loading the inputs and of writing the outputs, if recorded
+    double loadtime = -1.0;
+    double savetime = -1.0;
     double tot_rec_tup = 0.0;
     double tot_copy_time = 0.0;
+    bool has_counters = false;
+
+    // the memory of relations and their indices by name, and of the record and symbol tables
+    std::map<std::string, Memory> relation_memory;
+    std::map<std::string, std::map<std::string, Memory>> index_memory;
+    Memory record_memory;
+    Memory symbol_memory;
+    // the peak resident set size of the process
+    Memory peak_memory;
+
+    // the lookups of relations by name and bound columns, if recorded
+    std::map<std::string, std::map<std::string, souffle::IndexStats>> lookups;
+
+    // the use of the locks by site, if recorded
+    std::map<std::string, souffle::LockCounts> locks;
 
 public:
     ProgramRun() : relation_map(), runtime(-1.0) {}
@@ -33,10 +55,73 @@ public:
         this->runtime = runtime;
     }
 
+    inline void setLoadtime(double loadtime) {
+        this->loadtime = loadtime;
+    }
+
+    inline void setSavetime(double savetime) {
+        this->savetime = savetime;
+    }
+
+    inline bool hasPhases() const {
+        return loadtime != -1.0 && savetime != -1.0;
+    }
+
     inline void setRelation_map(std::unordered_map<std::string, std::shared_ptr<Relation>>& relation_map) {
         this->relation_map = relation_map;
     }
 
+    inline bool hasCounters() {
+        return has_counters;
+    }
+
+    inline void setHasCounters(bool has_counters) {
+        this->has_counters = has_counters;
+    }
+
+    // memory is only present in profiles of programs evaluated since it has been recorded
+    inline bool hasMemory() {
+        return !peak_memory.empty();
+    }
+
+    inline std::map<std::string, Memory>& getRelationMemory() {
+        return relation_memory;
+    }
+
+    inline std::map<std::string, std::map<std::string, Memory>>& getIndexMemory() {
+        return index_memory;
+    }
+
+    inline Memory& getRecordMemory() {
+        return record_memory;
+    }
+
+    inline Memory& getSymbolMemory() {
+        return symbol_memory;
+    }
+
+    inline Memory& getPeakMemory() {
+        return peak_memory;
+    }
+
+    // lookups are only present if recorded when profiling
+    inline bool hasLookups() {
+        return !lookups.empty();
+    }
+
+    inline std::map<std::string, std::map<std::string, souffle::IndexStats>>& getLookups() {
+        return lookups;
+    }
+
+    // locks are only present if souffle has been configured with --enable-lock-stats
+    inline bool hasLocks() {
+        return !locks.empty();
+    }
+
+    inline std::map<std::string, souffle::LockCounts>& getLocks() {
+        return locks;
+    }
+
     inline void update() {
         tot_rec_tup = (double)getTotNumRecTuples();
         tot_copy_time = getTotCopyTime();
@@ -59,6 +144,23 @@ public:
         return runtime;
     }
 
+    // the time of loading the inputs or of writing the outputs, -1 if not recorded
+    double getDoubleLoadtime() {
+        return loadtime;
+    }
+
+    double getDoubleSavetime() {
+        return savetime;
+    }
+
+    std::string getLoadtime() {
+        return formatTime(loadtime);
+    }
+
+    std::string getSavetime() {
+        return formatTime(savetime);
+    }
+
     long getTotNumTuples();
 
     long getTotNumRecTuples();
@@ -7,8 +7,23 @@
  */
 
 #include "Reader.hpp"
+#include "../ProfileEvent.h"
 
 void Reader::readFile() {
+    // binary logs of compiled programs are converted to the lines of textual logs
+    auto consume = [this](const std::string& str) {
+        if (!str.empty() && str.at(0) == '@') {
+            process(Tools::splitAtSemiColon(str.substr(1)));
+        }
+    };
+    if (file.is_open() && souffle::readProfileEvents(file, consume)) {
+        file.close();
+        loaded = true;
+        return;
+    }
+    file.clear();
+    file.seekg(0);
+
     if (isLive()) {
         livereadinit();
         // std::thread([this]{liveread();}).detach();
@@ -100,13 +115,30 @@ void Reader::save(std::string f_name) {
 void Reader::process(const std::vector<std::string>& data) {
     if (data[0].compare("runtime") == 0) {
         runtime = std::stod(data[1]);
+    } else if (data[0].compare("loadtime") == 0) {
+        run->setLoadtime(std::stod(data[1]));
+    } else if (data[0].compare("savetime") == 0) {
+        run->setSavetime(std::stod(data[1]));
+    } else if (data[0].at(0) == 'm') {
+        // memory is sampled after each stratum, also for relations without rules
+        addMemory(data);
+    } else if (data[0].compare("i-lookup") == 0) {
+        addLookups(data);
+    } else if (data[0].compare("l-lock") == 0) {
+        addLocks(data);
     } else {
-        // insert into the map if it does not exist already
-        if (relation_map.find(data[1]) == relation_map.end()) {
-            relation_map.emplace(data[1], std::make_shared<Relation>(Relation(data[1], createId())));
+        // insert into the map if it does not exist already, the run shares the relations
+        auto pos = relation_map.find(data[1]);
+        if (pos == relation_map.end()) {
+            pos = relation_map.emplace(data[1], std::make_shared<Relation>(data[1], createId(), store)).first;
+            run->setRelation_map(this->relation_map);
         }
 
-        std::shared_ptr<Relation> _rel = relation_map[data[1]];
+        std::shared_ptr<Relation> _rel = pos->second;
+        // hardware performance counters are only present if enabled when profiling
+        if (data[0].at(0) == 'h') {
+            run->setHasCounters(true);
+        }
         // find non-recursive first, since they both share text recursive
         if (data[0].find("nonrecursive") != std::string::npos) {
             if (data[0].at(0) == 't' && data[0].find("relation") != std::string::npos) {
@@ -114,6 +146,8 @@ void Reader::process(const std::vector<std::string>& data) {
                 _rel->setLocator(data[2]);
             } else if (data[0].at(0) == 'n' && data[0].find("relation") != std::string::npos) {
                 _rel->setNum_tuples(std::stol(data[3]));
+            } else if (data[0].at(0) == 'h' && data[0].find("relation") != std::string::npos) {
+                _rel->setCounters(Counters(data, 3));
             } else if (data[0].find("rule") != std::string::npos) {
                 addRule(_rel, data);
             }
@@ -123,21 +157,11 @@ void Reader::process(const std::vector<std::string>& data) {
     }
 
     run->SetRuntime(this->runtime);
-    run->setRelation_map(this->relation_map);
 }
 
-void Reader::addIteration(std::shared_ptr<Relation> rel, std::vector<std::string> data) {
-    bool ready = rel->isReady();
-    std::vector<std::shared_ptr<Iteration>>& iterations = rel->getIterations();
-    std::string locator = rel->getLocator();
-
+void Reader::addIteration(std::shared_ptr<Relation> rel, const std::vector<std::string>& data) {
     // add an iteration if we require one
-    if (ready || iterations.empty()) {
-        iterations.push_back(std::make_shared<Iteration>(Iteration()));
-        rel->setReady(false);
-    }
-
-    std::shared_ptr<Iteration>& iter = iterations.back();
+    std::shared_ptr<Iteration> iter = rel->getCurrentIteration();
 
     if (data[0].find("rule") != std::string::npos) {
         std::string temp = rel->createRecID(data[4]);
@@ -148,13 +172,16 @@ void Reader::addIteration(std::shared_ptr<Relation> rel, std::vector<std::string
         rel->setLocator(data[2]);
     } else if (data[0].at(0) == 'n' && data[0].find("relation") != std::string::npos) {
         iter->setNum_tuples(std::stol(data[3]));
+    } else if (data[0].at(0) == 'h' && data[0].find("relation") != std::string::npos) {
+        iter->setCounters(Counters(data, 3));
     } else if (data[0].at(0) == 'c' && data[0].find("relation") != std::string::npos) {
+        // the copy time completes an iteration, which is paged out to the store
         iter->setCopy_time(std::stod(data[3]));
-        rel->setReady(true);
+        rel->completeIteration();
     }
 }
 
-void Reader::addRule(std::shared_ptr<Relation> rel, std::vector<std::string> data) {
+void Reader::addRule(std::shared_ptr<Relation> rel, const std::vector<std::string>& data) {
     std::unordered_map<std::string, std::shared_ptr<Rule>>& ruleMap = rel->getRuleMap();
 
     long prev_num_tuples = rel->getPrev_num_tuples();
@@ -171,9 +198,43 @@ void Reader::addRule(std::shared_ptr<Relation> rel, std::vector<std::string> dat
         assert(_rul != nullptr);
         _rul->setNum_tuples(std::stol(data[4]) - prev_num_tuples);
         rel->setPrev_num_tuples(std::stol(data[4]));
+    } else if (data[0].at(0) == 'h') {
+        _rul->addCounters(Counters(data, 4));
+    }
+}
+
+void Reader::addMemory(const std::vector<std::string>& data) {
+    if (data[0].compare("m-relation") == 0) {
+        run->getRelationMemory()[data[1]].add(std::stoi(data[2]), std::stol(data[3]));
+    } else if (data[0].compare("m-index") == 0) {
+        run->getIndexMemory()[data[1]][data[3]].add(std::stoi(data[2]), std::stol(data[4]));
+    } else if (data[0].compare("m-records") == 0) {
+        run->getRecordMemory().add(std::stoi(data[1]), std::stol(data[2]));
+    } else if (data[0].compare("m-symbols") == 0) {
+        run->getSymbolMemory().add(std::stoi(data[1]), std::stol(data[2]));
+    } else if (data[0].compare("m-peak") == 0) {
+        run->getPeakMemory().add(std::stoi(data[1]), std::stol(data[2]));
     }
 }
 
+void Reader::addLookups(const std::vector<std::string>& data) {
+    souffle::IndexStats stats;
+    stats.probes = std::stoull(data[3]);
+    stats.hits = std::stoull(data[4]);
+    stats.tuples = std::stoull(data[5]);
+    run->getLookups()[data[1]][data[2]] += stats;
+}
+
+void Reader::addLocks(const std::vector<std::string>& data) {
+    souffle::LockCounts counts;
+    counts.acquisitions = std::stoull(data[2]);
+    counts.reads = std::stoull(data[3]);
+    counts.contentions = std::stoull(data[4]);
+    counts.spins = std::stoull(data[5]);
+    counts.retries = std::stoull(data[6]);
+    run->getLocks()[data[1]] += counts;
+}
+
 std::string Reader::createId() {
     return "R" + std::to_string(++rel_id);
 }
@@ -203,11 +264,10 @@ void Reader::livereadinit() {
             if (line == "@start-debug") continue;
             process(part);
 
-            // @runtime only appears as last line.
+            // @runtime marks a finished run, the time of writing the outputs may still follow it
             std::size_t found = line.find("@runtime;");
             if (found != std::string::npos && found == 0) {
                 finished = true;
-                break;
             }
 
             // save position in case eof reached
@@ -46,6 +46,9 @@ private:
     std::unordered_map<std::string, std::shared_ptr<Relation>> relation_map;
     int rel_id = 0;
 
+    // the iterations of all relations, paged out once complete
+    std::shared_ptr<IterationStore> store = std::make_shared<IterationStore>();
+
 public:
     std::shared_ptr<ProgramRun> run;
 
@@ -68,9 +71,15 @@ public:
         return online;
     }
 
-    void addIteration(std::shared_ptr<Relation> rel, std::vector<std::string> data);
+    void addIteration(std::shared_ptr<Relation> rel, const std::vector<std::string>& data);
+
+    void addRule(std::shared_ptr<Relation> rel, const std::vector<std::string>& data);
+
+    void addMemory(const std::vector<std::string>& data);
+
+    void addLookups(const std::vector<std::string>& data);
 
-    void addRule(std::shared_ptr<Relation> rel, std::vector<std::string> data);
+    void addLocks(const std::vector<std::string>& data);
 
     inline bool isLoaded() {
         return loaded;
@@ -8,49 +8,185 @@
 
 #include "Relation.hpp"
 
+#include <cstring>
+
+namespace {
+
+/*
+ * The records of iterations in the store consist of a header followed by the rules
+ *
+ * header : runtime, tuples, copy time, counters, number of rules
+ * rule   : index of the recursive rule, runtime, tuples, counters
+ */
+const size_t headerSize = 2 * sizeof(double) + 5 * sizeof(long) + sizeof(uint32_t);
+const size_t ruleSize = sizeof(uint32_t) + sizeof(double) + 5 * sizeof(long);
+
+template <typename T>
+void put(std::string& record, const T& value) {
+    record.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void put(std::string& record, const Counters& counters) {
+    put(record, counters.cycles);
+    put(record, counters.instructions);
+    put(record, counters.cache_misses);
+    put(record, counters.branch_misses);
+}
+
+template <typename T>
+T get(const char*& pos) {
+    T value;
+    std::memcpy(&value, pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+}
+
+Counters getCounters(const char*& pos) {
+    Counters counters;
+    counters.cycles = get<long>(pos);
+    counters.instructions = get<long>(pos);
+    counters.cache_misses = get<long>(pos);
+    counters.branch_misses = get<long>(pos);
+    return counters;
+}
+
+// the key of a recursive rule within an iteration
+std::string getKey(const std::shared_ptr<Rule>& rule) {
+    return rule->getName() + rule->getLocator() + std::to_string(rule->getVersion());
+}
+
+// creates an empty copy of a recursive rule, to which the runtime, tuples and counters are added
+std::shared_ptr<Rule> copyRule(const std::shared_ptr<Rule>& rule) {
+    auto res = std::make_shared<Rule>(rule->getName(), rule->getVersion(), rule->getId());
+    res->setLocator(rule->getLocator());
+    return res;
+}
+
+void addRule(const std::shared_ptr<Rule>& target, const std::shared_ptr<Rule>& rule) {
+    target->setRuntime(target->getRuntime() + rule->getRuntime());
+    target->setNum_tuples(target->getNum_tuples() + rule->getNum_tuples());
+    target->addCounters(rule->getCounters());
+}
+
+}  // namespace
+
 std::vector<std::shared_ptr<Rule>> Relation::getRuleRecList() {
-    std::vector<std::shared_ptr<Rule>> temp = std::vector<std::shared_ptr<Rule>>();
-    for (auto& iter : iterations) {
-        for (auto& rul : iter->getRul_rec()) {
-            temp.push_back(rul.second);
+    std::vector<std::shared_ptr<Rule>> temp;
+    for (auto& rul : rec_rules) {
+        temp.push_back(std::make_shared<Rule>(*rul));
+    }
+    if (current) {
+        for (auto& rul : current->getRul_rec()) {
+            auto pos = rec_rule_index.find(rul.first);
+            if (pos != rec_rule_index.end()) {
+                addRule(temp[pos->second], rul.second);
+            } else {
+                temp.push_back(std::make_shared<Rule>(*rul.second));
+            }
         }
     }
     return temp;
 }
 
-std::string Relation::createRecID(std::string name) {
-    for (auto& iter : iterations) {
-        for (auto& rul : iter->getRul_rec()) {
-            if (rul.second->getName().compare(name) == 0) {
-                return rul.second->getId();
-            }
+std::vector<std::shared_ptr<Iteration>> Relation::getIterations() {
+    std::vector<std::shared_ptr<Iteration>> temp;
+    for (uint64_t offset : iterations) {
+        std::string header = store->read(offset, headerSize);
+        const char* pos = header.data();
+        auto iter = std::make_shared<Iteration>();
+        iter->setRuntime(get<double>(pos));
+        iter->setNum_tuples(get<long>(pos));
+        iter->setCopy_time(get<double>(pos));
+        iter->setCounters(::getCounters(pos));
+        iter->setLocator(locator);
+
+        const uint32_t num = get<uint32_t>(pos);
+        std::string rules = store->read(offset + headerSize, num * ruleSize);
+        pos = rules.data();
+        for (uint32_t i = 0; i < num; i++) {
+            std::shared_ptr<Rule> rul = copyRule(rec_rules[get<uint32_t>(pos)]);
+            rul->setRuntime(get<double>(pos));
+            rul->setNum_tuples(get<long>(pos));
+            rul->addCounters(::getCounters(pos));
+            iter->setRule(getKey(rul), rul);
+        }
+        temp.push_back(iter);
+    }
+    if (current) {
+        temp.push_back(current);
+    }
+    return temp;
+}
+
+std::shared_ptr<Iteration> Relation::getCurrentIteration() {
+    if (!current) {
+        current = std::make_shared<Iteration>();
+    }
+    return current;
+}
+
+void Relation::completeIteration() {
+    if (!current) {
+        return;
+    }
+    std::string record;
+    put(record, current->getRuntime());
+    put(record, current->getNum_tuples());
+    put(record, current->getCopy_time());
+    put(record, current->getCounters());
+    put(record, static_cast<uint32_t>(current->getRul_rec().size()));
+    for (auto& rul : current->getRul_rec()) {
+        auto pos = rec_rule_index.find(rul.first);
+        if (pos == rec_rule_index.end()) {
+            pos = rec_rule_index.emplace(rul.first, rec_rules.size()).first;
+            rec_rules.push_back(copyRule(rul.second));
         }
+        addRule(rec_rules[pos->second], rul.second);
+
+        put(record, static_cast<uint32_t>(pos->second));
+        put(record, rul.second->getRuntime());
+        put(record, rul.second->getNum_tuples());
+        put(record, rul.second->getCounters());
     }
-    return "C" + id.substr(1) + "." + std::to_string(++rec_id);
+
+    rec_time += current->getRuntime();
+    copy_time += current->getCopy_time();
+    rec_tuples += current->getNum_tuples();
+    rec_counters += current->getCounters();
+
+    iterations.push_back(store->append(record));
+    current.reset();
 }
 
-double Relation::getRecTime() {
-    double result = 0;
-    for (auto& iter : iterations) {
-        result += iter->getRuntime();
+std::string Relation::createRecID(std::string name) {
+    auto pos = rec_ids.find(name);
+    if (pos != rec_ids.end()) {
+        return pos->second;
     }
-    return result;
+    std::string res = "C" + id.substr(1) + "." + std::to_string(++rec_id);
+    rec_ids[name] = res;
+    return res;
+}
+
+double Relation::getRecTime() {
+    return rec_time + (current ? current->getRuntime() : 0);
 }
 
 double Relation::getCopyTime() {
-    double result = 0;
-    for (auto& iter : iterations) {
-        result += iter->getCopy_time();
+    return copy_time + (current ? current->getCopy_time() : 0);
+}
+
+Counters Relation::getCounters() {
+    Counters result = counters;
+    result += rec_counters;
+    if (current) {
+        result += current->getCounters();
     }
     return result;
 }
 
 long Relation::getNum_tuplesRel() {
-    long result = 0L;
-    for (auto& iter : iterations) {
-        result += iter->getNum_tuples();
-    }
-    return num_tuples + result;
+    return num_tuples + rec_tuples + (current ? current->getNum_tuples() : 0L);
 }
 
 long Relation::getNum_tuplesRul() {
@@ -58,18 +194,16 @@ long Relation::getNum_tuplesRul() {
     for (auto& rul : ruleMap) {
         result += rul.second->getNum_tuples();
     }
-    for (auto& iter : iterations) {
-        for (auto& rul : iter->getRul_rec()) {
-            result += rul.second->getNum_tuples();
-        }
-    }
-    return result;
+    return result + getTotNumRec_tuples();
 }
 
 long Relation::getTotNumRec_tuples() {
     long result = 0L;
-    for (auto& iter : iterations) {
-        for (auto& rul : iter->getRul_rec()) {
+    for (auto& rul : rec_rules) {
+        result += rul->getNum_tuples();
+    }
+    if (current) {
+        for (auto& rul : current->getRul_rec()) {
             result += rul.second->getNum_tuples();
         }
     }
@@ -85,14 +219,14 @@ std::string Relation::toString() {
     // TODO: ensure this is the same as java, as java just prints an array
     output << "\n],\n\"iterations\":\n";
     output << "[";
-    if (iterations.empty()) {
+    if (getNumIterations() == 0) {
         output << ", ";
     }
-    for (auto& iter : iterations) {
+    for (auto& iter : getIterations()) {
         output << iter->toString();
         output << ", ";
     }
     std::string retStr = output.str();
     // substring to remove the last comma
     return retStr.substr(0, retStr.size() - 2) + "]\n}";
-}
\ No newline at end of file
+}
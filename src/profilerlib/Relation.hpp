@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "Iteration.hpp"
+#include "IterationStore.hpp"
 #include "Rule.hpp"
 
 /*
@@ -29,18 +30,33 @@ private:
     std::string locator;
     int rul_id = 0;
     int rec_id = 0;
-
-    std::vector<std::shared_ptr<Iteration>> iterations;
+    Counters counters;
 
     std::unordered_map<std::string, std::shared_ptr<Rule>> ruleMap;
 
-    bool ready = true;
+    // the completed iterations are paged out to the store, keeping their offsets only
+    std::shared_ptr<IterationStore> store;
+    std::vector<uint64_t> iterations;
+
+    // the iteration being read, if any
+    std::shared_ptr<Iteration> current;
+
+    // the sums over the completed iterations
+    double rec_time = 0;
+    double copy_time = 0;
+    long rec_tuples = 0;
+    Counters rec_counters;
+
+    // the recursive rules of the completed iterations by name, locator and version
+    std::vector<std::shared_ptr<Rule>> rec_rules;
+    std::unordered_map<std::string, size_t> rec_rule_index;
+
+    // the identifiers of recursive rules by name, shared by their versions
+    std::unordered_map<std::string, std::string> rec_ids;
 
 public:
-    Relation(std::string name, std::string id) : name(name), id(id) {
-        ruleMap = std::unordered_map<std::string, std::shared_ptr<Rule>>();
-        iterations = std::vector<std::shared_ptr<Iteration>>();
-    }
+    Relation(std::string name, std::string id, std::shared_ptr<IterationStore> store)
+            : name(name), id(id), store(store) {}
 
     std::string createID() {
         return "N" + id.substr(1) + "." + std::to_string(++rul_id);
@@ -66,6 +82,12 @@ public:
 
     long getTotNumRec_tuples();
 
+    Counters getCounters();
+
+    inline void setCounters(const Counters& counters) {
+        this->counters = counters;
+    }
+
     inline void setRuntime(double runtime) {
         this->runtime = runtime;
     }
@@ -87,12 +109,30 @@ public:
         return this->ruleMap;
     }
 
+    /**
+     * @return the recursive rules by name, locator and version, summed over all iterations
+     */
     std::vector<std::shared_ptr<Rule>> getRuleRecList();
 
-    inline std::vector<std::shared_ptr<Iteration>>& getIterations() {
-        return this->iterations;
+    /**
+     * @return the iterations, paged in from the store
+     */
+    std::vector<std::shared_ptr<Iteration>> getIterations();
+
+    inline size_t getNumIterations() {
+        return iterations.size() + (current ? 1 : 0);
     }
 
+    /**
+     * @return the iteration being read, started if there is none
+     */
+    std::shared_ptr<Iteration> getCurrentIteration();
+
+    /**
+     * Completes the iteration being read, adding it to the sums and paging it out to the store
+     */
+    void completeIteration();
+
     inline std::string getId() {
         return id;
     }
@@ -105,14 +145,6 @@ public:
         this->locator = locator;
     }
 
-    inline bool isReady() {
-        return this->ready;
-    }
-
-    inline void setReady(bool ready) {
-        this->ready = ready;
-    }
-
     inline long getPrev_num_tuples() {
         return prev_num_tuples;
     }
@@ -13,6 +13,8 @@
 #include <sstream>
 #include <string>
 
+#include "Counters.hpp"
+
 /*
  * Class to hold information about souffle Rule profile information
  */
@@ -23,6 +25,7 @@ protected:
     long num_tuples = 0;
     std::string identifier;
     std::string locator = "";
+    Counters counters;
 
 private:
     bool recursive = false;
@@ -54,6 +57,14 @@ public:
         this->num_tuples = num_tuples;
     }
 
+    inline const Counters& getCounters() {
+        return counters;
+    }
+
+    inline void addCounters(const Counters& counters) {
+        this->counters += counters;
+    }
+
     inline std::string getName() {
         return name;
     }
@@ -140,6 +140,26 @@ std::string Tools::formatTime(double number) {
     return ".000";
 }
 
+/*
+ * Convert a number of bytes into a shorthand notation
+ * eg. 1572864 -> 1.5M
+ */
+std::string Tools::formatMemory(long bytes) {
+    static const char units[] = {'K', 'M', 'G', 'T'};
+    if (bytes < 1024) {
+        return std::to_string(bytes) + "B";
+    }
+    double size = bytes / 1024.0;
+    size_t unit = 0;
+    while (size >= 1024 && unit + 1 < sizeof(units)) {
+        size /= 1024;
+        unit++;
+    }
+    std::ostringstream result;
+    result << std::fixed << std::setprecision(1) << size << units[unit];
+    return result.str();
+}
+
 // convert a Table object into a 2D vector of strings
 std::vector<std::vector<std::string>> Tools::formatTable(Table table, int precision) {
     std::vector<std::vector<std::string>> result;
@@ -51,6 +51,8 @@ std::string formatNum(int precision, long amount);
 
 std::string formatTime(double number);
 
+std::string formatMemory(long bytes);
+
 std::vector<std::vector<std::string>> formatTable(Table table, int precision);
 
 std::vector<std::string> split(std::string str, std::string split_reg);
@@ -39,6 +39,8 @@ void Tui::runCommand(std::vector<std::string> c) {
 
     if (c[0].compare("top") == 0) {
         top();
+    } else if (c[0].compare("phases") == 0) {
+        phases();
     } else if (c[0].compare("rel") == 0) {
         if (c.size() == 2) {
             relRul(c[1]);
@@ -72,6 +74,18 @@ void Tui::runCommand(std::vector<std::string> c) {
         } else {
             std::cout << "Invalid parameters to graph command.\n";
         }
+    } else if (c[0].compare("memory") == 0) {
+        if (c.size() == 2) {
+            memRel(c[1]);
+        } else if (c.size() == 1) {
+            memory();
+        } else {
+            std::cout << "Invalid parameters to memory command.\n";
+        }
+    } else if (c[0].compare("lookups") == 0) {
+        lookups();
+    } else if (c[0].compare("locks") == 0) {
+        locks();
     } else if (c[0].compare("help") == 0) {
         help();
     } else {
@@ -223,7 +237,8 @@ void Tui::outputJson() {
         for (auto& i : iter) {
             std::fprintf(outfile, "%lu,", i->getNum_tuples());
         }
-        std::fprintf(outfile, "]}],\n");
+        std::fprintf(outfile, "]},[%ld,%ld,%ld,%ld]],\n", row[9]->getLongVal(), row[10]->getLongVal(),
+                row[11]->getLongVal(), row[12]->getLongVal());
     }
     std::fprintf(outfile, "},'rul':{\n");
 
@@ -307,15 +322,75 @@ void Tui::outputJson() {
                 for (auto& row : ver_table.rows) {
                     std::fprintf(outfile, "%ld,", (*row)[4]->getLongVal());
                 }
-                std::fprintf(outfile, "]}],\n");
+                std::fprintf(outfile, "]}");
             } else {
-                std::fprintf(outfile, "}],\n");
+                std::fprintf(outfile, "}");
             }
         } else {
-            std::fprintf(outfile, "],{},{}],\n");
+            std::fprintf(outfile, "],{},{}");
+        }
+        std::fprintf(outfile, ",[%ld,%ld,%ld,%ld]],\n", row[11]->getLongVal(), row[12]->getLongVal(),
+                row[13]->getLongVal(), row[14]->getLongVal());
+    }
+    std::fprintf(outfile, "},'counters':%s,", run->hasCounters() ? "true" : "false");
+
+    // the memory samples are pairs of a stratum and the bytes used after it
+    auto printSamples = [&](const Memory& memory) {
+        std::fprintf(outfile, "[");
+        for (const auto& cur : memory.samples) {
+            std::fprintf(outfile, "[%d,%ld],", cur.first, cur.second);
+        }
+        std::fprintf(outfile, "]");
+    };
+    if (run->hasMemory()) {
+        std::map<std::string, std::string> ids;
+        for (auto& _row : rel_table_state.getRows()) {
+            ids[(*_row)[5]->getStringVal()] = (*_row)[6]->getStringVal();
+        }
+        std::fprintf(outfile, "'memory':{'rel':{\n");
+        for (const auto& cur : run->getRelationMemory()) {
+            const std::string id = (ids.find(cur.first) != ids.end()) ? ids[cur.first] : "-";
+            std::fprintf(outfile, "'%s':['%s',", Tools::cleanJsonOut(cur.first).c_str(), id.c_str());
+            printSamples(cur.second);
+            std::fprintf(outfile, ",{");
+            for (const auto& index : run->getIndexMemory()[cur.first]) {
+                std::fprintf(outfile, "'%s':", index.first.c_str());
+                printSamples(index.second);
+                std::fprintf(outfile, ",");
+            }
+            std::fprintf(outfile, "}],\n");
+        }
+        std::fprintf(outfile, "},'records':");
+        printSamples(run->getRecordMemory());
+        std::fprintf(outfile, ",'symbols':");
+        printSamples(run->getSymbolMemory());
+        std::fprintf(outfile, ",'peak':");
+        printSamples(run->getPeakMemory());
+        std::fprintf(outfile, "},");
+    } else {
+        std::fprintf(outfile, "'memory':false,");
+    }
+
+    // the lookups of each relation are identified by their bound columns
+    if (run->hasLookups()) {
+        std::map<std::string, std::string> ids;
+        for (auto& _row : rel_table_state.getRows()) {
+            ids[(*_row)[5]->getStringVal()] = (*_row)[6]->getStringVal();
         }
+        std::fprintf(outfile, "'lookups':[\n");
+        for (const auto& rel : run->getLookups()) {
+            const std::string id = (ids.find(rel.first) != ids.end()) ? ids[rel.first] : "-";
+            for (const auto& cur : rel.second) {
+                std::fprintf(outfile, "['%s','%s','%s',%llu,%llu,%llu],\n",
+                        Tools::cleanJsonOut(rel.first).c_str(), id.c_str(), cur.first.c_str(),
+                        (unsigned long long)cur.second.probes, (unsigned long long)cur.second.hits,
+                        (unsigned long long)cur.second.tuples);
+            }
+        }
+        std::fprintf(outfile, "],");
+    } else {
+        std::fprintf(outfile, "'lookups':false,");
     }
-    std::fprintf(outfile, "},");
 
     std::string source_file_loc = Tools::split(source_loc, " ").at(0);  // add error check?
     std::ifstream source_file(source_file_loc);
@@ -410,7 +485,11 @@ void Tui::setupTabCompletion() {
     linereader.appendTabCompletion("rul");
     linereader.appendTabCompletion("rul id");
     linereader.appendTabCompletion("graph ");
+    linereader.appendTabCompletion("memory");
+    linereader.appendTabCompletion("lookups");
+    linereader.appendTabCompletion("locks");
     linereader.appendTabCompletion("top");
+    linereader.appendTabCompletion("phases");
     linereader.appendTabCompletion("help");
 
     // add rel tab completes after the rest so users can see all commands first
@@ -419,6 +498,7 @@ void Tui::setupTabCompletion() {
         linereader.appendTabCompletion("graph " + row[5] + " tot_t");
         linereader.appendTabCompletion("graph " + row[5] + " copy_t");
         linereader.appendTabCompletion("graph " + row[5] + " tuples");
+        linereader.appendTabCompletion("memory " + row[5]);
     }
 }
 
@@ -437,7 +517,13 @@ void Tui::help() {
             "graph recursive(C) rule by type(tot_t/tuples).");
     std::printf("  %-30s%-5s %-10s\n", "graph ver <rule id> <type>", "-",
             "graph recursive(C) rule versions by type(tot_t/copy_t/tuples).");
+    std::printf("  %-30s%-5s %-10s\n", "memory", "-", "display memory of relations, records and symbols.");
+    std::printf("  %-30s%-5s %-10s\n", "memory <relation id>", "-",
+            "display memory of a relation and its indices by stratum.");
+    std::printf("  %-30s%-5s %-10s\n", "lookups", "-", "display lookups of relations by bound columns.");
+    std::printf("  %-30s%-5s %-10s\n", "locks", "-", "display contention of locks by site.");
     std::printf("  %-30s%-5s %-10s\n", "top", "-", "display top-level summary of program run.");
+    std::printf("  %-30s%-5s %-10s\n", "phases", "-", "print times of phases and peak memory, unformatted.");
     std::printf("  %-30s%-5s %-10s\n", "help", "-", "print this.");
 
     std::cout << "\nInteractive mode only commands:" << std::endl;
@@ -456,30 +542,55 @@ void Tui::top() {
     if (alive) run->update();
     std::string runtime = run->getRuntime();
     std::cout << "\n Total runtime: " << runtime << "\n";
+    if (run->hasPhases()) {
+        std::cout << " Load time: " << run->getLoadtime() << "\n";
+        std::cout << " Output time: " << run->getSavetime() << "\n";
+    }
 
     std::cout << "\n Total number of new tuples: " << run->formatNum(precision, run->getTotNumTuples())
               << std::endl;
 }
 
+void Tui::phases() {
+    std::shared_ptr<ProgramRun>& run = out.getProgramRun();
+    if (alive) run->update();
+
+    // unformatted, such that scripts can process the summary of a run without reading the log
+    std::printf("runtime %.6f\n", run->getDoubleRuntime());
+    if (run->hasPhases()) {
+        std::printf("loadtime %.6f\n", run->getDoubleLoadtime());
+        std::printf("savetime %.6f\n", run->getDoubleSavetime());
+    }
+    if (run->hasMemory()) {
+        std::printf("peak %ld\n", run->getPeakMemory().getPeak());
+    }
+}
+
 void Tui::rel(std::string c) {
     rel_table_state.sort(sort_col);
     std::cout << " ----- Relation Table -----\n";
-    std::printf("%8s%8s%8s%8s%15s%6s%1s%-25s\n\n", "TOT_T", "NREC_T", "REC_T", "COPY_T", "TUPLES", "ID", "",
-            "NAME");
+    std::printf("%8s%8s%8s%8s%15s", "TOT_T", "NREC_T", "REC_T", "COPY_T", "TUPLES");
+    counterHeader();
+    std::printf("%6s%1s%-25s\n\n", "ID", "", "NAME");
     for (auto& row : out.formatTable(rel_table_state, precision)) {
-        std::printf("%8s%8s%8s%8s%15s%6s%1s%-5s\n", row[0].c_str(), row[1].c_str(), row[2].c_str(),
-                row[3].c_str(), row[4].c_str(), row[6].c_str(), "", row[5].c_str());
+        std::printf("%8s%8s%8s%8s%15s", row[0].c_str(), row[1].c_str(), row[2].c_str(), row[3].c_str(),
+                row[4].c_str());
+        counterCells(row, 9);
+        std::printf("%6s%1s%-5s\n", row[6].c_str(), "", row[5].c_str());
     }
 }
 
 void Tui::rul(std::string c) {
     rul_table_state.sort(sort_col);
     std::cout << "  ----- Rule Table -----\n";
-    std::printf(
-            "%8s%8s%8s%8s%15s    %-5s\n\n", "TOT_T", "NREC_T", "REC_T", "COPY_T", "TUPLES", "ID RELATION");
+    std::printf("%8s%8s%8s%8s%15s", "TOT_T", "NREC_T", "REC_T", "COPY_T", "TUPLES");
+    counterHeader();
+    std::printf("    %-5s\n\n", "ID RELATION");
     for (auto& row : out.formatTable(rul_table_state, precision)) {
-        std::printf("%8s%8s%8s%8s%15s%8s %-25s\n", row[0].c_str(), row[1].c_str(), row[2].c_str(),
-                row[3].c_str(), row[4].c_str(), row[6].c_str(), row[7].c_str());
+        std::printf("%8s%8s%8s%8s%15s", row[0].c_str(), row[1].c_str(), row[2].c_str(), row[3].c_str(),
+                row[4].c_str());
+        counterCells(row, 11);
+        std::printf("%8s %-25s\n", row[6].c_str(), row[7].c_str());
     }
 }
 
@@ -508,14 +619,17 @@ void Tui::relRul(std::string str) {
     std::vector<std::vector<std::string>> rel_table = out.formatTable(rel_table_state, precision);
 
     std::cout << "  ----- Rules of a Relation -----\n";
-    std::printf(
-            "%8s%8s%8s%8s%10s%8s %-25s\n\n", "TOT_T", "NREC_T", "REC_T", "COPY_T", "TUPLES", "ID", "NAME");
+    std::printf("%8s%8s%8s%8s%10s", "TOT_T", "NREC_T", "REC_T", "COPY_T", "TUPLES");
+    counterHeader();
+    std::printf("%8s %-25s\n\n", "ID", "NAME");
     std::string name = "";
     bool found = false;  // workaround to make it the same as java (row[5] seems to have priority)
     for (auto& row : rel_table) {
         if (row[5].compare(str) == 0) {
-            std::printf("%8s%8s%8s%8s%10s%8s %-25s\n", row[0].c_str(), row[1].c_str(), row[2].c_str(),
-                    row[3].c_str(), row[4].c_str(), row[6].c_str(), row[5].c_str());
+            std::printf("%8s%8s%8s%8s%10s", row[0].c_str(), row[1].c_str(), row[2].c_str(), row[3].c_str(),
+                    row[4].c_str());
+            counterCells(row, 9);
+            std::printf("%8s %-25s\n", row[6].c_str(), row[5].c_str());
             name = row[5];
             found = true;
             break;
@@ -524,8 +638,10 @@ void Tui::relRul(std::string str) {
     if (!found) {
         for (auto& row : rel_table) {
             if (row[6].compare(str) == 0) {
-                std::printf("%8s%8s%8s%8s%10s%8s %-25s\n", row[0].c_str(), row[1].c_str(), row[2].c_str(),
-                        row[3].c_str(), row[4].c_str(), row[6].c_str(), row[5].c_str());
+                std::printf("%8s%8s%8s%8s%10s", row[0].c_str(), row[1].c_str(), row[2].c_str(),
+                        row[3].c_str(), row[4].c_str());
+                counterCells(row, 9);
+                std::printf("%8s %-25s\n", row[6].c_str(), row[5].c_str());
                 name = row[5];
                 break;
             }
@@ -534,8 +650,10 @@ void Tui::relRul(std::string str) {
     std::cout << " ---------------------------------------------------------\n";
     for (auto& row : rul_table) {
         if (row[7].compare(name) == 0) {
-            std::printf("%8s%8s%8s%8s%10s%8s %-25s\n", row[0].c_str(), row[1].c_str(), row[2].c_str(),
-                    row[3].c_str(), row[4].c_str(), row[6].c_str(), row[7].c_str());
+            std::printf("%8s%8s%8s%8s%10s", row[0].c_str(), row[1].c_str(), row[2].c_str(), row[3].c_str(),
+                    row[4].c_str());
+            counterCells(row, 11);
+            std::printf("%8s %-25s\n", row[6].c_str(), row[7].c_str());
         }
     }
     std::string src = "";
@@ -755,6 +873,142 @@ void Tui::verGraph(std::string c, std::string col) {
     }
 }
 
+void Tui::memory() {
+    std::shared_ptr<ProgramRun>& run = out.getProgramRun();
+    if (!run->hasMemory()) {
+        std::cout << "No memory usage recorded in this profile.\n";
+        return;
+    }
+
+    // relations without rules, e.g. input relations, have no id
+    std::map<std::string, std::string> ids;
+    for (auto& row : out.formatTable(rel_table_state, precision)) {
+        ids[row[5]] = row[6];
+    }
+    typedef std::pair<std::string, const Memory*> entry;
+    std::vector<entry> relations;
+    for (const auto& cur : run->getRelationMemory()) {
+        relations.push_back(std::make_pair(cur.first, &cur.second));
+    }
+    std::stable_sort(relations.begin(), relations.end(), [](const entry& a, const entry& b) {
+        return a.second->getPeak() > b.second->getPeak();
+    });
+
+    std::cout << " ----- Memory Table -----\n";
+    std::printf("%10s%10s%6s%1s%-25s\n\n", "PEAK", "LAST", "ID", "", "NAME");
+    for (const auto& cur : relations) {
+        const std::string id = (ids.find(cur.first) != ids.end()) ? ids[cur.first] : "-";
+        std::printf("%10s%10s%6s%1s%-5s\n", Tools::formatMemory(cur.second->getPeak()).c_str(),
+                Tools::formatMemory(cur.second->getLast()).c_str(), id.c_str(), "", cur.first.c_str());
+    }
+    std::printf("\n%10s%10s%7s%-25s\n", Tools::formatMemory(run->getRecordMemory().getPeak()).c_str(),
+            Tools::formatMemory(run->getRecordMemory().getLast()).c_str(), "", "records");
+    std::printf("%10s%10s%7s%-25s\n", Tools::formatMemory(run->getSymbolMemory().getPeak()).c_str(),
+            Tools::formatMemory(run->getSymbolMemory().getLast()).c_str(), "", "symbols");
+    std::cout << "\n Peak resident set size: " << Tools::formatMemory(run->getPeakMemory().getPeak()) << "\n";
+}
+
+void Tui::memRel(std::string str) {
+    std::shared_ptr<ProgramRun>& run = out.getProgramRun();
+    std::string id = "-";
+    std::string name = str;
+    for (auto& row : out.formatTable(rel_table_state, precision)) {
+        if (row[5].compare(str) == 0 || row[6].compare(str) == 0) {
+            id = row[6];
+            name = row[5];
+            break;
+        }
+    }
+    auto memory = run->getRelationMemory().find(name);
+    if (memory == run->getRelationMemory().end()) {
+        std::cout << "No memory usage recorded for relation " << str << ".\n";
+        return;
+    }
+
+    std::printf("%4s%2s%-25s\n\n", id.c_str(), "", name.c_str());
+    std::printf("%7s %8s\n\n", "STRATUM", "MEMORY");
+    const long peak = memory->second.getPeak();
+    for (const auto& cur : memory->second.samples) {
+        int len = (peak == 0) ? 0 : (int)(64 * ((double)cur.second / (double)peak));
+        std::printf("%7d %8s | %s\n", cur.first, Tools::formatMemory(cur.second).c_str(),
+                std::string(len, '*').c_str());
+    }
+
+    std::printf("\n%10s%10s%2s%-25s\n\n", "PEAK", "LAST", "", "INDEX");
+    for (const auto& cur : run->getIndexMemory()[name]) {
+        std::printf("%10s%10s%2s%-25s\n", Tools::formatMemory(cur.second.getPeak()).c_str(),
+                Tools::formatMemory(cur.second.getLast()).c_str(), "", cur.first.c_str());
+    }
+}
+
+void Tui::lookups() {
+    std::shared_ptr<ProgramRun>& run = out.getProgramRun();
+    if (!run->hasLookups()) {
+        std::cout << "No lookups recorded in this profile, use souffle -i to record them.\n";
+        return;
+    }
+
+    std::map<std::string, std::string> ids;
+    for (auto& row : out.formatTable(rel_table_state, precision)) {
+        ids[row[5]] = row[6];
+    }
+    typedef std::pair<std::pair<std::string, std::string>, const souffle::IndexStats*> entry;
+    std::vector<entry> patterns;
+    for (const auto& rel : run->getLookups()) {
+        for (const auto& cur : rel.second) {
+            patterns.push_back(std::make_pair(std::make_pair(rel.first, cur.first), &cur.second));
+        }
+    }
+    std::stable_sort(patterns.begin(), patterns.end(),
+            [](const entry& a, const entry& b) { return a.second->probes > b.second->probes; });
+
+    // the hit ratio and the length of the ranges are relative to the probes
+    std::cout << " ----- Lookup Table -----\n";
+    std::printf("%10s%8s%10s%6s%1s%-12s%-25s\n\n", "PROBES", "HIT%", "AVG", "ID", "", "COLUMNS", "NAME");
+    for (const auto& cur : patterns) {
+        const souffle::IndexStats& stats = *cur.second;
+        const double hits = (stats.probes == 0) ? 0 : 100.0 * stats.hits / stats.probes;
+        const double avg = (stats.probes == 0) ? 0 : (double)stats.tuples / stats.probes;
+        const std::string& name = cur.first.first;
+        const std::string id = (ids.find(name) != ids.end()) ? ids[name] : "-";
+        std::printf("%10s%8.1f%10.2f%6s%1s%-12s%-25s\n", Tools::formatNum(precision, stats.probes).c_str(),
+                hits, avg, id.c_str(), "", cur.first.second.c_str(), name.c_str());
+    }
+}
+
+void Tui::locks() {
+    std::shared_ptr<ProgramRun>& run = out.getProgramRun();
+    if (!run->hasLocks()) {
+        std::cout << "No locks recorded in this profile, configure souffle with --enable-lock-stats to "
+                     "record them.\n";
+        return;
+    }
+
+    typedef std::pair<std::string, const souffle::LockCounts*> entry;
+    std::vector<entry> sites;
+    for (const auto& cur : run->getLocks()) {
+        sites.push_back(std::make_pair(cur.first, &cur.second));
+    }
+    std::stable_sort(sites.begin(), sites.end(),
+            [](const entry& a, const entry& b) { return a.second->contentions > b.second->contentions; });
+
+    // the contention is relative to all accesses, the spins to the contended accesses
+    std::cout << " ----- Lock Table -----\n";
+    std::printf("%10s%10s%10s%8s%10s%10s%1s%-25s\n\n", "ACQUIRED", "READS", "CONTENDED", "CONT%", "SPINS",
+            "RETRIES", "", "SITE");
+    for (const auto& cur : sites) {
+        const souffle::LockCounts& counts = *cur.second;
+        const uint64_t accesses = counts.acquisitions + counts.reads;
+        const double contended = (accesses == 0) ? 0 : 100.0 * counts.contentions / accesses;
+        std::printf("%10s%10s%10s%8.2f%10s%10s%1s%-25s\n",
+                Tools::formatNum(precision, counts.acquisitions).c_str(),
+                Tools::formatNum(precision, counts.reads).c_str(),
+                Tools::formatNum(precision, counts.contentions).c_str(), contended,
+                Tools::formatNum(precision, counts.spins).c_str(),
+                Tools::formatNum(precision, counts.retries).c_str(), "", cur.first.c_str());
+    }
+}
+
 void Tui::graphD(std::vector<double> list) {
     double max = 0;
     for (auto& d : list) {
@@ -803,6 +1057,19 @@ void Tui::graphL(std::vector<long> list) {
     }
 }
 
+void Tui::counterHeader() {
+    if (out.getProgramRun()->hasCounters()) {
+        std::printf("%12s%12s%10s%10s", "CYCLES", "INSTR", "LLC_MISS", "BR_MISS");
+    }
+}
+
+void Tui::counterCells(const std::vector<std::string>& row, size_t pos) {
+    if (out.getProgramRun()->hasCounters()) {
+        std::printf("%12s%12s%10s%10s", row[pos].c_str(), row[pos + 1].c_str(), row[pos + 2].c_str(),
+                row[pos + 3].c_str());
+    }
+}
+
 bool Tui::string_sort(std::vector<std::string> a, std::vector<std::string> b) {
     // std::cerr << a->getCells()[0]->getDoubVal() << "\n";
     return a[0] > b[0];
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <iostream>
+#include <map>
 #include <string>
 #include <vector>
 #include <dirent.h>
@@ -64,6 +65,8 @@ public:
 
     void top();
 
+    void phases();
+
     void rel(std::string c);
 
     void rul(std::string c);
@@ -80,9 +83,23 @@ public:
 
     void verGraph(std::string c, std::string col);
 
+    void memory();
+
+    void memRel(std::string str);
+
+    void lookups();
+
+    void locks();
+
     void graphD(std::vector<double> list);
 
     void graphL(std::vector<long> list);
 
+    // print the headers of the hardware performance counters if the profile has any
+    void counterHeader();
+
+    // print the hardware performance counters of a formatted row starting at the given position
+    void counterCells(const std::vector<std::string>& row, size_t pos);
+
     static bool string_sort(std::vector<std::string> a, std::vector<std::string> b);
 };
\ No newline at end of file
@@ -190,6 +190,8 @@ function changeTab(event, change_to) {
 function toggle_precision() {
     precision=!precision;
     flip_table_values(document.getElementById("Rel_table"));
+    flip_table_values(document.getElementById("Mem_table"));
+    flip_table_values(document.getElementById("Lookup_table"));
     flip_table_values(document.getElementById("Rul_table"));
     flip_table_values(document.getElementById("rulesofrel_table"));
     flip_table_values(document.getElementById("rulvertable"));
@@ -208,6 +210,9 @@ function flip_table_values(table) {
             } else if (cell.className === "int_cell") {
                 val = cell.getAttribute('data-sort');
                 cell.innerHTML = minify_numbers(parseInt(val));
+            } else if (cell.className === "memory_cell") {
+                val = cell.getAttribute('data-sort');
+                cell.innerHTML = humanize_memory(parseInt(val));
             }
         }
     }
@@ -238,6 +243,10 @@ function create_cell(type, value, perc_total) {
         cell.innerHTML = minify_numbers(value);
         cell.setAttribute('data-sort', value);
         cell.className = "int_cell";
+    } else if (type === "memory") {
+        cell.innerHTML = humanize_memory(value);
+        cell.setAttribute('data-sort', value);
+        cell.className = "memory_cell";
     } else if (type === "perc") {
         div = document.createElement("div");
         div.className = "perc_time";
@@ -302,6 +311,8 @@ function generate_table(data_format,body_id,data_key) {
                 if (!data_format.hasOwnProperty(i)) continue;
                 if (data_format[i][0] === "perc") {
                     cell = create_cell(data_format[i][0], data[data_key][item][data_format[i][2]], perc_totals[perc_counter++][2]);
+                } else if (data_format[i][0] === "counter") {
+                    cell = create_cell("int", data[data_key][item][data_format[i][1]][data_format[i][2]]);
                 } else {
                     cell = create_cell(data_format[i][0], data[data_key][item][data_format[i][1]]);
                 }
@@ -312,16 +323,23 @@ function generate_table(data_format,body_id,data_key) {
     }
 }
 
+function with_counters(data_format, index) {
+    // the hardware performance counters follow the tuples if they have been recorded
+    if (!data.counters) return data_format;
+    return data_format.slice(0,7).concat([["counter",index,0],["counter",index,1],
+        ["counter",index,2],["counter",index,3]], data_format.slice(7));
+}
+
 function gen_rel_table() {
-    generate_table([["text",0],["id",1],["time",2],["time",3],["time",4],
-        ["time",5],["int",6],["perc","float",2],["perc","int",6],["code_loc",7]],
+    generate_table(with_counters([["text",0],["id",1],["time",2],["time",3],["time",4],
+        ["time",5],["int",6],["perc","float",2],["perc","int",6],["code_loc",7]],10),
         "Rel_table_body",
     "rel");
 }
 
 function gen_rul_table() {
-    generate_table([["text",0],["id",1],["time",2],["time",3],["time",4],
-            ["time",5],["int",6],["perc","float",2],["perc","int",6],["code_loc",7]],
+    generate_table(with_counters([["text",0],["id",1],["time",2],["time",3],["time",4],
+            ["time",5],["int",6],["perc","float",2],["perc","int",6],["code_loc",7]],11),
         "Rul_table_body",
         "rul");
 }
@@ -330,7 +348,9 @@ function gen_rul_table() {
 function genRulesOfRelations() {
     var data_format = [["text",0],["id",1],["time",2],["time",3],["time",4],
             ["time",5],["int",6],["perc","float",2],["perc","int",6],["code_loc",7]];
+    var rel_format = with_counters(data_format,10);
     var rules = data.rel[selected.rel][8];
+    data_format = with_counters(data_format,11);
     var perc_totals = [];
     var row, cell, perc_counter, table_body, i, j;
     table_body = document.getElementById("rulesofrel_body");
@@ -346,12 +366,14 @@ function genRulesOfRelations() {
     }
 
     row = document.createElement("tr");
-    for (i in data_format) {
-        if (!data_format.hasOwnProperty(i)) continue;
-        if (data_format[i][0] === "perc") {
-            cell = create_cell(data_format[i][0], 1, 1);
+    for (i in rel_format) {
+        if (!rel_format.hasOwnProperty(i)) continue;
+        if (rel_format[i][0] === "perc") {
+            cell = create_cell(rel_format[i][0], 1, 1);
+        } else if (rel_format[i][0] === "counter") {
+            cell = create_cell("int", data.rel[selected.rel][rel_format[i][1]][rel_format[i][2]]);
         } else {
-            cell = create_cell(data_format[i][0], data.rel[selected.rel][data_format[i][1]]);
+            cell = create_cell(rel_format[i][0], data.rel[selected.rel][rel_format[i][1]]);
         }
         row.appendChild(cell);
     }
@@ -364,6 +386,8 @@ function genRulesOfRelations() {
             if (!data_format.hasOwnProperty(i)) continue;
             if (data_format[i][0] === "perc") {
                 cell = create_cell(data_format[i][0], data.rul[rules[j]][data_format[i][2]], perc_totals[perc_counter++][2]);
+            } else if (data_format[i][0] === "counter") {
+                cell = create_cell("int", data.rul[rules[j]][data_format[i][1]][data_format[i][2]]);
             } else {
                 cell = create_cell(data_format[i][0], data.rul[rules[j]][data_format[i][1]]);
             }
@@ -426,14 +450,125 @@ function genRulVer() {
 }
 
 function gen_top() {
-    var x, line1, line2;
+    var x, line1, line2, line3;
     x = document.getElementById("Top");
     line1 = document.createElement("p");
     line1.textContent = "Total runtime: " + humanize_time(data.top[0]) + " (" + data.top[0] + " seconds)";
     line2 = document.createElement("p");
     line2.textContent = "Total tuples: " + minify_numbers(data.top[1]) + " (" + data.top[1] + ")";
     x.appendChild(line1);
-    x.appendChild(line2)
+    x.appendChild(line2);
+    if (data.memory) {
+        line3 = document.createElement("p");
+        line3.textContent = "Peak memory: " + humanize_memory(memory_peak(data.memory.peak));
+        x.appendChild(line3);
+    }
+}
+
+function memory_peak(samples) {
+    var i, peak = 0;
+    for (i = 0; i < samples.length; i++) {
+        peak = Math.max(peak, samples[i][1]);
+    }
+    return peak;
+}
+
+function memory_series(samples) {
+    // samples are pairs of a stratum and the bytes used after it; strata without a sample are left out
+    var i, series = [];
+    for (i = 0; i < memory_vals.labels.length; i++) {
+        series.push(null);
+    }
+    for (i = 0; i < samples.length; i++) {
+        series[samples[i][0]] = samples[i][1];
+    }
+    return series;
+}
+
+function gen_memory() {
+    var name, rel, row, table_body, i;
+    for (i = 0; i < data.memory.peak.length; i++) {
+        memory_vals.labels.push(data.memory.peak[i][0].toString());
+    }
+
+    table_body = document.getElementById("Mem_table_body");
+    table_body.innerHTML = "";
+    for (name in data.memory.rel) {
+        if (!data.memory.rel.hasOwnProperty(name)) continue;
+        rel = data.memory.rel[name];
+        row = document.createElement("tr");
+        row.id = "mem_" + name;
+        row.className = "rel_row";
+        row.onclick = function () {
+            changeSelectedMem(this.id.slice(4));
+        };
+        row.appendChild(create_cell("text", name));
+        row.appendChild(create_cell("id", rel[0]));
+        row.appendChild(create_cell("memory", memory_peak(rel[1])));
+        row.appendChild(create_cell("memory", rel[1].length ? rel[1][rel[1].length - 1][1] : 0));
+        table_body.appendChild(row);
+        if (!memory_vals.rel || memory_peak(rel[1]) > memory_peak(data.memory.rel[memory_vals.rel][1])) {
+            memory_vals.rel = name;
+        }
+    }
+}
+
+function gen_lookups() {
+    var i, cur, row, table_body;
+    table_body = document.getElementById("Lookup_table_body");
+    table_body.innerHTML = "";
+    for (i = 0; i < data.lookups.length; i++) {
+        cur = data.lookups[i];
+        row = document.createElement("tr");
+        row.appendChild(create_cell("text", cur[0]));
+        row.appendChild(create_cell("id", cur[1]));
+        row.appendChild(create_cell("text", cur[2]));
+        row.appendChild(create_cell("int", cur[3]));
+        row.appendChild(create_cell("perc", cur[4], cur[3]));
+        row.appendChild(create_cell("id", cur[3] == 0 ? "0" : (cur[5] / cur[3]).toFixed(2)));
+        table_body.appendChild(row);
+    }
+}
+
+function changeSelectedMem(name) {
+    memory_vals.rel = name;
+    drawMemory();
+}
+
+function drawMemory() {
+    var name, rel, series = [], options = {
+        height: "calc((100vh - 167px) / 2)",
+        axisY: {
+            labelInterpolationFnc: function (value) {
+                return humanize_memory(value);
+            }
+        },
+        lineSmooth: false,
+        plugins: [Chartist.plugins.tooltip()]
+    };
+
+    new Chartist.Line(".ct-chart-mem1", {
+        labels: memory_vals.labels,
+        series: [
+            {name: "peak resident set size", data: memory_series(data.memory.peak)},
+            {name: "records", data: memory_series(data.memory.records)},
+            {name: "symbols", data: memory_series(data.memory.symbols)}
+        ]
+    }, options);
+
+    if (!memory_vals.rel) return;
+    rel = data.memory.rel[memory_vals.rel];
+    document.getElementById("mem-rel-title").textContent = "Memory of " + memory_vals.rel + " by stratum";
+    series.push({name: memory_vals.rel, data: memory_series(rel[1])});
+    for (name in rel[2]) {
+        if (rel[2].hasOwnProperty(name)) {
+            series.push({name: "index " + name, data: memory_series(rel[2][name])});
+        }
+    }
+    new Chartist.Line(".ct-chart-mem2", {
+        labels: memory_vals.labels,
+        series: series
+    }, options);
 }
 
 function view_code_snippet(value) {
@@ -485,6 +620,10 @@ function gen_code(highlight_row) {
 var precision = !1;
 var selected = {rel: !1, rul: !1};
 var came_from = !1;
+var memory_vals = {
+    labels:[],
+    rel:!1
+};
 var graph_vals = {
     labels:[],
     tot_t:[],
@@ -494,9 +633,23 @@ var graph_vals = {
 
 
 function init() {
+    var i, headers = document.getElementsByClassName("counter_col");
+    for (i = 0; i < headers.length; i++) {
+        headers[i].style.display = data.counters ? "" : "none";
+    }
     gen_top();
     gen_rel_table();
     gen_rul_table();
+    if (data.memory) {
+        document.getElementById("memory-tab").style.display = "";
+        gen_memory();
+        Tablesort(document.getElementById('Mem_table'),{descending: true});
+    }
+    if (data.lookups) {
+        document.getElementById("lookups-tab").style.display = "";
+        gen_lookups();
+        Tablesort(document.getElementById('Lookup_table'),{descending: true});
+    }
     Tablesort(document.getElementById('Rel_table'),{descending: true});
     Tablesort(document.getElementById('Rul_table'),{descending: true});
     Tablesort(document.getElementById('rulesofrel_table'),{descending: true});
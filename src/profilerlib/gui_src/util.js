@@ -44,6 +44,17 @@ function humanize_time(time) {
     }
 }
 
+function humanize_memory(bytes) {
+    if (precision) return bytes.toString();
+    var units = ["K", "M", "G", "T"], i = -1;
+    if (bytes < 1024) return bytes + "B";
+    do {
+        bytes /= 1024;
+        i++;
+    } while (bytes >= 1024 && i < units.length - 1);
+    return bytes.toFixed(1) + units[i];
+}
+
 function minify_numbers(num) {
     if (precision) return num.toString();
     kilo = (num / 1000);
@@ -108,6 +108,7 @@
 "eqrel"                               { return yy::parser::make_EQREL_QUALIFIER(yylloc); }
 "brie"                                { return yy::parser::make_BRIE_QUALIFIER(yylloc); }
 "btree"                               { return yy::parser::make_BTREE_QUALIFIER(yylloc); }
+"hash"                                { return yy::parser::make_HASH_QUALIFIER(yylloc); }
 "min"                                 { return yy::parser::make_MIN(yylloc); }
 "max"                                 { return yy::parser::make_MAX(yylloc); }
 "nil"                                 { return yy::parser::make_NIL(yylloc); }
@@ -0,0 +1,190 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file bench.h
+ *
+ * Simple microbenchmark infrastructure, in the style of the unit tests
+ *
+ ***********************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* the options of a run of the benchmarks, given on the command line */
+
+struct BenchmarkOptions {
+    unsigned repeat = 5;                                  // the measurements of each case
+    std::vector<size_t> sizes = {10000, 100000, 1000000};  // the numbers of elements of the cases
+    std::vector<int> threads;                             // the numbers of threads of parallel cases
+    std::string filter;                                   // the benchmarks to run contain this string
+};
+
+static BenchmarkOptions benchmarkOptions;
+
+/* singly linked list for linking benchmarks */
+
+static class Benchmark* benchmarks = nullptr;
+
+class Benchmark {
+private:
+    Benchmark* next;    // next benchmark (linked by constructor)
+    std::string group;  // group name of benchmark
+    std::string name;   // name of benchmark
+
+protected:
+    const BenchmarkOptions& options;
+
+public:
+    Benchmark(std::string g, std::string n) : group(g), name(n), options(benchmarkOptions) {
+        next = benchmarks;
+        benchmarks = this;
+    }
+    virtual ~Benchmark() {}
+
+    /**
+     * Measures a case of the benchmark
+     *
+     * Runs prepare and then body the configured number of times, and reports the median and the
+     * minimum time of body, which performs the given number of operations using the given number
+     * of threads, and the resulting throughput. Only body is timed.
+     */
+    void measure(const std::string& label, int threads, size_t operations,
+            const std::function<void()>& prepare, const std::function<void()>& body) {
+#ifdef _OPENMP
+        omp_set_num_threads(threads);
+#endif
+        std::vector<double> times;
+        for (unsigned i = 0; i < std::max(1u, options.repeat); i++) {
+            prepare();
+            auto start = std::chrono::steady_clock::now();
+            body();
+            auto end = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<double>(end - start).count());
+        }
+        std::sort(times.begin(), times.end());
+        double median = (times[(times.size() - 1) / 2] + times[times.size() / 2]) / 2;
+        std::printf("%s/%s\t%s\t%d\t%zu\t%.3f\t%.3f\t%.2f\n", group.c_str(), name.c_str(), label.c_str(),
+                threads, operations, median * 1e3, times.front() * 1e3, operations / median / 1e6);
+        std::fflush(stdout);
+    }
+
+    /**
+     * Measures a case without preparation
+     */
+    void measure(
+            const std::string& label, int threads, size_t operations, const std::function<void()>& body) {
+        measure(label, threads, operations, []() {}, body);
+    }
+
+    /**
+     * Run method
+     */
+    virtual void run() = 0;
+
+    /**
+     * Next benchmark in singly linked list
+     */
+    Benchmark* nextBenchmark() {
+        return next;
+    }
+
+    /**
+     * get full name of benchmark
+     */
+    std::string getName() const {
+        return group + "/" + name;
+    }
+};
+
+#define BENCHMARK(a, b)                                                       \
+    class benchmark_##a##_##b : public Benchmark {                            \
+    public:                                                                   \
+        benchmark_##a##_##b(std::string g, std::string n) : Benchmark(g, n) {} \
+        void run();                                                           \
+    } Benchmark_##a##_##b(#a, #b);                                            \
+    void benchmark_##a##_##b::run()
+
+/**
+ * Parses a comma separated list of numbers
+ */
+template <typename T>
+std::vector<T> parseBenchmarkList(const std::string& list) {
+    std::vector<T> res;
+    std::stringstream in(list);
+    std::string cur;
+    while (std::getline(in, cur, ',')) {
+        res.push_back(std::stoll(cur));
+    }
+    return res;
+}
+
+/**
+ * Main program of a microbenchmark
+ *
+ * usage: <benchmark> [-r repeat] [-n size,...] [-t threads,...] [filter]
+ *
+ * Prints a line for each case, of the benchmark, the case, the threads, the operations, the median
+ * and the minimum time in milliseconds, and the millions of operations per second, separated by tabs.
+ */
+
+int main(int argc, char** argv) {
+    BenchmarkOptions& options = benchmarkOptions;
+#ifdef _OPENMP
+    int cores = omp_get_max_threads();
+#else
+    int cores = 1;
+#endif
+    for (int threads = 1; threads < cores; threads *= 2) {
+        options.threads.push_back(threads);
+    }
+    options.threads.push_back(cores);
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-r" && i + 1 < argc) {
+            options.repeat = std::stoul(argv[++i]);
+        } else if (arg == "-n" && i + 1 < argc) {
+            options.sizes = parseBenchmarkList<size_t>(argv[++i]);
+        } else if (arg == "-t" && i + 1 < argc) {
+            options.threads = parseBenchmarkList<int>(argv[++i]);
+        } else if (arg[0] != '-') {
+            options.filter = arg;
+        } else {
+            std::cerr << "usage: " << argv[0] << " [-r repeat] [-n size,...] [-t threads,...] [filter]\n";
+            return 1;
+        }
+    }
+
+    // benchmarks are run in the order of their definition
+    std::vector<Benchmark*> all;
+    for (Benchmark* p = benchmarks; p != nullptr; p = p->nextBenchmark()) {
+        all.insert(all.begin(), p);
+    }
+
+    std::printf("# benchmark\tcase\tthreads\toperations\tmedian_ms\tmin_ms\tmops\n");
+    for (Benchmark* p : all) {
+        if (p->getName().find(options.filter) != std::string::npos) {
+            p->run();
+        }
+    }
+    return 0;
+}
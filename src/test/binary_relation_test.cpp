@@ -475,6 +475,104 @@ TEST(BinRelTest, IterPartition) {
     EXPECT_EQ(br.size(), values.size());
 }
 
+TEST(BinRelTest, IterClasses) {
+    BinRel br;
+    // classes {0,2,4,6,8}, {1,3,5,7,9} and {11}
+    for (RamDomain i = 0; i < 8; ++i) br.insert(i, i + 2);
+    br.insert(11, 11);
+
+    EXPECT_EQ(3, br.getNumClasses());
+
+    std::vector<std::vector<RamDomain>> classes;
+    for (auto cls : br.getClasses()) {
+        classes.push_back(std::vector<RamDomain>(cls.begin(), cls.end()));
+    }
+    EXPECT_EQ(3, classes.size());
+    EXPECT_EQ(std::vector<RamDomain>({0, 2, 4, 6, 8}), classes[0]);
+    EXPECT_EQ(std::vector<RamDomain>({1, 3, 5, 7, 9}), classes[1]);
+    EXPECT_EQ(std::vector<RamDomain>({11}), classes[2]);
+
+    auto cls = br.getClass(7);
+    EXPECT_EQ(std::vector<RamDomain>({1, 3, 5, 7, 9}), std::vector<RamDomain>(cls.begin(), cls.end()));
+    EXPECT_TRUE(br.getClass(10).empty());
+
+    // all pairs (7, _)
+    ram::Tuple<RamDomain, 2> t;
+    t[0] = 7;
+    t[1] = 0;
+    BinRel::operation_hints h;
+    size_t count = 0;
+    for (auto x : br.getBoundaries<1>(t, h)) {
+        EXPECT_EQ(7, x[0]);
+        EXPECT_EQ(1, x[1] % 2);
+        ++count;
+    }
+    EXPECT_EQ(5, count);
+
+    // exactly (7, 3)
+    t[1] = 3;
+    count = 0;
+    for (auto x : br.getBoundaries<2>(t, h)) {
+        EXPECT_EQ(7, x[0]);
+        EXPECT_EQ(3, x[1]);
+        ++count;
+    }
+    EXPECT_EQ(1, count);
+
+    // (7, 2) is not contained
+    t[1] = 2;
+    EXPECT_TRUE(br.getBoundaries<2>(t, h).empty());
+
+    // iterating from (8, 4) covers the rest of the first class and all following ones
+    t[0] = 8;
+    t[1] = 4;
+    count = 0;
+    for (auto x = br.find(t); x != br.end(); ++x) ++count;
+    EXPECT_EQ(3 + 25 + 1, count);
+
+    // all pairs of the middle class
+    count = 0;
+    for (auto x = br.closure(5); x != br.end(); ++x) {
+        EXPECT_EQ(1, (*x)[0] % 2);
+        EXPECT_EQ(1, (*x)[1] % 2);
+        ++count;
+    }
+    EXPECT_EQ(25, count);
+}
+
+TEST(BinRelTest, IterPartitionLargeClass) {
+    // a single large class and many small ones, each pair needs to be covered exactly once
+    BinRel br;
+    const RamDomain N = 2000;
+    for (RamDomain i = 0; i < N; ++i) br.insert(0, i);
+    for (RamDomain i = N; i < 2 * N; ++i) br.insert(i, i);
+
+    const size_t total = (size_t)N * N + N;
+    EXPECT_EQ(total, br.size());
+
+    for (size_t np : {1, 2, 7, 400}) {
+        auto chunks = br.partition(np);
+        EXPECT_TRUE(chunks.size() > 0);
+        if (np > 1) {
+            EXPECT_TRUE(chunks.size() >= np / 2);
+        }
+
+        size_t count = 0;
+        size_t singletons = 0;
+        for (auto chunk : chunks) {
+            for (auto x = chunk.begin(); x != chunk.end(); ++x) {
+                ++count;
+                if ((*x)[0] >= N) {
+                    EXPECT_EQ((*x)[0], (*x)[1]);
+                    ++singletons;
+                }
+            }
+        }
+        EXPECT_EQ(total, count);
+        EXPECT_EQ((size_t)N, singletons);
+    }
+}
+
 TEST(BinRelTest, ParallelTest) {
     // insert a lot of times into a disjoint set over multiple std::threads
 
@@ -513,6 +611,53 @@ TEST(BinRelTest, ParallelTest) {
     EXPECT_EQ(count, br.size());
 }
 
+TEST(BinRelTest, ParallelSparseMapping) {
+    // concurrently add the same sparse values from multiple threads, each must be mapped exactly once
+    const RamDomain N = 10000;
+    SparseDisjointSet<RamDomain> sds;
+    std::vector<std::thread> starts;
+
+    for (int t = 0; t < 4; ++t) {
+        starts.push_back(std::thread([&, t]() {
+            for (RamDomain i = 0; i < N; ++i) {
+                RamDomain v = ((t % 2) ? (N - 1 - i) : i) * 7919;
+                sds.makeNode(v);
+                EXPECT_TRUE(sds.nodeExists(v));
+                EXPECT_EQ(v, sds.findNode(v));
+            }
+        }));
+    }
+
+    for (auto& r : starts) r.join();
+
+    EXPECT_EQ((size_t)N, sds.size());
+    EXPECT_FALSE(sds.nodeExists(1));
+    for (RamDomain i = 0; i < N; ++i) {
+        EXPECT_TRUE(sds.nodeExists(i * 7919));
+    }
+
+    // union them into pairs concurrently
+    starts.clear();
+    for (int t = 0; t < 4; ++t) {
+        starts.push_back(std::thread([&, t]() {
+            for (RamDomain i = t * 2; i < N; i += 8) sds.unionNodes(i * 7919, (i + 1) * 7919);
+        }));
+    }
+
+    for (auto& r : starts) r.join();
+
+    EXPECT_EQ((size_t)N, sds.size());
+    for (RamDomain i = 0; i < N; i += 2) {
+        EXPECT_TRUE(sds.contains(i * 7919, (i + 1) * 7919));
+        EXPECT_EQ(2, sds.sizeOfRepresentativeSet(i * 7919));
+    }
+    EXPECT_FALSE(sds.contains(7919, 2 * 7919));
+
+    sds.clear();
+    EXPECT_EQ(0, sds.size());
+    EXPECT_FALSE(sds.nodeExists(0));
+}
+
 #ifdef _OPENMP
 TEST(BinRelTest, ParallelScaling) {
     // use OpenMP this time
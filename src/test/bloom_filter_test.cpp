@@ -0,0 +1,143 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file bloom_filter_test.cpp
+ *
+ * A test case testing the Bloom filters summarizing relations.
+ *
+ ***********************************************************************/
+
+#include "BloomFilter.h"
+#include "CompiledRamTuple.h"
+#include "test.h"
+
+#include <vector>
+
+namespace souffle {
+
+namespace test {
+
+typedef ram::Tuple<RamDomain, 2> Pair;
+
+TEST(BloomFilter, NoFalseNegatives) {
+    const int N = 10000;
+    BloomFilter filter(3, N);
+
+    for (int i = 0; i < N; i++) {
+        RamDomain t[2] = {i, i * 3};
+        EXPECT_TRUE(filter.insert(t));
+    }
+    EXPECT_FALSE(filter.isSaturated());
+
+    for (int i = 0; i < N; i++) {
+        RamDomain t[2] = {i, i * 3};
+        EXPECT_TRUE(filter.mayContain(t));
+    }
+
+    // the false positive rate should be low
+    int positives = 0;
+    for (int i = N; i < 2 * N; i++) {
+        RamDomain t[2] = {i, i * 3};
+        if (filter.mayContain(t)) positives++;
+    }
+    EXPECT_LT(positives, N / 100);
+}
+
+TEST(BloomFilter, Projection) {
+    // only the second column is summarized
+    BloomFilter filter(2, 100);
+
+    RamDomain a[2] = {1, 2};
+    RamDomain b[2] = {5, 2};
+    filter.insert(a);
+    EXPECT_TRUE(filter.mayContain(b));
+}
+
+TEST(BloomFilter, Saturation) {
+    BloomFilter filter(1, 100);
+    for (int i = 0; i < 100; i++) {
+        RamDomain t[1] = {i};
+        EXPECT_TRUE(filter.insert(t));
+    }
+    EXPECT_FALSE(filter.isSaturated());
+
+    RamDomain t[1] = {100};
+    EXPECT_FALSE(filter.insert(t));
+    EXPECT_TRUE(filter.isSaturated());
+}
+
+TEST(RelationFilter, LazyBuild) {
+    std::vector<Pair> rel;
+    for (int i = 0; i < 100; i++) {
+        rel.push_back(Pair({i, i + 1}));
+    }
+
+    RelationFilter filter(3);
+    EXPECT_FALSE(filter.isBuilt());
+
+    // inserts before the filter is built are ignored
+    Pair t({1000, 1001});
+    filter.insert(&t[0]);
+    EXPECT_FALSE(filter.isBuilt());
+
+    for (const auto& cur : rel) {
+        EXPECT_TRUE(filter.mayContain(&cur[0], rel));
+    }
+    EXPECT_TRUE(filter.isBuilt());
+
+    // later inserts are recorded
+    rel.push_back(t);
+    filter.insert(&t[0]);
+    EXPECT_TRUE(filter.mayContain(&t[0], rel));
+}
+
+TEST(RelationFilter, Rebuild) {
+    std::vector<Pair> rel;
+    RelationFilter filter(1);
+
+    // build an empty filter, then exceed its capacity
+    Pair probe({-1, 0});
+    filter.mayContain(&probe[0], rel);
+    EXPECT_TRUE(filter.isBuilt());
+
+    const int N = 1000;
+    for (int i = 0; i < N && filter.isBuilt(); i++) {
+        rel.push_back(Pair({i, 0}));
+        filter.insert(&rel.back()[0]);
+    }
+    EXPECT_FALSE(filter.isBuilt());
+
+    // the next test re-builds the filter covering all tuples
+    for (int i = rel.size(); i < N; i++) {
+        rel.push_back(Pair({i, 0}));
+    }
+    for (const auto& cur : rel) {
+        EXPECT_TRUE(filter.mayContain(&cur[0], rel));
+    }
+    EXPECT_TRUE(filter.isBuilt());
+}
+
+TEST(RelationFilter, Clear) {
+    std::vector<Pair> rel;
+    rel.push_back(Pair({1, 2}));
+
+    RelationFilter filter(3);
+    EXPECT_TRUE(filter.mayContain(&rel[0][0], rel));
+    EXPECT_TRUE(filter.isBuilt());
+
+    filter.clear();
+    EXPECT_FALSE(filter.isBuilt());
+
+    rel.clear();
+    EXPECT_FALSE(filter.mayContain(&Pair({1, 2})[0], rel));
+}
+
+}  // end namespace test
+}  // end namespace souffle
@@ -0,0 +1,260 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file checkpoint_test.cpp
+ *
+ * A test case testing the snapshots taken at stratum boundaries.
+ *
+ ***********************************************************************/
+
+#include "Checkpoint.h"
+#include "test.h"
+
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace souffle {
+
+namespace test {
+
+namespace {
+
+typedef std::array<RamDomain, 2> Pair;
+
+/* A minimal relation of pairs. */
+struct PairRelation : public std::set<Pair> {
+    void insert(const RamDomain* tuple) {
+        std::set<Pair>::insert(Pair{{tuple[0], tuple[1]}});
+    }
+};
+
+/* Record tables of pairs only. */
+class PairRecords : public RecordTables {
+    std::vector<Pair> records;
+
+public:
+    std::vector<int> getArities() const override {
+        return {2};
+    }
+
+    std::size_t size(int) const override {
+        return records.size();
+    }
+
+    const RamDomain* unpack(int, RamDomain index) const override {
+        return records[index - 1].data();
+    }
+
+    RamDomain pack(int, const RamDomain* tuple) override {
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            if (records[i][0] == tuple[0] && records[i][1] == tuple[1]) {
+                return i + 1;
+            }
+        }
+        records.push_back(Pair{{tuple[0], tuple[1]}});
+        return records.size();
+    }
+};
+
+/* A temporary directory, removed with the files within it at the end of the test. */
+class TempDirectory {
+    std::string name;
+
+public:
+    TempDirectory() {
+        char buffer[] = "/tmp/souffle_checkpoint_XXXXXX";
+        name = mkdtemp(buffer);
+    }
+
+    ~TempDirectory() {
+        if (DIR* dir = opendir(name.c_str())) {
+            while (const dirent* entry = readdir(dir)) {
+                const std::string file = entry->d_name;
+                if (file != "." && file != "..") {
+                    std::remove((name + "/" + file).c_str());
+                }
+            }
+            closedir(dir);
+        }
+        rmdir(name.c_str());
+    }
+
+    const std::string& get() const {
+        return name;
+    }
+};
+
+}  // namespace
+
+TEST(Checkpoint, Disabled) {
+    Checkpoint checkpoint("", 1);
+    EXPECT_FALSE(checkpoint.isEnabled());
+    EXPECT_EQ(-1, checkpoint.getResumedStratum());
+    EXPECT_FALSE(checkpoint.isCompleted(0));
+    EXPECT_TRUE(checkpoint.isNeeded(0));
+
+    // saving and committing has no effect
+    PairRelation rel;
+    SymbolTable symbols;
+    PairRecords records;
+    checkpoint.save("rel", 2, rel);
+    checkpoint.commit(0, symbols, records);
+}
+
+TEST(Checkpoint, Resume) {
+    const TempDirectory temp;
+    const std::string& dir = temp.get();
+
+    PairRelation rel;
+    for (RamDomain i = 0; i < 100000; ++i) {
+        const RamDomain tuple[] = {i, i * 3};
+        rel.insert(tuple);
+    }
+
+    {
+        Checkpoint checkpoint(dir, 42);
+        EXPECT_TRUE(checkpoint.isEnabled());
+        EXPECT_EQ(-1, checkpoint.getResumedStratum());
+
+        SymbolTable symbols;
+        PairRecords records;
+        symbols.lookup("a");
+        const RamDomain r[] = {1, 2};
+        records.pack(2, r);
+        checkpoint.save("rel", 2, rel);
+        checkpoint.commit(0, symbols, records);
+
+        symbols.lookup("b");
+        symbols.lookup("c");
+        const RamDomain s[] = {3, 4};
+        records.pack(2, s);
+        checkpoint.commit(1, symbols, records);
+    }
+
+    // a different program does not resume
+    {
+        Checkpoint checkpoint(dir, 43);
+        EXPECT_EQ(-1, checkpoint.getResumedStratum());
+    }
+
+    // the same program resumes after the last stratum
+    Checkpoint checkpoint(dir, 42);
+    EXPECT_EQ(1, checkpoint.getResumedStratum());
+    EXPECT_TRUE(checkpoint.isCompleted(0));
+    EXPECT_TRUE(checkpoint.isCompleted(1));
+    EXPECT_FALSE(checkpoint.isCompleted(2));
+    EXPECT_FALSE(checkpoint.isNeeded(1));
+    EXPECT_TRUE(checkpoint.isNeeded(2));
+
+    SymbolTable symbols;
+    PairRecords records;
+    checkpoint.restoreTables(0, symbols, records);
+    checkpoint.restoreTables(1, symbols, records);
+    EXPECT_EQ(3, symbols.size());
+    EXPECT_EQ(std::string("c"), symbols.resolve(2));
+    EXPECT_EQ(2, records.size(2));
+    EXPECT_EQ(4, records.unpack(2, 2)[1]);
+
+    PairRelation restored;
+    checkpoint.restore("rel", 2, restored);
+    EXPECT_TRUE(rel == restored);
+
+    // a relation of another arity is rejected
+    bool failed = false;
+    try {
+        PairRelation other;
+        checkpoint.restore("rel", 3, other);
+    } catch (const std::exception&) {
+        failed = true;
+    }
+    EXPECT_TRUE(failed);
+}
+
+TEST(Checkpoint, Mismatch) {
+    const TempDirectory temp;
+    const std::string& dir = temp.get();
+    {
+        Checkpoint checkpoint(dir, 7);
+        SymbolTable symbols;
+        PairRecords records;
+        symbols.lookup("a");
+        checkpoint.commit(0, symbols, records);
+    }
+
+    // symbols of a different input occupy other indices
+    Checkpoint checkpoint(dir, 7);
+    SymbolTable symbols;
+    PairRecords records;
+    symbols.lookup("b");
+    bool failed = false;
+    try {
+        checkpoint.restoreTables(0, symbols, records);
+    } catch (const std::exception&) {
+        failed = true;
+    }
+    EXPECT_TRUE(failed);
+}
+
+TEST(Checkpoint, Inputs) {
+    const TempDirectory temp;
+    const std::string& dir = temp.get();
+    const std::string fileName = dir + "/input.facts";
+    IODirectives input;
+    input.setIOType("file");
+    input.setFileName(fileName);
+    std::ofstream(fileName) << "1\t2\n";
+
+    const uint64_t program = Checkpoint::getFingerprint("program");
+    const uint64_t fingerprint = Checkpoint::getFingerprint(program, {input});
+    EXPECT_NE(program, fingerprint);
+    EXPECT_EQ(fingerprint, Checkpoint::getFingerprint(program, {input}));
+
+    // a modified input changes the fingerprint
+    std::ofstream(fileName, std::ios::app) << "3\t4\n";
+    EXPECT_NE(fingerprint, Checkpoint::getFingerprint(program, {input}));
+
+    // as does another input
+    input.setFileName(dir + "/other.facts");
+    EXPECT_NE(fingerprint, Checkpoint::getFingerprint(program, {input}));
+}
+
+TEST(Checkpoint, Clear) {
+    const TempDirectory temp;
+    const std::string& dir = temp.get();
+    PairRelation rel;
+    SymbolTable symbols;
+    PairRecords records;
+    {
+        Checkpoint checkpoint(dir, 5);
+        checkpoint.save("rel", 2, rel);
+        checkpoint.commit(0, symbols, records);
+        checkpoint.commit(1, symbols, records);
+        checkpoint.clear(2, {"rel"});
+        EXPECT_EQ(-1, checkpoint.getResumedStratum());
+    }
+
+    // a completed evaluation is not resumed and leaves no files behind
+    Checkpoint checkpoint(dir, 5);
+    EXPECT_EQ(-1, checkpoint.getResumedStratum());
+    for (const char* name : {"checkpoint", "stratum-0", "stratum-1", "rel.rel"}) {
+        EXPECT_FALSE(std::ifstream(dir + "/" + name).good());
+    }
+}
+
+}  // end namespace test
+}  // end namespace souffle
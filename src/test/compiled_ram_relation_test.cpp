@@ -355,6 +355,19 @@ TEST(Relation, Structure_Brie) {
             (Relation<Brie, 8, index<0, 1, 2>, index<2, 3, 4>>()).getDescription());
 }
 
+TEST(Relation, Structure_Hash) {
+    // check the proper instantiation of a few relations
+    EXPECT_EQ("Nullary Relation", (Relation<Hash, 0>().getDescription()));
+    EXPECT_EQ("Hash-Organized Relation of arity=1 based on a hash-index(<0>)",
+            (Relation<Hash, 1>().getDescription()));
+    EXPECT_EQ("Hash-Organized Relation of arity=3 based on a hash-index(<0,1,2>)",
+            (Relation<Hash, 3>().getDescription()));
+
+    // indices are ignored
+    EXPECT_EQ("Hash-Organized Relation of arity=2 based on a hash-index(<0,1>)",
+            (Relation<Hash, 2, index<1, 0>, index<1>>()).getDescription());
+}
+
 TEST(Relation, BigTuple) {
     typedef Relation<Auto, 5> relation_t;
 
@@ -533,6 +546,98 @@ TEST(Relation, EqualRange) {
     EXPECT_EQ("{[2,4]}", toString(set));
 }
 
+TEST(Relation, HashEqualRange) {
+    Relation<Hash, 2> rel;
+    typedef decltype(rel)::tuple_type tuple_t;
+
+    for (int i = 0; i < 5; i++) {
+        for (int j = 3; j < 8; j++) {
+            rel.insert(i, j);
+        }
+    }
+
+    EXPECT_EQ(25, rel.size());
+    EXPECT_TRUE(rel.contains(2, 4));
+    EXPECT_FALSE(rel.contains(4, 2));
+
+    std::set<tuple_t> set;
+    tuple_t pattern = {{2, 4}};
+
+    // full-key queries are answered by the hash index
+    for (const auto& cur : rel.equalRange<0, 1>(pattern)) {
+        set.insert(cur);
+    }
+    EXPECT_EQ("{[2,4]}", toString(set));
+
+    // partial queries are answered by filtered scans
+    set.clear();
+    for (const auto& cur : rel.equalRange<1>(pattern)) {
+        set.insert(cur);
+    }
+    EXPECT_EQ("{[0,4],[1,4],[2,4],[3,4],[4,4]}", toString(set));
+
+    // merge into an ordered relation and back
+    Relation<Auto, 2, index<0, 1>> ordered;
+    ordered.insertAll(rel);
+    EXPECT_EQ(25, ordered.size());
+
+    Relation<Hash, 2> copy;
+    copy.insertAll(ordered);
+    copy.insertAll(rel);
+    EXPECT_EQ(25, copy.size());
+
+    // check partitioning
+    std::set<tuple_t> all;
+    for (const auto& part : copy.partition()) {
+        EXPECT_FALSE(part.empty());
+        for (const auto& cur : part) {
+            EXPECT_TRUE(all.insert(cur).second) << "Duplicate: " << cur;
+        }
+    }
+    EXPECT_EQ(25, all.size());
+
+    copy.purge();
+    EXPECT_TRUE(copy.empty());
+}
+
+TEST(Relation, Filtered) {
+    typedef Relation<Filtered<Auto, index<1>, index<0, 1>>, 2, index<1>> rel_type;
+    typedef typename rel_type::tuple_type tuple_type;
+
+    rel_type rel;
+    rel.insert(1, 2);
+    rel.insert(3, 4);
+
+    // the filters are built lazily by the first test
+    EXPECT_TRUE(rel.mayContain<1>(tuple_type({0, 2})));
+    EXPECT_TRUE((rel.mayContain<0, 1>(tuple_type({3, 4}))));
+
+    // tuples inserted later are covered
+    rel.insert(5, 6);
+    EXPECT_TRUE(rel.mayContain<1>(tuple_type({0, 6})));
+    EXPECT_TRUE((rel.mayContain<0, 1>(tuple_type({5, 6}))));
+
+    Relation<Auto, 2> other;
+    other.insert(7, 8);
+    rel.insertAll(other);
+    EXPECT_TRUE((rel.mayContain<0, 1>(tuple_type({7, 8}))));
+    EXPECT_TRUE(rel.contains(7, 8));
+    EXPECT_FALSE(rel.equalRange<1>(tuple_type({0, 8})).empty());
+
+    // a large number of tuples requires the filters to be rebuilt
+    for (int i = 0; i < 1000; i++) {
+        rel.insert(i, i + 100);
+    }
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_TRUE((rel.mayContain<0, 1>(tuple_type({i, i + 100}))));
+    }
+
+    // a purged relation may not contain anything
+    rel.purge();
+    EXPECT_TRUE(rel.empty());
+    EXPECT_FALSE((rel.mayContain<0, 1>(tuple_type({1, 2}))));
+}
+
 TEST(Relation, NullArity) {
     Relation<Auto, 0> rel;
     EXPECT_EQ(0, sizeof(Relation<Auto, 0>::tuple_type));  // strange, but true
@@ -569,6 +674,70 @@ TEST(Relation, NullArity) {
     EXPECT_EQ(1, count);
 }
 
+TEST(Relation, MemoryUsage) {
+    Relation<Auto, 2, index<0>, index<1>> a;
+    Relation<Brie, 2> b;
+    Relation<Hash, 2> h;
+
+    EXPECT_EQ(2, a.getIndexMemoryUsage().size());
+    EXPECT_EQ(1, b.getIndexMemoryUsage().size());
+    EXPECT_EQ(1, h.getIndexMemoryUsage().size());
+
+    const size_t emptyA = a.getMemoryUsage();
+    const size_t emptyB = b.getMemoryUsage();
+    const size_t emptyH = h.getMemoryUsage();
+    for (int i = 0; i < 1000; i++) {
+        a.insert(i, i % 7);
+        b.insert(i, i % 7);
+        h.insert(i, i % 7);
+    }
+    EXPECT_LT(emptyA, a.getMemoryUsage());
+    EXPECT_LT(emptyB, b.getMemoryUsage());
+    EXPECT_LT(emptyH, h.getMemoryUsage());
+
+    // the memory of a relation covers the memory of its indices
+    size_t indices = 0;
+    for (size_t cur : a.getIndexMemoryUsage()) {
+        EXPECT_LT(0, cur);
+        indices += cur;
+    }
+    EXPECT_TRUE(indices <= a.getMemoryUsage());
+}
+
+TEST(Relation, Truncate) {
+    Relation<Auto, 2, index<1>> a;
+    Relation<Hash, 2> h;
+    Relation<Brie, 2> b;
+    for (int i = 0; i < 1000; i++) {
+        a.insert(i, i % 7);
+        h.insert(i, i % 7);
+        b.insert(i, i % 7);
+    }
+
+    a.truncate();
+    h.truncate();
+    b.truncate();
+    EXPECT_TRUE(a.empty());
+    EXPECT_TRUE(h.empty());
+    EXPECT_TRUE(b.empty());
+    EXPECT_FALSE(a.contains(1, 1));
+    EXPECT_TRUE(a.equalRange<1>(Relation<Auto, 2>::tuple_type({0, 1})).empty());
+    EXPECT_FALSE(h.contains(1, 1));
+
+    // truncated relations may be refilled, the hash table is not grown again
+    const size_t usedH = h.getMemoryUsage();
+    for (int i = 0; i < 1000; i++) {
+        h.insert(i, i % 5);
+    }
+    EXPECT_EQ(usedH, h.getMemoryUsage());
+    a.insert(1, 2);
+    b.insert(1, 2);
+    EXPECT_EQ(1, a.size());
+    EXPECT_EQ(1000, h.size());
+    EXPECT_EQ(1, b.size());
+    EXPECT_FALSE(a.equalRange<1>(Relation<Auto, 2>::tuple_type({0, 2})).empty());
+}
+
 template <typename C>
 int count(const C& c) {
     int res = 0;
@@ -0,0 +1,234 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file data_structures_bench.cpp
+ *
+ * Microbenchmarks of the relations of compiled programs, and thus of the
+ * b-trees, bries, hash sets and disjoint sets implementing them
+ *
+ ***********************************************************************/
+
+#include "CompiledRamRelation.h"
+#include "bench.h"
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <set>
+
+namespace souffle {
+namespace ram {
+
+namespace {
+
+/* the results of lookups and scans, such that they are not optimized away */
+volatile size_t sink;
+
+/* the distributions of the keys of the tuples */
+enum class Keys { dense, sparse, skewed };
+
+const char* getName(Keys keys) {
+    switch (keys) {
+        case Keys::dense:
+            return "dense";
+        case Keys::sparse:
+            return "sparse";
+        case Keys::skewed:
+            return "skewed";
+    }
+    return "";
+}
+
+/**
+ * Generates tuples of the given distribution in random order, the same in every run. Dense
+ * tuples enumerate the smallest cube of values holding all of them, sparse tuples are spread over
+ * all values, and skewed tuples share few values of their first column following a power law.
+ */
+template <unsigned arity>
+std::vector<Tuple<RamDomain, arity>> generate(Keys keys, size_t n) {
+    std::mt19937 random(n * 16 + arity * 4 + (unsigned)keys);
+    std::uniform_real_distribution<double> uniform;
+
+    RamDomain width = 1;
+    while (std::pow(width, arity) < n) {
+        width++;
+    }
+
+    std::vector<Tuple<RamDomain, arity>> res(n);
+    for (size_t i = 0; i < n; i++) {
+        size_t cur = i;
+        for (unsigned j = 0; j < arity; j++) {
+            if (keys == Keys::dense) {
+                res[i][arity - 1 - j] = cur % width;
+                cur /= width;
+            } else if (keys == Keys::sparse) {
+                res[i][j] = random() & 0x3fffffff;
+            } else if (j == 0) {
+                res[i][j] = std::sqrt(n) * std::pow(uniform(random), 4);
+            } else {
+                res[i][j] = random() % n;
+            }
+        }
+    }
+    std::shuffle(res.begin(), res.end(), random);
+    return res;
+}
+
+/**
+ * Measures the relations of the given setup and arity for all sizes and distributions. Scans of
+ * the tuples of the values of the first column are only measured for ordered relations, and the
+ * enumeration of all tuples only if it is proportional to the number of inserted tuples.
+ */
+template <typename Setup, unsigned arity>
+void measureRelation(Benchmark& bench, const BenchmarkOptions& options, bool scans, bool enumeration) {
+    typedef Relation<Setup, arity> relation_t;
+    typedef typename relation_t::operation_context context_t;
+
+    for (size_t n : options.sizes) {
+        for (Keys keys : {Keys::dense, Keys::sparse, Keys::skewed}) {
+            const auto data = generate<arity>(keys, n);
+            const long num = data.size();
+            const std::string label = std::string(getName(keys)) + "/" + std::to_string(n);
+
+            // inserts the tuples by all threads, each thread starting with a fresh context
+            std::unique_ptr<relation_t> rel;
+            for (int threads : options.threads) {
+                bench.measure("insert/" + label, threads, n, [&]() { rel.reset(new relation_t()); },
+                        [&]() {
+#pragma omp parallel
+                            {
+                                context_t ctxt;
+#pragma omp for schedule(static)
+                                for (long i = 0; i < num; i++) {
+                                    rel->insert(data[i], ctxt);
+                                }
+                            }
+                        });
+            }
+
+            for (int threads : options.threads) {
+                bench.measure("lookup/" + label, threads, n, [&]() {
+                    size_t found = 0;
+#pragma omp parallel reduction(+ : found)
+                    {
+                        context_t ctxt;
+#pragma omp for schedule(static)
+                        for (long i = num - 1; i >= 0; i--) {
+                            found += rel->contains(data[i], ctxt);
+                        }
+                    }
+                    sink = found;
+                });
+            }
+
+            if (scans) {
+                // every value of the first column is scanned once, such that every tuple is visited once
+                std::vector<Tuple<RamDomain, arity>> firsts;
+                std::set<RamDomain> seen;
+                for (const auto& cur : data) {
+                    if (seen.insert(cur[0]).second) {
+                        firsts.push_back(cur);
+                    }
+                }
+                const long numFirsts = firsts.size();
+                for (int threads : options.threads) {
+                    bench.measure("scan/" + label, threads, rel->size(), [&]() {
+                        size_t visited = 0;
+#pragma omp parallel reduction(+ : visited)
+                        {
+                            context_t ctxt;
+#pragma omp for schedule(dynamic)
+                            for (long i = 0; i < numFirsts; i++) {
+                                for (const auto& cur : rel->template equalRange<0>(firsts[i], ctxt)) {
+                                    visited += cur[arity - 1] & 1;
+                                }
+                            }
+                        }
+                        sink = visited;
+                    });
+                }
+            }
+
+            if (!enumeration) {
+                continue;
+            }
+
+            bench.measure("iterate/" + label, 1, rel->size(), [&]() {
+                size_t visited = 0;
+                for (const auto& cur : *rel) {
+                    visited += cur[0] & 1;
+                }
+                sink = visited;
+            });
+
+            // the tuples are enumerated in parallel as in the evaluation of a rule
+            for (int threads : options.threads) {
+                bench.measure("partition/" + label, threads, rel->size(), [&]() {
+                    auto parts = rel->partition();
+                    const long numParts = parts.size();
+                    size_t visited = 0;
+#pragma omp parallel for reduction(+ : visited) schedule(dynamic)
+                    for (long i = 0; i < numParts; i++) {
+                        for (const auto& cur : parts[i]) {
+                            visited += cur[0] & 1;
+                        }
+                    }
+                    sink = visited;
+                });
+            }
+
+            std::unique_ptr<relation_t> target;
+            bench.measure("insertAll/" + label, 1, rel->size(), [&]() { target.reset(new relation_t()); },
+                    [&]() { target->insertAll(*rel); });
+        }
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BTree, Binary) {
+    measureRelation<BTree, 2>(*this, options, true, true);
+}
+
+BENCHMARK(BTree, Quaternary) {
+    measureRelation<BTree, 4>(*this, options, true, true);
+}
+
+BENCHMARK(Brie, Binary) {
+    measureRelation<Brie, 2>(*this, options, true, true);
+}
+
+BENCHMARK(Brie, Quaternary) {
+    measureRelation<Brie, 4>(*this, options, true, true);
+}
+
+BENCHMARK(Hash, Binary) {
+    measureRelation<Hash, 2>(*this, options, false, true);
+}
+
+BENCHMARK(Hash, Quaternary) {
+    measureRelation<Hash, 4>(*this, options, false, true);
+}
+
+BENCHMARK(Auto, Binary) {
+    measureRelation<Auto, 2>(*this, options, true, true);
+}
+
+BENCHMARK(Auto, Quaternary) {
+    measureRelation<Auto, 4>(*this, options, true, true);
+}
+
+// the equivalence classes of random pairs may grow quadratically, thus only unions and finds are measured
+BENCHMARK(EqRel, Binary) {
+    measureRelation<EqRel, 2>(*this, options, false, false);
+}
+
+}  // end namespace ram
+}  // end namespace souffle
@@ -0,0 +1,153 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file hash_join_table_test.cpp
+ *
+ * A test case testing the hash tables utilized by hash joins.
+ *
+ ***********************************************************************/
+
+#include "CompiledRamTuple.h"
+#include "HashJoinTable.h"
+#include "test.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace souffle {
+
+namespace test {
+
+typedef ram::Tuple<RamDomain, 3> Triple;
+
+namespace {
+
+std::set<Triple> lookup(const HashJoinTable& table, const Triple& key) {
+    std::set<Triple> res;
+    for (const RamDomain* cur : table.lookup(key)) {
+        res.insert(Triple({cur[0], cur[1], cur[2]}));
+    }
+    return res;
+}
+/* A relation enumerating its tuples in several partitions. */
+struct PartitionedRelation : public std::vector<Triple> {
+    std::vector<range<const_iterator>> partition() const {
+        std::vector<range<const_iterator>> res;
+        for (std::size_t i = 0; i < size(); i += 7) {
+            res.push_back(make_range(begin() + i, begin() + std::min(i + 7, size())));
+        }
+        return res;
+    }
+};
+
+}  // namespace
+
+TEST(HashJoinTable, Empty) {
+    const Triple key({1, 2, 3});
+    HashJoinTable table(3, 1);
+    EXPECT_TRUE(table.empty());
+    EXPECT_TRUE(table.lookup(key).empty());
+
+    std::vector<Triple> rel;
+    table.build(rel);
+    EXPECT_TRUE(table.empty());
+    EXPECT_TRUE(table.lookup(key).empty());
+}
+
+TEST(HashJoinTable, Lookup) {
+    std::vector<Triple> rel;
+    rel.push_back(Triple({1, 2, 3}));
+    rel.push_back(Triple({1, 3, 4}));
+    rel.push_back(Triple({2, 3, 4}));
+    rel.push_back(Triple({3, 3, 5}));
+
+    // key on the second column
+    HashJoinTable table(3, 2);
+    table.build(rel);
+    EXPECT_EQ(4, table.size());
+
+    EXPECT_EQ(std::set<Triple>({Triple({1, 2, 3})}), lookup(table, Triple({0, 2, 0})));
+    EXPECT_EQ(std::set<Triple>({Triple({1, 3, 4}), Triple({2, 3, 4}), Triple({3, 3, 5})}),
+            lookup(table, Triple({0, 3, 0})));
+    EXPECT_TRUE(lookup(table, Triple({0, 4, 0})).empty());
+
+    // key on the first and last column
+    HashJoinTable table2(3, 5);
+    table2.build(rel);
+
+    EXPECT_EQ(std::set<Triple>({Triple({1, 3, 4})}), lookup(table2, Triple({1, 0, 4})));
+    EXPECT_EQ(std::set<Triple>({Triple({2, 3, 4})}), lookup(table2, Triple({2, 0, 4})));
+    EXPECT_TRUE(lookup(table2, Triple({2, 0, 5})).empty());
+}
+
+TEST(HashJoinTable, Large) {
+    const int N = 100000;
+    std::vector<Triple> rel;
+    for (int i = 0; i < N; i++) {
+        rel.push_back(Triple({i % 100, i, -i}));
+    }
+
+    HashJoinTable table(3, 1);
+    table.build(rel);
+    EXPECT_EQ(N, table.size());
+
+    for (int i = 0; i < 100; i++) {
+        int count = 0;
+        const Triple key({i, 0, 0});
+        for (const RamDomain* cur : table.lookup(key)) {
+            EXPECT_EQ(i, cur[0]);
+            EXPECT_EQ(-cur[1], cur[2]);
+            count++;
+        }
+        EXPECT_EQ(N / 100, count);
+    }
+    const Triple missing({100, 0, 0});
+    EXPECT_TRUE(table.lookup(missing).empty());
+}
+
+TEST(HashJoinTable, Partitioned) {
+    const int N = 1000;
+    PartitionedRelation rel;
+    for (int i = 0; i < N; i++) {
+        rel.push_back(Triple({i % 10, i, -i}));
+    }
+
+    HashJoinTable table(3, 2);
+    table.build(rel);
+    EXPECT_EQ(N, table.size());
+
+    for (int i = 0; i < N; i++) {
+        const Triple key({0, i, 0});
+        EXPECT_EQ(std::set<Triple>({Triple({i % 10, i, -i})}), lookup(table, key));
+    }
+}
+
+TEST(HashJoinTable, Rebuild) {
+    std::vector<Triple> rel;
+    rel.push_back(Triple({1, 2, 3}));
+
+    const Triple first({1, 2, 3});
+    const Triple second({4, 5, 6});
+
+    HashJoinTable table(3, 7);
+    table.build(rel);
+    EXPECT_FALSE(table.lookup(first).empty());
+
+    rel.clear();
+    rel.push_back(second);
+    table.build(rel);
+    EXPECT_EQ(1, table.size());
+    EXPECT_TRUE(table.lookup(first).empty());
+    EXPECT_FALSE(table.lookup(second).empty());
+}
+
+}  // end namespace test
+}  // end namespace souffle
@@ -0,0 +1,189 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file hash_set_test.cpp
+ *
+ * A test case testing the concurrent hash set implementation.
+ *
+ ***********************************************************************/
+
+#include "CompiledRamTuple.h"
+#include "HashSet.h"
+#include "test.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace souffle {
+
+namespace test {
+
+TEST(HashSet, Basic) {
+    HashSet<int> set;
+
+    EXPECT_TRUE(set.empty());
+    EXPECT_EQ(0, set.size());
+    EXPECT_FALSE(set.contains(12));
+
+    EXPECT_TRUE(set.insert(12));
+    EXPECT_FALSE(set.insert(12));
+    EXPECT_TRUE(set.insert(14));
+
+    EXPECT_FALSE(set.empty());
+    EXPECT_EQ(2, set.size());
+    EXPECT_TRUE(set.contains(12));
+    EXPECT_TRUE(set.contains(14));
+    EXPECT_FALSE(set.contains(16));
+
+    EXPECT_TRUE(set.find(16) == set.end());
+    EXPECT_EQ(14, *set.find(14));
+}
+
+TEST(HashSet, Growth) {
+    const int N = 100000;
+    HashSet<int> set;
+
+    for (int i = 0; i < N; i++) {
+        EXPECT_TRUE(set.insert(i * 7));
+    }
+    EXPECT_EQ(N, set.size());
+
+    for (int i = 0; i < N; i++) {
+        EXPECT_TRUE(set.contains(i * 7));
+        EXPECT_FALSE(set.contains(i * 7 + 1));
+    }
+
+    std::set<int> is(set.begin(), set.end());
+    EXPECT_EQ(N, is.size());
+    EXPECT_EQ(0, *is.begin());
+    EXPECT_EQ((N - 1) * 7, *is.rbegin());
+}
+
+TEST(HashSet, Tuples) {
+    typedef ram::Tuple<RamDomain, 3> tuple_t;
+    HashSet<tuple_t> set;
+
+    for (int i = 0; i < 20; i++) {
+        for (int j = 0; j < 20; j++) {
+            EXPECT_TRUE(set.insert(tuple_t({{i, j, i + j}})));
+        }
+    }
+    EXPECT_EQ(400, set.size());
+    EXPECT_TRUE(set.contains(tuple_t({{3, 4, 7}})));
+    EXPECT_FALSE(set.contains(tuple_t({{3, 4, 8}})));
+}
+
+TEST(HashSet, Copy) {
+    HashSet<int> a;
+    for (int i = 0; i < 1000; i++) {
+        a.insert(i);
+    }
+
+    HashSet<int> b(a);
+    EXPECT_EQ(1000, b.size());
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_TRUE(b.contains(i));
+    }
+
+    b.insert(1000);
+    EXPECT_FALSE(a.contains(1000));
+
+    HashSet<int> c;
+    c.insertAll(b);
+    c.insertAll(a);
+    EXPECT_EQ(1001, c.size());
+}
+
+TEST(HashSet, Clear) {
+    HashSet<int> set;
+    for (int i = 0; i < 1000; i++) {
+        set.insert(i);
+    }
+    EXPECT_EQ(1000, set.size());
+
+    set.clear();
+    EXPECT_TRUE(set.empty());
+    EXPECT_FALSE(set.contains(10));
+    EXPECT_TRUE(set.begin() == set.end());
+
+    set.insert(10);
+    EXPECT_TRUE(set.contains(10));
+}
+
+TEST(HashSet, Truncate) {
+    HashSet<int> set;
+    for (int i = 0; i < 1000; i++) {
+        set.insert(i);
+    }
+
+    // only the active table is retained
+    set.truncate();
+    EXPECT_TRUE(set.empty());
+    EXPECT_FALSE(set.contains(10));
+    EXPECT_TRUE(set.begin() == set.end());
+    const std::size_t memory = set.getMemoryUsage();
+
+    for (int i = 0; i < 1000; i++) {
+        set.insert(i + 1000);
+    }
+    EXPECT_EQ(1000, set.size());
+    EXPECT_FALSE(set.contains(10));
+    EXPECT_TRUE(set.contains(1010));
+    EXPECT_EQ(memory, set.getMemoryUsage());
+}
+
+TEST(HashSet, Chunks) {
+    const int N = 10000;
+    HashSet<int> set;
+    EXPECT_TRUE(set.getChunks(100).empty());
+
+    for (int i = 0; i < N; i++) {
+        set.insert(i);
+    }
+
+    auto chunks = set.getChunks(100);
+    EXPECT_LT(1, chunks.size());
+
+    std::set<int> is;
+    for (const auto& chunk : chunks) {
+        EXPECT_FALSE(chunk.empty());
+        for (const auto& cur : chunk) {
+            EXPECT_TRUE(is.insert(cur).second) << "Duplicate: " << cur;
+        }
+    }
+    EXPECT_EQ(N, is.size());
+}
+
+TEST(HashSet, Parallel) {
+    const int N = 100000;
+
+    std::vector<int> full;
+    for (int dup = 0; dup < 3; dup++) {
+        for (int i = 0; i < N; i++) {
+            full.push_back(i);
+        }
+    }
+    std::random_shuffle(full.begin(), full.end());
+
+    HashSet<int> set;
+#pragma omp parallel for
+    for (std::size_t i = 0; i < full.size(); i++) {
+        set.insert(full[i]);
+        EXPECT_TRUE(set.contains(full[i]));
+    }
+
+    EXPECT_EQ(N, set.size());
+    std::set<int> is(set.begin(), set.end());
+    EXPECT_EQ(N, is.size());
+}
+
+}  // end namespace test
+}  // end namespace souffle
@@ -0,0 +1,57 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file io_thread_test.cpp
+ *
+ * A test case testing the background thread conducting output operations.
+ *
+ ***********************************************************************/
+
+#include "IOThread.h"
+#include "test.h"
+
+#include <vector>
+
+namespace souffle {
+
+namespace test {
+
+TEST(IOThread, Empty) {
+    IOThread thread;
+    thread.wait();
+}
+
+TEST(IOThread, Order) {
+    std::vector<int> done;
+    IOThread thread;
+    for (int i = 0; i < 100; i++) {
+        thread.submit([&done, i]() { done.push_back(i); });
+    }
+    thread.wait();
+
+    EXPECT_EQ(100, done.size());
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(i, done[i]);
+    }
+}
+
+TEST(IOThread, Destruction) {
+    int counter = 0;
+    {
+        IOThread thread;
+        for (int i = 0; i < 100; i++) {
+            thread.submit([&counter]() { counter++; });
+        }
+    }
+    EXPECT_EQ(100, counter);
+}
+
+}  // end namespace test
+}  // end namespace souffle
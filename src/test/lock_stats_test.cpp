@@ -0,0 +1,144 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file lock_stats_test.cpp
+ *
+ * A test case testing the statistics recorded by locks, independent of
+ * the configuration of souffle.
+ *
+ ***********************************************************************/
+
+#define USE_LOCK_STATS
+
+#include "BTree.h"
+#include "ParallelUtils.h"
+#include "test.h"
+
+#include <sstream>
+
+namespace souffle {
+
+namespace test {
+
+TEST(LockStats, Sequential) {
+    resetLockCounts();
+
+    Lock lock(LockSite::records);
+    for (int i = 0; i < 10; i++) {
+        auto lease = lock.acquire();
+        (void)lease;
+    }
+    EXPECT_TRUE(lock.try_lock());
+    EXPECT_FALSE(lock.try_lock());
+    lock.unlock();
+
+    LockCounts counts = getLockCounts(LockSite::records);
+    EXPECT_EQ(11, counts.acquisitions);
+    EXPECT_EQ(0, counts.reads);
+    EXPECT_EQ(1, counts.contentions);
+    EXPECT_EQ(0, counts.spins);
+
+    // other sites are not affected
+    EXPECT_EQ(0, getLockCounts(LockSite::symbols).acquisitions);
+    EXPECT_EQ(0, getLockCounts(LockSite::other).acquisitions);
+
+    resetLockCounts();
+    EXPECT_EQ(0, getLockCounts(LockSite::records).acquisitions);
+}
+
+TEST(LockStats, OptimisticRetries) {
+    resetLockCounts();
+
+    OptimisticReadWriteLock lock(LockSite::btreeNode);
+    auto lease = lock.start_read();
+    EXPECT_TRUE(lock.validate(lease));
+
+    // a write invalidates the lease
+    lock.start_write();
+    lock.end_write();
+    EXPECT_FALSE(lock.end_read(lease));
+    EXPECT_FALSE(lock.try_upgrade_to_write(lease));
+
+    lease = lock.start_read();
+    EXPECT_TRUE(lock.try_upgrade_to_write(lease));
+    EXPECT_FALSE(lock.try_start_write());
+    lock.end_write();
+
+    LockCounts counts = getLockCounts(LockSite::btreeNode);
+    EXPECT_EQ(2, counts.acquisitions);
+    EXPECT_EQ(2, counts.reads);
+    EXPECT_EQ(1, counts.contentions);
+    EXPECT_EQ(2, counts.retries);
+}
+
+TEST(LockStats, Parallel) {
+    const int N = 100000;
+    resetLockCounts();
+
+    SpinLock spin(LockSite::other);
+    ReadWriteLock rw(LockSite::hashSet);
+    volatile int c = 0;
+
+#pragma omp parallel for num_threads(4)
+    for (int i = 0; i < N; i++) {
+        spin.lock();
+        c++;
+        spin.unlock();
+        if (i % 10 == 0) {
+            rw.start_write();
+            rw.end_write();
+        } else {
+            rw.start_read();
+            rw.end_read();
+        }
+    }
+
+    // contention depends on the schedule, but every access is counted exactly once
+    LockCounts counts = getLockCounts(LockSite::other);
+    EXPECT_EQ(N, c);
+    EXPECT_EQ(N, counts.acquisitions);
+    EXPECT_TRUE(counts.contentions <= counts.spins);
+
+    counts = getLockCounts(LockSite::hashSet);
+    EXPECT_EQ(N / 10, counts.acquisitions);
+    EXPECT_EQ(N - N / 10, counts.reads);
+    EXPECT_TRUE(counts.contentions <= counts.spins);
+}
+
+TEST(LockStats, BTree) {
+    resetLockCounts();
+
+    btree_set<int> set;
+    for (int i = 0; i < 10000; i++) {
+        set.insert(i);
+    }
+
+    // inserts read the nodes optimistically and lock the ones they modify
+    LockCounts nodes = getLockCounts(LockSite::btreeNode);
+    EXPECT_LT(0, nodes.reads);
+    EXPECT_LT(0, nodes.acquisitions);
+    EXPECT_LT(0, getLockCounts(LockSite::btreeRoot).reads);
+}
+
+TEST(LockStats, Log) {
+    resetLockCounts();
+
+    Lock lock(LockSite::symbols);
+    lock.lock();
+    lock.unlock();
+
+    // only sites which have been used are logged
+    std::stringstream out;
+    logLockCounts(out);
+    EXPECT_EQ("@l-lock;symbols;1;0;0;0;0\n", out.str());
+}
+
+}  // namespace test
+}  // end namespace souffle
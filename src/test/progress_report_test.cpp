@@ -0,0 +1,130 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file progress_report_test.cpp
+ *
+ * A test case testing the reports of the progress of evaluations.
+ *
+ ***********************************************************************/
+
+#include "ProgressReport.h"
+#include "test.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace souffle {
+
+namespace test {
+
+namespace {
+
+/* A status file within a temporary directory, both removed at the end of the test. */
+class TempFile {
+    std::string directory;
+    std::string name;
+
+public:
+    TempFile() {
+        char buffer[] = "/tmp/souffle_progress_XXXXXX";
+        directory = mkdtemp(buffer);
+        name = directory + "/status.json";
+    }
+
+    ~TempFile() {
+        std::remove(name.c_str());
+        std::remove((name + ".tmp").c_str());
+        rmdir(directory.c_str());
+    }
+
+    const std::string& get() const {
+        return name;
+    }
+};
+
+std::string readFile(const std::string& file) {
+    std::ifstream in(file);
+    std::stringstream res;
+    res << in.rdbuf();
+    return res.str();
+}
+
+bool contains(const std::string& str, const std::string& part) {
+    return str.find(part) != std::string::npos;
+}
+
+}  // namespace
+
+TEST(ProgressReport, Disabled) {
+    ProgressReport progress("", 2);
+    EXPECT_FALSE(progress.isEnabled());
+    EXPECT_FALSE(progress.enter(0));
+    EXPECT_FALSE(progress.enter(1));
+}
+
+TEST(ProgressReport, Strata) {
+    const TempFile temp;
+    const std::string& file = temp.get();
+    {
+        ProgressReport progress(file, 3);
+        EXPECT_TRUE(progress.isEnabled());
+
+        // the initial status is written right away
+        EXPECT_TRUE(contains(readFile(file), "\"state\":\"running\""));
+        EXPECT_TRUE(contains(readFile(file), "\"strata\":3"));
+
+        // sizes are due until they have been sampled
+        EXPECT_TRUE(progress.enter(0));
+        progress.sample({{"edge", 10}}, {});
+        EXPECT_FALSE(progress.enter(1));
+        EXPECT_FALSE(progress.enter(1));
+        EXPECT_FALSE(progress.enter(1));
+        progress.sample({{"path", 42}}, {{"path", 7}});
+
+        std::stringstream status;
+        progress.print(status);
+        EXPECT_TRUE(contains(status.str(), "\"current\":{\"index\":1,\"iteration\":2,"));
+        EXPECT_TRUE(contains(status.str(), "\"relations\":{\"path\":42},\"deltas\":{\"path\":7}}"));
+        EXPECT_TRUE(contains(status.str(), "\"completed\":[{\"index\":0,\"iterations\":0,"));
+    }
+
+    // the final status is written once the evaluation is done
+    const std::string status = readFile(file);
+    EXPECT_TRUE(contains(status, "\"state\":\"done\""));
+    EXPECT_FALSE(contains(status, "\"current\""));
+    EXPECT_TRUE(contains(status, "{\"index\":1,\"iterations\":2,"));
+    EXPECT_FALSE(contains(status, "\"index\":2"));
+}
+
+TEST(ProgressReport, Periodic) {
+    const TempFile temp;
+    const std::string& file = temp.get();
+    ProgressReport progress(file, 1, std::chrono::milliseconds(10));
+    EXPECT_TRUE(progress.enter(0));
+    progress.sample({{"path", 1}}, {{"path", 1}});
+    EXPECT_FALSE(progress.enter(0));
+
+    // the status is rewritten and the sizes are due again after the interval
+    bool due = false;
+    for (int i = 0; i < 1000 && !due; i++) {
+        usleep(1000);
+        due = progress.enter(0);
+    }
+    EXPECT_TRUE(due);
+    EXPECT_TRUE(contains(readFile(file), "\"relations\":{\"path\":1}"));
+}
+
+}  // namespace test
+}  // end namespace souffle
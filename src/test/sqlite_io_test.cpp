@@ -0,0 +1,157 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file sqlite_io_test.cpp
+ *
+ * A test case testing the reading and writing of relations stored in SQLite databases.
+ *
+ ***********************************************************************/
+
+#include "CompiledRamTuple.h"
+#include "ReadStreamSQLite.h"
+#include "WriteStreamSQLite.h"
+#include "test.h"
+
+#include <cstdio>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace souffle {
+
+namespace test {
+
+namespace {
+
+typedef ram::Tuple<RamDomain, 3> Triple;
+
+/* A relation of triples as read from a database. */
+struct TripleList {
+    std::vector<Triple> tuples;
+
+    void insert(const RamDomain* tuple) {
+        tuples.push_back(Triple{{tuple[0], tuple[1], tuple[2]}});
+    }
+};
+
+/* Formats a tuple whose first and last columns are symbols. */
+std::string format(const std::string& first, RamDomain second, const std::string& last) {
+    return first + "," + std::to_string(second) + "," + last;
+}
+
+/* A temporary database file, removed at the end of the test. */
+class TempDatabase {
+    std::string name;
+
+public:
+    TempDatabase() {
+        char buffer[] = "/tmp/souffle_sqlite_XXXXXX";
+        const int fd = mkstemp(buffer);
+        close(fd);
+        name = buffer;
+    }
+
+    ~TempDatabase() {
+        std::remove(name.c_str());
+    }
+
+    const std::string& get() const {
+        return name;
+    }
+};
+
+/* Writes the given tuples, whose first and last columns are symbols, to the given database. */
+void write(const std::string& db, const std::string& relation, const SymbolTable& symbols,
+        const std::vector<Triple>& tuples) {
+    WriteStreamSQLite(db, relation, SymbolMask({true, false, true}), symbols).writeAll(tuples);
+}
+
+/* Reads the tuples of a relation written by write(), formatted by format(). */
+std::multiset<std::string> read(const std::string& db, const std::string& relation) {
+    SymbolTable symbols;
+    TripleList tuples;
+    ReadStreamSQLite(db, relation, SymbolMask({true, false, true}), symbols).readAll(tuples);
+    std::multiset<std::string> res;
+    for (const Triple& cur : tuples.tuples) {
+        res.insert(format(symbols.resolve(cur[0]), cur[1], symbols.resolve(cur[2])));
+    }
+    return res;
+}
+
+}  // namespace
+
+TEST(SQLite, RoundTrip) {
+    const TempDatabase db;
+
+    // more tuples and symbols than written by a single statement, and not a multiple of it
+    SymbolTable symbols;
+    std::vector<Triple> tuples;
+    std::multiset<std::string> expected;
+    for (RamDomain i = 0; i < 1000; ++i) {
+        const std::string first = "s" + std::to_string(i % 300);
+        const std::string last = "t" + std::to_string(i % 7);
+        tuples.push_back(Triple{{RamDomain(symbols.lookup(first.c_str())), i - 500,
+                RamDomain(symbols.lookup(last.c_str()))}});
+        expected.insert(format(first, i - 500, last));
+    }
+    write(db.get(), "a", symbols, tuples);
+
+    // a second relation shares the symbols of the database
+    std::vector<Triple> other = {tuples[0], tuples[999]};
+    write(db.get(), "b", symbols, other);
+
+    EXPECT_TRUE(expected == read(db.get(), "a"));
+    EXPECT_EQ(2, read(db.get(), "b").size());
+    EXPECT_EQ(1, read(db.get(), "b").count(format("s0", -500, "t0")));
+}
+
+TEST(SQLite, Empty) {
+    const TempDatabase db;
+    SymbolTable symbols;
+    write(db.get(), "a", symbols, {});
+    EXPECT_TRUE(read(db.get(), "a").empty());
+}
+
+TEST(SQLite, Rewrite) {
+    const TempDatabase db;
+    SymbolTable symbols;
+    const RamDomain x = symbols.lookup("x");
+    const RamDomain y = symbols.lookup("y");
+    write(db.get(), "a", symbols, {Triple{{x, 1, y}}, Triple{{y, 2, x}}});
+
+    // writing a relation again replaces its tuples
+    write(db.get(), "a", symbols, {Triple{{y, 3, y}}});
+    const auto res = read(db.get(), "a");
+    EXPECT_EQ(1, res.size());
+    EXPECT_EQ(1, res.count(format("y", 3, "y")));
+}
+
+TEST(SQLite, Rollback) {
+    const TempDatabase db;
+    SymbolTable symbols;
+    const RamDomain x = symbols.lookup("x");
+    write(db.get(), "a", symbols, {Triple{{x, 1, x}}});
+
+    // a relation not written completely leaves the database unchanged
+    {
+        const std::string relation = "a";
+        const SymbolMask mask({true, false, true});
+        WriteStreamSQLite writer(db.get(), relation, mask, symbols);
+    }
+    const auto res = read(db.get(), "a");
+    EXPECT_EQ(1, res.size());
+    EXPECT_EQ(1, res.count(format("x", 1, "x")));
+}
+
+}  // end namespace test
+}  // end namespace souffle
@@ -96,6 +96,40 @@ TEST(SymbolTable, Assign) {
     EXPECT_STREQ("Hello", c.resolve(c_idx));
 }
 
+TEST(SymbolTable, Merge) {
+    SymbolTable a;
+    a.insert("A");
+    a.insert("B");
+
+    SymbolTable b;
+    b.insert("C");
+    b.insert("A");
+
+    std::vector<size_t> indices = a.merge(b);
+
+    EXPECT_EQ(3, a.size());
+    EXPECT_EQ(2, indices.size());
+    EXPECT_EQ(a.lookup("C"), indices[0]);
+    EXPECT_EQ(a.lookup("A"), indices[1]);
+
+    // merged symbols are copies
+    EXPECT_STREQ("C", a.resolve(indices[0]));
+    EXPECT_NE(b.resolve(0), a.resolve(indices[0]));
+}
+
+TEST(SymbolTable, Find) {
+    SymbolTable table;
+    table.insert("A");
+
+    size_t idx = 42;
+    EXPECT_TRUE(table.find("A", idx));
+    EXPECT_EQ(table.lookup("A"), idx);
+
+    // symbols not in the table are not inserted
+    EXPECT_FALSE(table.find("B", idx));
+    EXPECT_EQ(1, table.size());
+}
+
 TEST(SymbolTable, Inserts) {
     // whether to print the recorded times to stdout
     // should be false unless developing
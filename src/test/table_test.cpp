@@ -61,5 +61,38 @@ TEST(Table, Stress) {
         EXPECT_EQ(last + 1, i);
     }
 }
+
+TEST(Table, Truncate) {
+    Table<int, 16> table;
+    for (int i = 0; i < 100; ++i) {
+        table.insert(i);
+    }
+    const std::size_t memory = table.getMemoryUsage();
+
+    table.truncate();
+    EXPECT_TRUE(table.empty());
+    EXPECT_EQ(0, table.size());
+    EXPECT_EQ(0, count(table));
+    EXPECT_EQ(memory, table.getMemoryUsage());
+
+    // refilling the table reuses the retained blocks
+    for (int i = 0; i < 50; ++i) {
+        table.insert(2 * i);
+    }
+    EXPECT_EQ(50, table.size());
+    EXPECT_EQ(memory, table.getMemoryUsage());
+    int last = -2;
+    for (const auto& cur : table) {
+        EXPECT_EQ(last + 2, cur);
+        last = cur;
+    }
+    EXPECT_EQ(98, last);
+
+    for (int i = 0; i < 100; ++i) {
+        table.insert(i);
+    }
+    EXPECT_EQ(150, table.size());
+    EXPECT_EQ(150, count(table));
+}
 }  // namespace test
 }  // end namespace souffle
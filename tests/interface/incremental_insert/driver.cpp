@@ -0,0 +1,107 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program running one instance of a Souffle program repeatedly,
+ * inserting further input tuples between the runs
+ *
+ ***********************************************************************/
+
+#include <array>
+#include <set>
+#include <string>
+#include <vector>
+#include "souffle/SouffleInterface.h"
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt)
+{
+   std::cerr << "error: " << txt << "\n";
+   exit(1);
+}
+
+/**
+ * Main program
+ */
+int main(int argc, char **argv)
+{
+   // create an instance of program "incremental_insert"
+   SouffleProgram *prog = ProgramFactory::newInstance("incremental_insert");
+   if (prog == nullptr) {
+      error("cannot find program incremental_insert");
+   }
+   Relation *edge = prog->getRelation("edge");
+   Relation *block = prog->getRelation("block");
+   if (edge == nullptr || block == nullptr) {
+      error("cannot find relations");
+   }
+
+   std::vector<std::vector<std::array<std::string,2>>> edges = {
+      {{"A","B"}, {"B","C"}},
+      {{"C","A"}, {"D","E"}},
+      {{"E","D"}, {"C","D"}, {"A","B"}},
+      {}
+   };
+   std::vector<std::vector<std::string>> blocks = {
+      {},
+      {"C"},
+      {},
+      {"A", "E"}
+   };
+   for (size_t i = 0; i < edges.size(); i++) {
+      // insert further tuples into the inputs
+      for (const auto &cur : edges[i]) {
+         tuple t(edge);
+         t << cur[0] << cur[1];
+         edge->insert(t);
+      }
+      for (const auto &cur : blocks[i]) {
+         tuple t(block);
+         t << cur;
+         block->insert(t);
+      }
+
+      // run program
+      prog->run();
+      std::cout << "run " << i << "\n";
+
+      // print output relations in a fixed order
+      for (Relation *rel : prog->getOutputRelations()) {
+         std::set<std::string> tuples;
+         for (auto &output : *rel) {
+            std::string str;
+            for (size_t j = 0; j < rel->getArity(); j++) {
+               if (*rel->getAttrType(j) == 's') {
+                  std::string sym;
+                  output >> sym;
+                  str += " " + sym;
+               } else {
+                  RamDomain num;
+                  output >> num;
+                  str += " " + std::to_string(num);
+               }
+            }
+            tuples.insert(str);
+         }
+         std::cout << rel->getName() << ":";
+         for (const auto &cur : tuples) {
+            std::cout << cur << ";";
+         }
+         std::cout << "\n";
+      }
+   }
+
+   delete prog;
+}
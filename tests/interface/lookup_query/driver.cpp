@@ -0,0 +1,117 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program looking up tuples of a Souffle program by bound columns
+ *
+ ***********************************************************************/
+
+#include <array>
+#include <set>
+#include <string>
+#include <vector>
+#include "souffle/SouffleInterface.h"
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt)
+{
+   std::cerr << "error: " << txt << "\n";
+   exit(1);
+}
+
+/**
+ * Look up the tuples of a binary relation, fetching them in batches of two tuples,
+ * and print them in a fixed order
+ */
+void query(Relation *rel, SearchColumns columns, const std::array<std::string,2> &key)
+{
+   // encode the key, where unbound columns are ignored
+   std::array<RamDomain,2> data = {{0, 0}};
+   for (size_t i = 0; i < 2; i++) {
+      if ((columns >> i) & 1) {
+         if (*rel->getAttrType(i) == 's') {
+            data[i] = rel->getSymbolTable().lookup(key[i].c_str());
+         } else {
+            data[i] = std::stoi(key[i]);
+         }
+      }
+   }
+
+   std::set<std::string> result;
+   std::unique_ptr<Relation::cursor> cursor = rel->lookup(columns, data.data());
+   RamDomain buffer[4];
+   size_t num;
+   do {
+      num = cursor->next(buffer, 2);
+      for (size_t i = 0; i < num; i++) {
+         std::string str;
+         for (size_t j = 0; j < 2; j++) {
+            RamDomain value = buffer[i * 2 + j];
+            str += " " + ((*rel->getAttrType(j) == 's') ? std::string(rel->getSymbolTable().resolve(value))
+                                                         : std::to_string(value));
+         }
+         result.insert(str);
+      }
+   } while (num == 2);
+
+   std::cout << rel->getName() << "(" << ((columns & 1) ? key[0] : "_") << ","
+             << ((columns & 2) ? key[1] : "_") << "):";
+   for (const auto &cur : result) {
+      std::cout << cur << ";";
+   }
+   std::cout << "\n";
+}
+
+/**
+ * Main program
+ */
+int main(int argc, char **argv)
+{
+   // create an instance of program "lookup_query"
+   SouffleProgram *prog = ProgramFactory::newInstance("lookup_query");
+   if (prog == nullptr) {
+      error("cannot find program lookup_query");
+   }
+
+   Relation *edge = prog->getRelation("edge");
+   Relation *path = prog->getRelation("path");
+   Relation *reach = prog->getRelation("reach");
+   if (edge == nullptr || path == nullptr || reach == nullptr) {
+      error("cannot find relations");
+   }
+
+   // the first column of edges is indexed for the joins of the program
+   if (!edge->hasIndex(1)) {
+      error("missing index of edge");
+   }
+
+   // look up loaded inputs by the first column, by the second column and by both columns
+   prog->loadAll(argv[1]);
+   query(edge, 1, {{"b", ""}});
+   query(edge, 2, {{"", "a"}});
+   query(edge, 3, {{"c", "d"}});
+   query(edge, 3, {{"d", "c"}});
+
+   // look up the outputs
+   prog->run();
+   query(path, 1, {{"a", ""}});
+   query(path, 1, {{"x", ""}});
+   query(path, 2, {{"", "e"}});
+   query(path, 0, {{"", ""}});
+   query(reach, 2, {{"", "3"}});
+   query(reach, 1, {{"e", ""}});
+
+   delete prog;
+}
@@ -0,0 +1,88 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2017, The Souffle Developers and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program running one instance of a Souffle program repeatedly,
+ * purging it and inserting new inputs in bulk between the runs
+ *
+ ***********************************************************************/
+
+#include <array>
+#include <set>
+#include <string>
+#include <vector>
+#include "souffle/SouffleInterface.h"
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt)
+{
+   std::cerr << "error: " << txt << "\n";
+   exit(1);
+}
+
+/**
+ * Main program
+ */
+int main(int argc, char **argv)
+{
+   // create an instance of program "purge_insert"
+   SouffleProgram *prog = ProgramFactory::newInstance("purge_insert");
+   if (prog == nullptr) {
+      error("cannot find program purge_insert");
+   }
+   Relation *edge = prog->getRelation("edge");
+   Relation *path = prog->getRelation("path");
+   if (edge == nullptr || path == nullptr) {
+      error("cannot find relations");
+   }
+
+   std::vector<std::vector<std::array<std::string,2>>> inputs = {
+      {{"A","B"}, {"B","C"}, {"C","A"}},
+      {{"D","E"}, {"E","F"}},
+      {{"A","B"}, {"B","C"}, {"C","A"}}
+   };
+   for (const auto &input : inputs) {
+      // encode the input as consecutive tuples and insert them at once
+      std::vector<RamDomain> data;
+      for (const auto &cur : input) {
+         data.push_back(edge->getSymbolTable().lookup(cur[0].c_str()));
+         data.push_back(edge->getSymbolTable().lookup(cur[1].c_str()));
+      }
+      edge->insert(data.data(), input.size());
+      std::cout << "run with " << edge->size() << " edges\n";
+
+      // run program
+      prog->run();
+
+      // print output relation "path" in a fixed order
+      std::set<std::string> paths;
+      for (auto &output : *path) {
+         std::string src, dest;
+         output >> src >> dest;
+         paths.insert(src + "-" + dest);
+      }
+      for (const auto &cur : paths) {
+         std::cout << cur << "\n";
+      }
+
+      // reset the program for the next run
+      prog->purge();
+      if (edge->size() != 0 || path->size() != 0) {
+         error("relations not purged");
+      }
+   }
+
+   delete prog;
+}